@@ -1260,7 +1260,25 @@ typedef enum {
      * @a value1   New width
      * @a value2   New height
      */
-    ENGINE_CALLBACK_EMBED_UI_RESIZED = 48
+    ENGINE_CALLBACK_EMBED_UI_RESIZED = 48,
+
+    /*!
+     * Offline rendering progress.
+     * Sent periodically while rendering, and once more with 100% when done.
+     * @a value1   Progress in percent, from 0 to 100
+     * @a valuef   Render speed relative to realtime
+     * @a valueStr Output filename
+     * @see CarlaEngine::renderToFile() and carla_engine_render_to_file()
+     */
+    ENGINE_CALLBACK_RENDER_PROGRESS = 49,
+
+    /*!
+     * A plugin has been frozen or unfrozen.
+     * @a pluginId Plugin Id
+     * @a value1   1 if the plugin now plays from its freeze cache, 0 otherwise
+     * @see CarlaEngine::freezePlugin() and carla_freeze_plugin()
+     */
+    ENGINE_CALLBACK_PLUGIN_FREEZE_CHANGED = 50
 
 } EngineCallbackOpcode;
 
@@ -1551,10 +1569,81 @@ typedef enum {
     /*!
      * Treat loaded plugins as standalone (that is, there is no host UI to manage them)
      */
-    ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35
+    ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35,
+
+    /*!
+     * Process patchbay graphs in double precision.
+     * Audio between plugins that support 64-bit processing is kept as double,
+     * and is only converted to float where a float-only plugin or the audio driver is reached.
+     * Only used in patchbay mode.
+     * Default is false.
+     */
+    ENGINE_OPTION_AUDIO_DOUBLE_PRECISION = 36,
+
+    /*!
+     * Time in microseconds that plugin bridges busy-wait for the other side before sleeping.
+     * Lowers the wake-up latency of bridged plugins with small buffer sizes, at the cost of extra CPU usage.
+     * Spinning is skipped for a while when the other side keeps taking longer than this.
+     * Maximum is 1000, default is 0 (always sleep).
+     */
+    ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME = 37,
+
+    /*!
+     * Set of CPUs a thread class is allowed to run on.
+     * Value is the thread class, valueStr is a list of CPU numbers and ranges, like "2,3" or "4-7".
+     * An empty list leaves the CPU set unchanged, which is the default.
+     * @see EngineThreadClass
+     */
+    ENGINE_OPTION_THREAD_CPU_SET = 38,
+
+    /*!
+     * Scheduling priority of a thread class.
+     * Value is the thread class, valueStr is the priority as a number:
+     * 1 to 99 for realtime (FIFO) scheduling, 0 for normal scheduling, or -1 to leave it unchanged (default).
+     * @see EngineThreadClass
+     */
+    ENGINE_OPTION_THREAD_PRIORITY = 39
 
 } EngineOption;
 
+/* ------------------------------------------------------------------------------------------------------------
+ * Engine Thread Class */
+
+/*!
+ * Engine thread class.
+ * Threads are grouped by what they do, each group can be given its own CPU set and priority.
+ * @see ENGINE_OPTION_THREAD_CPU_SET and ENGINE_OPTION_THREAD_PRIORITY
+ */
+typedef enum {
+    /*!
+     * Audio thread, as given by the audio driver.
+     * In plugin bridges this is the thread that processes audio in sync with the host.
+     */
+    ENGINE_THREAD_AUDIO = 0,
+
+    /*!
+     * Worker threads, used by plugins to spread their processing over several CPUs.
+     */
+    ENGINE_THREAD_WORKER = 1,
+
+    /*!
+     * Engine idle thread, which also handles OSC when the engine has no main thread to do so.
+     */
+    ENGINE_THREAD_IDLE = 2,
+
+    /*!
+     * Plugin bridge processes.
+     * Applies to all threads a bridge creates after startup, except for its audio thread.
+     */
+    ENGINE_THREAD_BRIDGE = 3,
+
+    /*!
+     * Terminator/count, not a thread class.
+     */
+    ENGINE_THREAD_CLASS_COUNT = 4
+
+} EngineThreadClass;
+
 /* ------------------------------------------------------------------------------------------------------------
  * Engine Process Mode */
 
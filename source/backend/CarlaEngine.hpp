@@ -28,6 +28,8 @@ class XmlDocument;
 
 CARLA_BACKEND_START_NAMESPACE
 
+class CarlaEngineRenderWriter;
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -254,9 +256,11 @@ struct CARLA_API EngineOptions {
 
     uint maxParameters;
     uint uiBridgesTimeout;
+    uint bridgeSpinWaitTime;
     uint audioBufferSize;
     uint audioSampleRate;
     bool audioTripleBuffer;
+    bool audioDoublePrecision;
     const char* audioDriver;
     const char* audioDevice;
 
@@ -286,6 +290,9 @@ struct CARLA_API EngineOptions {
     bool preventBadBehaviour;
     uintptr_t frontendWinId;
 
+    const char* threadCpuSets[ENGINE_THREAD_CLASS_COUNT];
+    int threadPriorities[ENGINE_THREAD_CLASS_COUNT];
+
 #ifndef CARLA_OS_WIN
     struct Wine {
         const char* executable;
@@ -366,6 +373,34 @@ struct CARLA_API EngineTimeInfo {
 #endif
 };
 
+/*!
+ * Engine plugin processing time information.
+ * All times are in microseconds, measured around each plugin process call.
+ */
+struct CARLA_API EnginePluginTimingInfo {
+    uint32_t cycles; //!< number of measured cycles
+    float min;       //!< fastest cycle
+    float avg;       //!< average cycle
+    float max;       //!< slowest cycle
+    float p95;       //!< 95th percentile (approximate)
+    float p99;       //!< 99th percentile (approximate)
+
+    /*!
+     * Clear.
+     */
+    void clear() noexcept;
+
+#ifndef DOXYGEN
+    EnginePluginTimingInfo() noexcept;
+#endif
+};
+
+/*!
+ * Task function for the engine worker pool.
+ * @see CarlaEngine::runWorkerTasks()
+ */
+typedef void (*EngineWorkerTaskFunc)(void* ptr, uint32_t taskIndex);
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -961,6 +996,24 @@ public:
      */
     virtual void clearXruns() const noexcept;
 
+    /*!
+     * Write the engine cycle statistics as JSON into @a outStream.
+     * This includes log-scale histograms of cycle time and start jitter,
+     * plus the slowest cycles so far with the individual cost of each plugin.
+     */
+    void getCycleStatsAsJSON(water::MemoryOutputStream& outStream) const;
+
+    /*!
+     * Clear the engine cycle statistics.
+     */
+    void clearCycleStats() const noexcept;
+
+    /*!
+     * Write the requested and effective CPU set and priority of each engine thread class as JSON into @a outStream.
+     * Classes whose threads have not started yet are reported as not applied.
+     */
+    void getThreadPlacementAsJSON(water::MemoryOutputStream& outStream) const;
+
     /*!
      * Dynamically change buffer size and/or sample rate while engine is running.
      * @see ENGINE_DRIVER_DEVICE_VARIABLE_BUFFER_SIZE
@@ -1148,6 +1201,38 @@ public:
      */
     float getOutputPeak(uint pluginId, bool isLeft) const noexcept;
 
+    /*!
+     * Copy the peak values of all plugins into @a peaks, 4 values per plugin, up to @a maxPlugins.
+     * Returns the number of plugins, which can be higher than @a maxPlugins.
+     */
+    uint getAllPeaks(float* peaks, uint maxPlugins) const noexcept;
+
+    // -------------------------------------------------------------------
+    // Information (snapshots)
+
+    /*!
+     * Get the snapshot version of the current plugins.
+     * Compares the change counter of each plugin and the number of plugins with the previous call,
+     * the version is increased if anything is different.
+     * Plugins which never checked for changes are checked here.
+     * @see CarlaPlugin::getParameterValuesAndCheckChanges()
+     */
+    uint64_t getSnapshotVersion() noexcept;
+
+    // -------------------------------------------------------------------
+    // Information (timings)
+
+    /*!
+     * Get a plugin's processing time information.
+     * Values are collected on the audio thread, so they might be one cycle behind.
+     */
+    void getPluginTimingInfo(uint pluginId, EnginePluginTimingInfo& info) const noexcept;
+
+    /*!
+     * Clear the processing time information of all plugins.
+     */
+    void clearPluginTimings() const noexcept;
+
     // -------------------------------------------------------------------
     // Callback
 
@@ -1230,6 +1315,27 @@ public:
      */
     virtual void transportRelocate(uint64_t frame) noexcept;
 
+    /*!
+     * Render @a numFrames of the engine output into an audio file, starting at transport frame @a startFrame.
+     * The graph runs as fast as possible with plugins in offline mode, a background thread writes the file.
+     * The file format is taken from the extension, "wav" for 32-bit float and "flac" for 24-bit integer.
+     * This blocks until done, progress is reported with ENGINE_CALLBACK_RENDER_PROGRESS,
+     * and it can be stopped with setActionCanceled().
+     * The audio device outputs silence meanwhile, external transport is not moved.
+     * Needs the rack or patchbay processing mode, and is not possible while running as a plugin.
+     */
+    virtual bool renderToFile(const char* filename, uint64_t startFrame, uint64_t numFrames);
+
+    /*!
+     * Freeze plugin with id @a id over @a numFrames, starting at transport frame @a startFrame.
+     * The engine renders the range offline while the plugin output is stored in a cache file,
+     * afterwards the plugin plays back from the cache instead of processing.
+     * Only audio is cached, plugins with CV or MIDI outputs cannot be frozen.
+     * The plugin is unfrozen automatically when its input, parameters or state change.
+     * This blocks until done, like renderToFile(), and has the same restrictions.
+     */
+    bool freezePlugin(uint id, uint64_t startFrame, uint64_t numFrames);
+
     // -------------------------------------------------------------------
     // Error handling
 
@@ -1276,6 +1382,29 @@ public:
      */
     bool wasActionCanceled() const noexcept;
 
+    // -------------------------------------------------------------------
+    // Worker pool
+
+    /*!
+     * Start the engine worker threads, if not running yet.
+     * Returns false if the system has no spare CPUs for them.
+     */
+    bool startWorkerPool();
+
+    /*!
+     * Run @a numTasks calls to @a func, spread over the engine worker threads and the calling thread.
+     * Only returns after all tasks are done.
+     * Returns false without running any task if the workers are not running or busy,
+     * in which case the caller should run the tasks by itself.
+     * @note RT call
+     */
+    bool runWorkerTasks(uint32_t numTasks, EngineWorkerTaskFunc func, void* ptr) noexcept;
+
+    /*!
+     * Check if the calling thread is one of the engine worker threads.
+     */
+    bool isWorkerThread() const noexcept;
+
     // -------------------------------------------------------------------
     // Options
 
@@ -1324,6 +1453,7 @@ protected:
     friend class PendingRtEventsRunner;
     friend class ScopedActionLock;
     friend class ScopedEngineEnvironmentLocker;
+    friend class ScopedPluginTableUpdate;
     friend class ScopedRunnerStopper;
     friend class PatchbayGraph;
     friend struct ExternalGraph;
@@ -1354,6 +1484,21 @@ protected:
      */
     void setPluginPeaksRT(uint pluginId, float const inPeaks[2], float const outPeaks[2]) noexcept;
 
+    /*!
+     * Add a plugin processing time measurement, in nanoseconds.
+     * @note RT call
+     */
+    void addPluginTimingRT(uint pluginId, uint64_t timeNs) noexcept;
+
+    /*!
+     * Render @a numFrames of the engine graph offline, starting at transport frame @a startFrame.
+     * The output is written to @a writer and the writer closed afterwards, it is discarded if @a writer is null.
+     * @a name is used for progress reports.
+     * The graph is processed from the calling thread, driver audio callbacks must skip their cycle
+     * while the engine render mutex is held.
+     */
+    virtual bool renderOffline(CarlaEngineRenderWriter* writer, const char* name, uint64_t startFrame, uint64_t numFrames);
+
 public:
     /*!
      * Common save project function for main engine and plugin.
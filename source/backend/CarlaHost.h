@@ -339,6 +339,90 @@ typedef struct {
 
 } CarlaRuntimeEngineDriverDeviceInfo;
 
+/*!
+ * Plugin processing time information.
+ * All times are in microseconds.
+ * @see carla_get_plugin_timing_info()
+ */
+typedef struct _CarlaPluginTimingInfo {
+    /*!
+     * Number of measured process cycles.
+     */
+    uint32_t cycles;
+
+    /*!
+     * Fastest process cycle.
+     */
+    float min;
+
+    /*!
+     * Average process cycle.
+     */
+    float avg;
+
+    /*!
+     * Slowest process cycle.
+     */
+    float max;
+
+    /*!
+     * 95th percentile, approximate.
+     */
+    float p95;
+
+    /*!
+     * 99th percentile, approximate.
+     */
+    float p99;
+
+} CarlaPluginTimingInfo;
+
+/*!
+ * Plugin state inside an engine snapshot.
+ * @see carla_get_engine_snapshot()
+ */
+typedef struct _CarlaPluginSnapshot {
+    /*!
+     * Change counter of this plugin.
+     * Changes whenever a parameter value, internal parameter, current program or MIDI program changes.
+     * Counters are unique, a different plugin never has the same counter.
+     */
+    uint64_t changeCounter;
+
+    /*!
+     * Number of parameters.
+     */
+    uint32_t parameterCount;
+
+    /*!
+     * Index of this plugin's first parameter value inside the snapshot values array.
+     */
+    uint32_t parameterOffset;
+
+    /*!
+     * Number of parameter values copied into the snapshot values array.
+     * Lower than @a parameterCount if the array is too small.
+     */
+    uint32_t parametersCopied;
+
+    /*!
+     * Current program number (-1 if unset).
+     */
+    int32_t currentProgram;
+
+    /*!
+     * Current MIDI program number (-1 if unset).
+     */
+    int32_t currentMidiProgram;
+
+    /*!
+     * Peak values, input left and right, then output left and right.
+     * Peaks are not part of the change counter.
+     */
+    float peaks[4];
+
+} CarlaPluginSnapshot;
+
 /*!
  * Image data for LV2 inline display API.
  * raw image pixmap format is ARGB32,
@@ -469,6 +553,27 @@ CARLA_API_EXPORT bool carla_show_engine_device_control_panel(CarlaHostHandle han
  */
 CARLA_API_EXPORT void carla_clear_engine_xruns(CarlaHostHandle handle);
 
+/*!
+ * Get the engine cycle statistics, as a JSON string.
+ * This includes log-scale histograms of cycle time and start jitter,
+ * plus the slowest cycles so far with the individual cost of each plugin that ran.
+ * @note Returned string is only valid until the next call to this function.
+ */
+CARLA_API_EXPORT const char* carla_get_engine_cycle_stats(CarlaHostHandle handle);
+
+/*!
+ * Clear the engine cycle statistics.
+ */
+CARLA_API_EXPORT void carla_clear_engine_cycle_stats(CarlaHostHandle handle);
+
+/*!
+ * Get the requested and effective CPU set and priority of each engine thread class, as a JSON string.
+ * Classes whose threads have not started yet are reported as not applied.
+ * @see ENGINE_OPTION_THREAD_CPU_SET and ENGINE_OPTION_THREAD_PRIORITY
+ * @note Returned string is only valid until the next call to this function.
+ */
+CARLA_API_EXPORT const char* carla_get_engine_thread_placement(CarlaHostHandle handle);
+
 /*!
  * Tell the engine to stop the current cancelable action.
  * @see ENGINE_CALLBACK_CANCELABLE_ACTION
@@ -605,6 +710,19 @@ CARLA_API_EXPORT uint64_t carla_get_current_transport_frame(CarlaHostHandle hand
  * Get the engine transport information.
  */
 CARLA_API_EXPORT const CarlaTransportInfo* carla_get_transport_info(CarlaHostHandle handle);
+
+/*!
+ * Render the engine output into an audio file, as fast as possible.
+ * Transport is relocated to @a startFrame and rolls for @a numFrames, with plugins set to offline mode.
+ * The file format is taken from the extension, either "wav" or "flac".
+ * Blocks until done, reporting progress via ENGINE_CALLBACK_RENDER_PROGRESS.
+ * Can be stopped with carla_cancel_engine_action().
+ * The audio device outputs silence meanwhile.
+ * Needs the rack or patchbay processing mode, and is not possible while running as a plugin.
+ * @see carla_get_last_error()
+ */
+CARLA_API_EXPORT bool carla_engine_render_to_file(CarlaHostHandle handle,
+                                                  const char* filename, uint64_t startFrame, uint64_t numFrames);
 #endif
 
 /*!
@@ -895,6 +1013,16 @@ CARLA_API_EXPORT float carla_get_default_parameter_value(CarlaHostHandle handle,
  */
 CARLA_API_EXPORT float carla_get_current_parameter_value(CarlaHostHandle handle, uint pluginId, uint32_t parameterId);
 
+/*!
+ * Get all of a plugin's current parameter values in a single call.
+ * Returns the number of parameters, which can be higher than @a count.
+ * @param pluginId Plugin
+ * @param values   Array to copy the values into
+ * @param count    Size of @a values
+ */
+CARLA_API_EXPORT uint32_t carla_get_current_parameter_values(CarlaHostHandle handle, uint pluginId,
+                                                             float* values, uint32_t count);
+
 /*!
  * Get a plugin's internal parameter value.
  * @param pluginId    Plugin
@@ -916,6 +1044,14 @@ CARLA_API_EXPORT uint32_t carla_get_plugin_latency(CarlaHostHandle handle, uint
  */
 CARLA_API_EXPORT const float* carla_get_peak_values(CarlaHostHandle handle, uint pluginId);
 
+/*!
+ * Get the peak values of all plugins in a single call, 4 values per plugin.
+ * Returns the number of plugins, which can be higher than @a maxPlugins.
+ * @param peaks      Array to copy the values into, must fit 4 * @a maxPlugins values
+ * @param maxPlugins Maximum number of plugins to copy
+ */
+CARLA_API_EXPORT uint carla_get_all_peak_values(CarlaHostHandle handle, float* peaks, uint maxPlugins);
+
 /*!
  * Get a plugin's input peak value.
  * @param pluginId Plugin
@@ -930,6 +1066,37 @@ CARLA_API_EXPORT float carla_get_input_peak_value(CarlaHostHandle handle, uint p
  */
 CARLA_API_EXPORT float carla_get_output_peak_value(CarlaHostHandle handle, uint pluginId, bool isLeft);
 
+/*!
+ * Get a plugin's processing time information, collected since it was added or last cleared.
+ * @param pluginId Plugin
+ */
+CARLA_API_EXPORT const CarlaPluginTimingInfo* carla_get_plugin_timing_info(CarlaHostHandle handle, uint pluginId);
+
+/*!
+ * Clear the processing time information of all plugins.
+ */
+CARLA_API_EXPORT void carla_clear_plugin_timings(CarlaHostHandle handle);
+
+/*!
+ * Get the state of all plugins in a single call.
+ * Parameter values of all plugins are packed one after the other into @a values,
+ * each plugin snapshot tells where its values start.
+ * Clients can skip plugins whose change counter did not change since their last call,
+ * or everything when the returned version is the same.
+ *
+ * Returns the snapshot version, which increases whenever the number of plugins or any change counter is different.
+ * @param plugins     Array to copy the plugin snapshots into
+ * @param maxPlugins  Size of @a plugins
+ * @param values      Array to copy the parameter values into
+ * @param maxValues   Size of @a values
+ * @param pluginCount Set to the number of plugins, which can be higher than @a maxPlugins
+ * @param valueCount  Set to the number of parameter values needed for all plugins, can be higher than @a maxValues
+ */
+CARLA_API_EXPORT uint64_t carla_get_engine_snapshot(CarlaHostHandle handle,
+                                                    CarlaPluginSnapshot* plugins, uint maxPlugins,
+                                                    float* values, uint32_t maxValues,
+                                                    uint* pluginCount, uint32_t* valueCount);
+
 /*!
  * Render a plugin's inline display.
  * @param pluginId Plugin
@@ -946,6 +1113,37 @@ CARLA_API_EXPORT const CarlaInlineDisplayImageSurface* carla_render_inline_displ
  */
 CARLA_API_EXPORT void carla_set_active(CarlaHostHandle handle, uint pluginId, bool onOff);
 
+/*!
+ * Set a custom tail for a plugin, in sample frames, used to put it to sleep while its input is silent.
+ * @param pluginId Plugin
+ * @param samples  Tail length, or -1 to use the tail reported by the plugin
+ */
+CARLA_API_EXPORT void carla_set_plugin_tail_samples(CarlaHostHandle handle, uint pluginId, int32_t samples);
+
+/*!
+ * Freeze a plugin, rendering its output over a transport range into a cache it plays back from.
+ * The engine renders the range offline, blocking until done like carla_engine_render_to_file().
+ * Plugins with CV or MIDI outputs cannot be frozen.
+ * The plugin is unfrozen automatically when its input, parameters or state change.
+ * Reports ENGINE_CALLBACK_PLUGIN_FREEZE_CHANGED on success.
+ * @param pluginId   Plugin
+ * @param startFrame First transport frame to freeze
+ * @param numFrames  Number of frames to freeze
+ */
+CARLA_API_EXPORT bool carla_freeze_plugin(CarlaHostHandle handle, uint pluginId, uint64_t startFrame, uint64_t numFrames);
+
+/*!
+ * Unfreeze a plugin, deleting its freeze cache.
+ * @param pluginId Plugin
+ */
+CARLA_API_EXPORT void carla_unfreeze_plugin(CarlaHostHandle handle, uint pluginId);
+
+/*!
+ * Check if a plugin is currently playing from its freeze cache.
+ * @param pluginId Plugin
+ */
+CARLA_API_EXPORT bool carla_is_plugin_frozen(CarlaHostHandle handle, uint pluginId);
+
 #ifndef BUILD_BRIDGE
 /*!
  * Change a plugin's internal dry/wet.
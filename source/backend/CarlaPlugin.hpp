@@ -162,6 +162,37 @@ public:
      */
     virtual uint32_t getLatencyInFrames() const noexcept;
 
+    /*!
+     * Get the plugin's tail, in sample frames.
+     * This is how long the plugin can keep producing sound after its input becomes silent.
+     * Returns UINT32_MAX if unknown or infinite, which is the default.
+     * @note May be called from the audio thread
+     */
+    virtual uint32_t getTailSamples() const noexcept;
+
+    /*!
+     * Check if the plugin is currently sleeping.
+     * @see setUserTailSamples()
+     */
+    bool isSleeping() const noexcept;
+
+    /*!
+     * Check if the plugin is frozen, playing back its cached output instead of being processed.
+     * @see CarlaEngine::freezePlugin()
+     */
+    bool isFrozen() const noexcept;
+
+    /*!
+     * Check if the plugin output is currently being recorded into a freeze cache.
+     */
+    bool isFreezing() const noexcept;
+
+    /*!
+     * Check if the plugin's custom UI is shown.
+     * @see setCustomUIShown()
+     */
+    bool isCustomUIShown() const noexcept;
+
     // -------------------------------------------------------------------
     // Information (count)
 
@@ -380,6 +411,24 @@ public:
      */
     float getInternalParameterValue(int32_t parameterId) const noexcept;
 
+    /*!
+     * Copy the current value of all parameters into @a values, up to @a count.
+     * Returns the number of parameters, which can be higher than @a count.
+     */
+    uint32_t getParameterValues(float* values, uint32_t count) const noexcept;
+
+    /*!
+     * Same as getParameterValues(), but also check for changes since the last call.
+     * Parameter values, internal parameters, current program and MIDI program are checked.
+     * The change counter is updated when something changed, its values are unique within the process.
+     */
+    uint32_t getParameterValuesAndCheckChanges(float* values, uint32_t count) noexcept;
+
+    /*!
+     * Get the change counter from the last call to getParameterValuesAndCheckChanges(), 0 if never called.
+     */
+    uint64_t getChangeCounter() const noexcept;
+
     /*!
      * Get the name of the program at @a index.
      */
@@ -501,6 +550,22 @@ public:
      */
     void setActive(bool active, bool sendOsc, bool sendCallback) noexcept;
 
+    /*!
+     * Set a custom tail for the plugin, in sample frames, overriding the one reported by the plugin.
+     * Use a negative @a samples value to go back to the plugin's own tail.
+     *
+     * Plugins with a known tail are put to sleep once their input has been silent for longer than the tail,
+     * and the output is silent too. Sleeping plugins are not processed until new input or events arrive.
+     */
+    void setUserTailSamples(int32_t samples) noexcept;
+
+    /*!
+     * Drop the plugin's freeze cache and go back to processing it.
+     * Frozen plugins are also unfrozen on idle after a parameter, program or state change,
+     * or when their input no longer matches the rendered input.
+     */
+    void unfreeze(bool sendCallback) noexcept;
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     /*!
      * Set the plugin's dry/wet signal value to @a value.
@@ -719,6 +784,74 @@ public:
     virtual void process(const float* const* audioIn, float** audioOut,
                          const float* const* cvIn, float** cvOut, uint32_t frames) = 0;
 
+    /*!
+     * Check if the plugin can currently process audio in double precision, see processDouble().
+     * Only plugins that natively support 64-bit audio return true, and only when the engine uses double precision.
+     * @note RT call
+     */
+    virtual bool canProcessDouble() const noexcept;
+
+    /*!
+     * Plugin process call, double precision version.
+     * Only called when canProcessDouble() returns true, audio input and output buffers may be the same.
+     */
+    virtual void processDouble(const double* const* audioIn, double** audioOut,
+                               const float* const* cvIn, float** cvOut, uint32_t frames);
+
+    /*!
+     * Check if the plugin can skip processing for the current cycle.
+     * Wakes up the plugin on any audio input, pending event, parameter change or transport change.
+     * When true is returned, the host must clear the plugin outputs instead of calling process().
+     * @note RT call
+     */
+    bool isSleepingRT(const float* const* audioIn, uint32_t frames) noexcept;
+
+    /*!
+     * Double precision version of isSleepingRT(), used before processDouble().
+     * @note RT call
+     */
+    bool isSleepingRT(const double* const* audioIn, uint32_t frames) noexcept;
+
+    /*!
+     * Update the sleep state after a process() call, putting the plugin to sleep once its tail is over.
+     * @note RT call
+     */
+    void updateSleepStateRT(const float* const* audioOut, uint32_t frames) noexcept;
+
+    /*!
+     * Double precision version of updateSleepStateRT(), used after processDouble().
+     * @note RT call
+     */
+    void updateSleepStateRT(const double* const* audioOut, uint32_t frames) noexcept;
+
+    /*!
+     * Start recording the plugin's output into a new freeze cache,
+     * for @a numFrames starting at transport frame @a startFrame.
+     * Called by CarlaEngine::freezePlugin() before rendering the range offline.
+     */
+    bool startFreeze(uint64_t startFrame, uint64_t numFrames);
+
+    /*!
+     * Finish recording the freeze cache and start playing it back.
+     * The cache is dropped instead if @a rendered is false.
+     */
+    bool finishFreeze(bool rendered);
+
+    /*!
+     * Check if the plugin is frozen for the current cycle.
+     * When true is returned, the cached output has been written to @a audioOut and the host must not call process().
+     * Input that differs from the rendered input, or external notes, unfreeze the plugin.
+     * While the freeze cache is being recorded the input is hashed and false is returned.
+     * @note RT call
+     */
+    bool isFrozenRT(const float* const* audioIn, float* const* audioOut, uint32_t frames) noexcept;
+
+    /*!
+     * Store the plugin output for the current cycle while recording the freeze cache.
+     * @note RT call
+     */
+    void recordFreezeRT(const float* const* audioOut, uint32_t frames) noexcept;
+
     /*!
      * Tell the plugin the current buffer size changed.
      */
@@ -814,6 +947,12 @@ public:
      */
     virtual void showCustomUI(bool yesNo);
 
+    /*!
+     * Remember if the plugin's custom UI is shown, hosts call this right before showCustomUI().
+     * The engine clears it again when the plugin reports its UI closed through ENGINE_CALLBACK_UI_STATE_CHANGED.
+     */
+    void setCustomUIShown(bool yesNo) noexcept;
+
     /*!
      * Embed the plugin's custom UI to the system pointer @a ptr.
      * This function is always called from the main thread.
@@ -1070,6 +1209,11 @@ protected:
         CARLA_DECLARE_NON_COPYABLE(ScopedSingleProcessLocker)
     };
 
+private:
+    // shared by the float and double versions of isSleepingRT() and updateSleepStateRT()
+    template <typename T> bool _isSleepingRT(const T* const* audioIn, uint32_t frames) noexcept;
+    template <typename T> void _updateSleepStateRT(const T* const* audioOut, uint32_t frames) noexcept;
+
     friend class CarlaEngine;
     friend class CarlaEngineBridge;
     CARLA_DECLARE_NON_COPYABLE(CarlaPlugin)
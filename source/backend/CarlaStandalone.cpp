@@ -29,6 +29,7 @@
 #include "ThreadSafeFFTW.hpp"
 
 #include "water/files/File.h"
+#include "water/streams/MemoryOutputStream.h"
 
 #ifdef USING_JUCE
 # include "carla_juce/carla_juce.h"
@@ -242,6 +243,9 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
     if (const char* const uiBridgesTimeout = std::getenv("ENGINE_OPTION_UI_BRIDGES_TIMEOUT"))
         engine->setOption(CB::ENGINE_OPTION_UI_BRIDGES_TIMEOUT, std::atoi(uiBridgesTimeout), nullptr);
 
+    if (const char* const bridgeSpinWaitTime = std::getenv("ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME"))
+        engine->setOption(CB::ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME, std::atoi(bridgeSpinWaitTime), nullptr);
+
     if (const char* const pathAudio = std::getenv("ENGINE_OPTION_FILE_PATH_AUDIO"))
         engine->setOption(CB::ENGINE_OPTION_FILE_PATH, CB::FILE_AUDIO, pathAudio);
 
@@ -290,6 +294,20 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
 
     if (const char* const frontendWinId = std::getenv("ENGINE_OPTION_FRONTEND_WIN_ID"))
         engine->setOption(CB::ENGINE_OPTION_FRONTEND_WIN_ID, 0, frontendWinId);
+
+    for (int i=0; i < CB::ENGINE_THREAD_CLASS_COUNT; ++i)
+    {
+        char envName[64];
+        envName[63] = '\0';
+
+        std::snprintf(envName, 63, "ENGINE_OPTION_THREAD_CPU_SET_%i", i);
+        if (const char* const cpuSet = std::getenv(envName))
+            engine->setOption(CB::ENGINE_OPTION_THREAD_CPU_SET, i, cpuSet);
+
+        std::snprintf(envName, 63, "ENGINE_OPTION_THREAD_PRIORITY_%i", i);
+        if (const char* const priority = std::getenv(envName))
+            engine->setOption(CB::ENGINE_OPTION_THREAD_PRIORITY, i, priority);
+    }
 #else
     engine->setOption(CB::ENGINE_OPTION_FORCE_STEREO,          standalone.engineOptions.forceStereo         ? 1 : 0,        nullptr);
     engine->setOption(CB::ENGINE_OPTION_PREFER_PLUGIN_BRIDGES, standalone.engineOptions.preferPluginBridges ? 1 : 0,        nullptr);
@@ -298,9 +316,11 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
     engine->setOption(CB::ENGINE_OPTION_MAX_PARAMETERS,        static_cast<int>(standalone.engineOptions.maxParameters),    nullptr);
     engine->setOption(CB::ENGINE_OPTION_RESET_XRUNS,           standalone.engineOptions.resetXruns          ? 1 : 0,        nullptr);
     engine->setOption(CB::ENGINE_OPTION_UI_BRIDGES_TIMEOUT,    static_cast<int>(standalone.engineOptions.uiBridgesTimeout), nullptr);
+    engine->setOption(CB::ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME, static_cast<int>(standalone.engineOptions.bridgeSpinWaitTime), nullptr);
     engine->setOption(CB::ENGINE_OPTION_AUDIO_BUFFER_SIZE,     static_cast<int>(standalone.engineOptions.audioBufferSize),  nullptr);
     engine->setOption(CB::ENGINE_OPTION_AUDIO_SAMPLE_RATE,     static_cast<int>(standalone.engineOptions.audioSampleRate),  nullptr);
     engine->setOption(CB::ENGINE_OPTION_AUDIO_TRIPLE_BUFFER,   standalone.engineOptions.audioTripleBuffer   ? 1 : 0,        nullptr);
+    engine->setOption(CB::ENGINE_OPTION_AUDIO_DOUBLE_PRECISION, standalone.engineOptions.audioDoublePrecision ? 1 : 0,    nullptr);
 
     if (standalone.engineOptions.audioDriver != nullptr)
         engine->setOption(CB::ENGINE_OPTION_AUDIO_DRIVER,      0, standalone.engineOptions.audioDriver);
@@ -388,6 +408,16 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
     engine->setOption(CB::ENGINE_OPTION_CLIENT_NAME_PREFIX, 0, standalone.engineOptions.clientNamePrefix);
 
     engine->setOption(CB::ENGINE_OPTION_PLUGINS_ARE_STANDALONE, standalone.engineOptions.pluginsAreStandalone, nullptr);
+
+    for (int i=0; i < CB::ENGINE_THREAD_CLASS_COUNT; ++i)
+    {
+        char strBuf[STR_MAX+1];
+        strBuf[STR_MAX] = '\0';
+        std::snprintf(strBuf, STR_MAX, "%i", standalone.engineOptions.threadPriorities[i]);
+
+        engine->setOption(CB::ENGINE_OPTION_THREAD_CPU_SET, i, standalone.engineOptions.threadCpuSets[i]);
+        engine->setOption(CB::ENGINE_OPTION_THREAD_PRIORITY, i, strBuf);
+    }
 #endif // BUILD_BRIDGE
 }
 
@@ -660,6 +690,38 @@ void carla_clear_engine_xruns(CarlaHostHandle handle)
         handle->engine->clearXruns();
 }
 
+const char* carla_get_engine_cycle_stats(CarlaHostHandle handle)
+{
+    static CarlaString retStats;
+
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, "{}");
+
+    water::MemoryOutputStream out;
+    handle->engine->getCycleStatsAsJSON(out);
+
+    retStats = out.toString().toRawUTF8();
+    return retStats.buffer();
+}
+
+void carla_clear_engine_cycle_stats(CarlaHostHandle handle)
+{
+    if (handle->engine != nullptr)
+        handle->engine->clearCycleStats();
+}
+
+const char* carla_get_engine_thread_placement(CarlaHostHandle handle)
+{
+    static CarlaString retPlacement;
+
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, "{}");
+
+    water::MemoryOutputStream out;
+    handle->engine->getThreadPlacementAsJSON(out);
+
+    retPlacement = out.toString().toRawUTF8();
+    return retPlacement.buffer();
+}
+
 void carla_cancel_engine_action(CarlaHostHandle handle)
 {
     if (handle->engine != nullptr)
@@ -777,6 +839,11 @@ void carla_set_engine_option(CarlaHostHandle handle, EngineOption option, int va
             shandle.engineOptions.uiBridgesTimeout = static_cast<uint>(value);
             break;
 
+        case CB::ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 1000,);
+            shandle.engineOptions.bridgeSpinWaitTime = static_cast<uint>(value);
+            break;
+
         case CB::ENGINE_OPTION_AUDIO_BUFFER_SIZE:
             CARLA_SAFE_ASSERT_RETURN(value >= 8,);
             shandle.engineOptions.audioBufferSize = static_cast<uint>(value);
@@ -792,6 +859,11 @@ void carla_set_engine_option(CarlaHostHandle handle, EngineOption option, int va
             shandle.engineOptions.audioTripleBuffer = (value != 0);
             break;
 
+        case CB::ENGINE_OPTION_AUDIO_DOUBLE_PRECISION:
+            CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+            shandle.engineOptions.audioDoublePrecision = (value != 0);
+            break;
+
         case CB::ENGINE_OPTION_AUDIO_DRIVER:
             CARLA_SAFE_ASSERT_RETURN(valueStr != nullptr,);
 
@@ -1006,6 +1078,28 @@ void carla_set_engine_option(CarlaHostHandle handle, EngineOption option, int va
             CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
             shandle.engineOptions.pluginsAreStandalone = (value != 0);
             break;
+
+        case CB::ENGINE_OPTION_THREAD_CPU_SET:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0 && value < CB::ENGINE_THREAD_CLASS_COUNT,);
+
+            // syntax is checked by the engine
+            if (shandle.engineOptions.threadCpuSets[value] != nullptr)
+                delete[] shandle.engineOptions.threadCpuSets[value];
+
+            shandle.engineOptions.threadCpuSets[value] = valueStr != nullptr && valueStr[0] != '\0'
+                                                       ? carla_strdup_safe(valueStr)
+                                                       : nullptr;
+            break;
+
+        case CB::ENGINE_OPTION_THREAD_PRIORITY: {
+            CARLA_SAFE_ASSERT_RETURN(value >= 0 && value < CB::ENGINE_THREAD_CLASS_COUNT,);
+            CARLA_SAFE_ASSERT_RETURN(valueStr != nullptr,);
+
+            const int priority = std::atoi(valueStr);
+            CARLA_SAFE_ASSERT_RETURN(priority >= -1 && priority <= 99,);
+
+            shandle.engineOptions.threadPriorities[value] = priority;
+        }   break;
         }
     }
 
@@ -1206,6 +1300,18 @@ const CarlaTransportInfo* carla_get_transport_info(CarlaHostHandle handle)
 
     return &retTransInfo;
 }
+
+bool carla_engine_render_to_file(CarlaHostHandle handle,
+                                 const char* filename, uint64_t startFrame, uint64_t numFrames)
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_engine_render_to_file(%p, \"%s\", " P_UINT64 ", " P_UINT64 ")",
+                handle, filename, startFrame, numFrames);
+
+    return handle->engine->renderToFile(filename, startFrame, numFrames);
+}
 #endif
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -1972,6 +2078,17 @@ float carla_get_current_parameter_value(CarlaHostHandle handle, uint pluginId, u
     return 0.0f;
 }
 
+uint32_t carla_get_current_parameter_values(CarlaHostHandle handle, uint pluginId, float* values, uint32_t count)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(values != nullptr || count == 0, 0);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        return plugin->getParameterValues(values, count);
+
+    return 0;
+}
+
 float carla_get_internal_parameter_value(CarlaHostHandle handle, uint pluginId, int32_t parameterId)
 {
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -2008,6 +2125,14 @@ const float* carla_get_peak_values(CarlaHostHandle handle, uint pluginId)
     return handle->engine->getPeaks(pluginId);
 }
 
+uint carla_get_all_peak_values(CarlaHostHandle handle, float* peaks, uint maxPlugins)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(peaks != nullptr || maxPlugins == 0, 0);
+
+    return handle->engine->getAllPeaks(peaks, maxPlugins);
+}
+
 float carla_get_input_peak_value(CarlaHostHandle handle, uint pluginId, bool isLeft)
 {
     CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0.0f);
@@ -2022,6 +2147,89 @@ float carla_get_output_peak_value(CarlaHostHandle handle, uint pluginId, bool is
     return handle->engine->getOutputPeak(pluginId, isLeft);
 }
 
+const CarlaPluginTimingInfo* carla_get_plugin_timing_info(CarlaHostHandle handle, uint pluginId)
+{
+    static CarlaPluginTimingInfo retInfo;
+    carla_zeroStruct(retInfo);
+
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, &retInfo);
+
+    CB::EnginePluginTimingInfo info;
+    handle->engine->getPluginTimingInfo(pluginId, info);
+
+    retInfo.cycles = info.cycles;
+    retInfo.min = info.min;
+    retInfo.avg = info.avg;
+    retInfo.max = info.max;
+    retInfo.p95 = info.p95;
+    retInfo.p99 = info.p99;
+
+    return &retInfo;
+}
+
+void carla_clear_plugin_timings(CarlaHostHandle handle)
+{
+    if (handle->engine != nullptr)
+        handle->engine->clearPluginTimings();
+}
+
+uint64_t carla_get_engine_snapshot(CarlaHostHandle handle,
+                                   CarlaPluginSnapshot* plugins, uint maxPlugins,
+                                   float* values, uint32_t maxValues,
+                                   uint* pluginCount, uint32_t* valueCount)
+{
+    if (pluginCount != nullptr)
+        *pluginCount = 0;
+    if (valueCount != nullptr)
+        *valueCount = 0;
+
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(plugins != nullptr || maxPlugins == 0, 0);
+    CARLA_SAFE_ASSERT_RETURN(values != nullptr || maxValues == 0, 0);
+
+    const uint count = handle->engine->getCurrentPluginCount();
+    uint32_t offset = 0;
+
+    for (uint i=0; i < count; ++i)
+    {
+        // still counted if the plugin is gone, so leave it empty
+        if (i < maxPlugins)
+            carla_zeroStruct(plugins[i]);
+
+        const CarlaPluginPtr plugin = handle->engine->getPlugin(i);
+        CARLA_SAFE_ASSERT_CONTINUE(plugin.get() != nullptr);
+
+        // plugins not copied are still checked, so the snapshot version is right
+        if (i >= maxPlugins)
+        {
+            offset += plugin->getParameterValuesAndCheckChanges(nullptr, 0);
+            continue;
+        }
+
+        const uint32_t room = offset < maxValues ? maxValues - offset : 0;
+        const uint32_t paramCount = plugin->getParameterValuesAndCheckChanges(room != 0 ? values + offset : nullptr,
+                                                                              room);
+
+        CarlaPluginSnapshot& snapshot(plugins[i]);
+        snapshot.changeCounter = plugin->getChangeCounter();
+        snapshot.parameterCount = paramCount;
+        snapshot.parameterOffset = offset;
+        snapshot.parametersCopied = std::min(paramCount, room);
+        snapshot.currentProgram = plugin->getCurrentProgram();
+        snapshot.currentMidiProgram = plugin->getCurrentMidiProgram();
+        carla_copyFloats(snapshot.peaks, handle->engine->getPeaks(i), 4);
+
+        offset += paramCount;
+    }
+
+    if (pluginCount != nullptr)
+        *pluginCount = count;
+    if (valueCount != nullptr)
+        *valueCount = offset;
+
+    return handle->engine->getSnapshotVersion();
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 CARLA_BACKEND_START_NAMESPACE
@@ -2081,6 +2289,41 @@ void carla_set_active(CarlaHostHandle handle, uint pluginId, bool onOff)
         plugin->setActive(onOff, true, false);
 }
 
+void carla_set_plugin_tail_samples(CarlaHostHandle handle, uint pluginId, int32_t samples)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr,);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        plugin->setUserTailSamples(samples);
+}
+
+bool carla_freeze_plugin(CarlaHostHandle handle, uint pluginId, uint64_t startFrame, uint64_t numFrames)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_freeze_plugin(%p, %i, " P_UINT64 ", " P_UINT64 ")", handle, pluginId, startFrame, numFrames);
+
+    return handle->engine->freezePlugin(pluginId, startFrame, numFrames);
+}
+
+void carla_unfreeze_plugin(CarlaHostHandle handle, uint pluginId)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr,);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        plugin->unfreeze(true);
+}
+
+bool carla_is_plugin_frozen(CarlaHostHandle handle, uint pluginId)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, false);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        return plugin->isFrozen();
+
+    return false;
+}
+
 #ifndef BUILD_BRIDGE
 void carla_set_drywet(CarlaHostHandle handle, uint pluginId, float value)
 {
@@ -2310,7 +2553,10 @@ void carla_show_custom_ui(CarlaHostHandle handle, uint pluginId, bool yesNo)
     CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr,);
 
     if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+    {
+        plugin->setCustomUIShown(yesNo);
         plugin->showCustomUI(yesNo);
+    }
 }
 
 void* carla_embed_custom_ui(CarlaHostHandle handle, uint pluginId, void* ptr)
@@ -25,6 +25,7 @@
 #include "CarlaEngineClient.hpp"
 #include "CarlaEngineInit.hpp"
 #include "CarlaEngineInternal.hpp"
+#include "CarlaEngineRender.hpp"
 #include "CarlaPlugin.hpp"
 
 #include "CarlaBackendUtils.hpp"
@@ -532,6 +533,202 @@ void CarlaEngine::clearXruns() const noexcept
 #endif
 }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+static void writeJsonString(water::MemoryOutputStream& outStream, const char* text)
+{
+    outStream << '"';
+
+    for (; *text != '\0'; ++text)
+    {
+        const char c = *text;
+
+        switch (c)
+        {
+        case '"':
+            outStream << "\\\"";
+            break;
+        case '\\':
+            outStream << "\\\\";
+            break;
+        case '\n':
+            outStream << "\\n";
+            break;
+        case '\t':
+            outStream << "\\t";
+            break;
+        default:
+            if (static_cast<uchar>(c) >= 0x20)
+                outStream << c;
+            break;
+        }
+    }
+
+    outStream << '"';
+}
+
+static const char* nsToMicrosecondsStr(water::String& tmp, const double timeNs)
+{
+    tmp = water::String(timeNs / 1000.0, 3);
+    return tmp.toRawUTF8();
+}
+
+static void writeJsonHistogram(water::MemoryOutputStream& outStream, const uint32_t* const buckets)
+{
+    water::String tmp;
+    bool first = true;
+
+    outStream << '[';
+
+    for (uint i=0; i < EngineCycleStats::kNumBuckets; ++i)
+    {
+        if (buckets[i] == 0)
+            continue;
+
+        if (! first)
+            outStream << ',';
+        first = false;
+
+        outStream << "{\"max_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(EngineCycleStats::getBucketUpperLimit(i)))
+                  << ",\"count\":" << static_cast<water::int64>(buckets[i]) << '}';
+    }
+
+    outStream << ']';
+}
+#endif
+
+void CarlaEngine::getCycleStatsAsJSON(water::MemoryOutputStream& outStream) const
+{
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    const EngineCycleStats& stats(pData->cycleStats);
+    water::String tmp;
+
+    outStream << "{\"buffer_size\":" << static_cast<int>(pData->bufferSize)
+              << ",\"sample_rate\":" << pData->sampleRate
+              << ",\"xruns\":" << static_cast<water::int64>(pData->xruns);
+
+    if (stats.ring == nullptr || stats.needsReset)
+    {
+        outStream << ",\"cycles\":0}";
+        return;
+    }
+
+    outStream << ",\"cycles\":" << static_cast<water::int64>(stats.numCycles)
+              << ",\"overruns\":" << static_cast<water::int64>(stats.numOverruns);
+
+    // summary of recent cycles, the audio thread might still be writing into the newest one
+    {
+        const uint written = stats.ringWriteCount.get();
+        const uint count = written > EngineCycleStats::kRingSize ? EngineCycleStats::kRingSize - 1
+                                                                 : (written > 0 ? written - 1 : 0);
+        uint64_t totalSum = 0, graphSum = 0, pluginsSum = 0;
+        uint32_t totalMax = 0;
+        int64_t jitterMax = 0;
+
+        for (uint i=0; i < count; ++i)
+        {
+            const EngineCycleRecord& record(stats.ring[(written - 2 - i) & (EngineCycleStats::kRingSize - 1)]);
+
+            totalSum   += record.totalNs;
+            graphSum   += record.graphNs;
+            pluginsSum += record.pluginsNs;
+            totalMax    = std::max(totalMax, record.totalNs);
+            jitterMax   = std::max(jitterMax, static_cast<int64_t>(std::abs(record.jitterNs)));
+        }
+
+        const double divider = count != 0 ? static_cast<double>(count) : 1.0;
+
+        outStream << ",\"recent\":{\"cycles\":" << static_cast<int>(count)
+                  << ",\"avg_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(totalSum) / divider)
+                  << ",\"max_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(totalMax))
+                  << ",\"max_jitter_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(jitterMax))
+                  << ",\"avg_graph_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(graphSum) / divider)
+                  << ",\"avg_plugins_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(pluginsSum) / divider)
+                  << '}';
+    }
+
+    outStream << ",\"histograms\":{\"total\":";
+    writeJsonHistogram(outStream, stats.totalBuckets);
+    outStream << ",\"jitter\":";
+    writeJsonHistogram(outStream, stats.jitterBuckets);
+    outStream << '}';
+
+    // slowest cycles, sorted from slowest to fastest
+    EngineCycleSlowest slowest[EngineCycleStats::kNumSlowest];
+    uint order[EngineCycleStats::kNumSlowest];
+    uint numSlowest = 0;
+
+    for (uint i=0; i < EngineCycleStats::kNumSlowest; ++i)
+    {
+        if (! stats.copySlowest(i, slowest[i]) || slowest[i].record.totalNs == 0)
+            continue;
+
+        uint j = numSlowest++;
+
+        for (; j > 0 && slowest[order[j - 1]].record.totalNs < slowest[i].record.totalNs; --j)
+            order[j] = order[j - 1];
+
+        order[j] = i;
+    }
+
+    outStream << ",\"slowest\":[";
+
+    for (uint i=0; i < numSlowest; ++i)
+    {
+        const EngineCycleSlowest& slot(slowest[order[i]]);
+
+        if (i != 0)
+            outStream << ',';
+
+        outStream << "{\"start_ns\":" << static_cast<water::int64>(slot.record.startNs)
+                  << ",\"frames\":" << static_cast<int>(slot.record.frames)
+                  << ",\"total_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(slot.record.totalNs))
+                  << ",\"jitter_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(slot.record.jitterNs))
+                  << ",\"graph_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(slot.record.graphNs))
+                  << ",\"plugins_us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(slot.record.pluginsNs))
+                  << ",\"xruns\":" << static_cast<water::int64>(slot.xruns)
+                  << ",\"num_plugins\":" << static_cast<int>(slot.numPlugins)
+                  << ",\"plugins\":[";
+
+        for (uint32_t j=0; j < slot.numCosts; ++j)
+        {
+            const EngineCyclePluginCost& cost(slot.costs[j]);
+
+            if (j != 0)
+                outStream << ',';
+
+            outStream << "{\"id\":" << static_cast<int>(cost.pluginId) << ",\"name\":";
+
+            // plugins might have been removed or moved since, names are a best guess
+            const CarlaPluginPtr plugin = cost.pluginId < pData->curPluginCount
+                                        ? pData->plugins[cost.pluginId].plugin
+                                        : CarlaPluginPtr();
+
+            writeJsonString(outStream, plugin.get() != nullptr ? plugin->getName() : "");
+
+            outStream << ",\"us\":" << nsToMicrosecondsStr(tmp, static_cast<double>(cost.timeNs)) << '}';
+        }
+
+        outStream << "]}";
+    }
+
+    outStream << "]}";
+#else
+    outStream << "{}";
+#endif
+}
+
+void CarlaEngine::clearCycleStats() const noexcept
+{
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    pData->cycleStats.needsReset = true;
+#endif
+}
+
+void CarlaEngine::getThreadPlacementAsJSON(MemoryOutputStream& outStream) const
+{
+    pData->threadPlacement.writeAsJSON(outStream);
+}
+
 bool CarlaEngine::showDeviceControlPanel() const noexcept
 {
     return false;
@@ -881,10 +1078,6 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
         return false;
     }
 
-    EnginePluginData& pluginData(pData->plugins[id]);
-    pluginData.plugin = plugin;
-    carla_zeroFloats(pluginData.peaks, 4);
-
    #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     if (oldPlugin.get() != nullptr)
     {
@@ -895,6 +1088,11 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
         if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
             pData->graph.replacePlugin(oldPlugin, plugin);
 
+        {
+            ScopedPluginTableUpdate sptu(this);
+            sptu.replacePlugin(id, plugin);
+        }
+
         const bool  wasActive = oldPlugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f;
         const float oldDryWet = oldPlugin->getInternalParameterValue(PARAMETER_DRYWET);
         const float oldVolume = oldPlugin->getInternalParameterValue(PARAMETER_VOLUME);
@@ -916,12 +1114,32 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
 
         callback(true, true, ENGINE_CALLBACK_RELOAD_ALL, id, 0, 0, 0, 0.0f, nullptr);
     }
-    else if (! pData->loadingProject)
+    else if (pData->loadingProject)
+    {
+        // kept past the current count, the project loader publishes it after restoring its state
+        EnginePluginData& pluginData(pData->plugins[id]);
+        pluginData.plugin = plugin;
+        carla_zeroFloats(pluginData.peaks, 4);
+        pluginData.timings.needsReset = true;
+    }
+    else
    #endif
     {
         plugin->setEnabled(true);
 
+       #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        {
+            ScopedPluginTableUpdate sptu(this);
+            sptu.addPlugin(plugin);
+        }
+       #else
+        EnginePluginData& pluginData(pData->plugins[id]);
+        pluginData.plugin = plugin;
+        carla_zeroFloats(pluginData.peaks, 4);
+        pluginData.timings.needsReset = true;
+
         ++pData->curPluginCount;
+       #endif
         callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, id, plugin->getType(), 0, 0, 0.0f, plugin->getName());
 
         if (getType() != kEngineTypeBridge)
@@ -975,7 +1193,10 @@ bool CarlaEngine::removePlugin(const uint id)
     if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
         pData->graph.removePlugin(plugin);
 
-    const ScopedActionLock sal(this, kEnginePostActionRemovePlugin, id, 0);
+    {
+        ScopedPluginTableUpdate sptu(this);
+        sptu.removePlugin(id);
+    }
 
     /*
     for (uint i=id; i < pData->curPluginCount; ++i)
@@ -989,6 +1210,7 @@ bool CarlaEngine::removePlugin(const uint id)
     pData->curPluginCount = 0;
     pData->plugins[0].plugin.reset();
     carla_zeroStruct(pData->plugins[0].peaks);
+    pData->plugins[0].timings.needsReset = true;
 #endif
 
     plugin->prepareForDeletion();
@@ -1018,29 +1240,44 @@ bool CarlaEngine::removeAllPlugins()
 
     const uint curPluginCount = pData->curPluginCount;
 
+    // the table entries are released once the audio thread stops using them, keep our own references
+    std::vector<CarlaPluginPtr> plugins;
+    plugins.reserve(curPluginCount);
+
+    for (uint i=0; i < curPluginCount; ++i)
+        plugins.push_back(pData->plugins[i].plugin);
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
         pData->graph.removeAllPlugins(pData->aboutToClose);
-#endif
 
-    const ScopedActionLock sal(this, kEnginePostActionZeroCount, 0, 0);
+    {
+        ScopedPluginTableUpdate sptu(this);
+        sptu.removeAllPlugins();
+    }
+#else
+    {
+        const ScopedActionLock sal(this, kEnginePostActionZeroCount, 0, 0);
+    }
+
+    pData->plugins[0].plugin.reset();
+    carla_zeroStruct(pData->plugins[0].peaks);
+    pData->plugins[0].timings.needsReset = true;
+#endif
 
     callback(true, false, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
 
     for (uint i=0; i < curPluginCount; ++i)
     {
         const uint id = curPluginCount - i - 1;
-        EnginePluginData& pluginData(pData->plugins[id]);
+        const CarlaPluginPtr& plugin(plugins[id]);
 
-        pluginData.plugin->prepareForDeletion();
+        plugin->prepareForDeletion();
         {
             const CarlaMutexLocker cml(pData->pluginsToDeleteMutex);
-            pData->pluginsToDelete.push_back(pluginData.plugin);
+            pData->pluginsToDelete.push_back(plugin);
         }
 
-        pluginData.plugin.reset();
-        carla_zeroStruct(pluginData.peaks);
-
         callback(true, true, ENGINE_CALLBACK_PLUGIN_REMOVED, id, 0, 0, 0, 0.0f, nullptr);
         callback(true, false, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
     }
@@ -1167,7 +1404,10 @@ bool CarlaEngine::switchPlugins(const uint idA, const uint idB) noexcept
     if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
         pData->graph.switchPlugins(pluginA, pluginB);
 
-    const ScopedActionLock sal(this, kEnginePostActionSwitchPlugins, idA, idB);
+    {
+        ScopedPluginTableUpdate sptu(this);
+        sptu.switchPlugins(idA, idB);
+    }
 
     // TODO
     /*
@@ -1598,6 +1838,8 @@ const float* CarlaEngine::getPeaks(const uint pluginId) const noexcept
 {
     static const float kFallback[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 
+    pData->setPeaksRead();
+
     if (pluginId == MAIN_CARLA_PLUGIN_ID)
     {
         // get peak from first plugin, if available
@@ -1623,6 +1865,8 @@ const float* CarlaEngine::getPeaks(const uint pluginId) const noexcept
 
 float CarlaEngine::getInputPeak(const uint pluginId, const bool isLeft) const noexcept
 {
+    pData->setPeaksRead();
+
     if (pluginId == MAIN_CARLA_PLUGIN_ID)
     {
         // get peak from first plugin, if available
@@ -1638,6 +1882,8 @@ float CarlaEngine::getInputPeak(const uint pluginId, const bool isLeft) const no
 
 float CarlaEngine::getOutputPeak(const uint pluginId, const bool isLeft) const noexcept
 {
+    pData->setPeaksRead();
+
     if (pluginId == MAIN_CARLA_PLUGIN_ID)
     {
         // get peak from last plugin, if available
@@ -1651,6 +1897,79 @@ float CarlaEngine::getOutputPeak(const uint pluginId, const bool isLeft) const n
     return pData->plugins[pluginId].peaks[isLeft ? 2 : 3];
 }
 
+uint CarlaEngine::getAllPeaks(float* const peaks, const uint maxPlugins) const noexcept
+{
+    const uint count = pData->curPluginCount;
+    CARLA_SAFE_ASSERT_RETURN(peaks != nullptr || maxPlugins == 0, count);
+
+    pData->setPeaksRead();
+
+    for (uint i=0, n=std::min(count, maxPlugins); i < n; ++i)
+        carla_copyFloats(peaks + i*4, pData->plugins[i].peaks, 4);
+
+    return count;
+}
+
+// -----------------------------------------------------------------------
+// Information (snapshots)
+
+uint64_t CarlaEngine::getSnapshotVersion() noexcept
+{
+    EngineSnapshotVersion& snapshot(pData->snapshotVersion);
+    const CarlaMutexLocker cml(snapshot.mutex);
+
+    const uint count = pData->curPluginCount;
+    CARLA_SAFE_ASSERT_RETURN(count <= snapshot.size, snapshot.version);
+
+    bool changed = snapshot.count != count;
+
+    for (uint i=0; i < count; ++i)
+    {
+        const CarlaPluginPtr plugin = pData->plugins[i].plugin;
+        CARLA_SAFE_ASSERT_CONTINUE(plugin.get() != nullptr);
+
+        uint64_t counter = plugin->getChangeCounter();
+
+        if (counter == 0)
+        {
+            plugin->getParameterValuesAndCheckChanges(nullptr, 0);
+            counter = plugin->getChangeCounter();
+        }
+
+        // counters are unique per plugin, so this also catches plugins being replaced or moved
+        if (snapshot.counters[i] != counter)
+        {
+            snapshot.counters[i] = counter;
+            changed = true;
+        }
+    }
+
+    if (changed)
+    {
+        snapshot.count = count;
+        ++snapshot.version;
+    }
+
+    return snapshot.version;
+}
+
+// -----------------------------------------------------------------------
+// Information (timings)
+
+void CarlaEngine::getPluginTimingInfo(const uint pluginId, EnginePluginTimingInfo& info) const noexcept
+{
+    info.clear();
+    CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount,);
+
+    pData->plugins[pluginId].timings.fillInfo(info);
+}
+
+void CarlaEngine::clearPluginTimings() const noexcept
+{
+    for (uint i=0; i < pData->curPluginCount; ++i)
+        pData->plugins[i].timings.needsReset = true;
+}
+
 // -----------------------------------------------------------------------
 // Callback
 
@@ -1672,6 +1991,13 @@ void CarlaEngine::callback(const bool sendHost, const bool sendOSC,
                     static_cast<double>(valuef), valueStr);
 #endif
 
+    // plugins report UIs that were closed or that crashed
+    if (action == ENGINE_CALLBACK_UI_STATE_CHANGED && pluginId < pData->curPluginCount)
+    {
+        if (const CarlaPluginPtr plugin = pData->plugins[pluginId].plugin)
+            plugin->setCustomUIShown(value1 == 1);
+    }
+
     if (sendHost && pData->callback != nullptr)
     {
         if (action == ENGINE_CALLBACK_IDLE)
@@ -1856,6 +2182,64 @@ void CarlaEngine::transportRelocate(const uint64_t frame) noexcept
     pData->time.relocate(frame);
 }
 
+bool CarlaEngine::renderToFile(const char* const filename, const uint64_t startFrame, const uint64_t numFrames)
+{
+    carla_debug("CarlaEngine::renderToFile(\"%s\", " P_UINT64 ", " P_UINT64 ")", filename, startFrame, numFrames);
+
+#ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // unused
+    (void)filename;
+    (void)startFrame;
+    (void)numFrames;
+
+    setLastError("Offline rendering is not supported by the current engine driver");
+    return false;
+#else
+    CARLA_SAFE_ASSERT_RETURN_ERR(isRunning(), "Engine is not running");
+    CARLA_SAFE_ASSERT_RETURN_ERR(! pData->isRendering, "Engine is already rendering");
+    CARLA_SAFE_ASSERT_RETURN_ERR(filename != nullptr && filename[0] != '\0', "Invalid filename");
+    CARLA_SAFE_ASSERT_RETURN_ERR(numFrames > 0, "Invalid number of frames");
+
+    CarlaEngineRenderWriter writer;
+
+    if (! writer.open(filename, 2, pData->bufferSize, pData->sampleRate, numFrames))
+    {
+        setLastError(writer.getError());
+        return false;
+    }
+
+    const bool ok = renderOffline(&writer, filename, startFrame, numFrames);
+
+    // the writer is left open if rendering could not start
+    if (writer.isThreadRunning())
+        writer.close(true);
+
+    return ok;
+#endif
+}
+
+bool CarlaEngine::freezePlugin(const uint id, const uint64_t startFrame, const uint64_t numFrames)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount != 0, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->curPluginCount, "Invalid plugin Id");
+    CARLA_SAFE_ASSERT_RETURN_ERR(numFrames > 0, "Invalid number of frames");
+    carla_debug("CarlaEngine::freezePlugin(%u, " P_UINT64 ", " P_UINT64 ")", id, startFrame, numFrames);
+
+    const CarlaPluginPtr plugin = pData->plugins[id].plugin;
+
+    CARLA_SAFE_ASSERT_RETURN_ERR(plugin.get() != nullptr, "Could not find plugin to freeze");
+    CARLA_SAFE_ASSERT_RETURN_ERR(plugin->getId() == id, "Invalid engine internal data");
+
+    if (! plugin->startFreeze(startFrame, numFrames))
+        return false;
+
+    const bool rendered = renderOffline(nullptr, plugin->getName(), startFrame, numFrames);
+
+    return plugin->finishFreeze(rendered);
+}
+
 // -----------------------------------------------------------------------
 // Error handling
 
@@ -1903,6 +2287,26 @@ bool CarlaEngine::wasActionCanceled() const noexcept
     return pData->actionCanceled;
 }
 
+// -----------------------------------------------------------------------
+// Worker pool
+
+bool CarlaEngine::startWorkerPool()
+{
+    return pData->workerPool.start(pData->threadPlacement);
+}
+
+bool CarlaEngine::runWorkerTasks(const uint32_t numTasks, const EngineWorkerTaskFunc func, void* const ptr) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(func != nullptr, false);
+
+    return pData->workerPool.runTasksRT(numTasks, func, ptr);
+}
+
+bool CarlaEngine::isWorkerThread() const noexcept
+{
+    return pData->workerPool.isWorkerThread();
+}
+
 // -----------------------------------------------------------------------
 // Global options
 
@@ -1916,6 +2320,9 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
         {
         case ENGINE_OPTION_PROCESS_MODE:
         case ENGINE_OPTION_AUDIO_TRIPLE_BUFFER:
+        case ENGINE_OPTION_AUDIO_DOUBLE_PRECISION:
+        case ENGINE_OPTION_THREAD_CPU_SET:
+        case ENGINE_OPTION_THREAD_PRIORITY:
         case ENGINE_OPTION_AUDIO_DRIVER:
         case ENGINE_OPTION_AUDIO_DEVICE:
             return carla_stderr("CarlaEngine::setOption(%i:%s, %i, \"%s\") - Cannot set this option while engine is running!",
@@ -1999,6 +2406,11 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
         pData->options.uiBridgesTimeout = static_cast<uint>(value);
         break;
 
+    case ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 1000,);
+        pData->options.bridgeSpinWaitTime = static_cast<uint>(value);
+        break;
+
     case ENGINE_OPTION_AUDIO_BUFFER_SIZE:
         CARLA_SAFE_ASSERT_RETURN(value >= 8,);
         pData->options.audioBufferSize = static_cast<uint>(value);
@@ -2276,6 +2688,39 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
         CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
         pData->options.pluginsAreStandalone = (value != 0);
         break;
+
+    case ENGINE_OPTION_AUDIO_DOUBLE_PRECISION:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.audioDoublePrecision = (value != 0);
+        break;
+
+    case ENGINE_OPTION_THREAD_CPU_SET: {
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value < ENGINE_THREAD_CLASS_COUNT,);
+
+        CarlaEngineThreadPlacement::CpuSet cpuSet;
+
+        if (valueStr != nullptr && valueStr[0] != '\0')
+        {
+            CARLA_SAFE_ASSERT_RETURN(CarlaEngineThreadPlacement::parseCpuSet(valueStr, cpuSet),);
+        }
+
+        if (pData->options.threadCpuSets[value] != nullptr)
+            delete[] pData->options.threadCpuSets[value];
+
+        pData->options.threadCpuSets[value] = valueStr != nullptr && valueStr[0] != '\0'
+                                            ? carla_strdup_safe(valueStr)
+                                            : nullptr;
+    }   break;
+
+    case ENGINE_OPTION_THREAD_PRIORITY: {
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value < ENGINE_THREAD_CLASS_COUNT,);
+        CARLA_SAFE_ASSERT_RETURN(valueStr != nullptr,);
+
+        const int priority = std::atoi(valueStr);
+        CARLA_SAFE_ASSERT_RETURN(priority >= -1 && priority <= 99,);
+
+        pData->options.threadPriorities[value] = priority;
+    }   break;
     }
 }
 
@@ -2402,6 +2847,196 @@ void CarlaEngine::setPluginPeaksRT(const uint pluginId, float const inPeaks[2],
     pluginData.peaks[3] = outPeaks[1];
 }
 
+void CarlaEngine::addPluginTimingRT(const uint pluginId, const uint64_t timeNs) noexcept
+{
+    pData->plugins[pluginId].timings.addRT(timeNs);
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // plugins run on their own threads in multi-client mode, outside of the engine cycle
+    if (pData->options.processMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS)
+        pData->cycleStats.addPluginTimeRT(pluginId, timeNs);
+#endif
+}
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+static void renderProgressCallback(CarlaEngine* const engine,
+                                   const char* const name,
+                                   const uint64_t framesDone,
+                                   const uint64_t numFrames,
+                                   const int64_t elapsedUs) noexcept
+{
+    const int percent = static_cast<int>(framesDone * 100 / numFrames);
+    const float speed = elapsedUs > 0
+                      ? static_cast<float>(static_cast<double>(framesDone) / engine->getSampleRate() * 1000000.0 / elapsedUs)
+                      : 0.0f;
+
+    engine->callback(true, true, ENGINE_CALLBACK_RENDER_PROGRESS, 0, percent, 0, 0, speed, name);
+}
+#endif
+
+bool CarlaEngine::renderOffline(CarlaEngineRenderWriter* const writer, const char* const name,
+                                const uint64_t startFrame, const uint64_t numFrames)
+{
+    carla_debug("CarlaEngine::renderOffline(%p, \"%s\", " P_UINT64 ", " P_UINT64 ")", writer, name, startFrame, numFrames);
+
+#ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // unused
+    (void)writer;
+    (void)name;
+    (void)startFrame;
+    (void)numFrames;
+
+    setLastError("Offline rendering is not supported by the current engine driver");
+    return false;
+#else
+    CARLA_SAFE_ASSERT_RETURN_ERR(isRunning(), "Engine is not running");
+    CARLA_SAFE_ASSERT_RETURN_ERR(! pData->isRendering, "Engine is already rendering");
+    CARLA_SAFE_ASSERT_RETURN_ERR(numFrames > 0, "Invalid number of frames");
+
+    if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK &&
+        pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
+    {
+        setLastError("Offline rendering needs the rack or patchbay processing mode");
+        return false;
+    }
+
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->graph.isReady(), "Engine graph is not ready");
+
+    const bool isRack = pData->graph.isRack();
+    const uint32_t bufferSize = pData->bufferSize;
+    const uint32_t numIns  = isRack ? 2 : pData->graph.getNumInputBuffers();
+    const uint32_t numOuts = isRack ? 2 : pData->graph.getNumOutputBuffers();
+
+    float** const audioIns  = new float*[numIns];
+    float** const audioOuts = new float*[numOuts];
+
+    for (uint32_t i=0; i < numIns; ++i)
+    {
+        audioIns[i] = new float[bufferSize];
+        carla_zeroFloats(audioIns[i], bufferSize);
+    }
+
+    for (uint32_t i=0; i < numOuts; ++i)
+        audioOuts[i] = new float[bufferSize];
+
+    // the driver audio callback outputs silence from now on, the graph runs on this thread instead
+    const CarlaMutexLocker cml(pData->renderMutex);
+
+    // external transport does not follow offline rendering
+    const EngineTransportMode oldTransportMode = pData->options.transportMode;
+    const bool oldPlaying = pData->timeInfo.playing;
+    const uint64_t oldFrame = pData->timeInfo.frame;
+    pData->options.transportMode = ENGINE_TRANSPORT_MODE_INTERNAL;
+
+    pData->isRendering = true;
+    offlineModeChanged(true);
+
+    pData->actionCanceled = false;
+    callback(true, true, ENGINE_CALLBACK_CANCELABLE_ACTION, 0, 1, 0, 0, 0.0f, "Rendering");
+
+    carla_zeroStructs(pData->events.in, kMaxEngineEventInternalCount);
+    CarlaEngine::transportRelocate(startFrame);
+    CarlaEngine::transportPlay();
+
+    const int64_t startTime = carla_gettime_us();
+    int64_t lastProgressTime = startTime;
+    uint64_t framesDone = 0;
+    bool ok = true;
+
+    while (framesDone < numFrames)
+    {
+        if (pData->actionCanceled || pData->aboutToClose)
+        {
+            setLastError("Rendering was canceled");
+            ok = false;
+            break;
+        }
+
+        float* const* const writerOuts = writer != nullptr ? writer->getNextBlock() : nullptr;
+
+        if (writer != nullptr && writerOuts == nullptr)
+        {
+            setLastError(writer->getError());
+            ok = false;
+            break;
+        }
+
+        {
+            const PendingRtEventsRunner prt(this, bufferSize, true);
+
+            for (uint32_t i=0; i < numOuts; ++i)
+                carla_zeroFloats(audioOuts[i], bufferSize);
+
+            carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+
+            if (isRack)
+                pData->graph.processRack(pData, const_cast<const float**>(audioIns), audioOuts, bufferSize);
+            else
+                pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+        }
+
+        // the last block is processed in full, but only the requested frames are written
+        const uint32_t frames = static_cast<uint32_t>(std::min<uint64_t>(bufferSize, numFrames - framesDone));
+
+        if (writer != nullptr)
+        {
+            for (uint32_t i=0; i < 2; ++i)
+            {
+                if (i < numOuts)
+                    carla_copyFloats(writerOuts[i], audioOuts[i], bufferSize);
+                else
+                    carla_zeroFloats(writerOuts[i], bufferSize);
+            }
+
+            writer->commitBlock(frames);
+        }
+
+        framesDone += frames;
+
+        const int64_t now = carla_gettime_us();
+
+        if (now - lastProgressTime >= 250000)
+        {
+            lastProgressTime = now;
+            renderProgressCallback(this, name, framesDone, numFrames, now - startTime);
+        }
+    }
+
+    if (writer != nullptr && ! writer->close(! ok) && ok)
+    {
+        setLastError(writer->getError());
+        ok = false;
+    }
+
+    if (ok)
+        renderProgressCallback(this, name, framesDone, numFrames, carla_gettime_us() - startTime);
+
+    callback(true, true, ENGINE_CALLBACK_CANCELABLE_ACTION, 0, 0, 0, 0, 0.0f, "Rendering");
+
+    // put transport back where it was before rendering
+    CarlaEngine::transportPause();
+    CarlaEngine::transportRelocate(oldFrame);
+
+    if (oldPlaying)
+        CarlaEngine::transportPlay();
+
+    pData->options.transportMode = oldTransportMode;
+
+    pData->isRendering = false;
+    offlineModeChanged(false);
+
+    for (uint32_t i=0; i < numIns; ++i)
+        delete[] audioIns[i];
+    for (uint32_t i=0; i < numOuts; ++i)
+        delete[] audioOuts[i];
+
+    delete[] audioIns;
+    delete[] audioOuts;
+
+    return ok;
+#endif
+}
+
 void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) const
 {
     // send initial prepareForSave first, giving time for bridges to act
@@ -3004,7 +3639,11 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
                         plugin->setActive(stateSave.active, true, true);
                         plugin->setEnabled(true);
 
-                        ++pData->curPluginCount;
+                        {
+                            ScopedPluginTableUpdate sptu(this);
+                            sptu.addPlugin(plugin);
+                        }
+
                         callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, plugin->getType(),
                                  0, 0, 0.0f,
                                  plugin->getName());
@@ -3059,7 +3698,11 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
                         plugin->setActive(stateSave.active, true, true);
                         plugin->setEnabled(true);
 
-                        ++pData->curPluginCount;
+                        {
+                            ScopedPluginTableUpdate sptu(this);
+                            sptu.addPlugin(plugin);
+                        }
+
                         callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, plugin->getType(),
                                  0, 0, 0.0f,
                                  plugin->getName());
@@ -3213,7 +3856,14 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
                      */
                     plugin->setEnabled(true);
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+                    {
+                        ScopedPluginTableUpdate sptu(this);
+                        sptu.addPlugin(plugin);
+                    }
+#else
                     ++pData->curPluginCount;
+#endif
                     callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, plugin->getType(),
                              0, 0, 0.0f,
                              plugin->getName());
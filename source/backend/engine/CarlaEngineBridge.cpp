@@ -140,6 +140,9 @@ public:
           fShmRtClientControl(),
           fShmNonRtClientControl(),
           fShmNonRtServerControl(),
+          fShmClientChunkPool(true),
+          fShmServerChunkPool(false),
+          fShmParameterPool(),
           fBaseNameAudioPool(audioPoolBaseName),
           fBaseNameRtClientControl(rtClientBaseName),
           fBaseNameNonRtClientControl(nonRtClientBaseName),
@@ -148,7 +151,9 @@ public:
           fIsOffline(false),
           fFirstIdle(true),
           fBridgeVersion(0),
-          fLastPingTime(-1)
+          fLastPingTime(-1),
+          fServerChunkPoolSize(0),
+          fServerChunkPoolRequested(false)
     {
         carla_debug("CarlaEngineBridge::CarlaEngineBridge(\"%s\", \"%s\", \"%s\", \"%s\")", audioPoolBaseName, rtClientBaseName, nonRtClientBaseName, nonRtServerBaseName);
     }
@@ -173,6 +178,9 @@ public:
             return false;
         }
 
+        // before starting any threads, so they inherit it
+        pData->threadPlacement.applyToProcess(ENGINE_THREAD_BRIDGE);
+
         if (! fShmAudioPool.attachClient(fBaseNameAudioPool))
         {
             pData->close();
@@ -196,6 +204,8 @@ public:
             return false;
         }
 
+        fShmRtClientControl.setSpinWaitTime(pData->options.bridgeSpinWaitTime);
+
         if (! fShmNonRtClientControl.attachClient(fBaseNameNonRtClientControl))
         {
             pData->close();
@@ -236,6 +246,8 @@ public:
         const uint32_t apiVersion = fShmNonRtClientControl.readUInt();
         CARLA_SAFE_ASSERT_RETURN(apiVersion >= CARLA_PLUGIN_BRIDGE_API_VERSION_MINIMUM, false);
 
+        fBridgeVersion = apiVersion;
+
         const uint32_t shmRtClientDataSize = fShmNonRtClientControl.readUInt();
         CARLA_SAFE_ASSERT_INT2(shmRtClientDataSize == sizeof(BridgeRtClientData), shmRtClientDataSize, sizeof(BridgeRtClientData));
 
@@ -271,6 +283,25 @@ public:
 
         pData->initTime(nullptr);
 
+        // chunk pools were added in API 11, chunks are sent through temporary files without them
+        if (apiVersion >= 11)
+        {
+            if (! fShmClientChunkPool.attachClient(fBaseNameAudioPool) ||
+                ! fShmServerChunkPool.attachClient(fBaseNameAudioPool))
+            {
+                carla_stderr("Failed to attach to shared memory chunk pools");
+                fShmClientChunkPool.clear();
+                fShmServerChunkPool.clear();
+            }
+        }
+
+        // parameter pool was added in API 12, the server checks if we managed to map it
+        if (apiVersion >= 12 && ! fShmParameterPool.attachClient(fBaseNameAudioPool))
+        {
+            carla_stderr("Failed to attach to shared memory parameter pool");
+            fShmParameterPool.clear();
+        }
+
         // tell backend we're live
         {
             const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
@@ -661,8 +692,8 @@ public:
             fLastPingTime = carla_gettime_ms();
         }
 
-        // send parameter outputs
-        if (const uint32_t count = plugin->getParameterCount())
+        // send parameter outputs, unless they go through the parameter pool
+        if (const uint32_t count = fShmParameterPool.count == 0 ? plugin->getParameterCount() : 0)
         {
             const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
 
@@ -802,6 +833,9 @@ public:
 
     void clear() noexcept
     {
+        fShmParameterPool.clear();
+        fShmServerChunkPool.clear();
+        fShmClientChunkPool.clear();
         fShmAudioPool.clear();
         fShmRtClientControl.clear();
         fShmNonRtClientControl.clear();
@@ -1007,6 +1041,29 @@ public:
                 break;
             }
 
+            case kPluginBridgeNonRtClientSetChunkDataShm: {
+                const std::size_t size = static_cast<std::size_t>(fShmNonRtClientControl.readULong());
+
+                if (size != 0 && fShmClientChunkPool.map(size))
+                {
+                    if (plugin->isEnabled())
+                        plugin->setChunkData(fShmClientChunkPool.data, size);
+
+                    fShmClientChunkPool.unmap();
+                }
+
+                // always reply, so the server can reuse the pool
+                const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+
+                fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerChunkDataReceived);
+                fShmNonRtServerControl.commitWrite();
+                break;
+            }
+
+            case kPluginBridgeNonRtClientSetServerChunkPoolSize:
+                fServerChunkPoolSize = fShmNonRtClientControl.readULong();
+                break;
+
             case kPluginBridgeNonRtClientSetCtrlChannel: {
                 const int16_t channel(fShmNonRtClientControl.readShort());
                 CARLA_SAFE_ASSERT_BREAK(channel >= -1 && channel < MAX_MIDI_CHANNELS);
@@ -1086,6 +1143,29 @@ public:
 
                 plugin->prepareForSave(false);
 
+                void* chunkData = nullptr;
+                std::size_t chunkSize = 0;
+
+                if (plugin->getOptionsEnabled() & PLUGIN_OPTION_USE_CHUNKS)
+                    chunkSize = plugin->getChunkData(&chunkData);
+
+                // raw chunk data goes through shared memory, the server grows its pool and asks again if needed
+                const bool useChunkPool = chunkSize != 0 && fBridgeVersion >= 11 && fShmServerChunkPool.filename.isNotEmpty();
+
+                if (useChunkPool && chunkSize > fServerChunkPoolSize && ! fServerChunkPoolRequested)
+                {
+                    fServerChunkPoolRequested = true;
+
+                    const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+
+                    fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerResizeChunkPool);
+                    fShmNonRtServerControl.writeULong(static_cast<uint64_t>(chunkSize));
+                    fShmNonRtServerControl.commitWrite();
+                    break;
+                }
+
+                fServerChunkPoolRequested = false;
+
                 const uint32_t maxLocalValueLen = fBridgeVersion >= 10 ? 4096 : 16384;
 
                 for (uint32_t i=0, count=plugin->getCustomDataCount(); i<count; ++i)
@@ -1147,14 +1227,24 @@ public:
                     }
                 }
 
-                if (plugin->getOptionsEnabled() & PLUGIN_OPTION_USE_CHUNKS)
+                if (chunkSize != 0)
                 {
-                    void* data = nullptr;
-                    if (const std::size_t dataSize = plugin->getChunkData(&data))
+                    CARLA_SAFE_ASSERT_BREAK(chunkData != nullptr);
+
+                    if (useChunkPool && chunkSize <= fServerChunkPoolSize && fShmServerChunkPool.map(chunkSize))
                     {
-                        CARLA_SAFE_ASSERT_BREAK(data != nullptr);
+                        std::memcpy(fShmServerChunkPool.data, chunkData, chunkSize);
+                        fShmServerChunkPool.unmap();
+
+                        const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
 
-                        CarlaString dataBase64 = CarlaString::asBase64(data, dataSize);
+                        fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerSetChunkDataShm);
+                        fShmNonRtServerControl.writeULong(static_cast<uint64_t>(chunkSize));
+                        fShmNonRtServerControl.commitWrite();
+                    }
+                    else
+                    {
+                        CarlaString dataBase64 = CarlaString::asBase64(chunkData, chunkSize);
                         CARLA_SAFE_ASSERT_BREAK(dataBase64.length() > 0);
 
                         String filePath(File::getSpecialLocation(File::tempDirectory).getFullPathName());
@@ -1192,12 +1282,18 @@ public:
 
             case kPluginBridgeNonRtClientShowUI:
                 if (plugin->isEnabled())
+                {
+                    plugin->setCustomUIShown(true);
                     plugin->showCustomUI(true);
+                }
                 break;
 
             case kPluginBridgeNonRtClientHideUI:
                 if (plugin->isEnabled())
+                {
+                    plugin->setCustomUIShown(false);
                     plugin->showCustomUI(false);
+                }
                 break;
 
             case kPluginBridgeNonRtClientEmbedUI: {
@@ -1285,6 +1381,8 @@ protected:
         _mm_setcsr(_mm_getcsr() | 0x8040);
 #endif
 
+        pData->threadPlacement.applyToCurrentThread(ENGINE_THREAD_AUDIO);
+
         bool quitReceived = false;
 
         for (; ! shouldThreadExit();)
@@ -1491,6 +1589,20 @@ protected:
 
                     if (plugin.get() != nullptr && plugin->isEnabled() && plugin->tryLock(fIsOffline))
                     {
+                        // apply the latest parameter values from the server, with the plugin lock held
+                        if (fShmParameterPool.hasChanges())
+                        {
+                            const uint32_t paramCount = plugin->getParameterCount();
+                            uint32_t index;
+                            float value;
+
+                            while (fShmParameterPool.readNextValue(index, value))
+                            {
+                                if (index < paramCount)
+                                    plugin->setParameterValueRT(index, value, 0, true);
+                            }
+                        }
+
                         const BridgeTimeInfo& bridgeTimeInfo(fShmRtClientControl.data->timeInfo);
 
                         const uint32_t audioInCount = plugin->getAudioInCount();
@@ -1539,6 +1651,16 @@ protected:
                         plugin->initBuffers();
                         plugin->process(audioIn, audioOut, cvIn, cvOut, frames);
                         plugin->unlock();
+
+                        // send parameter outputs, the server reads them once this cycle is done
+                        if (fShmParameterPool.count != 0)
+                        {
+                            for (uint32_t i=0, count = std::min(fShmParameterPool.count, plugin->getParameterCount()); i < count; ++i)
+                            {
+                                if (plugin->isParameterOutput(i))
+                                    fShmParameterPool.writeValue(i, plugin->getParameterValue(i), true);
+                            }
+                        }
                     }
 
                     uint8_t* midiData(fShmRtClientControl.data->midiOut);
@@ -1626,6 +1748,12 @@ protected:
 
                 }   break;
 
+                case kPluginBridgeRtClientSetParameterPool: {
+                    const uint32_t count(fShmRtClientControl.readUInt());
+                    fShmParameterPool.map(count);
+                    break;
+                }
+
                 case kPluginBridgeRtClientQuit: {
                     quitReceived = true;
                     fClosingDown = true;
@@ -1679,6 +1807,9 @@ private:
     BridgeRtClientControl    fShmRtClientControl;
     BridgeNonRtClientControl fShmNonRtClientControl;
     BridgeNonRtServerControl fShmNonRtServerControl;
+    BridgeChunkPool          fShmClientChunkPool;
+    BridgeChunkPool          fShmServerChunkPool;
+    BridgeParameterPool      fShmParameterPool;
 
     CarlaString fBaseNameAudioPool;
     CarlaString fBaseNameRtClientControl;
@@ -1691,6 +1822,10 @@ private:
     uint32_t fBridgeVersion;
     int64_t fLastPingTime;
 
+    // capacity of the server chunk pool, and if a bigger pool was asked for during the current save
+    uint64_t fServerChunkPoolSize;
+    bool fServerChunkPoolRequested;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineBridge)
 };
 
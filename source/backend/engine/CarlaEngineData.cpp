@@ -215,9 +215,11 @@ EngineOptions::EngineOptions() noexcept
       uiScale(1.0f),
       maxParameters(MAX_DEFAULT_PARAMETERS),
       uiBridgesTimeout(4000),
+      bridgeSpinWaitTime(0),
       audioBufferSize(512),
       audioSampleRate(44100),
       audioTripleBuffer(false),
+      audioDoublePrecision(false),
       audioDriver(nullptr),
       audioDevice(nullptr),
 #ifndef BUILD_BRIDGE
@@ -244,11 +246,15 @@ EngineOptions::EngineOptions() noexcept
       resourceDir(nullptr),
       clientNamePrefix(nullptr),
       preventBadBehaviour(false),
-      frontendWinId(0)
+      frontendWinId(0),
+      threadCpuSets(),
+      threadPriorities()
 #ifndef CARLA_OS_WIN
       , wine()
 #endif
 {
+    for (uint i=0; i < ENGINE_THREAD_CLASS_COUNT; ++i)
+        threadPriorities[i] = -1;
 }
 
 EngineOptions::~EngineOptions() noexcept
@@ -333,6 +339,15 @@ EngineOptions::~EngineOptions() noexcept
         delete[] clientNamePrefix;
         clientNamePrefix = nullptr;
     }
+
+    for (uint i=0; i < ENGINE_THREAD_CLASS_COUNT; ++i)
+    {
+        if (threadCpuSets[i] != nullptr)
+        {
+            delete[] threadCpuSets[i];
+            threadCpuSets[i] = nullptr;
+        }
+    }
 }
 
 #ifndef CARLA_OS_WIN
@@ -491,6 +506,27 @@ bool EngineTimeInfo::operator!=(const EngineTimeInfo& timeInfo) const noexcept
     return !operator==(timeInfo);
 }
 
+// -----------------------------------------------------------------------
+// EnginePluginTimingInfo
+
+EnginePluginTimingInfo::EnginePluginTimingInfo() noexcept
+    : cycles(0),
+      min(0.0f),
+      avg(0.0f),
+      max(0.0f),
+      p95(0.0f),
+      p99(0.0f) {}
+
+void EnginePluginTimingInfo::clear() noexcept
+{
+    cycles = 0;
+    min = 0.0f;
+    avg = 0.0f;
+    max = 0.0f;
+    p95 = 0.0f;
+    p99 = 0.0f;
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
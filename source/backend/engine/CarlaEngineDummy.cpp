@@ -25,6 +25,10 @@ CARLA_BACKEND_START_NAMESPACE
 // -------------------------------------------------------------------------------------------------------------------
 // Dummy Engine
 
+// Special device name for running the audio thread as fast as possible, without waiting between cycles.
+// Can be followed by ":N" for injecting N MIDI events on each cycle, used for benchmarking.
+static const char* const kDummyFreeRunningDeviceName = "Free-running";
+
 class CarlaEngineDummy : public CarlaEngine,
                          public CarlaThread
 {
@@ -32,7 +36,9 @@ public:
     CarlaEngineDummy()
         : CarlaEngine(),
           CarlaThread("CarlaEngineDummy"),
-          fRunning(false)
+          fRunning(false),
+          fFreeRunning(false),
+          fMidiEventsPerCycle(0)
     {
         carla_debug("CarlaEngineDummy::CarlaEngineDummy()");
 
@@ -52,13 +58,34 @@ public:
         CARLA_SAFE_ASSERT_RETURN(clientName != nullptr && clientName[0] != '\0', false);
         carla_debug("CarlaEngineDummy::init(\"%s\")", clientName);
 
-        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK &&
+            pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
         {
             setLastError("Invalid process mode");
             return false;
         }
 
         fRunning = true;
+        fFreeRunning = false;
+        fMidiEventsPerCycle = 0;
+
+        if (const char* const deviceName = pData->options.audioDevice)
+        {
+            const std::size_t nameLen = std::strlen(kDummyFreeRunningDeviceName);
+
+            if (std::strncmp(deviceName, kDummyFreeRunningDeviceName, nameLen) == 0)
+            {
+                fFreeRunning = true;
+
+                if (deviceName[nameLen] == ':')
+                {
+                    const int numEvents = std::atoi(deviceName + nameLen + 1);
+
+                    if (numEvents > 0)
+                        fMidiEventsPerCycle = std::min(static_cast<uint>(numEvents), static_cast<uint>(kMaxEngineEventInternalCount));
+                }
+            }
+        }
 
         if (! pData->init(clientName))
         {
@@ -117,7 +144,7 @@ public:
 
     bool isOffline() const noexcept override
     {
-        return false;
+        return pData->isRendering;
     }
 
     EngineType getType() const noexcept override
@@ -133,10 +160,21 @@ public:
     // -------------------------------------------------------------------
     // Patchbay
 
-    bool patchbayRefresh(const bool sendHost, const bool sendOSC, const bool) override
+    bool patchbayRefresh(const bool sendHost, const bool sendOSC, const bool external) override
     {
         CARLA_SAFE_ASSERT_RETURN(pData->graph.isReady(), false);
 
+        // no external ports to show in patchbay mode
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+        {
+            if (sendHost)
+                pData->graph.setUsingExternalHost(external);
+            if (sendOSC)
+                pData->graph.setUsingExternalOSC(external);
+
+            return CarlaEngine::patchbayRefresh(sendHost, sendOSC, false);
+        }
+
         RackGraph* const graph = pData->graph.getRackGraph();
         CARLA_SAFE_ASSERT_RETURN(graph != nullptr, false);
 
@@ -190,6 +228,22 @@ public:
     // -------------------------------------------------------------------
 
 protected:
+    bool renderOffline(CarlaEngineRenderWriter* const writer, const char* const name,
+                       const uint64_t startFrame, const uint64_t numFrames) override
+    {
+        CARLA_SAFE_ASSERT_RETURN_ERR(! pData->isRendering, "Engine is already rendering");
+
+        // the graph is processed from the calling thread while rendering
+        stopThread(-1);
+
+        const bool ok = CarlaEngine::renderOffline(writer, name, startFrame, numFrames);
+
+        if (! startThread())
+            carla_stderr2("CarlaEngineDummy::renderOffline() - failed to restart dummy audio thread");
+
+        return ok;
+    }
+
     void run() override
     {
         const uint32_t bufferSize = pData->bufferSize;
@@ -201,8 +255,12 @@ protected:
             if ((delay = atoi(delaystr)) == 1)
                 delay = 0;
 
-        carla_stdout("CarlaEngineDummy audio thread started, cycle time: " P_INT64 "ms, delay %ds",
-                     cycleTime / 1000, delay);
+        if (fFreeRunning)
+            carla_stdout("CarlaEngineDummy audio thread started, free-running with %u MIDI events per cycle",
+                         fMidiEventsPerCycle);
+        else
+            carla_stdout("CarlaEngineDummy audio thread started, cycle time: " P_INT64 "ms, delay %ds",
+                         cycleTime / 1000, delay);
 
         float* audioIns[2] = {
             (float*)std::malloc(sizeof(float)*bufferSize),
@@ -231,13 +289,22 @@ protected:
 
             oldTime = carla_gettime_us();
 
-            const PendingRtEventsRunner prt(this, bufferSize, true);
+            // keep the cycle scope out of the sleep below, so timing stats and DSP load stay meaningful
+            {
+                const PendingRtEventsRunner prt(this, bufferSize, true);
+
+                carla_zeroFloats(audioOuts[0], bufferSize);
+                carla_zeroFloats(audioOuts[1], bufferSize);
+                carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
 
-            carla_zeroFloats(audioOuts[0], bufferSize);
-            carla_zeroFloats(audioOuts[1], bufferSize);
-            carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+                if (fMidiEventsPerCycle != 0)
+                    fillMidiEvents(bufferSize);
+
+                pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+            }
 
-            pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+            if (fFreeRunning)
+                continue;
 
             newTime = carla_gettime_us();
             CARLA_SAFE_ASSERT_CONTINUE(newTime >= oldTime);
@@ -269,6 +336,26 @@ protected:
 
 private:
     bool fRunning;
+    bool fFreeRunning;
+    uint fMidiEventsPerCycle;
+
+    // alternating note-on and note-off pairs, evenly spread over the cycle
+    void fillMidiEvents(const uint32_t bufferSize) noexcept
+    {
+        uint8_t midiData[3] = { 0, 0, 0 };
+
+        for (uint i=0; i < fMidiEventsPerCycle; ++i)
+        {
+            EngineEvent& event(pData->events.in[i]);
+
+            midiData[0] = (i % 2) == 0 ? MIDI_STATUS_NOTE_ON : MIDI_STATUS_NOTE_OFF;
+            midiData[1] = static_cast<uint8_t>(36 + (i / 2) % 64);
+            midiData[2] = (i % 2) == 0 ? 100 : 0;
+
+            event.time = static_cast<uint32_t>(static_cast<uint64_t>(i) * bufferSize / fMidiEventsPerCycle);
+            event.fillFromMidiData(3, midiData, 0);
+        }
+    }
 
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineDummy)
 };
@@ -21,6 +21,7 @@
 
 #include "CarlaMathUtils.hpp"
 #include "CarlaScopeUtils.hpp"
+#include "CarlaTimeUtils.hpp"
 
 #include "CarlaMIDI.h"
 
@@ -750,13 +751,16 @@ RackGraph::Buffers::Buffers() noexcept
       inBufTmp{nullptr, nullptr},
       outBuf{nullptr, nullptr},
 #endif
-      unusedBuf(nullptr)
+      unusedBuf(nullptr),
+      publishedRouting(0),
+      activeRouting(-1)
     {
 #ifndef CARLA_PROPER_CPP11_SUPPORT
         inBuf[0]    = inBuf[1]    = nullptr;
         inBufTmp[0] = inBufTmp[1] = nullptr;
         outBuf[0]   = outBuf[1]   = nullptr;
 #endif
+        carla_zeroStructs(routing, 2);
     }
 
 RackGraph::Buffers::~Buffers() noexcept
@@ -775,6 +779,12 @@ RackGraph::Buffers::~Buffers() noexcept
     connectedIn2.clear();
     connectedOut1.clear();
     connectedOut2.clear();
+
+    for (int i = 0; i < 2; ++i)
+    {
+        delete[] routing[i].ports;
+        routing[i].ports = nullptr;
+    }
 }
 
 void RackGraph::Buffers::setBufferSize(const uint32_t bufferSize, const bool createBuffers) noexcept
@@ -831,6 +841,89 @@ void RackGraph::Buffers::setBufferSize(const uint32_t bufferSize, const bool cre
     }
 }
 
+static uint32_t copyRoutingPorts(const LinkedList<uint>& list, const uint32_t numPorts, uint32_t* const ports) noexcept
+{
+    uint32_t count = 0;
+
+    for (LinkedList<uint>::Itenerator it = list.begin2(); it.valid(); it.next())
+    {
+        const uint& port(it.getValue(0));
+        CARLA_SAFE_ASSERT_CONTINUE(port > 0);
+        CARLA_SAFE_ASSERT_CONTINUE(port <= numPorts);
+
+        ports[count++] = port - 1;
+    }
+
+    return count;
+}
+
+void RackGraph::Buffers::updateRouting(const uint32_t inputs, const uint32_t outputs) noexcept
+{
+    const int index = 1 - publishedRouting.get();
+
+    // the audio thread might still be using this table, if it started its cycle before the last update
+    while (activeRouting.get() == index)
+        carla_msleep(1);
+
+    Routing& table(routing[index]);
+
+    const uint32_t total = static_cast<uint32_t>(connectedIn1.count() + connectedIn2.count()
+                                                 + connectedOut1.count() + connectedOut2.count());
+
+    if (table.capacity < total)
+    {
+        uint32_t* ports;
+
+        try {
+            ports = new uint32_t[total];
+        } CARLA_SAFE_EXCEPTION_RETURN("RackGraph::Buffers::updateRouting",);
+
+        delete[] table.ports;
+        table.ports = ports;
+        table.capacity = total;
+    }
+
+    uint32_t* ports = table.ports;
+
+    table.counts[kRoutingIn1] = copyRoutingPorts(connectedIn1, inputs, ports);
+    ports += table.counts[kRoutingIn1];
+
+    table.counts[kRoutingIn2] = copyRoutingPorts(connectedIn2, inputs, ports);
+    ports += table.counts[kRoutingIn2];
+
+    table.counts[kRoutingOut1] = copyRoutingPorts(connectedOut1, outputs, ports);
+    ports += table.counts[kRoutingOut1];
+
+    table.counts[kRoutingOut2] = copyRoutingPorts(connectedOut2, outputs, ports);
+
+    publishedRouting.set(index);
+}
+
+const RackGraph::Buffers::Routing& RackGraph::Buffers::acquireRouting() noexcept
+{
+    int index = publishedRouting.get();
+
+    // mark the table as in use, then make sure it was not replaced meanwhile
+    for (;;)
+    {
+        activeRouting.set(index);
+
+        const int latest = publishedRouting.get();
+
+        if (latest == index)
+            break;
+
+        index = latest;
+    }
+
+    return routing[index];
+}
+
+void RackGraph::Buffers::releaseRouting() noexcept
+{
+    activeRouting.set(-1);
+}
+
 // -----------------------------------------------------------------------
 // RackGraph
 
@@ -1072,11 +1165,25 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
                 outBuf[j] = dummyBuf;
         }
 
-        // process
-        plugin->initBuffers();
-        plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
+        // process, sleeping plugins keep the zeroed outputs and frozen plugins play from their cache
+        const uint64_t startTime = carla_gettime_ns();
+
+        if (! plugin->isFrozenRT(inBuf, outBuf, frames))
+        {
+            if (! plugin->isSleepingRT(inBuf, frames))
+            {
+                plugin->initBuffers();
+                plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
+                plugin->updateSleepStateRT(outBuf, frames);
+            }
+
+            plugin->recordFreezeRT(outBuf, frames);
+        }
+
         plugin->unlock();
 
+        kEngine->addPluginTimingRT(i, carla_gettime_ns() - startTime);
+
         // if plugin has no audio inputs, add input buffer
         if (oldAudioInCount == 0)
         {
@@ -1121,58 +1228,36 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     }
 }
 
-void RackGraph::processHelper(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
+static void mixRoutedChannels(float* const dst, const float* const* const src,
+                              const uint32_t* const ports, const uint32_t count, const uint32_t frames) noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(audioBuffers.outBuf[1] != nullptr,);
-
-    const CarlaRecursiveMutexLocker _cml(audioBuffers.mutex);
-
-    if (inBuf != nullptr && inputs > 0)
+    if (count == 0)
     {
-        bool noConnections = true;
-
-        // connect input buffers
-        for (LinkedList<uint>::Itenerator it = audioBuffers.connectedIn1.begin2(); it.valid(); it.next())
-        {
-            const uint& port(it.getValue(0));
-            CARLA_SAFE_ASSERT_CONTINUE(port > 0);
-            CARLA_SAFE_ASSERT_CONTINUE(port <= inputs);
-
-            if (noConnections)
-            {
-                carla_copyFloats(audioBuffers.inBuf[0], inBuf[port], frames);
-                noConnections = false;
-            }
-            else
-            {
-                carla_addFloats(audioBuffers.inBuf[0], inBuf[port], frames);
-            }
-        }
+        carla_zeroFloats(dst, frames);
+        return;
+    }
 
-        if (noConnections)
-            carla_zeroFloats(audioBuffers.inBuf[0], frames);
+    carla_copyFloats(dst, src[ports[0]], frames);
 
-        noConnections = true;
+    for (uint32_t i = 1; i < count; ++i)
+        carla_addFloats(dst, src[ports[i]], frames);
+}
 
-        for (LinkedList<uint>::Itenerator it = audioBuffers.connectedIn2.begin2(); it.valid(); it.next())
-        {
-            const uint& port(it.getValue(0));
-            CARLA_SAFE_ASSERT_CONTINUE(port > 0);
-            CARLA_SAFE_ASSERT_CONTINUE(port <= inputs);
+void RackGraph::processHelper(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
+{
+    CARLA_SAFE_ASSERT_RETURN(audioBuffers.outBuf[1] != nullptr,);
 
-            if (noConnections)
-            {
-                carla_copyFloats(audioBuffers.inBuf[1], inBuf[port-1], frames);
-                noConnections = false;
-            }
-            else
-            {
-                carla_addFloats(audioBuffers.inBuf[1], inBuf[port-1], frames);
-            }
-        }
+    const Buffers::Routing& routing(audioBuffers.acquireRouting());
+    const uint32_t* const in1Ports  = routing.ports;
+    const uint32_t* const in2Ports  = in1Ports  + routing.counts[Buffers::kRoutingIn1];
+    const uint32_t* const out1Ports = in2Ports  + routing.counts[Buffers::kRoutingIn2];
+    const uint32_t* const out2Ports = out1Ports + routing.counts[Buffers::kRoutingOut1];
 
-        if (noConnections)
-            carla_zeroFloats(audioBuffers.inBuf[1], frames);
+    // connect input buffers
+    if (inBuf != nullptr)
+    {
+        mixRoutedChannels(audioBuffers.inBuf[0], inBuf, in1Ports, routing.counts[Buffers::kRoutingIn1], frames);
+        mixRoutedChannels(audioBuffers.inBuf[1], inBuf, in2Ports, routing.counts[Buffers::kRoutingIn2], frames);
     }
     else
     {
@@ -1187,29 +1272,13 @@ void RackGraph::processHelper(CarlaEngine::ProtectedData* const data, const floa
     process(data, const_cast<const float**>(audioBuffers.inBuf), audioBuffers.outBuf, frames);
 
     // connect output buffers
-    if (audioBuffers.connectedOut1.count() != 0)
-    {
-        for (LinkedList<uint>::Itenerator it = audioBuffers.connectedOut1.begin2(); it.valid(); it.next())
-        {
-            const uint& port(it.getValue(0));
-            CARLA_SAFE_ASSERT_CONTINUE(port > 0);
-            CARLA_SAFE_ASSERT_CONTINUE(port <= outputs);
-
-            carla_addFloats(outBuf[port-1], audioBuffers.outBuf[0], frames);
-        }
-    }
+    for (uint32_t i = 0; i < routing.counts[Buffers::kRoutingOut1]; ++i)
+        carla_addFloats(outBuf[out1Ports[i]], audioBuffers.outBuf[0], frames);
 
-    if (audioBuffers.connectedOut2.count() != 0)
-    {
-        for (LinkedList<uint>::Itenerator it = audioBuffers.connectedOut2.begin2(); it.valid(); it.next())
-        {
-            const uint& port(it.getValue(0));
-            CARLA_SAFE_ASSERT_CONTINUE(port > 0);
-            CARLA_SAFE_ASSERT_CONTINUE(port <= outputs);
+    for (uint32_t i = 0; i < routing.counts[Buffers::kRoutingOut2]; ++i)
+        carla_addFloats(outBuf[out2Ports[i]], audioBuffers.outBuf[1], frames);
 
-            carla_addFloats(outBuf[port-1], audioBuffers.outBuf[1], frames);
-        }
-    }
+    audioBuffers.releaseRouting();
 }
 
 // -----------------------------------------------------------------------
@@ -1562,16 +1631,9 @@ public:
             return;
         }
 
-        if (CarlaEngineEventPort* const port = plugin->getDefaultEventInPort())
-        {
-            EngineEvent* const engineEvents(port->fBuffer);
-            CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
-
-            carla_zeroStructs(engineEvents, kMaxEngineEventInternalCount);
-            fillEngineEventsFromWaterMidiBuffer(engineEvents, midi);
-        }
+        readEventsRT(plugin, midi);
 
-        midi.clear();
+        const uint64_t startTime = carla_gettime_ns();
 
         plugin->initBuffers();
 
@@ -1613,9 +1675,23 @@ public:
             for (uint32_t i=0, count=jmin(plugin->getAudioInCount(), numChan2); i<count; ++i)
                 inPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
 
-            plugin->process(const_cast<const float**>(audioBuffers), audioBuffers,
-                            cvInBuffers, cvOutBuffers,
-                            numSamples);
+            // frozen plugins play from their cache, which replaces the input in place
+            if (! plugin->isFrozenRT(audioBuffers, audioBuffers, numSamples))
+            {
+                if (plugin->isSleepingRT(audioBuffers, numSamples))
+                {
+                    audio.clear();
+                }
+                else
+                {
+                    plugin->process(const_cast<const float**>(audioBuffers), audioBuffers,
+                                    cvInBuffers, cvOutBuffers,
+                                    numSamples);
+                    plugin->updateSleepStateRT(audioBuffers, numSamples);
+                }
+
+                plugin->recordFreezeRT(audioBuffers, numSamples);
+            }
 
             for (uint32_t i=0, count=jmin(plugin->getAudioOutCount(), numChan2); i<count; ++i)
                 outPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
@@ -1638,17 +1714,94 @@ public:
                             numSamples);
         }
 
-        midi.clear();
+        kEngine->addPluginTimingRT(plugin->getId(), carla_gettime_ns() - startTime);
 
-        if (CarlaEngineEventPort* const port = plugin->getDefaultEventOutPort())
+        writeEventsRT(plugin, midi);
+
+        plugin->unlock();
+    }
+
+    bool supportsDoublePrecisionProcessing() const noexcept override
+    {
+        const CarlaPluginPtr plugin = fPlugin;
+
+        // sleeping and freezing are only handled in the float path, which wakes the plugin up when needed
+        return plugin.get() != nullptr && plugin->canProcessDouble() && ! plugin->isSleeping()
+            && ! plugin->isFrozen() && ! plugin->isFreezing();
+    }
+
+    void processBlockDoubleWithCV(double* const* const audio,
+                                  const uint numAudioChan,
+                                  const AudioSampleBuffer& cvIn,
+                                  AudioSampleBuffer& cvOut,
+                                  MidiBuffer& midi,
+                                  const int numSamplesInt) override
+    {
+        const CarlaPluginPtr plugin = fPlugin;
+        const uint32_t numSamples = static_cast<uint32_t>(numSamplesInt);
+
+        if (plugin.get() == nullptr || !plugin->isEnabled() || !plugin->tryLock(kEngine->isOffline()))
         {
-            /*const*/ EngineEvent* const engineEvents(port->fBuffer);
-            CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
+            for (uint32_t i=0; i<numAudioChan; ++i)
+                carla_zeroDoubles(audio[i], numSamples);
+            cvOut.clear();
+            midi.clear();
+            return;
+        }
 
-            fillWaterMidiBufferFromEngineEvents(midi, engineEvents);
-            carla_zeroStructs(engineEvents, kMaxEngineEventInternalCount);
+        readEventsRT(plugin, midi);
+
+        const uint64_t startTime = carla_gettime_ns();
+
+        plugin->initBuffers();
+
+        const uint32_t numCVInChan  = cvIn.getNumChannels();
+        const uint32_t numCVOutChan = cvOut.getNumChannels();
+        const uint32_t numChan2     = jmin(numAudioChan, 2U);
+
+        float* cvOutBuffers[MAX_GRAPH_CV_IO];
+        const float* cvInBuffers[MAX_GRAPH_CV_IO];
+        CARLA_SAFE_ASSERT_RETURN(numCVOutChan <= MAX_GRAPH_CV_IO, plugin->unlock());
+        CARLA_SAFE_ASSERT_RETURN(numCVInChan <= MAX_GRAPH_CV_IO, plugin->unlock());
+
+        for (uint32_t i=0; i<numCVOutChan; ++i)
+            cvOutBuffers[i] = cvOut.getWritePointer(i);
+        for (uint32_t i=0; i<numCVInChan; ++i)
+            cvInBuffers[i] = cvIn.getReadPointer(i);
+
+        if (plugin->getAudioInCount() == 0)
+        {
+            for (uint32_t i=0; i<numAudioChan; ++i)
+                carla_zeroDoubles(audio[i], numSamples);
         }
 
+        float inPeaks[2] = { 0.0f };
+        float outPeaks[2] = { 0.0f };
+
+        for (uint32_t i=0, count=jmin(plugin->getAudioInCount(), numChan2); i<count; ++i)
+            inPeaks[i] = carla_findMaxNormalizedDouble(audio[i], numSamples);
+
+        if (plugin->isSleepingRT(audio, numSamples))
+        {
+            for (uint32_t i=0; i<numAudioChan; ++i)
+                carla_zeroDoubles(audio[i], numSamples);
+        }
+        else
+        {
+            plugin->processDouble(const_cast<const double* const*>(audio), const_cast<double**>(audio),
+                                  cvInBuffers, cvOutBuffers,
+                                  numSamples);
+            plugin->updateSleepStateRT(audio, numSamples);
+        }
+
+        for (uint32_t i=0, count=jmin(plugin->getAudioOutCount(), numChan2); i<count; ++i)
+            outPeaks[i] = carla_findMaxNormalizedDouble(audio[i], numSamples);
+
+        kEngine->setPluginPeaksRT(plugin->getId(), inPeaks, outPeaks);
+        kEngine->addPluginTimingRT(plugin->getId(), carla_gettime_ns() - startTime);
+
+        writeEventsRT(plugin, midi);
+
         plugin->unlock();
     }
 
@@ -1711,7 +1864,72 @@ public:
         return plugin->getDefaultEventOutPort() != nullptr;
     }
 
+    // disabled and deactivated plugins only output silence, the graph skips them
+    bool isInactive() const noexcept override
+    {
+        const CarlaPluginPtr plugin = fPlugin;
+
+        return plugin.get() == nullptr
+            || ! plugin->isEnabled()
+            || plugin->getInternalParameterValue(PARAMETER_ACTIVE) < 0.5f;
+    }
+
+    // plugins still have consumers when their outputs are not connected:
+    // output parameters, a shown UI, peaks read by the host, and offline renders including freezing
+    bool isAlwaysNeeded() const noexcept override
+    {
+        const CarlaPluginPtr plugin = fPlugin;
+        CARLA_SAFE_ASSERT_RETURN(plugin.get() != nullptr, false);
+
+        if (plugin->isFreezing() || plugin->isCustomUIShown() || kEngine->isOffline())
+            return true;
+
+        if (kEngine->pData->arePeaksInUse())
+            return true;
+
+        uint32_t ins, outs;
+        plugin->getParameterCountInfo(ins, outs);
+        return outs != 0;
+    }
+
 private:
+    // Events are converted between water MidiBuffers and the plugin engine event ports on every hop.
+    // Graph wires, fan-in merging and external MIDI ports all use MidiBuffer, and water cannot depend on
+    // backend types, so carrying EngineEvent arrays through the graph would mean a fixed-size event array
+    // per wire. The conversion is a single linear pass over the used events, which is cheap next to the
+    // plugin processing itself.
+    static void readEventsRT(const CarlaPluginPtr& plugin, MidiBuffer& midi)
+    {
+        if (CarlaEngineEventPort* const port = plugin->getDefaultEventInPort())
+        {
+            EngineEvent* const engineEvents(port->fBuffer);
+
+            if (engineEvents != nullptr)
+            {
+                clearUsedEngineEvents(engineEvents);
+                fillEngineEventsFromWaterMidiBuffer(engineEvents, midi);
+            }
+        }
+
+        midi.clear();
+    }
+
+    static void writeEventsRT(const CarlaPluginPtr& plugin, MidiBuffer& midi)
+    {
+        midi.clear();
+
+        if (CarlaEngineEventPort* const port = plugin->getDefaultEventOutPort())
+        {
+            /*const*/ EngineEvent* const engineEvents(port->fBuffer);
+
+            if (engineEvents != nullptr)
+            {
+                fillWaterMidiBufferFromEngineEvents(midi, engineEvents);
+                clearUsedEngineEvents(engineEvents);
+            }
+        }
+    }
+
     CarlaEngine* const kEngine;
     CarlaPluginPtr fPlugin;
 
@@ -1785,6 +2003,7 @@ PatchbayGraph::PatchbayGraph(CarlaEngine* const engine,
                                numCVIns, numCVOuts,
                                1, 1,
                                sampleRate, static_cast<int>(bufferSize));
+    graph.setDoublePrecisionProcessing(engine->getOptions().audioDoublePrecision);
     graph.prepareToPlay(sampleRate, static_cast<int>(bufferSize));
 
     audioBuffer.setSize(jmax(numAudioIns, numAudioOuts), bufferSize);
@@ -2599,6 +2818,36 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data,
         fillWaterMidiBufferFromEngineEvents(midiBuffer, data->events.in);
     }
 
+    // there is no time limit when offline, apply pending graph changes right away
+    if (kEngine->isOffline())
+        graph.reorderNowIfNeeded();
+
+    // fast path, let the graph IO nodes read and write the carla buffers directly
+    if (canUseExternalBuffers(inBuf, outBuf))
+    {
+        {
+            const CarlaRecursiveMutexTryLocker crmtl(graph.getCallbackLock(), kEngine->isOffline());
+
+            if (crmtl.wasLocked())
+            {
+                graph.processWithExternalBuffers(inBuf, outBuf, inBuf + numAudioIns, outBuf + numAudioOuts,
+                                                 frames, midiBuffer);
+            }
+            else
+            {
+                for (uint32_t i=0, count=numAudioOuts+numCVOuts; i < count; ++i)
+                    carla_zeroFloats(outBuf[i], frames);
+
+                midiBuffer.clear();
+            }
+        }
+
+        clearUsedEngineEvents(data->events.out);
+        fillEngineEventsFromWaterMidiBuffer(data->events.out, midiBuffer);
+        midiBuffer.clear();
+        return;
+    }
+
     // set audio and cv buffer size, needed for water internals
     if (! audioBuffer.setSizeRT(frames))
         return;
@@ -2630,7 +2879,21 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data,
     }
 
     // ready to go!
-    graph.processBlockWithCV(audioBuffer, cvInBuffer, cvOutBuffer, midiBuffer);
+    // the reorder thread swaps and deletes rendering ops while holding this lock, skip the cycle if busy
+    {
+        const CarlaRecursiveMutexTryLocker crmtl(graph.getCallbackLock(), kEngine->isOffline());
+
+        if (crmtl.wasLocked())
+        {
+            graph.processBlockWithCV(audioBuffer, cvInBuffer, cvOutBuffer, midiBuffer);
+        }
+        else
+        {
+            audioBuffer.clear();
+            cvOutBuffer.clear();
+            midiBuffer.clear();
+        }
+    }
 
     // put water audio and cv in carla buffer
     {
@@ -2645,12 +2908,39 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data,
 
     // put water events in carla buffer
     {
-        carla_zeroStructs(data->events.out, kMaxEngineEventInternalCount);
+        clearUsedEngineEvents(data->events.out);
         fillEngineEventsFromWaterMidiBuffer(data->events.out, midiBuffer);
         midiBuffer.clear();
     }
 }
 
+bool PatchbayGraph::canUseExternalBuffers(const float* const* const inBuf, float* const* const outBuf) const noexcept
+{
+    const uint32_t numIns  = numAudioIns + numCVIns;
+    const uint32_t numOuts = numAudioOuts + numCVOuts;
+
+    for (uint32_t i=0; i < numIns; ++i)
+    {
+        if (inBuf[i] == nullptr)
+            return false;
+    }
+
+    // outputs are cleared before the graph runs, so they must not alias any input
+    for (uint32_t i=0; i < numOuts; ++i)
+    {
+        if (outBuf[i] == nullptr)
+            return false;
+
+        for (uint32_t j=0; j < numIns; ++j)
+        {
+            if (outBuf[i] == inBuf[j])
+                return false;
+        }
+    }
+
+    return true;
+}
+
 bool PatchbayGraph::run()
 {
     graph.reorderNowIfNeeded();
@@ -2663,6 +2953,8 @@ bool PatchbayGraph::run()
 EngineInternalGraph::EngineInternalGraph(CarlaEngine* const engine) noexcept
     : fIsRack(false),
       fNumAudioOuts(0),
+      fNumInputBuffers(0),
+      fNumOutputBuffers(0),
       fIsReady(false),
       fRack(nullptr),
       kEngine(engine) {}
@@ -2690,6 +2982,8 @@ void EngineInternalGraph::create(const uint32_t audioIns, const uint32_t audioOu
     }
 
     fNumAudioOuts = audioOuts;
+    fNumInputBuffers = audioIns + cvIns;
+    fNumOutputBuffers = audioOuts + cvOuts;
     fIsReady = true;
 }
 
@@ -2716,6 +3010,8 @@ void EngineInternalGraph::destroy() noexcept
 
     fIsReady = false;
     fNumAudioOuts = 0;
+    fNumInputBuffers = 0;
+    fNumOutputBuffers = 0;
 }
 
 void EngineInternalGraph::setBufferSize(const uint32_t bufferSize)
@@ -2784,6 +3080,8 @@ PatchbayGraph* EngineInternalGraph::getPatchbayGraphOrNull() const noexcept
 
 void EngineInternalGraph::process(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
 {
+    const uint64_t startTime = carla_gettime_ns();
+
     if (fIsRack)
     {
         CARLA_SAFE_ASSERT_RETURN(fRack != nullptr,);
@@ -2794,6 +3092,8 @@ void EngineInternalGraph::process(CarlaEngine::ProtectedData* const data, const
         CARLA_SAFE_ASSERT_RETURN(fPatchbay != nullptr,);
         fPatchbay->process(data, inBuf, outBuf, frames);
     }
+
+    data->cycleStats.addGraphTimeRT(carla_gettime_ns() - startTime);
 }
 
 void EngineInternalGraph::processRack(CarlaEngine::ProtectedData* const data, const float* inBuf[2], float* outBuf[2], const uint32_t frames)
@@ -2801,7 +3101,11 @@ void EngineInternalGraph::processRack(CarlaEngine::ProtectedData* const data, co
     CARLA_SAFE_ASSERT_RETURN(fIsRack,);
     CARLA_SAFE_ASSERT_RETURN(fRack != nullptr,);
 
+    const uint64_t startTime = carla_gettime_ns();
+
     fRack->process(data, inBuf, outBuf, frames);
+
+    data->cycleStats.addGraphTimeRT(carla_gettime_ns() - startTime);
 }
 
 // -----------------------------------------------------------------------
@@ -3097,19 +3401,30 @@ bool CarlaEngine::connectExternalGraphPort(const uint connectionType, const uint
 
     const CarlaRecursiveMutexLocker cml(graph->audioBuffers.mutex);
 
+    bool ok;
+
     switch (connectionType)
     {
     case kExternalGraphConnectionAudioIn1:
-        return graph->audioBuffers.connectedIn1.append(portId);
+        ok = graph->audioBuffers.connectedIn1.append(portId);
+        break;
     case kExternalGraphConnectionAudioIn2:
-        return graph->audioBuffers.connectedIn2.append(portId);
+        ok = graph->audioBuffers.connectedIn2.append(portId);
+        break;
     case kExternalGraphConnectionAudioOut1:
-        return graph->audioBuffers.connectedOut1.append(portId);
+        ok = graph->audioBuffers.connectedOut1.append(portId);
+        break;
     case kExternalGraphConnectionAudioOut2:
-        return graph->audioBuffers.connectedOut2.append(portId);
+        ok = graph->audioBuffers.connectedOut2.append(portId);
+        break;
+    default:
+        return false;
     }
 
-    return false;
+    if (ok)
+        graph->audioBuffers.updateRouting(graph->inputs, graph->outputs);
+
+    return ok;
 }
 
 bool CarlaEngine::disconnectExternalGraphPort(const uint connectionType, const uint portId, const char* const portName)
@@ -3122,19 +3437,30 @@ bool CarlaEngine::disconnectExternalGraphPort(const uint connectionType, const u
 
     const CarlaRecursiveMutexLocker cml(graph->audioBuffers.mutex);
 
+    bool ok;
+
     switch (connectionType)
     {
     case kExternalGraphConnectionAudioIn1:
-        return graph->audioBuffers.connectedIn1.removeOne(portId);
+        ok = graph->audioBuffers.connectedIn1.removeOne(portId);
+        break;
     case kExternalGraphConnectionAudioIn2:
-        return graph->audioBuffers.connectedIn2.removeOne(portId);
+        ok = graph->audioBuffers.connectedIn2.removeOne(portId);
+        break;
     case kExternalGraphConnectionAudioOut1:
-        return graph->audioBuffers.connectedOut1.removeOne(portId);
+        ok = graph->audioBuffers.connectedOut1.removeOne(portId);
+        break;
     case kExternalGraphConnectionAudioOut2:
-        return graph->audioBuffers.connectedOut2.removeOne(portId);
+        ok = graph->audioBuffers.connectedOut2.removeOne(portId);
+        break;
+    default:
+        return false;
     }
 
-    return false;
+    if (ok)
+        graph->audioBuffers.updateRouting(graph->inputs, graph->outputs);
+
+    return ok;
 }
 
 // -----------------------------------------------------------------------
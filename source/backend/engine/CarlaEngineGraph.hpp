@@ -24,6 +24,7 @@
 #include "CarlaStringList.hpp"
 #include "CarlaRunner.hpp"
 
+#include "water/memory/Atomic.h"
 #include "water/processors/AudioProcessorGraph.h"
 #include "water/text/StringArray.h"
 
@@ -131,9 +132,37 @@ struct RackGraph {
         float* inBufTmp[2];
         float* outBuf[2];
         float* unusedBuf;
+
+        // flat copy of the connected lists, used by the audio thread without locking
+        enum RoutingList {
+            kRoutingIn1,
+            kRoutingIn2,
+            kRoutingOut1,
+            kRoutingOut2,
+            kRoutingListCount
+        };
+
+        struct Routing {
+            uint32_t* ports; // 0-based device channels, each list following the previous one
+            uint32_t capacity;
+            uint32_t counts[kRoutingListCount];
+        } routing[2];
+
+        // index of the latest routing table, and of the one in use by the audio thread (-1 if none).
+        // the main thread only writes into the table that is neither of these.
+        water::Atomic<int> publishedRouting;
+        water::Atomic<int> activeRouting;
+
         Buffers() noexcept;
         ~Buffers() noexcept;
         void setBufferSize(uint32_t bufferSize, bool createBuffers) noexcept;
+
+        // rebuild the routing table from the connected lists, must be called with mutex locked
+        void updateRouting(uint32_t inputs, uint32_t outputs) noexcept;
+
+        // audio thread side, the table stays valid until releaseRouting()
+        const Routing& acquireRouting() noexcept;
+        void releaseRouting() noexcept;
         CARLA_PREVENT_HEAP_ALLOCATION
         CARLA_DECLARE_NON_COPYABLE(Buffers)
     } audioBuffers;
@@ -217,6 +246,7 @@ public:
                  uint32_t frames);
 
 private:
+    bool canUseExternalBuffers(const float* const* inBuf, float* const* outBuf) const noexcept;
     bool run() override;
 
     CarlaEngine* const kEngine;
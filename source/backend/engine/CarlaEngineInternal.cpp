@@ -18,6 +18,7 @@
 #include "CarlaEngineInternal.hpp"
 #include "CarlaPlugin.hpp"
 #include "CarlaSemUtils.hpp"
+#include "CarlaTimeUtils.hpp"
 
 #include "jackbridge/JackBridge.hpp"
 
@@ -371,6 +372,407 @@ void EngineNextAction::clearAndReset() noexcept
     mutex.unlock();
 }
 
+// -----------------------------------------------------------------------
+// EnginePluginTimings
+
+// bucket 0 is for anything under 4ns, then 4 buckets per octave
+static inline
+uint getTimingBucketIndex(const uint64_t timeNs) noexcept
+{
+    if (timeNs < 4)
+        return 0;
+
+    uint octave = 0;
+    uint64_t value = timeNs;
+
+    for (; value >= 8; value >>= 1)
+        ++octave;
+
+    const uint index = 1 + octave * 4 + static_cast<uint>(value - 4);
+    return std::min(index, EnginePluginTimings::kNumBuckets - 1);
+}
+
+static inline
+uint64_t getTimingBucketUpperLimit(const uint index) noexcept
+{
+    if (index == 0)
+        return 4;
+
+    const uint octave = (index - 1) / 4;
+    const uint64_t value = 5 + (index - 1) % 4;
+
+    return value << octave;
+}
+
+EnginePluginTimings::EnginePluginTimings() noexcept
+    : count(0),
+      buckets(),
+      minNs(0),
+      maxNs(0),
+      totalNs(0),
+      needsReset(false)
+{
+    carla_zeroStructs(buckets, kNumBuckets);
+}
+
+void EnginePluginTimings::clear() noexcept
+{
+    count = 0;
+    carla_zeroStructs(buckets, kNumBuckets);
+    minNs = maxNs = totalNs = 0;
+    needsReset = false;
+}
+
+void EnginePluginTimings::addRT(const uint64_t timeNs) noexcept
+{
+    if (needsReset || count == UINT32_MAX)
+        clear();
+
+    if (count == 0 || timeNs < minNs)
+        minNs = timeNs;
+    if (timeNs > maxNs)
+        maxNs = timeNs;
+
+    totalNs += timeNs;
+    ++buckets[getTimingBucketIndex(timeNs)];
+    ++count;
+}
+
+void EnginePluginTimings::copyFrom(const EnginePluginTimings& other) noexcept
+{
+    count = other.count;
+    std::memcpy(buckets, other.buckets, sizeof(buckets));
+    minNs = other.minNs;
+    maxNs = other.maxNs;
+    totalNs = other.totalNs;
+    needsReset = other.needsReset;
+}
+
+void EnginePluginTimings::fillInfo(EnginePluginTimingInfo& info) const noexcept
+{
+    info.clear();
+
+    // NOTE: the audio thread might be writing while we read, values can be off by one cycle
+    const uint32_t numCycles = count;
+
+    if (numCycles == 0 || needsReset)
+        return;
+
+    const uint64_t min = minNs;
+    const uint64_t max = maxNs;
+
+    info.cycles = numCycles;
+    info.min = static_cast<float>(min) / 1000.0f;
+    info.max = static_cast<float>(max) / 1000.0f;
+    info.avg = static_cast<float>(static_cast<double>(totalNs) / numCycles / 1000.0);
+
+    const uint32_t target95 = numCycles - numCycles / 20;
+    const uint32_t target99 = numCycles - numCycles / 100;
+    uint32_t accum = 0;
+    bool got95 = false;
+
+    for (uint i=0; i < kNumBuckets; ++i)
+    {
+        accum += buckets[i];
+
+        if (accum < target95)
+            continue;
+
+        const uint64_t limit = std::max(min, std::min(max, getTimingBucketUpperLimit(i)));
+
+        if (! got95)
+        {
+            info.p95 = static_cast<float>(limit) / 1000.0f;
+            got95 = true;
+        }
+
+        if (accum >= target99)
+        {
+            info.p99 = static_cast<float>(limit) / 1000.0f;
+            break;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------
+// EngineSnapshotVersion
+
+EngineSnapshotVersion::EngineSnapshotVersion() noexcept
+    : mutex(),
+      version(0),
+      counters(nullptr),
+      count(0),
+      size(0) {}
+
+EngineSnapshotVersion::~EngineSnapshotVersion() noexcept
+{
+    CARLA_SAFE_ASSERT(counters == nullptr);
+}
+
+void EngineSnapshotVersion::init(const uint maxPluginNumber)
+{
+    const CarlaMutexLocker cml(mutex);
+    CARLA_SAFE_ASSERT_RETURN(counters == nullptr,);
+
+    counters = new uint64_t[maxPluginNumber];
+    carla_zeroStructs(counters, maxPluginNumber);
+    size = maxPluginNumber;
+    count = 0;
+    version = 0;
+}
+
+void EngineSnapshotVersion::close() noexcept
+{
+    const CarlaMutexLocker cml(mutex);
+
+    delete[] counters;
+    counters = nullptr;
+    count = size = 0;
+}
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+// -----------------------------------------------------------------------
+// EngineCycleStats
+
+EngineCycleSlowest::EngineCycleSlowest() noexcept
+    : seq(0),
+      record(),
+      xruns(0),
+      numPlugins(0),
+      numCosts(0),
+      costs()
+{
+    carla_zeroStruct(record);
+    carla_zeroStructs(costs, kMaxCosts);
+}
+
+EngineCycleStats::EngineCycleStats() noexcept
+    : ring(nullptr),
+      ringWriteCount(0),
+      numCycles(0),
+      numOverruns(0),
+      totalBuckets(),
+      jitterBuckets(),
+      slowest(),
+      needsReset(false),
+      inCycle(false),
+      lastStartNs(0),
+      periodNs(0),
+      slowestMinIndex(0),
+      current(),
+      currentCosts(nullptr),
+      currentCostsCount(0),
+      currentCostsSize(0)
+{
+    carla_zeroStructs(totalBuckets, kNumBuckets);
+    carla_zeroStructs(jitterBuckets, kNumBuckets);
+    carla_zeroStruct(current);
+}
+
+EngineCycleStats::~EngineCycleStats() noexcept
+{
+    CARLA_SAFE_ASSERT(ring == nullptr);
+    CARLA_SAFE_ASSERT(currentCosts == nullptr);
+}
+
+void EngineCycleStats::init(const uint maxPluginNumber)
+{
+    CARLA_SAFE_ASSERT_RETURN(ring == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(currentCosts == nullptr,);
+
+    ring = new EngineCycleRecord[kRingSize];
+    carla_zeroStructs(ring, kRingSize);
+
+    // plugins can run more than once per cycle, so leave some room
+    currentCostsSize = maxPluginNumber * 2;
+    currentCosts = new EngineCyclePluginCost[currentCostsSize];
+
+    inCycle = false;
+    clearRT();
+}
+
+void EngineCycleStats::close() noexcept
+{
+    // audio thread is already stopped at this point
+    inCycle = false;
+    currentCostsCount = currentCostsSize = 0;
+
+    if (currentCosts != nullptr)
+    {
+        delete[] currentCosts;
+        currentCosts = nullptr;
+    }
+
+    if (ring != nullptr)
+    {
+        delete[] ring;
+        ring = nullptr;
+    }
+}
+
+void EngineCycleStats::clearRT() noexcept
+{
+    numCycles = numOverruns = 0;
+    carla_zeroStructs(totalBuckets, kNumBuckets);
+    carla_zeroStructs(jitterBuckets, kNumBuckets);
+
+    for (uint i=0; i < kNumSlowest; ++i)
+    {
+        EngineCycleSlowest& slot(slowest[i]);
+        ++slot.seq;
+        carla_zeroStruct(slot.record);
+        slot.xruns = slot.numPlugins = slot.numCosts = 0;
+        ++slot.seq;
+    }
+
+    lastStartNs = 0;
+    slowestMinIndex = 0;
+    needsReset = false;
+}
+
+void EngineCycleStats::startCycleRT(const uint32_t frames, const double sampleRate) noexcept
+{
+    if (ring == nullptr)
+        return;
+
+    if (needsReset)
+        clearRT();
+
+    const uint64_t startNs = carla_gettime_ns();
+
+    current.startNs = startNs;
+    current.jitterNs = 0;
+    current.frames = frames;
+    current.totalNs = current.graphNs = current.pluginsNs = 0;
+    currentCostsCount = 0;
+
+    // jitter is relative to the previous cycle, ignore long gaps (engine stopped, offline, etc)
+    if (lastStartNs != 0 && periodNs != 0 && startNs - lastStartNs < 1000000000ULL)
+        current.jitterNs = static_cast<int64_t>(startNs - lastStartNs) - static_cast<int64_t>(periodNs);
+
+    lastStartNs = startNs;
+    periodNs = sampleRate > 0.0 ? static_cast<uint64_t>(frames * 1000000000.0 / sampleRate) : 0;
+    inCycle = true;
+}
+
+void EngineCycleStats::addGraphTimeRT(const uint64_t timeNs) noexcept
+{
+    if (! inCycle)
+        return;
+
+    current.graphNs += static_cast<uint32_t>(timeNs);
+}
+
+void EngineCycleStats::addPluginTimeRT(const uint pluginId, const uint64_t timeNs) noexcept
+{
+    if (! inCycle)
+        return;
+
+    current.pluginsNs += static_cast<uint32_t>(timeNs);
+
+    if (currentCostsCount < currentCostsSize)
+    {
+        EngineCyclePluginCost& cost(currentCosts[currentCostsCount++]);
+        cost.pluginId = pluginId;
+        cost.timeNs = static_cast<uint32_t>(timeNs);
+    }
+}
+
+void EngineCycleStats::endCycleRT(const uint32_t xruns) noexcept
+{
+    if (! inCycle)
+        return;
+
+    inCycle = false;
+
+    const uint64_t totalNs = carla_gettime_ns() - current.startNs;
+    current.totalNs = static_cast<uint32_t>(std::min<uint64_t>(totalNs, UINT32_MAX));
+
+    const uint32_t writeCount = ringWriteCount.get();
+    ring[writeCount & (kRingSize - 1)] = current;
+
+    // wrap explicitly instead of overflowing, going back by kRingSize keeps the same ring position
+    ringWriteCount.set(writeCount + 1 < 2 * kRingSize ? writeCount + 1 : kRingSize);
+
+    ++numCycles;
+    ++totalBuckets[getTimingBucketIndex(totalNs)];
+    ++jitterBuckets[getTimingBucketIndex(static_cast<uint64_t>(std::abs(current.jitterNs)))];
+
+    if (periodNs != 0 && totalNs > periodNs)
+        ++numOverruns;
+
+    EngineCycleSlowest& slot(slowest[slowestMinIndex]);
+
+    if (current.totalNs <= slot.record.totalNs)
+        return;
+
+    ++slot.seq;
+
+    slot.record = current;
+    slot.xruns = xruns;
+    slot.numPlugins = currentCostsCount;
+    slot.numCosts = 0;
+
+    // keep the most expensive plugins, sorted by cost
+    for (uint32_t i=0; i < currentCostsCount; ++i)
+    {
+        const EngineCyclePluginCost& cost(currentCosts[i]);
+
+        uint32_t j = std::min(slot.numCosts, static_cast<uint32_t>(kMaxCosts - 1));
+
+        if (slot.numCosts == kMaxCosts && cost.timeNs <= slot.costs[j].timeNs)
+            continue;
+
+        for (; j > 0 && slot.costs[j - 1].timeNs < cost.timeNs; --j)
+            slot.costs[j] = slot.costs[j - 1];
+
+        slot.costs[j] = cost;
+
+        if (slot.numCosts < kMaxCosts)
+            ++slot.numCosts;
+    }
+
+    ++slot.seq;
+
+    for (uint i=0; i < kNumSlowest; ++i)
+    {
+        if (slowest[i].record.totalNs < slowest[slowestMinIndex].record.totalNs)
+            slowestMinIndex = i;
+    }
+}
+
+uint64_t EngineCycleStats::getBucketUpperLimit(const uint index) noexcept
+{
+    return getTimingBucketUpperLimit(index);
+}
+
+bool EngineCycleStats::copySlowest(const uint index, EngineCycleSlowest& out) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(index < kNumSlowest, false);
+
+    const EngineCycleSlowest& slot(slowest[index]);
+
+    for (int tries = 0; tries < 8; ++tries)
+    {
+        const int seq = slot.seq.get();
+
+        if (seq % 2 != 0)
+            continue;
+
+        out.record = slot.record;
+        out.xruns = slot.xruns;
+        out.numPlugins = slot.numPlugins;
+        out.numCosts = std::min(slot.numCosts, static_cast<uint32_t>(kMaxCosts));
+        std::memcpy(out.costs, slot.costs, sizeof(out.costs));
+
+        if (slot.seq.get() == seq)
+            return true;
+    }
+
+    return false;
+}
+#endif
+
 // -----------------------------------------------------------------------
 // Helper functions
 
@@ -384,6 +786,7 @@ EngineEvent* CarlaEngine::getInternalEventBuffer(const bool isInput) const noexc
 
 CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
     : runner(engine),
+      workerPool(),
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
       osc(engine),
 #endif
@@ -410,16 +813,26 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
       name(),
       options(),
       timeInfo(),
+      threadPlacement(options),
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
       plugins(nullptr),
+      pluginsNext(nullptr),
+      pluginTableUpdate(nullptr),
+      pluginTablesToDelete(),
+      pluginTablesMaybeInUse(false),
       xruns(0),
       dspLoad(0.0f),
+      cycleStats(),
 #endif
+      peaksReadTime(),
+      snapshotVersion(),
       pluginsToDeleteMutex(),
       pluginsToDelete(),
       events(),
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
       graph(engine),
+      renderMutex(),
+      isRendering(false),
 #endif
       time(timeInfo, options.transportMode),
       nextAction()
@@ -438,6 +851,8 @@ CarlaEngine::ProtectedData::~ProtectedData()
     CARLA_SAFE_ASSERT(isIdling == 0);
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     CARLA_SAFE_ASSERT(plugins == nullptr);
+    CARLA_SAFE_ASSERT(pluginsNext == nullptr);
+    CARLA_SAFE_ASSERT(pluginTablesToDelete.size() == 0);
 #endif
 
     const CarlaMutexLocker cml(pluginsToDeleteMutex);
@@ -470,6 +885,8 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
     curPluginCount = 0;
     nextPluginId   = 0;
 
+    threadPlacement.reset();
+
     switch (options.processMode)
     {
     case ENGINE_PROCESS_MODE_CONTINUOUS_RACK:
@@ -515,9 +932,12 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     plugins = new EnginePluginData[maxPluginNumber];
+    pluginsNext = new EnginePluginData[maxPluginNumber];
     xruns = 0;
     dspLoad = 0.0f;
+    cycleStats.init(maxPluginNumber);
 #endif
+    snapshotVersion.init(maxPluginNumber);
 
     nextAction.clearAndReset();
     runner.start();
@@ -536,6 +956,7 @@ void CarlaEngine::ProtectedData::close()
     aboutToClose = true;
 
     runner.stop();
+    workerPool.stop();
     nextAction.clearAndReset();
 
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
@@ -555,7 +976,18 @@ void CarlaEngine::ProtectedData::close()
         delete[] plugins;
         plugins = nullptr;
     }
+
+    if (pluginsNext != nullptr)
+    {
+        delete[] pluginsNext;
+        pluginsNext = nullptr;
+    }
+
+    deletePluginTablesAsNeeded(true);
+
+    cycleStats.close();
 #endif
+    snapshotVersion.close();
 
     events.clear();
     name.clear();
@@ -580,6 +1012,11 @@ void CarlaEngine::ProtectedData::initTime(const char* const features)
 
 void CarlaEngine::ProtectedData::deletePluginsAsNeeded()
 {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // release references held by old tables first, so their plugins can be deleted below
+    deletePluginTablesAsNeeded(false);
+#endif
+
     std::vector<CarlaPluginPtr> safePluginListToDelete;
 
     if (const size_t size = pluginsToDelete.size())
@@ -604,54 +1041,39 @@ void CarlaEngine::ProtectedData::deletePluginsAsNeeded()
     }
 }
 
-// -----------------------------------------------------------------------
-
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-void CarlaEngine::ProtectedData::doPluginRemove(const uint pluginId) noexcept
+void CarlaEngine::ProtectedData::deletePluginTablesAsNeeded(const bool force)
 {
-    CARLA_SAFE_ASSERT_RETURN(curPluginCount > 0,);
-    CARLA_SAFE_ASSERT_RETURN(pluginId < curPluginCount,);
-    --curPluginCount;
+    std::vector<EnginePluginData*> safePluginTablesToDelete;
 
-    // move all plugins 1 spot backwards
-    for (uint i=pluginId; i < curPluginCount; ++i)
     {
-        const CarlaPluginPtr plugin = plugins[i+1].plugin;
-        CARLA_SAFE_ASSERT_BREAK(plugin.get() != nullptr);
+        const CarlaMutexLocker cml(pluginsToDeleteMutex);
 
-        plugin->setId(i);
+        // acquire pairs with the release at the end of the audio cycle, so its reads of the old tables are done
+        if (pluginTablesToDelete.size() == 0 || (pluginTablesMaybeInUse.load(std::memory_order_acquire) && ! force))
+            return;
 
-        plugins[i].plugin = plugin;
-        carla_zeroStruct(plugins[i].peaks);
+        safePluginTablesToDelete.swap(pluginTablesToDelete);
     }
 
-    const uint id = curPluginCount;
-
-    // reset last plugin (now removed)
-    plugins[id].plugin.reset();
-    carla_zeroFloats(plugins[id].peaks, 4);
+    for (std::vector<EnginePluginData*>::iterator it = safePluginTablesToDelete.begin(); it != safePluginTablesToDelete.end(); ++it)
+        delete[] *it;
 }
+#endif
 
-void CarlaEngine::ProtectedData::doPluginsSwitch(const uint idA, const uint idB) noexcept
-{
-    CARLA_SAFE_ASSERT_RETURN(curPluginCount >= 2,);
-
-    CARLA_SAFE_ASSERT_RETURN(idA < curPluginCount,);
-    CARLA_SAFE_ASSERT_RETURN(idB < curPluginCount,);
-
-    const CarlaPluginPtr pluginA = plugins[idA].plugin;
-    CARLA_SAFE_ASSERT_RETURN(pluginA.get() != nullptr,);
-
-    const CarlaPluginPtr pluginB = plugins[idB].plugin;
-    CARLA_SAFE_ASSERT_RETURN(pluginB.get() != nullptr,);
+// -----------------------------------------------------------------------
 
-    pluginA->setId(idB);
-    plugins[idA].plugin = pluginB;
+void CarlaEngine::ProtectedData::setPeaksRead() noexcept
+{
+    peaksReadTime.set(carla_gettime_ms());
+}
 
-    pluginB->setId(idA);
-    plugins[idB].plugin = pluginA;
+bool CarlaEngine::ProtectedData::arePeaksInUse() const noexcept
+{
+    return carla_gettime_ms() - peaksReadTime.get() < 2000;
 }
-#endif
+
+// -----------------------------------------------------------------------
 
 void CarlaEngine::ProtectedData::doNextPluginAction() noexcept
 {
@@ -680,12 +1102,20 @@ void CarlaEngine::ProtectedData::doNextPluginAction() noexcept
         curPluginCount = 0;
         break;
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    case kEnginePostActionRemovePlugin:
-        doPluginRemove(pluginId);
-        break;
-    case kEnginePostActionSwitchPlugins:
-        doPluginsSwitch(pluginId, value);
+    case kEnginePostActionSwapPlugins: {
+        // everything was prepared on the main thread, only swap the tables here
+        EnginePluginData* const oldPlugins = plugins;
+        plugins = pluginsNext;
+        pluginsNext = oldPlugins;
+        curPluginCount = value;
+
+        for (uint i=0; i < curPluginCount; ++i)
+        {
+            if (CarlaPlugin* const plugin = plugins[i].plugin.get())
+                plugin->setId(i);
+        }
         break;
+    }
 #endif
     }
 
@@ -727,6 +1157,12 @@ PendingRtEventsRunner::PendingRtEventsRunner(CarlaEngine* const engine,
     : pData(engine->pData),
       prevTime(calcDSPLoad ? getTimeInMicroseconds() : 0)
 {
+    pData->threadPlacement.applyToCurrentThreadOnce(ENGINE_THREAD_AUDIO);
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    pData->cycleStats.startCycleRT(frames, pData->sampleRate);
+#endif
+
     pData->time.preProcess(frames);
 }
 
@@ -735,6 +1171,11 @@ PendingRtEventsRunner::~PendingRtEventsRunner() noexcept
     pData->doNextPluginAction();
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // this cycle is done, old plugin tables swapped before it are no longer in use
+    pData->pluginTablesMaybeInUse.store(false, std::memory_order_release);
+
+    pData->cycleStats.endCycleRT(pData->xruns);
+
     if (prevTime > 0)
     {
         const int64_t newTime = getTimeInMicroseconds();
@@ -761,7 +1202,8 @@ ScopedActionLock::ScopedActionLock(CarlaEngine* const engine,
                                    const EnginePostAction action,
                                    const uint pluginId,
                                    const uint value) noexcept
-    : pData(engine->pData)
+    : pData(engine->pData),
+      confirmed(false)
 {
     CARLA_SAFE_ASSERT_RETURN(action != kEnginePostActionNull,);
 
@@ -822,8 +1264,10 @@ ScopedActionLock::ScopedActionLock(CarlaEngine* const engine,
        #endif
       #endif
 
+        confirmed = pData->nextAction.postDone;
+
         // check if anything went wrong...
-        if (! pData->nextAction.postDone)
+        if (! confirmed)
         {
             bool needsCorrection = false;
 
@@ -849,6 +1293,7 @@ ScopedActionLock::ScopedActionLock(CarlaEngine* const engine,
     else
     {
         pData->doNextPluginAction();
+        confirmed = true;
     }
 }
 
@@ -857,6 +1302,216 @@ ScopedActionLock::~ScopedActionLock() noexcept
     CARLA_SAFE_ASSERT(pData->nextAction.opcode == kEnginePostActionNull);
 }
 
+// -----------------------------------------------------------------------
+// ScopedPluginTableUpdate
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+ScopedPluginTableUpdate::ScopedPluginTableUpdate(CarlaEngine* const e) noexcept
+    : engine(e),
+      pData(e->pData),
+      outer(e->pData->pluginTableUpdate),
+      pluginCount(e->pData->curPluginCount),
+      copied(false)
+{
+    if (outer == nullptr)
+        pData->pluginTableUpdate = this;
+}
+
+ScopedPluginTableUpdate::~ScopedPluginTableUpdate() noexcept
+{
+    if (outer != nullptr)
+        return;
+
+    pData->pluginTableUpdate = nullptr;
+    publish();
+}
+
+uint ScopedPluginTableUpdate::addPlugin(const CarlaPluginPtr& plugin) noexcept
+{
+    if (outer != nullptr)
+        return outer->addPlugin(plugin);
+
+    CARLA_SAFE_ASSERT_RETURN(pluginCount < pData->maxPluginNumber, pluginCount);
+
+    const uint id = pluginCount++;
+
+    EnginePluginData& pluginData(pData->pluginsNext[id]);
+    pluginData.plugin = plugin;
+    carla_zeroFloats(pluginData.peaks, 4);
+    pluginData.timings.needsReset = true;
+
+    return id;
+}
+
+void ScopedPluginTableUpdate::replacePlugin(const uint id, const CarlaPluginPtr& plugin) noexcept
+{
+    if (outer != nullptr)
+    {
+        outer->replacePlugin(id, plugin);
+        return;
+    }
+
+    CARLA_SAFE_ASSERT_RETURN(id < pluginCount,);
+
+    copyTableIfNeeded();
+
+    EnginePluginData& pluginData(pData->pluginsNext[id]);
+    pluginData.plugin = plugin;
+    carla_zeroFloats(pluginData.peaks, 4);
+    pluginData.timings.needsReset = true;
+}
+
+void ScopedPluginTableUpdate::removePlugin(const uint id) noexcept
+{
+    if (outer != nullptr)
+    {
+        outer->removePlugin(id);
+        return;
+    }
+
+    CARLA_SAFE_ASSERT_RETURN(id < pluginCount,);
+
+    copyTableIfNeeded();
+
+    --pluginCount;
+
+    // move all plugins 1 spot backwards
+    for (uint i=id; i < pluginCount; ++i)
+    {
+        EnginePluginData& pluginData(pData->pluginsNext[i]);
+
+        pluginData.plugin = pData->pluginsNext[i+1].plugin;
+        carla_zeroFloats(pluginData.peaks, 4);
+        pluginData.timings.needsReset = true;
+    }
+
+    // reset last plugin (now removed)
+    EnginePluginData& lastData(pData->pluginsNext[pluginCount]);
+    lastData.plugin.reset();
+    carla_zeroFloats(lastData.peaks, 4);
+    lastData.timings.needsReset = true;
+}
+
+void ScopedPluginTableUpdate::removeAllPlugins() noexcept
+{
+    if (outer != nullptr)
+    {
+        outer->removeAllPlugins();
+        return;
+    }
+
+    copyTableIfNeeded();
+
+    for (uint i=0; i < pluginCount; ++i)
+    {
+        EnginePluginData& pluginData(pData->pluginsNext[i]);
+
+        pluginData.plugin.reset();
+        carla_zeroFloats(pluginData.peaks, 4);
+        pluginData.timings.needsReset = true;
+    }
+
+    pluginCount = 0;
+}
+
+void ScopedPluginTableUpdate::switchPlugins(const uint idA, const uint idB) noexcept
+{
+    if (outer != nullptr)
+    {
+        outer->switchPlugins(idA, idB);
+        return;
+    }
+
+    CARLA_SAFE_ASSERT_RETURN(idA < pluginCount,);
+    CARLA_SAFE_ASSERT_RETURN(idB < pluginCount,);
+
+    copyTableIfNeeded();
+
+    EnginePluginData& pluginDataA(pData->pluginsNext[idA]);
+    EnginePluginData& pluginDataB(pData->pluginsNext[idB]);
+
+    pluginDataA.plugin.swap(pluginDataB.plugin);
+    carla_zeroFloats(pluginDataA.peaks, 4);
+    carla_zeroFloats(pluginDataB.peaks, 4);
+    pluginDataA.timings.needsReset = true;
+    pluginDataB.timings.needsReset = true;
+}
+
+void ScopedPluginTableUpdate::copyTableIfNeeded() noexcept
+{
+    if (copied)
+        return;
+
+    copied = true;
+
+    // plugins appended so far are already in place after the current ones
+    for (uint i=0, count=pData->curPluginCount; i < count; ++i)
+    {
+        EnginePluginData& nextData(pData->pluginsNext[i]);
+        const EnginePluginData& curData(pData->plugins[i]);
+
+        nextData.plugin = curData.plugin;
+        carla_copyFloats(nextData.peaks, curData.peaks, 4);
+        nextData.timings.copyFrom(curData.timings);
+    }
+}
+
+void ScopedPluginTableUpdate::publish() noexcept
+{
+    const uint curPluginCount = pData->curPluginCount;
+
+    if (! copied)
+    {
+        if (pluginCount == curPluginCount)
+            return;
+
+        // only appends, the audio thread does not read past the current count
+        for (uint i=curPluginCount; i < pluginCount; ++i)
+        {
+            EnginePluginData& curData(pData->plugins[i]);
+            EnginePluginData& nextData(pData->pluginsNext[i]);
+
+            curData.plugin.swap(nextData.plugin);
+            nextData.plugin.reset();
+            carla_zeroFloats(curData.peaks, 4);
+            curData.timings.needsReset = true;
+        }
+
+        pData->curPluginCount = pluginCount;
+        return;
+    }
+
+    bool confirmed;
+
+    {
+        const ScopedActionLock sal(engine, kEnginePostActionSwapPlugins, 0, pluginCount);
+        confirmed = sal.wasConfirmed();
+    }
+
+    // pluginsNext now holds the old table
+    if (! confirmed)
+    {
+        EnginePluginData* newPluginsNext = nullptr;
+
+        // the audio thread might still be in a cycle using it, keep it until that cycle is done
+        try {
+            newPluginsNext = new EnginePluginData[pData->maxPluginNumber];
+
+            const CarlaMutexLocker cml(pData->pluginsToDeleteMutex);
+            pData->pluginTablesToDelete.push_back(pData->pluginsNext);
+            pData->pluginTablesMaybeInUse.store(true, std::memory_order_relaxed);
+            pData->pluginsNext = newPluginsNext;
+            return;
+        } CARLA_SAFE_EXCEPTION("ScopedPluginTableUpdate keep old table");
+
+        delete[] newPluginsNext;
+    }
+
+    for (uint i=0; i < pData->maxPluginNumber; ++i)
+        pData->pluginsNext[i].plugin.reset();
+}
+#endif
+
 // -----------------------------------------------------------------------
 // ScopedRunnerStopper
 
@@ -19,7 +19,9 @@
 #define CARLA_ENGINE_INTERNAL_HPP_INCLUDED
 
 #include "CarlaEngineRunner.hpp"
+#include "CarlaEngineThreadPlacement.hpp"
 #include "CarlaEngineUtils.hpp"
+#include "CarlaEngineWorkerPool.hpp"
 #include "CarlaPlugin.hpp"
 #include "LinkedList.hpp"
 
@@ -34,6 +36,7 @@
 # include "water/memory/Atomic.h"
 #endif
 
+#include <atomic>
 #include <vector>
 
 // FIXME only use CARLA_PREVENT_HEAP_ALLOCATION for structs
@@ -73,6 +76,7 @@ struct EngineInternalEvents {
 
 struct RackGraph;
 class PatchbayGraph;
+class ScopedPluginTableUpdate;
 
 class EngineInternalGraph
 {
@@ -102,6 +106,17 @@ public:
         return fNumAudioOuts;
     }
 
+    // buffers used by process(), audio followed by CV
+    uint32_t getNumInputBuffers() const noexcept
+    {
+        return fNumInputBuffers;
+    }
+
+    uint32_t getNumOutputBuffers() const noexcept
+    {
+        return fNumOutputBuffers;
+    }
+
     RackGraph*     getRackGraph() const noexcept;
     PatchbayGraph* getPatchbayGraph() const noexcept;
     PatchbayGraph* getPatchbayGraphOrNull() const noexcept;
@@ -127,6 +142,8 @@ public:
 private:
     bool fIsRack;
     uint32_t fNumAudioOuts;
+    uint32_t fNumInputBuffers;
+    uint32_t fNumOutputBuffers;
     volatile bool fIsReady;
 
     union {
@@ -198,8 +215,7 @@ enum EnginePostAction {
     kEnginePostActionNull = 0,
     kEnginePostActionZeroCount,    // set curPluginCount to 0
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    kEnginePostActionRemovePlugin, // remove a plugin
-    kEnginePostActionSwitchPlugins // switch between 2 plugins
+    kEnginePostActionSwapPlugins   // use the plugin table prepared by the main thread
 #endif
 };
 
@@ -213,10 +229,8 @@ const char* EnginePostAction2Str(const EnginePostAction action)
     case kEnginePostActionZeroCount:
         return "kEnginePostActionZeroCount";
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    case kEnginePostActionRemovePlugin:
-        return "kEnginePostActionRemovePlugin";
-    case kEnginePostActionSwitchPlugins:
-        return "kEnginePostActionSwitchPlugins";
+    case kEnginePostActionSwapPlugins:
+        return "kEnginePostActionSwapPlugins";
 #endif
     }
 
@@ -242,19 +256,158 @@ struct EngineNextAction {
     CARLA_DECLARE_NON_COPYABLE(EngineNextAction)
 };
 
+// -----------------------------------------------------------------------
+// EnginePluginTimings
+
+struct EnginePluginTimings {
+    // quarter-octave histogram of process times, used for percentiles
+    static const uint kNumBuckets = 128;
+
+    uint32_t count;
+    uint32_t buckets[kNumBuckets];
+    uint64_t minNs;
+    uint64_t maxNs;
+    uint64_t totalNs;
+
+    // set from the main thread, handled on the next RT update
+    volatile bool needsReset;
+
+    EnginePluginTimings() noexcept;
+    void clear() noexcept;
+    void addRT(uint64_t timeNs) noexcept;
+    void fillInfo(EnginePluginTimingInfo& info) const noexcept;
+
+    // used when preparing a new plugin table, the audio thread might still be writing into other
+    void copyFrom(const EnginePluginTimings& other) noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE(EnginePluginTimings)
+};
+
+// -----------------------------------------------------------------------
+// EngineSnapshotVersion
+
+struct EngineSnapshotVersion {
+    CarlaMutex mutex;
+    uint64_t version;
+    uint64_t* counters; // plugin change counters seen on the last update, by plugin id
+    uint count;         // number of plugins seen on the last update
+    uint size;
+
+    EngineSnapshotVersion() noexcept;
+    ~EngineSnapshotVersion() noexcept;
+
+    void init(uint maxPluginNumber);
+    void close() noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE(EngineSnapshotVersion)
+};
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+// -----------------------------------------------------------------------
+// EngineCycleStats
+
+struct EngineCycleRecord {
+    uint64_t startNs;   // monotonic time at cycle start
+    int64_t  jitterNs;  // start time deviation from the expected period
+    uint32_t frames;
+    uint32_t totalNs;   // whole engine cycle
+    uint32_t graphNs;   // internal graph, 0 if not used
+    uint32_t pluginsNs; // sum of all plugin process calls
+};
+
+struct EngineCyclePluginCost {
+    uint pluginId;
+    uint32_t timeNs;
+};
+
+struct EngineCycleSlowest {
+    // most expensive plugins kept per cycle
+    static const uint kMaxCosts = 16;
+
+    // odd while the audio thread is writing into this slot
+    water::Atomic<int> seq;
+    EngineCycleRecord record;
+    uint32_t xruns;         // engine xrun count at the end of this cycle
+    uint32_t numPlugins;    // number of plugins that ran during this cycle
+    uint32_t numCosts;      // number of valid entries in costs
+    EngineCyclePluginCost costs[kMaxCosts];
+
+    EngineCycleSlowest() noexcept;
+};
+
+struct EngineCycleStats {
+    // number of recent cycles kept, must be power of 2
+    static const uint kRingSize = 4096;
+    // same quarter-octave layout as EnginePluginTimings
+    static const uint kNumBuckets = EnginePluginTimings::kNumBuckets;
+    static const uint kNumSlowest = 16;
+    static const uint kMaxCosts = EngineCycleSlowest::kMaxCosts;
+
+    EngineCycleRecord* ring;
+    // number of records written, kept within [kRingSize, 2*kRingSize) once the ring is full
+    water::Atomic<uint32_t> ringWriteCount;
+
+    uint64_t numCycles;
+    uint64_t numOverruns; // cycles that took longer than their period
+    uint32_t totalBuckets[kNumBuckets];
+    uint32_t jitterBuckets[kNumBuckets];
+
+    EngineCycleSlowest slowest[kNumSlowest];
+
+    // set from the main thread, handled on the next RT cycle
+    volatile bool needsReset;
+
+    EngineCycleStats() noexcept;
+    ~EngineCycleStats() noexcept;
+
+    void init(uint maxPluginNumber);
+    void close() noexcept;
+
+    // RT calls, must all happen from the same thread
+    void startCycleRT(uint32_t frames, double sampleRate) noexcept;
+    void addGraphTimeRT(uint64_t timeNs) noexcept;
+    void addPluginTimeRT(uint pluginId, uint64_t timeNs) noexcept;
+    void endCycleRT(uint32_t xruns) noexcept;
+
+    // non-RT, returns false if the audio thread kept writing into the slot
+    bool copySlowest(uint index, EngineCycleSlowest& out) const noexcept;
+
+    // upper time limit of a histogram bucket, in nanoseconds
+    static uint64_t getBucketUpperLimit(uint index) noexcept;
+
+private:
+    bool inCycle;
+    uint64_t lastStartNs;
+    uint64_t periodNs;
+    uint slowestMinIndex;
+
+    EngineCycleRecord current;
+    EngineCyclePluginCost* currentCosts;
+    uint32_t currentCostsCount;
+    uint32_t currentCostsSize;
+
+    void clearRT() noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE(EngineCycleStats)
+};
+#endif
+
 // -----------------------------------------------------------------------
 // EnginePluginData
 
 struct EnginePluginData {
     CarlaPluginPtr plugin;
     float peaks[4];
+    EnginePluginTimings timings;
 
     EnginePluginData()
         : plugin(nullptr),
 #ifdef CARLA_PROPER_CPP11_SUPPORT
-          peaks{0.0f, 0.0f, 0.0f, 0.0f} {}
+          peaks{0.0f, 0.0f, 0.0f, 0.0f},
+          timings() {}
 #else
-          peaks()
+          peaks(),
+          timings()
     {
         carla_zeroStruct(peaks);
     }
@@ -266,6 +419,7 @@ struct EnginePluginData {
 
 struct CarlaEngine::ProtectedData {
     CarlaEngineRunner runner;
+    CarlaEngineWorkerPool workerPool;
 
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
     CarlaEngineOsc osc;
@@ -301,21 +455,39 @@ struct CarlaEngine::ProtectedData {
     EngineOptions  options;
     EngineTimeInfo timeInfo;
 
+    CarlaEngineThreadPlacement threadPlacement;
+
 #ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
     EnginePluginData plugins[1];
 #else
     EnginePluginData* plugins;
+    EnginePluginData* pluginsNext; // prepared by the main thread, swapped with plugins on the audio thread
+    ScopedPluginTableUpdate* pluginTableUpdate; // outermost update in progress, nested ones join it
+
+    // old tables swapped without confirmation from the audio thread, it might still be reading them
+    std::vector<EnginePluginData*> pluginTablesToDelete;
+    std::atomic<bool> pluginTablesMaybeInUse; // cleared by the audio thread at the end of each cycle (release)
     uint32_t xruns;
     float dspLoad;
+    EngineCycleStats cycleStats;
 #endif
     float peaks[4];
 
+    // last time the host read plugin peaks, see arePeaksInUse()
+    water::Atomic<uint32_t> peaksReadTime;
+
+    EngineSnapshotVersion snapshotVersion;
+
     CarlaMutex pluginsToDeleteMutex;
     std::vector<CarlaPluginPtr> pluginsToDelete;
 
     EngineInternalEvents events;
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     EngineInternalGraph  graph;
+
+    // held by CarlaEngine::renderOffline() while it runs the graph, driver callbacks skip their cycle meanwhile
+    CarlaMutex renderMutex;
+    volatile bool isRendering;
 #endif
     EngineInternalTime   time;
     EngineNextAction     nextAction;
@@ -335,11 +507,18 @@ struct CarlaEngine::ProtectedData {
     // -------------------------------------------------------------------
 
     void deletePluginsAsNeeded();
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    void deletePluginTablesAsNeeded(bool force);
+#endif
+
+    // -------------------------------------------------------------------
+
+    // peaks are in use while the host keeps reading them, plugins are processed meanwhile even if unconnected
+    void setPeaksRead() noexcept;
+    bool arePeaksInUse() const noexcept;
 
     // -------------------------------------------------------------------
 
-    void doPluginRemove(uint pluginId) noexcept;
-    void doPluginsSwitch(uint idA, uint idB) noexcept;
     void doNextPluginAction() noexcept;
 
     // -------------------------------------------------------------------
@@ -376,8 +555,12 @@ public:
     ScopedActionLock(CarlaEngine* engine, EnginePostAction action, uint pluginId, uint value) noexcept;
     ~ScopedActionLock() noexcept;
 
+    // true if the action was done by the audio thread, or directly because the engine was not running
+    bool wasConfirmed() const noexcept { return confirmed; }
+
 private:
     CarlaEngine::ProtectedData* const pData;
+    bool confirmed;
 
     CARLA_PREVENT_HEAP_ALLOCATION
     CARLA_DECLARE_NON_COPYABLE(ScopedActionLock)
@@ -385,6 +568,46 @@ private:
 
 // -----------------------------------------------------------------------
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+/*!
+ * Changes to the plugin list, done on a copy of the current plugin table.
+ * The audio thread keeps using the current table until the new one is published on destruction,
+ * which happens between audio cycles in a single step.
+ * Updates created while another one is in progress join it, so all their changes are published together
+ * by the outermost update, with a single wait for the audio thread.
+ * Updates that only append plugins are published without waiting, the audio thread does not read past the count.
+ * The old table is recycled once the audio thread confirms the swap, otherwise it is kept until its next cycle.
+ */
+class ScopedPluginTableUpdate
+{
+public:
+    ScopedPluginTableUpdate(CarlaEngine* engine) noexcept;
+    ~ScopedPluginTableUpdate() noexcept;
+
+    // returns the id of the new plugin
+    uint addPlugin(const CarlaPluginPtr& plugin) noexcept;
+    void replacePlugin(uint id, const CarlaPluginPtr& plugin) noexcept;
+    void removePlugin(uint id) noexcept;
+    void removeAllPlugins() noexcept;
+    void switchPlugins(uint idA, uint idB) noexcept;
+
+private:
+    CarlaEngine* const engine;
+    CarlaEngine::ProtectedData* const pData;
+    ScopedPluginTableUpdate* const outer;
+    uint pluginCount;
+    bool copied; // pluginsNext holds the whole table, not only appended plugins
+
+    void copyTableIfNeeded() noexcept;
+    void publish() noexcept;
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPYABLE(ScopedPluginTableUpdate)
+};
+
+// -----------------------------------------------------------------------
+#endif
+
 class ScopedRunnerStopper
 {
 public:
@@ -26,6 +26,7 @@
 #include "CarlaMIDI.h"
 #include "CarlaPatchbayUtils.hpp"
 #include "CarlaStringList.hpp"
+#include "CarlaTimeUtils.hpp"
 
 #include "jackey.h"
 
@@ -1749,7 +1750,11 @@ public:
 
     bool isOffline() const noexcept override
     {
+#ifndef BUILD_BRIDGE
+        return fFreewheel || pData->isRendering;
+#else
         return fFreewheel;
+#endif
     }
 
     EngineType getType() const noexcept override
@@ -2856,6 +2861,25 @@ protected:
 
     void handleJackProcessCallback(const uint32_t nframes)
     {
+#ifndef BUILD_BRIDGE
+        // renderOffline() is running the graph on another thread, only possible in rack and patchbay modes
+        const CarlaMutexTryLocker cmtl(pData->renderMutex);
+
+        if (! cmtl.wasLocked())
+        {
+            for (uint i=kRackPortAudioOut1; i <= kRackPortAudioOut2; ++i)
+            {
+                if (float* const audioOut = (float*)jackbridge_port_get_buffer(fRackPorts[i], nframes))
+                    carla_zeroFloats(audioOut, nframes);
+            }
+
+            if (void* const eventOut = jackbridge_port_get_buffer(fRackPorts[kRackPortEventOut], nframes))
+                jackbridge_midi_clear_buffer(eventOut);
+
+            return;
+        }
+#endif
+
         const PendingRtEventsRunner prt(this, nframes);
 
         CARLA_SAFE_ASSERT_INT2_RETURN(nframes == pData->bufferSize, nframes, pData->bufferSize,);
@@ -3128,6 +3152,12 @@ protected:
 #ifndef BUILD_BRIDGE
     void handleJackTimebaseCallback(jack_nframes_t nframes, jack_position_t* const pos, const int new_pos)
     {
+        // engine time belongs to renderOffline() right now
+        const CarlaMutexTryLocker cmtl(pData->renderMutex);
+
+        if (! cmtl.wasLocked())
+            return;
+
         if (new_pos)
             pData->time.setNeedsReset();
 
@@ -4139,8 +4169,12 @@ private:
             }
         }
 
+        const uint64_t startTime = carla_gettime_ns();
+
         plugin->process(audioIn, audioOut, cvIn, cvOut, nframes);
 
+        addPluginTimingRT(plugin->getId(), carla_gettime_ns() - startTime);
+
         for (uint32_t i=0; i < audioOutCount && i < 2; ++i)
         {
             for (uint32_t j=0; j < nframes; ++j)
@@ -313,7 +313,7 @@ public:
 
     bool isOffline() const noexcept override
     {
-        return false;
+        return pData->isRendering;
     }
 
     EngineType getType() const noexcept override
@@ -606,6 +606,20 @@ protected:
         CARLA_SAFE_ASSERT_RETURN(numSamples >= 0,);
 
         const uint32_t nframes(static_cast<uint32_t>(numSamples));
+
+        // renderOffline() is running the graph on another thread
+        const CarlaMutexTryLocker cmtl(pData->renderMutex);
+
+        if (! cmtl.wasLocked())
+        {
+            if (outputChannelData != nullptr)
+            {
+                for (int i=0; i < numOutputChannels; ++i)
+                    carla_zeroFloats(outputChannelData[i], nframes);
+            }
+            return;
+        }
+
         const PendingRtEventsRunner prt(this, nframes, true); // FIXME remove dspCalc after updating juce
 
         // assert juce buffers
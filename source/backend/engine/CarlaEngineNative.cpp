@@ -409,6 +409,20 @@ public:
 protected:
     // -------------------------------------------------------------------
 
+    // the plugin host drives processing and transport, there is no way to render ahead of it
+    bool renderOffline(CarlaEngineRenderWriter* const writer, const char* const name,
+                       const uint64_t startFrame, const uint64_t numFrames) override
+    {
+        // unused
+        (void)writer;
+        (void)name;
+        (void)startFrame;
+        (void)numFrames;
+
+        setLastError("Offline rendering is not possible while running as a plugin");
+        return false;
+    }
+
     void bufferSizeChanged(const uint32_t newBufferSize)
     {
         if (pData->bufferSize == newBufferSize)
@@ -1315,6 +1329,7 @@ protected:
                         if (plugin->getHints() & PLUGIN_HAS_CUSTOM_UI)
                         {
                             try {
+                                plugin->setCustomUIShown(false);
                                 plugin->showCustomUI(false);
                             } CARLA_SAFE_EXCEPTION_CONTINUE("Plugin showCustomUI (hide)");
                         }
@@ -1475,6 +1490,8 @@ protected:
         // ------------------------------------------------------------------------------------------------------------
         // send peaks and param outputs for all plugins
 
+        pData->setPeaksRead();
+
         for (uint i=0; i < pData->curPluginCount; ++i)
         {
             const EnginePluginData& plugData(pData->plugins[i]);
@@ -1855,6 +1872,10 @@ bool CarlaEngineNativeUI::msgReceived(const char* const msg) noexcept
     {
         fEngine->clearXruns();
     }
+    else if (std::strcmp(msg, "clear_plugin_timings") == 0)
+    {
+        fEngine->clearPluginTimings();
+    }
     else if (std::strcmp(msg, "cancel_engine_action") == 0)
     {
         fEngine->setActionCanceled(true);
@@ -2112,6 +2133,17 @@ bool CarlaEngineNativeUI::msgReceived(const char* const msg) noexcept
         if (const CarlaPluginPtr plugin = fEngine->getPlugin(pluginId))
             plugin->setActive(onOff, true, false);
     }
+    else if (std::strcmp(msg, "set_plugin_tail_samples") == 0)
+    {
+        uint32_t pluginId;
+        int32_t samples;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(pluginId), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsInt(samples), true);
+
+        if (const CarlaPluginPtr plugin = fEngine->getPlugin(pluginId))
+            plugin->setUserTailSamples(samples);
+    }
     else if (std::strcmp(msg, "set_drywet") == 0)
     {
         uint32_t pluginId;
@@ -2366,7 +2398,10 @@ bool CarlaEngineNativeUI::msgReceived(const char* const msg) noexcept
         CARLA_SAFE_ASSERT_RETURN(readNextLineAsBool(yesNo), true);
 
         if (const CarlaPluginPtr plugin = fEngine->getPlugin(pluginId))
+        {
+            plugin->setCustomUIShown(yesNo);
             plugin->showCustomUI(yesNo);
+        }
     }
     else
     {
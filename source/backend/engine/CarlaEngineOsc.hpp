@@ -117,6 +117,7 @@ public:
     void sendRuntimeInfo() const noexcept;
     void sendParameterValue(uint pluginId, uint32_t index, float value) const noexcept;
     void sendPeaks(uint pluginId, const float peaks[4]) const noexcept;
+    void sendPluginTimings(uint pluginId, const EnginePluginTimingInfo& info) const noexcept;
 
     // -------------------------------------------------------------------
 
@@ -399,6 +399,23 @@ void CarlaEngineOsc::sendPeaks(const uint pluginId, const float peaks[4]) const
                 static_cast<double>(peaks[3]));
 }
 
+void CarlaEngineOsc::sendPluginTimings(const uint pluginId, const EnginePluginTimingInfo& info) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.path != nullptr && fControlDataUDP.path[0] != '\0',);
+    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.target != nullptr,);
+
+    char targetPath[std::strlen(fControlDataUDP.path)+9];
+    std::strcpy(targetPath, fControlDataUDP.path);
+    std::strcat(targetPath, "/timings");
+    try_lo_send(fControlDataUDP.target, targetPath, "iifffff", static_cast<int32_t>(pluginId),
+                static_cast<int32_t>(info.cycles),
+                static_cast<double>(info.min),
+                static_cast<double>(info.avg),
+                static_cast<double>(info.max),
+                static_cast<double>(info.p95),
+                static_cast<double>(info.p99));
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
@@ -150,7 +150,7 @@ void CarlaEngineEventPort::initBuffer() noexcept
     if (kProcessMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK || kProcessMode == ENGINE_PROCESS_MODE_BRIDGE)
         fBuffer = kClient.getEngine().getInternalEventBuffer(kIsInput);
     else if (kProcessMode == ENGINE_PROCESS_MODE_PATCHBAY && ! kIsInput)
-        carla_zeroStructs(fBuffer, kMaxEngineEventInternalCount);
+        clearUsedEngineEvents(fBuffer);
 }
 
 uint32_t CarlaEngineEventPort::getEventCount() const noexcept
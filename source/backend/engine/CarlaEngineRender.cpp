@@ -0,0 +1,425 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineRender.hpp"
+#include "CarlaMathUtils.hpp"
+
+#include "water/files/File.h"
+#include "water/files/FileOutputStream.h"
+#include "water/memory/ByteOrder.h"
+
+#ifdef HAVE_SNDFILE
+# include <sndfile.h>
+#endif
+
+CARLA_BACKEND_START_NAMESPACE
+
+using water::ByteOrder;
+using water::CharPointer_UTF8;
+using water::File;
+using water::FileOutputStream;
+using water::String;
+
+// -----------------------------------------------------------------------
+
+// float WAV header, using the extended 18 byte fmt chunk plus a fact chunk
+static const int64_t kWavRiffSizeOffset  = 4;
+static const int64_t kWavFactFramesOffset = 46;
+static const int64_t kWavDataSizeOffset  = 54;
+static const int64_t kWavHeaderSize      = 58;
+
+// -----------------------------------------------------------------------
+// CarlaEngineRenderWriter
+
+CarlaEngineRenderWriter::CarlaEngineRenderWriter() noexcept
+    : CarlaThread("CarlaEngineRenderWriter"),
+      fFormat(kFormatWav),
+      fNumChannels(0),
+      fBufferSize(0),
+      fSampleRate(0),
+      fFramesWritten(0),
+      fFilename(),
+      fError(nullptr),
+      fFileStream(nullptr),
+#ifdef HAVE_SNDFILE
+      fSndFile(nullptr),
+#endif
+      fBlockData(nullptr),
+      fBlockPtrs(nullptr),
+      fInterleaved(nullptr),
+      fNumCommitted(0),
+      fNumWritten(0),
+      fBlockReady(),
+      fBlockFreed(),
+      fFailed(false),
+      fFinishing(false)
+{
+    carla_zeroStructs(fBlockFrames, kNumBlocks);
+}
+
+CarlaEngineRenderWriter::~CarlaEngineRenderWriter() noexcept
+{
+    CARLA_SAFE_ASSERT(! isThreadRunning());
+
+    freeResources();
+}
+
+bool CarlaEngineRenderWriter::open(const char* const filename,
+                                   const uint32_t numChannels,
+                                   const uint32_t bufferSize,
+                                   const double sampleRate,
+                                   const uint64_t numFrames)
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(numChannels > 0, false);
+    CARLA_SAFE_ASSERT_RETURN(bufferSize > 0, false);
+    CARLA_SAFE_ASSERT_RETURN(sampleRate > 0.0, false);
+    CARLA_SAFE_ASSERT_RETURN(fBlockData == nullptr, false);
+    carla_debug("CarlaEngineRenderWriter::open(\"%s\", %u, %u, %f, " P_UINT64 ")",
+                filename, numChannels, bufferSize, sampleRate, numFrames);
+
+    const String jfilename = String(CharPointer_UTF8(filename));
+    const File file(jfilename);
+    const String extension(file.getFileExtension().toLowerCase());
+
+    if (extension == ".wav")
+    {
+        // plain RIFF uses 32-bit sizes
+        if (numFrames * numChannels * sizeof(float) > 0xffffffffULL - kWavHeaderSize)
+        {
+            fError = "Requested length is too big for a WAV file";
+            return false;
+        }
+
+        fFormat = kFormatWav;
+    }
+    else if (extension == ".flac")
+    {
+#ifdef HAVE_SNDFILE
+        fFormat = kFormatFlac;
+#else
+        fError = "FLAC output is not available in this build";
+        return false;
+#endif
+    }
+    else
+    {
+        fError = "Unsupported file format, use a .wav or .flac extension";
+        return false;
+    }
+
+    fNumChannels   = numChannels;
+    fBufferSize    = bufferSize;
+    fSampleRate    = static_cast<uint32_t>(sampleRate + 0.5);
+    fFramesWritten = 0;
+    fFilename      = filename;
+    fFailed        = false;
+    fFinishing     = false;
+    fNumCommitted.set(0);
+    fNumWritten.set(0);
+
+    try {
+        fBlockData   = new float[kNumBlocks * numChannels * bufferSize];
+        fBlockPtrs   = new float*[kNumBlocks * numChannels];
+        fInterleaved = new float[numChannels * bufferSize];
+    } CARLA_SAFE_EXCEPTION_RETURN("CarlaEngineRenderWriter::open", false);
+
+    for (uint32_t i=0; i < kNumBlocks * numChannels; ++i)
+        fBlockPtrs[i] = fBlockData + i * bufferSize;
+
+    switch (fFormat)
+    {
+    case kFormatWav:
+        if (file.existsAsFile() && ! file.deleteFile())
+        {
+            fError = "Failed to replace existing file";
+            freeResources();
+            return false;
+        }
+
+        fFileStream = new FileOutputStream(file, 65536);
+
+        if (fFileStream->failedToOpen() || ! writeWavHeader())
+        {
+            fError = "Failed to create file";
+            freeResources();
+            return false;
+        }
+        break;
+
+    case kFormatFlac:
+#ifdef HAVE_SNDFILE
+    {
+        SF_INFO info;
+        carla_zeroStruct(info);
+        info.samplerate = static_cast<int>(fSampleRate);
+        info.channels   = static_cast<int>(numChannels);
+        info.format     = SF_FORMAT_FLAC | SF_FORMAT_PCM_24;
+
+        SNDFILE* const sndfile = sf_open(filename, SFM_WRITE, &info);
+
+        if (sndfile == nullptr)
+        {
+            fError = "Failed to create file";
+            freeResources();
+            return false;
+        }
+
+        sf_command(sndfile, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+        fSndFile = sndfile;
+    }
+#endif
+        break;
+    }
+
+    if (! startThread())
+    {
+        fError = "Failed to start writer thread";
+        close(true);
+        return false;
+    }
+
+    return true;
+}
+
+bool CarlaEngineRenderWriter::close(const bool discard)
+{
+    carla_debug("CarlaEngineRenderWriter::close(%s)", bool2str(discard));
+
+    fFinishing = true;
+    fBlockReady.signal();
+    stopThread(-1);
+
+    bool ok = ! fFailed;
+
+    if (fFileStream != nullptr)
+    {
+        if (ok && ! discard && ! finalizeWavHeader())
+        {
+            fError = "Failed to write file";
+            ok = false;
+        }
+
+        delete fFileStream;
+        fFileStream = nullptr;
+    }
+
+#ifdef HAVE_SNDFILE
+    if (fSndFile != nullptr)
+    {
+        if (sf_close(static_cast<SNDFILE*>(fSndFile)) != 0 && ok)
+        {
+            fError = "Failed to write file";
+            ok = false;
+        }
+
+        fSndFile = nullptr;
+    }
+#endif
+
+    if (discard || ! ok)
+    {
+        const String jfilename = String(CharPointer_UTF8(fFilename.buffer()));
+        File(jfilename).deleteFile();
+    }
+
+    freeResources();
+    return ok;
+}
+
+float* const* CarlaEngineRenderWriter::getNextBlock() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fBlockPtrs != nullptr, nullptr);
+
+    for (;;)
+    {
+        if (fFailed)
+        {
+            fError = "Failed to write file";
+            return nullptr;
+        }
+
+        const uint32_t committed = static_cast<uint32_t>(fNumCommitted.get());
+        const uint32_t written   = static_cast<uint32_t>(fNumWritten.get());
+
+        if (committed - written < kNumBlocks)
+            return fBlockPtrs + (committed % kNumBlocks) * fNumChannels;
+
+        fBlockFreed.wait();
+    }
+}
+
+void CarlaEngineRenderWriter::commitBlock(const uint32_t frames) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(frames <= fBufferSize,);
+
+    fBlockFrames[static_cast<uint32_t>(fNumCommitted.get()) % kNumBlocks] = frames;
+    ++fNumCommitted;
+    fBlockReady.signal();
+}
+
+const char* CarlaEngineRenderWriter::getError() const noexcept
+{
+    return fError != nullptr ? fError : "Unknown error";
+}
+
+// -----------------------------------------------------------------------
+
+void CarlaEngineRenderWriter::run()
+{
+    for (;;)
+    {
+        const uint32_t written = static_cast<uint32_t>(fNumWritten.get());
+
+        if (written == static_cast<uint32_t>(fNumCommitted.get()))
+        {
+            if (fFinishing)
+                break;
+
+            fBlockReady.wait();
+            continue;
+        }
+
+        // keep consuming blocks after a failure, so the render side never blocks forever
+        if (! fFailed && ! writeBlock(written % kNumBlocks))
+            fFailed = true;
+
+        ++fNumWritten;
+        fBlockFreed.signal();
+    }
+}
+
+bool CarlaEngineRenderWriter::writeBlock(const uint32_t index) noexcept
+{
+    const uint32_t frames = fBlockFrames[index];
+    float* const* const block = fBlockPtrs + index * fNumChannels;
+
+    if (frames == 0)
+        return true;
+
+    for (uint32_t c=0; c < fNumChannels; ++c)
+    {
+        const float* const src = block[c];
+
+        for (uint32_t i=0; i < frames; ++i)
+            fInterleaved[i * fNumChannels + c] = src[i];
+    }
+
+    switch (fFormat)
+    {
+    case kFormatWav: {
+        // WAV data is little-endian, this is a no-op on most systems
+        uint32_t* const ints = reinterpret_cast<uint32_t*>(fInterleaved);
+
+        for (uint32_t i=0, count=frames * fNumChannels; i < count; ++i)
+            ints[i] = ByteOrder::swapIfBigEndian(ints[i]);
+
+        if (! fFileStream->write(fInterleaved, frames * fNumChannels * sizeof(float)))
+            return false;
+        break;
+    }
+
+    case kFormatFlac:
+#ifdef HAVE_SNDFILE
+        if (sf_writef_float(static_cast<SNDFILE*>(fSndFile), fInterleaved, frames) != static_cast<sf_count_t>(frames))
+            return false;
+#endif
+        break;
+    }
+
+    fFramesWritten += frames;
+    return true;
+}
+
+bool CarlaEngineRenderWriter::writeWavHeader() noexcept
+{
+    FileOutputStream& out(*fFileStream);
+
+    const uint32_t blockAlign = fNumChannels * sizeof(float);
+
+    bool ok = out.write("RIFF", 4);
+    ok = ok && out.writeInt(0);
+    ok = ok && out.write("WAVE", 4);
+
+    ok = ok && out.write("fmt ", 4);
+    ok = ok && out.writeInt(18);
+    ok = ok && out.writeShort(3); // WAVE_FORMAT_IEEE_FLOAT
+    ok = ok && out.writeShort(static_cast<short>(fNumChannels));
+    ok = ok && out.writeInt(static_cast<int>(fSampleRate));
+    ok = ok && out.writeInt(static_cast<int>(fSampleRate * blockAlign));
+    ok = ok && out.writeShort(static_cast<short>(blockAlign));
+    ok = ok && out.writeShort(32);
+    ok = ok && out.writeShort(0);
+
+    ok = ok && out.write("fact", 4);
+    ok = ok && out.writeInt(4);
+    ok = ok && out.writeInt(0);
+
+    ok = ok && out.write("data", 4);
+    ok = ok && out.writeInt(0);
+
+    CARLA_SAFE_ASSERT_RETURN(out.getPosition() == kWavHeaderSize, false);
+    return ok;
+}
+
+bool CarlaEngineRenderWriter::finalizeWavHeader() noexcept
+{
+    FileOutputStream& out(*fFileStream);
+
+    const uint32_t dataSize = static_cast<uint32_t>(fFramesWritten * fNumChannels * sizeof(float));
+
+    bool ok = out.setPosition(kWavRiffSizeOffset);
+    ok = ok && out.writeInt(static_cast<int>(dataSize + kWavHeaderSize - 8));
+    ok = ok && out.setPosition(kWavFactFramesOffset);
+    ok = ok && out.writeInt(static_cast<int>(fFramesWritten));
+    ok = ok && out.setPosition(kWavDataSizeOffset);
+    ok = ok && out.writeInt(static_cast<int>(dataSize));
+
+    if (! ok)
+        return false;
+
+    out.flush();
+    return out.getStatus().wasOk();
+}
+
+void CarlaEngineRenderWriter::freeResources() noexcept
+{
+    if (fFileStream != nullptr)
+    {
+        delete fFileStream;
+        fFileStream = nullptr;
+    }
+
+#ifdef HAVE_SNDFILE
+    if (fSndFile != nullptr)
+    {
+        sf_close(static_cast<SNDFILE*>(fSndFile));
+        fSndFile = nullptr;
+    }
+#endif
+
+    delete[] fBlockData;
+    delete[] fBlockPtrs;
+    delete[] fInterleaved;
+    fBlockData   = nullptr;
+    fBlockPtrs   = nullptr;
+    fInterleaved = nullptr;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
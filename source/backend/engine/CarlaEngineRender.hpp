@@ -0,0 +1,133 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_RENDER_HPP_INCLUDED
+#define CARLA_ENGINE_RENDER_HPP_INCLUDED
+
+#include "CarlaBackend.h"
+#include "CarlaMutex.hpp"
+#include "CarlaString.hpp"
+#include "CarlaThread.hpp"
+
+#include "CarlaJuceUtils.hpp"
+
+#include "water/memory/Atomic.h"
+
+namespace water {
+class FileOutputStream;
+}
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineRenderWriter
+
+/*!
+ * Writes rendered audio into a file from a background thread.
+ * The render side asks for a free block, fills it with non-interleaved audio and commits it,
+ * the writer thread interleaves and encodes committed blocks in order.
+ * When all blocks are in use the render side waits for the writer, so memory usage stays fixed.
+ *
+ * Supported formats are 32-bit float WAV and, when built with libsndfile, 24-bit FLAC.
+ * The format is chosen from the file extension.
+ */
+class CarlaEngineRenderWriter : public CarlaThread
+{
+public:
+    static const uint32_t kNumBlocks = 32;
+
+    CarlaEngineRenderWriter() noexcept;
+    ~CarlaEngineRenderWriter() noexcept override;
+
+    /*!
+     * Create the file and start the writer thread.
+     * @a numFrames is only used for validating the output size.
+     */
+    bool open(const char* filename, uint32_t numChannels, uint32_t bufferSize, double sampleRate, uint64_t numFrames);
+
+    /*!
+     * Stop the writer thread after all pending blocks are written, and finalize the file.
+     * The file is deleted if @a discard is true.
+     */
+    bool close(bool discard);
+
+    /*!
+     * Get the next free block, waiting for the writer thread if needed.
+     * Returns null if writing to disk has failed.
+     */
+    float* const* getNextBlock() noexcept;
+
+    /*!
+     * Queue the block returned by getNextBlock() for writing, with @a frames as its valid length.
+     */
+    void commitBlock(uint32_t frames) noexcept;
+
+    /*!
+     * Get the error message from the last failed operation.
+     */
+    const char* getError() const noexcept;
+
+protected:
+    void run() override;
+
+private:
+    enum Format {
+        kFormatWav,
+        kFormatFlac
+    };
+
+    Format   fFormat;
+    uint32_t fNumChannels;
+    uint32_t fBufferSize;
+    uint32_t fSampleRate;
+    uint64_t fFramesWritten;
+    CarlaString fFilename;
+    const char* fError;
+
+    water::FileOutputStream* fFileStream;
+#ifdef HAVE_SNDFILE
+    void* fSndFile;
+#endif
+
+    float*   fBlockData;
+    float**  fBlockPtrs;
+    uint32_t fBlockFrames[kNumBlocks];
+    float*   fInterleaved;
+
+    // block counters, only increased by render and writer thread respectively
+    water::Atomic<int> fNumCommitted;
+    water::Atomic<int> fNumWritten;
+
+    CarlaSignal fBlockReady;
+    CarlaSignal fBlockFreed;
+
+    volatile bool fFailed;
+    volatile bool fFinishing;
+
+    bool writeBlock(uint32_t index) noexcept;
+    bool writeWavHeader() noexcept;
+    bool finalizeWavHeader() noexcept;
+    void freeResources() noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineRenderWriter)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_RENDER_HPP_INCLUDED
@@ -454,7 +454,7 @@ public:
 
     bool isOffline() const noexcept override
     {
-        return false;
+        return pData->isRendering;
     }
 
     EngineType getType() const noexcept override
@@ -626,6 +626,16 @@ protected:
     void handleAudioProcessCallback(void* outputBuffer, void* inputBuffer,
                                     uint nframes, double streamTime, RtAudioStreamStatus status)
     {
+        // renderOffline() is running the graph on another thread
+        const CarlaMutexTryLocker cmtl(pData->renderMutex);
+
+        if (! cmtl.wasLocked())
+        {
+            if (outputBuffer != nullptr)
+                carla_zeroFloats((float*)outputBuffer, nframes*fAudioOutCount);
+            return;
+        }
+
         const PendingRtEventsRunner prt(this, nframes, true);
 
         if (status & RTAUDIO_INPUT_OVERFLOW)
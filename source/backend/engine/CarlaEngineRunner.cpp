@@ -66,11 +66,14 @@ bool CarlaEngineRunner::run() noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(kEngine != nullptr, false);
 
+    kEngine->pData->threadPlacement.applyToCurrentThreadOnce(ENGINE_THREAD_IDLE);
+
     float value;
 
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
     // int64_t lastPingTime = 0;
     const CarlaEngineOsc& engineOsc(kEngine->pData->osc);
+    EnginePluginTimingInfo timingInfo;
 #endif
 
     // runner must do something...
@@ -146,7 +149,12 @@ bool CarlaEngineRunner::run() noexcept
         // Update OSC control client peaks
 
         if (oscRegistedForUDP)
+        {
             engineOsc.sendPeaks(i, kEngine->getPeaks(i));
+
+            kEngine->getPluginTimingInfo(i, timingInfo);
+            engineOsc.sendPluginTimings(i, timingInfo);
+        }
 #endif
     }
 
@@ -245,7 +245,7 @@ public:
 
     bool isOffline() const noexcept override
     {
-        return false;
+        return pData->isRendering;
     }
 
     EngineType getType() const noexcept override
@@ -336,6 +336,15 @@ protected:
         const uint ulen = static_cast<uint>(static_cast<uint>(len) / sizeof(int16_t) / fAudioOutCount);
 #endif
 
+        // renderOffline() is running the graph on another thread
+        const CarlaMutexTryLocker cmtl(pData->renderMutex);
+
+        if (! cmtl.wasLocked())
+        {
+            std::memset(stream, 0, static_cast<std::size_t>(len));
+            return;
+        }
+
         const PendingRtEventsRunner prt(this, ulen, true);
 
         // init our deinterleaved audio buffers
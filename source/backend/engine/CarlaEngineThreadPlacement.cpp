@@ -0,0 +1,449 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineThreadPlacement.hpp"
+
+#include "water/streams/MemoryOutputStream.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef CARLA_OS_LINUX
+# include <sched.h>
+#endif
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static const char* const kThreadClassNames[ENGINE_THREAD_CLASS_COUNT] = {
+    "audio",
+    "worker",
+    "idle",
+    "bridge",
+};
+
+static bool isCpuInSet(const CarlaEngineThreadPlacement::CpuSet& set, const uint cpu) noexcept
+{
+    return (set.bits[cpu / 64] & (1ULL << (cpu % 64))) != 0;
+}
+
+static void addCpuToSet(CarlaEngineThreadPlacement::CpuSet& set, const uint cpu) noexcept
+{
+    set.bits[cpu / 64] |= 1ULL << (cpu % 64);
+}
+
+static void writeCpuSet(water::MemoryOutputStream& outStream, const CarlaEngineThreadPlacement::CpuSet& set)
+{
+    bool first = true;
+
+    for (uint cpu = 0; cpu < CarlaEngineThreadPlacement::kMaxCPUs; ++cpu)
+    {
+        if (! isCpuInSet(set, cpu))
+            continue;
+
+        uint last = cpu;
+
+        while (last + 1 < CarlaEngineThreadPlacement::kMaxCPUs && isCpuInSet(set, last + 1))
+            ++last;
+
+        if (! first)
+            outStream << ",";
+
+        outStream << static_cast<int>(cpu);
+
+        if (last != cpu)
+            outStream << "-" << static_cast<int>(last);
+
+        first = false;
+        cpu = last;
+    }
+}
+
+static const char* getPolicyName(const int policy) noexcept
+{
+#if defined(CARLA_OS_WIN) || defined(CARLA_OS_HAIKU)
+    return policy == 0 ? "other" : "realtime";
+#else
+    switch (policy)
+    {
+    case SCHED_OTHER:
+        return "other";
+    case SCHED_FIFO:
+        return "fifo";
+    case SCHED_RR:
+        return "rr";
+    }
+
+    return "unknown";
+#endif
+}
+
+// -----------------------------------------------------------------------
+
+CarlaEngineThreadPlacement::Status::Status() noexcept
+    : seq(0),
+      applied(false),
+      thread(),
+      hasCpuSet(false),
+      cpuSet(),
+      policy(0),
+      priority(0),
+      error(0),
+      errorStep(nullptr) {}
+
+CarlaEngineThreadPlacement::CarlaEngineThreadPlacement(const EngineOptions& options) noexcept
+    : kOptions(options) {}
+
+bool CarlaEngineThreadPlacement::parseCpuSet(const char* str, CpuSet& set) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(str != nullptr, false);
+
+    carla_zeroStruct(set);
+
+    for (;;)
+    {
+        while (*str == ' ')
+            ++str;
+
+        if (*str < '0' || *str > '9')
+            return false;
+
+        char* end = nullptr;
+        const ulong first = std::strtoul(str, &end, 10);
+        ulong last = first;
+        str = end;
+
+        if (*str == '-')
+        {
+            ++str;
+
+            if (*str < '0' || *str > '9')
+                return false;
+
+            last = std::strtoul(str, &end, 10);
+            str = end;
+        }
+
+        if (last < first || last >= kMaxCPUs)
+            return false;
+
+        for (ulong cpu = first; cpu <= last; ++cpu)
+            addCpuToSet(set, static_cast<uint>(cpu));
+
+        while (*str == ' ')
+            ++str;
+
+        if (*str == '\0')
+            return true;
+        if (*str != ',')
+            return false;
+
+        ++str;
+    }
+}
+
+void CarlaEngineThreadPlacement::applyToCurrentThread(const EngineThreadClass threadClass) noexcept
+{
+    apply(threadClass, false);
+}
+
+void CarlaEngineThreadPlacement::applyToCurrentThreadOnce(const EngineThreadClass threadClass) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(threadClass < ENGINE_THREAD_CLASS_COUNT,);
+
+    const Status& status(fStatus[threadClass]);
+
+    if (status.applied && pthread_equal(status.thread, pthread_self()))
+        return;
+
+    apply(threadClass, false);
+}
+
+void CarlaEngineThreadPlacement::applyToProcess(const EngineThreadClass threadClass) noexcept
+{
+    apply(threadClass, true);
+}
+
+void CarlaEngineThreadPlacement::reset() noexcept
+{
+    for (uint i=0; i < ENGINE_THREAD_CLASS_COUNT; ++i)
+    {
+        Status& status(fStatus[i]);
+
+        ++status.seq;
+        status.applied = false;
+        ++status.seq;
+    }
+}
+
+void CarlaEngineThreadPlacement::apply(const EngineThreadClass threadClass, const bool wholeProcess) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(threadClass < ENGINE_THREAD_CLASS_COUNT,);
+
+    const char* const cpuSetStr = kOptions.threadCpuSets[threadClass];
+    const int requestedPriority = kOptions.threadPriorities[threadClass];
+
+    Status& status(fStatus[threadClass]);
+
+    ++status.seq;
+
+    status.applied = true;
+    status.thread = pthread_self();
+    status.hasCpuSet = false;
+    status.error = 0;
+    status.errorStep = nullptr;
+
+    // CPU set
+
+    CpuSet requested;
+
+    if (cpuSetStr != nullptr && ! parseCpuSet(cpuSetStr, requested))
+    {
+        status.error = EINVAL;
+        status.errorStep = "cpu set";
+    }
+    else if (cpuSetStr != nullptr)
+    {
+       #if defined(CARLA_OS_WIN)
+        const DWORD_PTR mask = static_cast<DWORD_PTR>(requested.bits[0]);
+        const bool ok = wholeProcess ? SetProcessAffinityMask(GetCurrentProcess(), mask) != FALSE
+                                     : SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+
+        if (! ok)
+        {
+            status.error = static_cast<int>(GetLastError());
+            status.errorStep = "cpu set";
+        }
+       #elif defined(CARLA_OS_LINUX)
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+
+        for (uint cpu = 0; cpu < kMaxCPUs && cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (isCpuInSet(requested, cpu))
+                CPU_SET(cpu, &cpuset);
+        }
+
+        // new threads inherit the CPU set of their creator, so this also covers the process case
+        if (const int err = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset))
+        {
+            status.error = err;
+            status.errorStep = "cpu set";
+        }
+       #else
+        status.error = ENOTSUP;
+        status.errorStep = "cpu set";
+       #endif
+    }
+
+    // priority
+
+    if (requestedPriority >= 0)
+    {
+       #if defined(CARLA_OS_WIN)
+        if (SetThreadPriority(GetCurrentThread(), requestedPriority > 0 ? THREAD_PRIORITY_TIME_CRITICAL
+                                                                        : THREAD_PRIORITY_NORMAL) == FALSE
+            && status.error == 0)
+        {
+            status.error = static_cast<int>(GetLastError());
+            status.errorStep = "priority";
+        }
+       #elif defined(CARLA_OS_HAIKU)
+        if (status.error == 0)
+        {
+            status.error = ENOTSUP;
+            status.errorStep = "priority";
+        }
+       #else
+        struct sched_param param;
+        carla_zeroStruct(param);
+
+        int policy = SCHED_OTHER;
+
+        if (requestedPriority > 0)
+        {
+            policy = SCHED_FIFO;
+            param.sched_priority = std::max(sched_get_priority_min(SCHED_FIFO),
+                                            std::min(requestedPriority, sched_get_priority_max(SCHED_FIFO)));
+        }
+
+        const int err = pthread_setschedparam(pthread_self(), policy, &param);
+
+        if (err != 0 && status.error == 0)
+        {
+            status.error = err;
+            status.errorStep = "priority";
+        }
+       #endif
+    }
+
+    // read back what we ended up with
+
+   #if defined(CARLA_OS_WIN)
+    DWORD_PTR processMask = 0, systemMask = 0;
+
+    if (cpuSetStr != nullptr && status.error == 0)
+    {
+        status.cpuSet = requested;
+        status.hasCpuSet = true;
+    }
+    else if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) != FALSE)
+    {
+        carla_zeroStruct(status.cpuSet);
+        status.cpuSet.bits[0] = processMask;
+        status.hasCpuSet = true;
+    }
+
+    status.priority = GetThreadPriority(GetCurrentThread());
+    status.policy = status.priority >= THREAD_PRIORITY_TIME_CRITICAL ? 1 : 0;
+   #else
+   # ifdef CARLA_OS_LINUX
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0)
+    {
+        carla_zeroStruct(status.cpuSet);
+
+        for (uint cpu = 0; cpu < kMaxCPUs && cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &cpuset))
+                addCpuToSet(status.cpuSet, cpu);
+        }
+
+        status.hasCpuSet = true;
+    }
+   # endif
+
+    struct sched_param param;
+    carla_zeroStruct(param);
+
+    if (pthread_getschedparam(pthread_self(), &status.policy, &param) == 0)
+        status.priority = param.sched_priority;
+   #endif
+
+    // unused on some systems
+    (void)wholeProcess;
+
+    ++status.seq;
+}
+
+// -----------------------------------------------------------------------
+
+bool CarlaEngineThreadPlacement::copyStatus(const uint threadClass, Status& out) const noexcept
+{
+    const Status& status(fStatus[threadClass]);
+
+    for (int tries = 0; tries < 8; ++tries)
+    {
+        const int seq = status.seq.get();
+
+        if (seq % 2 != 0)
+            continue;
+
+        out.applied = status.applied;
+        out.hasCpuSet = status.hasCpuSet;
+        out.cpuSet = status.cpuSet;
+        out.policy = status.policy;
+        out.priority = status.priority;
+        out.error = status.error;
+        out.errorStep = status.errorStep;
+
+        if (status.seq.get() == seq)
+            return true;
+    }
+
+    return false;
+}
+
+void CarlaEngineThreadPlacement::writeAsJSON(water::MemoryOutputStream& outStream) const
+{
+    outStream << "{\"threads\":[";
+
+    for (uint i=0; i < ENGINE_THREAD_CLASS_COUNT; ++i)
+    {
+        if (i != 0)
+            outStream << ",";
+
+        outStream << "{\"class\":\"" << kThreadClassNames[i] << "\"";
+
+        // requested
+        CpuSet requested;
+
+        if (kOptions.threadCpuSets[i] != nullptr && parseCpuSet(kOptions.threadCpuSets[i], requested))
+        {
+            outStream << ",\"cpu_set\":\"";
+            writeCpuSet(outStream, requested);
+            outStream << "\"";
+        }
+        else
+        {
+            outStream << ",\"cpu_set\":null";
+        }
+
+        outStream << ",\"priority\":" << kOptions.threadPriorities[i];
+
+        // effective, bridges apply in their own process
+        Status status;
+
+        if (! copyStatus(i, status) || ! status.applied)
+        {
+            outStream << ",\"applied\":false}";
+            continue;
+        }
+
+        outStream << ",\"applied\":true";
+
+        if (status.hasCpuSet)
+        {
+            outStream << ",\"effective_cpu_set\":\"";
+            writeCpuSet(outStream, status.cpuSet);
+            outStream << "\"";
+        }
+        else
+        {
+            outStream << ",\"effective_cpu_set\":null";
+        }
+
+        outStream << ",\"effective_policy\":\"" << getPolicyName(status.policy) << "\""
+                  << ",\"effective_priority\":" << status.priority;
+
+        if (status.error != 0)
+        {
+            outStream << ",\"error\":\"" << status.errorStep << ": ";
+           #ifdef CARLA_OS_WIN
+            outStream << "error " << status.error;
+           #else
+            outStream << std::strerror(status.error);
+           #endif
+            outStream << "\"";
+        }
+        else
+        {
+            outStream << ",\"error\":null";
+        }
+
+        outStream << "}";
+    }
+
+    outStream << "]}";
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
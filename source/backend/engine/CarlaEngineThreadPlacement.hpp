@@ -0,0 +1,115 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_THREAD_PLACEMENT_HPP_INCLUDED
+#define CARLA_ENGINE_THREAD_PLACEMENT_HPP_INCLUDED
+
+#include "CarlaEngine.hpp"
+
+#include "CarlaJuceUtils.hpp"
+
+#include "water/memory/Atomic.h"
+
+#include <pthread.h>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineThreadPlacement
+
+/*!
+ * CPU set and scheduling priority of each engine thread class.
+ *
+ * The requested placement comes from the engine options, each thread applies it to itself.
+ * Afterwards the effective CPU set and scheduling of the thread are read back and kept for reporting.
+ */
+class CarlaEngineThreadPlacement
+{
+public:
+    static const uint kMaxCPUs = 1024;
+
+    struct CpuSet {
+        uint64_t bits[kMaxCPUs / 64];
+    };
+
+    CarlaEngineThreadPlacement(const EngineOptions& options) noexcept;
+
+    /*!
+     * Parse a list of CPU numbers and ranges, like "0,2-3".
+     * Returns false on syntax errors or CPU numbers out of range.
+     */
+    static bool parseCpuSet(const char* str, CpuSet& set) noexcept;
+
+    /*!
+     * Apply the placement of @a threadClass to the calling thread, and read back what it ended up with.
+     * Does not allocate, but does a few system calls.
+     */
+    void applyToCurrentThread(EngineThreadClass threadClass) noexcept;
+
+    /*!
+     * Same as applyToCurrentThread(), but only if the calling thread is not the last one that applied this class.
+     * Cheap enough to be called on every audio cycle.
+     */
+    void applyToCurrentThreadOnce(EngineThreadClass threadClass) noexcept;
+
+    /*!
+     * Apply the placement of @a threadClass to the whole process.
+     * On systems without process-wide CPU sets this applies to the calling thread,
+     * which only affects threads created by it afterwards.
+     */
+    void applyToProcess(EngineThreadClass threadClass) noexcept;
+
+    /*!
+     * Forget what has been applied, so all threads apply their placement again.
+     */
+    void reset() noexcept;
+
+    /*!
+     * Write the requested and effective placement of each thread class as JSON into @a outStream.
+     */
+    void writeAsJSON(water::MemoryOutputStream& outStream) const;
+
+private:
+    struct Status {
+        // odd while a thread is writing into this status
+        water::Atomic<int> seq;
+        bool applied;
+        pthread_t thread;   // last thread that applied this class
+        bool hasCpuSet;     // false if the CPU set cannot be read back on this system
+        CpuSet cpuSet;
+        int policy;
+        int priority;
+        int error;          // errno-style code of the first failure, 0 if none
+        const char* errorStep;
+
+        Status() noexcept;
+    };
+
+    const EngineOptions& kOptions;
+    Status fStatus[ENGINE_THREAD_CLASS_COUNT];
+
+    void apply(EngineThreadClass threadClass, bool wholeProcess) noexcept;
+    bool copyStatus(uint threadClass, Status& out) const noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineThreadPlacement)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_THREAD_PLACEMENT_HPP_INCLUDED
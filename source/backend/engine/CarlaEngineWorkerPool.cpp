@@ -0,0 +1,210 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineWorkerPool.hpp"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineWorkerPool::Worker
+
+CarlaEngineWorkerPool::Worker::Worker(CarlaEngineWorkerPool& pool) noexcept
+    : CarlaThread("CarlaEngineWorker"),
+      fPool(pool),
+      fSem(),
+      fPending()
+{
+    carla_sem_create2(fSem, false);
+}
+
+CarlaEngineWorkerPool::Worker::~Worker() noexcept
+{
+    carla_sem_destroy2(fSem);
+}
+
+void CarlaEngineWorkerPool::Worker::wakeUp() noexcept
+{
+    // binary semaphore, only post when the previous one has been consumed
+    if (fPending.compareAndSetBool(1, 0))
+        carla_sem_post(fSem);
+}
+
+void CarlaEngineWorkerPool::Worker::run()
+{
+    if (fPool.fPlacement != nullptr)
+        fPool.fPlacement->applyToCurrentThread(ENGINE_THREAD_WORKER);
+
+    while (! shouldThreadExit())
+    {
+        if (! carla_sem_timedwait(fSem, 100))
+            continue;
+
+        // reset before joining, so a job started from now on posts again
+        fPending.set(0);
+
+        if (shouldThreadExit())
+            break;
+
+        fPool.joinJob();
+    }
+}
+
+// -----------------------------------------------------------------------
+// CarlaEngineWorkerPool
+
+CarlaEngineWorkerPool::CarlaEngineWorkerPool() noexcept
+    : fNumWorkers(0),
+      fPlacement(nullptr),
+      fFunc(nullptr),
+      fPtr(nullptr),
+      fNumTasks(0),
+      fBusy(),
+      fJobOpen(),
+      fNextTask(),
+      fDoneTasks(),
+      fWorkersInJob()
+{
+    carla_zeroPointers(fWorkers, kMaxWorkers);
+}
+
+CarlaEngineWorkerPool::~CarlaEngineWorkerPool() noexcept
+{
+    stop();
+}
+
+bool CarlaEngineWorkerPool::start(CarlaEngineThreadPlacement& placement)
+{
+    if (fNumWorkers != 0)
+        return true;
+
+    fPlacement = &placement;
+
+    const uint numWorkers = std::min<uint>(carla_get_cpu_count() - 1, static_cast<uint>(kMaxWorkers));
+
+    if (numWorkers == 0)
+        return false;
+
+    for (uint i=0; i < numWorkers; ++i)
+    {
+        Worker* const worker = new Worker(*this);
+
+        if (! worker->startThread(true))
+        {
+            delete worker;
+            break;
+        }
+
+        fWorkers[fNumWorkers++] = worker;
+    }
+
+    carla_stdout("CarlaEngineWorkerPool started with %u workers", fNumWorkers);
+    return fNumWorkers != 0;
+}
+
+void CarlaEngineWorkerPool::stop() noexcept
+{
+    CARLA_SAFE_ASSERT(fBusy.get() == 0);
+
+    const uint numWorkers = fNumWorkers;
+    fNumWorkers = 0;
+
+    for (uint i=0; i < numWorkers; ++i)
+    {
+        fWorkers[i]->signalThreadShouldExit();
+        fWorkers[i]->wakeUp();
+    }
+
+    for (uint i=0; i < numWorkers; ++i)
+    {
+        fWorkers[i]->stopThread(-1);
+        delete fWorkers[i];
+        fWorkers[i] = nullptr;
+    }
+}
+
+bool CarlaEngineWorkerPool::runTasksRT(const uint32_t numTasks, const EngineWorkerTaskFunc func, void* const ptr) noexcept
+{
+    if (numTasks == 0)
+        return true;
+    if (fNumWorkers == 0 || numTasks > INT32_MAX)
+        return false;
+
+    // reject concurrent and nested jobs
+    if (! fBusy.compareAndSetBool(1, 0))
+        return false;
+
+    fFunc = func;
+    fPtr = ptr;
+    fNumTasks = static_cast<int>(numTasks);
+    fNextTask.set(0);
+    fDoneTasks.set(0);
+    fJobOpen.set(1);
+
+    for (uint i=0, count=std::min<uint>(fNumWorkers, numTasks - 1); i < count; ++i)
+        fWorkers[i]->wakeUp();
+
+    runPendingTasks();
+
+    // tasks claimed by workers are already running, wait for them to finish
+    while (fDoneTasks.get() != fNumTasks) {}
+
+    // close the job and wait for late workers to notice, so the next job starts clean
+    fJobOpen.set(0);
+    while (fWorkersInJob.get() != 0) {}
+
+    fBusy.set(0);
+    return true;
+}
+
+bool CarlaEngineWorkerPool::isWorkerThread() const noexcept
+{
+    const pthread_t self = pthread_self();
+
+    for (uint i=0; i < fNumWorkers; ++i)
+    {
+        if (pthread_equal(fWorkers[i]->getThreadId(), self))
+            return true;
+    }
+
+    return false;
+}
+
+void CarlaEngineWorkerPool::runPendingTasks() noexcept
+{
+    for (int index; (index = ++fNextTask - 1) < fNumTasks;)
+    {
+        try {
+            fFunc(fPtr, static_cast<uint32_t>(index));
+        } CARLA_SAFE_EXCEPTION("CarlaEngineWorkerPool task");
+
+        ++fDoneTasks;
+    }
+}
+
+void CarlaEngineWorkerPool::joinJob() noexcept
+{
+    ++fWorkersInJob;
+
+    if (fJobOpen.get() != 0)
+        runPendingTasks();
+
+    --fWorkersInJob;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,120 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_WORKER_POOL_HPP_INCLUDED
+#define CARLA_ENGINE_WORKER_POOL_HPP_INCLUDED
+
+#include "CarlaEngineThreadPlacement.hpp"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
+
+#include "CarlaJuceUtils.hpp"
+
+#include "water/memory/Atomic.h"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineWorkerPool
+
+/*!
+ * A small pool of realtime worker threads, used by plugins to split their processing over several CPUs.
+ *
+ * A job is a number of tasks, the calling thread and the workers claim task indexes from a shared counter
+ * until all are done, so the caller never waits on a worker that has not started yet.
+ * Running a job does not allocate or lock, workers are woken up with one semaphore post each.
+ * Only one job can run at a time, concurrent or nested requests are rejected.
+ */
+class CarlaEngineWorkerPool
+{
+public:
+    static const uint kMaxWorkers = 15;
+
+    CarlaEngineWorkerPool() noexcept;
+    ~CarlaEngineWorkerPool() noexcept;
+
+    /*!
+     * Start the worker threads, one per CPU besides the one running the audio thread.
+     * Each worker applies the ENGINE_THREAD_WORKER placement to itself.
+     * Does nothing if already running, returns false if there are no extra CPUs to use.
+     */
+    bool start(CarlaEngineThreadPlacement& placement);
+
+    /*!
+     * Stop all worker threads.
+     */
+    void stop() noexcept;
+
+    /*!
+     * Run @a numTasks calls to @a func, spread over the worker threads and the calling thread.
+     * Returns false without running any task if the pool is not running or busy with another job.
+     * @note RT call
+     */
+    bool runTasksRT(uint32_t numTasks, EngineWorkerTaskFunc func, void* ptr) noexcept;
+
+    /*!
+     * Check if the calling thread is one of the workers.
+     */
+    bool isWorkerThread() const noexcept;
+
+private:
+    class Worker : public CarlaThread
+    {
+    public:
+        Worker(CarlaEngineWorkerPool& pool) noexcept;
+        ~Worker() noexcept override;
+
+        // wake up the worker, unless it has a pending wake up already
+        void wakeUp() noexcept;
+
+    protected:
+        void run() override;
+
+    private:
+        CarlaEngineWorkerPool& fPool;
+        carla_sem_t fSem;
+        water::Atomic<int> fPending;
+
+        CARLA_DECLARE_NON_COPYABLE(Worker)
+    };
+
+    Worker* fWorkers[kMaxWorkers];
+    uint fNumWorkers;
+    CarlaEngineThreadPlacement* fPlacement;
+
+    // current job, only changed while fBusy is set and fJobOpen is not
+    EngineWorkerTaskFunc fFunc;
+    void* fPtr;
+    int fNumTasks;
+
+    water::Atomic<int> fBusy;
+    water::Atomic<int> fJobOpen;
+    water::Atomic<int> fNextTask;
+    water::Atomic<int> fDoneTasks;
+    water::Atomic<int> fWorkersInJob;
+
+    void runPendingTasks() noexcept;
+    void joinJob() noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineWorkerPool)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_WORKER_POOL_HPP_INCLUDED
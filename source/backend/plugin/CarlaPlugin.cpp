@@ -16,6 +16,7 @@
  */
 
 #include "CarlaPluginInternal.hpp"
+#include "CarlaPluginFreeze.hpp"
 #include "CarlaEngine.hpp"
 
 #include "CarlaBackendUtils.hpp"
@@ -170,6 +171,31 @@ uint32_t CarlaPlugin::getLatencyInFrames() const noexcept
     return 0;
 }
 
+uint32_t CarlaPlugin::getTailSamples() const noexcept
+{
+    return UINT32_MAX;
+}
+
+bool CarlaPlugin::isSleeping() const noexcept
+{
+    return pData->sleep.asleep;
+}
+
+bool CarlaPlugin::isFrozen() const noexcept
+{
+    return pData->freeze.cache != nullptr && ! pData->freeze.recording && ! pData->freeze.invalidated;
+}
+
+bool CarlaPlugin::isFreezing() const noexcept
+{
+    return pData->freeze.cache != nullptr && pData->freeze.recording;
+}
+
+bool CarlaPlugin::isCustomUIShown() const noexcept
+{
+    return pData->uiShown;
+}
+
 // -------------------------------------------------------------------
 // Information (count)
 
@@ -412,6 +438,94 @@ float CarlaPlugin::getInternalParameterValue(const int32_t parameterId) const no
     return getParameterValue(static_cast<uint32_t>(parameterId));
 }
 
+uint32_t CarlaPlugin::getParameterValues(float* const values, const uint32_t count) const noexcept
+{
+    const uint32_t paramCount = pData->param.count;
+    CARLA_SAFE_ASSERT_RETURN(values != nullptr || count == 0, paramCount);
+
+    for (uint32_t i=0, n=std::min(count, paramCount); i < n; ++i)
+        values[i] = getParameterValue(i);
+
+    return paramCount;
+}
+
+uint32_t CarlaPlugin::getParameterValuesAndCheckChanges(float* const values, const uint32_t count) noexcept
+{
+    const uint32_t paramCount = pData->param.count;
+    CARLA_SAFE_ASSERT_RETURN(values != nullptr || count == 0, paramCount);
+
+    ProtectedData::Changes& changes(pData->changes);
+    const CarlaMutexLocker cml(changes.mutex);
+
+    bool changed = changes.counter == 0;
+
+    if (changes.valueCount != paramCount)
+    {
+        changed = true;
+        delete[] changes.values;
+        changes.values = nullptr;
+        changes.valueCount = 0;
+
+        if (paramCount != 0)
+        {
+            try {
+                changes.values = new float[paramCount];
+            } CARLA_SAFE_EXCEPTION("getParameterValuesAndCheckChanges");
+
+            if (changes.values != nullptr)
+                changes.valueCount = paramCount;
+        }
+    }
+
+    for (uint32_t i=0; i < paramCount; ++i)
+    {
+        const float value = getParameterValue(i);
+
+        if (i < count)
+            values[i] = value;
+
+        if (i < changes.valueCount)
+        {
+            if (! changed && carla_isNotEqual(changes.values[i], value))
+                changed = true;
+            changes.values[i] = value;
+        }
+    }
+
+    // without storage the values cannot be compared, always report them as changed
+    if (changes.valueCount != paramCount)
+        changed = true;
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    for (int32_t i=0; i < 7; ++i)
+    {
+        const float value = getInternalParameterValue(PARAMETER_ACTIVE - i);
+
+        if (! changed && carla_isNotEqual(changes.internals[i], value))
+            changed = true;
+        changes.internals[i] = value;
+    }
+#endif
+
+    if (changes.program != pData->prog.current || changes.midiProgram != pData->midiprog.current)
+    {
+        changed = true;
+        changes.program = pData->prog.current;
+        changes.midiProgram = pData->midiprog.current;
+    }
+
+    if (changed)
+        changes.counter = ProtectedData::Changes::nextCounter();
+
+    return paramCount;
+}
+
+uint64_t CarlaPlugin::getChangeCounter() const noexcept
+{
+    const CarlaMutexLocker cml(pData->changes.mutex);
+    return pData->changes.counter;
+}
+
 bool CarlaPlugin::getProgramName(const uint32_t index, char* const strBuf) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(index < pData->prog.count, false);
@@ -1421,10 +1535,15 @@ void CarlaPlugin::setActive(const bool active, const bool sendOsc, const bool se
             activate();
         else
             deactivate();
+
+        pData->sleep.reset();
     }
 
     pData->active = active;
 
+    if (active)
+        pData->sleep.tail = getTailSamples();
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     const float value = active ? 1.0f : 0.0f;
 
@@ -1438,6 +1557,41 @@ void CarlaPlugin::setActive(const bool active, const bool sendOsc, const bool se
 #endif
 }
 
+void CarlaPlugin::setUserTailSamples(const int32_t samples) noexcept
+{
+    pData->sleep.userTail = std::max(-1, samples);
+    pData->sleep.tail = getTailSamples();
+    pData->sleep.wakeRequested = true;
+}
+
+void CarlaPlugin::unfreeze(const bool sendCallback) noexcept
+{
+    CarlaPluginFreezeCache* cache;
+
+    {
+        const ScopedSingleProcessLocker sspl(this, true);
+
+        cache = pData->freeze.cache;
+        pData->freeze.cache = nullptr;
+        pData->freeze.recording = false;
+        pData->freeze.invalidated = false;
+    }
+
+    if (cache == nullptr)
+        return;
+
+    carla_debug("CarlaPlugin::unfreeze(%s)", bool2str(sendCallback));
+
+    // stops the reader thread and deletes the cache file
+    delete cache;
+
+    pData->engine->callback(sendCallback, true,
+                            ENGINE_CALLBACK_PLUGIN_FREEZE_CHANGED,
+                            pData->id,
+                            0,
+                            0, 0, 0.0f, nullptr);
+}
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
 void CarlaPlugin::setDryWet(const float value, const bool sendOsc, const bool sendCallback) noexcept
 {
@@ -1454,6 +1608,7 @@ void CarlaPlugin::setDryWet(const float value, const bool sendOsc, const bool se
         return;
 
     pData->postProc.dryWet = fixedValue;
+    pData->freeze.invalidate();
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1479,6 +1634,7 @@ void CarlaPlugin::setVolume(const float value, const bool sendOsc, const bool se
         return;
 
     pData->postProc.volume = fixedValue;
+    pData->freeze.invalidate();
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1504,6 +1660,7 @@ void CarlaPlugin::setBalanceLeft(const float value, const bool sendOsc, const bo
         return;
 
     pData->postProc.balanceLeft = fixedValue;
+    pData->freeze.invalidate();
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1529,6 +1686,7 @@ void CarlaPlugin::setBalanceRight(const float value, const bool sendOsc, const b
         return;
 
     pData->postProc.balanceRight = fixedValue;
+    pData->freeze.invalidate();
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1554,6 +1712,7 @@ void CarlaPlugin::setPanning(const float value, const bool sendOsc, const bool s
         return;
 
     pData->postProc.panning = fixedValue;
+    pData->freeze.invalidate();
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1674,6 +1833,9 @@ void CarlaPlugin::setParameterValue(const uint32_t parameterId, const float valu
     if (sendGui && (pData->hints & PLUGIN_HAS_CUSTOM_UI) != 0)
         uiParameterChange(parameterId, value);
 
+    pData->sleep.wakeRequested = true;
+    pData->freeze.invalidate();
+
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
                             pData->id,
@@ -1913,6 +2075,8 @@ void CarlaPlugin::setCustomData(const char* const type, const char* const key, c
             return;
     }
 
+    pData->freeze.invalidate();
+
     // Check if we already have this key
     for (LinkedList<CustomData>::Itenerator it = pData->custom.begin2(); it.valid(); it.next())
     {
@@ -1950,6 +2114,8 @@ void CarlaPlugin::setProgram(const int32_t index,
     CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->prog.count),);
 
     pData->prog.current = index;
+    pData->sleep.wakeRequested = true;
+    pData->freeze.invalidate();
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PROGRAM_CHANGED,
@@ -1982,6 +2148,8 @@ void CarlaPlugin::setMidiProgram(const int32_t index,
     CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->midiprog.count),);
 
     pData->midiprog.current = index;
+    pData->sleep.wakeRequested = true;
+    pData->freeze.invalidate();
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_MIDI_PROGRAM_CHANGED,
@@ -2081,6 +2249,305 @@ void CarlaPlugin::deactivate() noexcept
     CARLA_SAFE_ASSERT(pData->active);
 }
 
+bool CarlaPlugin::canProcessDouble() const noexcept
+{
+    return false;
+}
+
+void CarlaPlugin::processDouble(const double* const* const, double** const audioOut,
+                                const float* const* const, float** const cvOut, const uint32_t frames)
+{
+    // only called for plugins that support double precision
+    CARLA_SAFE_ASSERT(canProcessDouble());
+
+    for (uint32_t i=0; i < pData->audioOut.count; ++i)
+        carla_zeroDoubles(audioOut[i], frames);
+    for (uint32_t i=0; i < pData->cvOut.count; ++i)
+        carla_zeroFloats(cvOut[i], frames);
+}
+
+static inline
+bool isSilentBuffer(const float* const buffer, const uint32_t frames) noexcept
+{
+    return carla_isSilentFloats(buffer, frames);
+}
+
+static inline
+bool isSilentBuffer(const double* const buffer, const uint32_t frames) noexcept
+{
+    return carla_isSilentDoubles(buffer, frames);
+}
+
+bool CarlaPlugin::isSleepingRT(const float* const* const audioIn, const uint32_t frames) noexcept
+{
+    return _isSleepingRT(audioIn, frames);
+}
+
+bool CarlaPlugin::isSleepingRT(const double* const* const audioIn, const uint32_t frames) noexcept
+{
+    return _isSleepingRT(audioIn, frames);
+}
+
+void CarlaPlugin::updateSleepStateRT(const float* const* const audioOut, const uint32_t frames) noexcept
+{
+    _updateSleepStateRT(audioOut, frames);
+}
+
+void CarlaPlugin::updateSleepStateRT(const double* const* const audioOut, const uint32_t frames) noexcept
+{
+    _updateSleepStateRT(audioOut, frames);
+}
+
+template <typename T>
+bool CarlaPlugin::_isSleepingRT(const T* const* const audioIn, const uint32_t frames) noexcept
+{
+    ProtectedData::Sleep& sleep(pData->sleep);
+
+    // transport start, stop or relocation, for plugins that follow it
+    const EngineTimeInfo timeInfo(pData->engine->getTimeInfo());
+    const bool transportChanged = timeInfo.playing != sleep.transportPlaying || timeInfo.frame != sleep.transportFrame;
+    sleep.transportPlaying = timeInfo.playing;
+    sleep.transportFrame = timeInfo.playing ? timeInfo.frame + frames : timeInfo.frame;
+
+    // plugins with outputs other than audio, or without a known tail, never sleep
+    if (pData->audioOut.count == 0 || pData->cvOut.count != 0 || pData->event.portOut != nullptr ||
+        (sleep.userTail < 0 && (sleep.hint == ProtectedData::Sleep::kHintNever ||
+                                (sleep.hint == ProtectedData::Sleep::kHintNone && sleep.tail == UINT32_MAX))))
+    {
+        sleep.asleep = sleep.quietInput = false;
+        sleep.wakeRequested = false;
+        return false;
+    }
+
+    bool quiet = true;
+
+    if (sleep.wakeRequested)
+    {
+        sleep.wakeRequested = false;
+        quiet = false;
+    }
+    else if (transportChanged)
+    {
+        quiet = false;
+    }
+    else if (timeInfo.playing && pData->audioIn.count == 0)
+    {
+        // generators may follow the transport, like sequencers, so they keep running while it plays
+        quiet = false;
+    }
+    else if (pData->extNotes.data.isNotEmpty())
+    {
+        quiet = false;
+    }
+    else if (pData->event.portIn != nullptr && pData->event.portIn->getEventCount() != 0)
+    {
+        quiet = false;
+    }
+    else
+    {
+        for (uint32_t i=0; i < pData->audioIn.count; ++i)
+        {
+            if (! isSilentBuffer(audioIn[i], frames))
+            {
+                quiet = false;
+                break;
+            }
+        }
+    }
+
+    sleep.quietInput = quiet;
+
+    if (! sleep.asleep)
+        return false;
+
+    if (quiet)
+        return true;
+
+    sleep.asleep = false;
+    sleep.quietFrames = 0;
+    return false;
+}
+
+template <typename T>
+void CarlaPlugin::_updateSleepStateRT(const T* const* const audioOut, const uint32_t frames) noexcept
+{
+    ProtectedData::Sleep& sleep(pData->sleep);
+
+    const bool silentOutput = sleep.silentOutput;
+    sleep.silentOutput = false;
+
+    if (! sleep.quietInput)
+    {
+        sleep.quietFrames = 0;
+        return;
+    }
+
+    uint32_t tail;
+
+    if (sleep.userTail >= 0)
+    {
+        tail = static_cast<uint32_t>(sleep.userTail);
+    }
+    else
+    {
+        switch (sleep.hint)
+        {
+        case ProtectedData::Sleep::kHintNever:
+            sleep.quietFrames = 0;
+            return;
+        case ProtectedData::Sleep::kHintNow:
+            sleep.asleep = true;
+            return;
+        case ProtectedData::Sleep::kHintWhenQuiet:
+            tail = 0;
+            break;
+        default:
+            tail = sleep.tail;
+            break;
+        }
+    }
+
+    sleep.quietFrames = sleep.quietFrames > UINT32_MAX - frames ? UINT32_MAX : sleep.quietFrames + frames;
+
+    if (sleep.quietFrames < tail)
+        return;
+
+    if (! silentOutput)
+    {
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+        {
+            if (! isSilentBuffer(audioOut[i], frames))
+                return;
+        }
+    }
+
+    sleep.asleep = true;
+}
+
+bool CarlaPlugin::startFreeze(const uint64_t startFrame, const uint64_t numFrames)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(numFrames > 0, "Invalid number of frames");
+    carla_debug("CarlaPlugin::startFreeze(" P_UINT64 ", " P_UINT64 ")", startFrame, numFrames);
+
+    // only audio is cached, nothing would be sent on other outputs while frozen
+    if (pData->audioOut.count == 0 || pData->cvOut.count != 0 || getMidiOutCount() != 0)
+    {
+        pData->engine->setLastError("Only plugins with audio outputs, and without CV or MIDI outputs, can be frozen");
+        return false;
+    }
+
+    unfreeze(true);
+
+    CarlaPluginFreezeCache* const cache = new CarlaPluginFreezeCache(pData->audioOut.count,
+                                                                     pData->engine->getSampleRate(),
+                                                                     startFrame, numFrames);
+
+    if (! cache->startRecording())
+    {
+        delete cache;
+        pData->engine->setLastError("Failed to create freeze cache file");
+        return false;
+    }
+
+    const ScopedSingleProcessLocker sspl(this, true);
+
+    pData->freeze.cache = cache;
+    pData->freeze.recording = true;
+    pData->freeze.invalidated = false;
+    return true;
+}
+
+bool CarlaPlugin::finishFreeze(const bool rendered)
+{
+    CarlaPluginFreezeCache* const cache = pData->freeze.cache;
+    CARLA_SAFE_ASSERT_RETURN(cache != nullptr && pData->freeze.recording, false);
+    carla_debug("CarlaPlugin::finishFreeze(%s)", bool2str(rendered));
+
+    bool ok;
+
+    {
+        const ScopedSingleProcessLocker sspl(this, true);
+
+        ok = rendered && cache->finishRecording();
+
+        if (! ok)
+            pData->freeze.cache = nullptr;
+
+        pData->freeze.recording = false;
+    }
+
+    if (! ok)
+    {
+        delete cache;
+
+        if (rendered)
+            pData->engine->setLastError("Failed to write freeze cache file");
+
+        return false;
+    }
+
+    pData->engine->callback(true, true,
+                            ENGINE_CALLBACK_PLUGIN_FREEZE_CHANGED,
+                            pData->id,
+                            1,
+                            0, 0, 0.0f, nullptr);
+    return true;
+}
+
+bool CarlaPlugin::isFrozenRT(const float* const* const audioIn, float* const* const audioOut, const uint32_t frames) noexcept
+{
+    ProtectedData::Freeze& freeze(pData->freeze);
+    CarlaPluginFreezeCache* const cache = freeze.cache;
+
+    if (cache == nullptr || freeze.invalidated)
+        return false;
+
+    const EngineTimeInfo timeInfo(pData->engine->getTimeInfo());
+
+    if (freeze.recording)
+    {
+        if (timeInfo.playing && pData->engine->isOffline())
+            cache->checkInputRT(timeInfo.frame, audioIn, pData->audioIn.count, pData->event.portIn, frames);
+        return false;
+    }
+
+    // the cache no longer matches what the plugin would output, process it again
+    if (cache->getNumChannels() != pData->audioOut.count ||
+        carla_isNotEqual(cache->getSampleRate(), pData->engine->getSampleRate()) ||
+        pData->extNotes.data.isNotEmpty() ||
+        (timeInfo.playing && ! cache->checkInputRT(timeInfo.frame, audioIn, pData->audioIn.count,
+                                                   pData->event.portIn, frames)))
+    {
+        freeze.invalidated = true;
+        return false;
+    }
+
+    if (pData->active && timeInfo.playing)
+    {
+        cache->playRT(timeInfo.frame, audioOut, frames, pData->engine->isOffline());
+    }
+    else
+    {
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+            carla_zeroFloats(audioOut[i], frames);
+    }
+
+    return true;
+}
+
+void CarlaPlugin::recordFreezeRT(const float* const* const audioOut, const uint32_t frames) noexcept
+{
+    ProtectedData::Freeze& freeze(pData->freeze);
+
+    if (freeze.cache == nullptr || ! freeze.recording || ! pData->engine->isOffline())
+        return;
+
+    const EngineTimeInfo timeInfo(pData->engine->getTimeInfo());
+
+    if (timeInfo.playing)
+        freeze.cache->recordRT(timeInfo.frame, audioOut, frames);
+}
+
 void CarlaPlugin::bufferSizeChanged(const uint32_t newBufferSize)
 {
    #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -2112,6 +2579,9 @@ void CarlaPlugin::idle()
     const bool needsUiMainThread = pData->hints & PLUGIN_NEEDS_UI_MAIN_THREAD;
     const uint32_t latency = getLatencyInFrames();
 
+    if (pData->freeze.invalidated)
+        unfreeze(true);
+
     if (pData->latency.frames != latency)
     {
         carla_stdout("latency changed to %i samples", latency);
@@ -2441,6 +2911,11 @@ void CarlaPlugin::showCustomUI(const bool yesNo)
     }
 }
 
+void CarlaPlugin::setCustomUIShown(const bool yesNo) noexcept
+{
+    pData->uiShown = yesNo;
+}
+
 void* CarlaPlugin::embedCustomUI(void*)
 {
     return nullptr;
@@ -261,6 +261,22 @@ protected:
             std::snprintf(strBuf, STR_MAX, "%u", options.uiBridgesTimeout);
             carla_setenv("ENGINE_OPTION_UI_BRIDGES_TIMEOUT",strBuf);
 
+            std::snprintf(strBuf, STR_MAX, "%u", options.bridgeSpinWaitTime);
+            carla_setenv("ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME", strBuf);
+
+            for (int i=0; i < ENGINE_THREAD_CLASS_COUNT; ++i)
+            {
+                char envName[64];
+                envName[63] = '\0';
+
+                std::snprintf(envName, 63, "ENGINE_OPTION_THREAD_CPU_SET_%i", i);
+                carla_setenv(envName, options.threadCpuSets[i] != nullptr ? options.threadCpuSets[i] : "");
+
+                std::snprintf(envName, 63, "ENGINE_OPTION_THREAD_PRIORITY_%i", i);
+                std::snprintf(strBuf, STR_MAX, "%i", options.threadPriorities[i]);
+                carla_setenv(envName, strBuf);
+            }
+
             if (options.pathLADSPA != nullptr)
                 carla_setenv("ENGINE_OPTION_PLUGIN_PATH_LADSPA", options.pathLADSPA);
             else
@@ -454,12 +470,16 @@ public:
           fBufferSize(engine->getBufferSize()),
           fProcWaitTime(0),
           fPendingEmbedCustomUI(0),
+          fClientChunkPoolBusy(false),
           fBridgeBinary(),
           fBridgeThread(engine, this),
           fShmAudioPool(),
           fShmRtClientControl(),
           fShmNonRtClientControl(),
           fShmNonRtServerControl(),
+          fShmClientChunkPool(true),
+          fShmServerChunkPool(false),
+          fShmParameterPool(),
 #ifndef CARLA_OS_WIN
           fWinePrefix(),
 #endif
@@ -510,6 +530,9 @@ public:
 
         fBridgeThread.stopThread(3000);
 
+        fShmParameterPool.clear();
+        fShmServerChunkPool.clear();
+        fShmClientChunkPool.clear();
         fShmNonRtServerControl.clear();
         fShmNonRtClientControl.clear();
         fShmRtClientControl.clear();
@@ -801,6 +824,10 @@ public:
             fShmNonRtClientControl.waitIfDataIsReachingLimit();
         }
 
+        // also keep the parameter pool up to date, so older values written there during process do not win
+        if (parameterId < fShmParameterPool.count)
+            fShmParameterPool.writeValue(parameterId, fixedValue, false);
+
         CarlaPlugin::setParameterValue(parameterId, fixedValue, sendGui, sendOsc, sendCallback);
     }
 
@@ -811,6 +838,12 @@ public:
         const float fixedValue(pData->param.getFixedValue(parameterId, value));
         fParams[parameterId].value = fixedValue;
 
+        // the bridge picks up the latest values from the parameter pool at the start of each process cycle
+        if (parameterId < fShmParameterPool.count)
+        {
+            fShmParameterPool.writeValue(parameterId, fixedValue, false);
+        }
+        else
         {
             const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
 
@@ -1024,25 +1057,7 @@ public:
         CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
         CARLA_SAFE_ASSERT_RETURN(dataSize > 0,);
 
-        CarlaString dataBase64(CarlaString::asBase64(data, dataSize));
-        CARLA_SAFE_ASSERT_RETURN(dataBase64.length() > 0,);
-
-        String filePath(File::getSpecialLocation(File::tempDirectory).getFullPathName());
-
-        filePath += CARLA_OS_SEP_STR ".CarlaChunk_";
-        filePath += fShmAudioPool.getFilenameSuffix();
-
-        if (File(filePath).replaceWithText(dataBase64.buffer()))
-        {
-            const uint32_t ulength = static_cast<uint32_t>(filePath.length());
-
-            const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
-
-            fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientSetChunkDataFile);
-            fShmNonRtClientControl.writeUInt(ulength);
-            fShmNonRtClientControl.writeCustomData(filePath.toRawUTF8(), ulength);
-            fShmNonRtClientControl.commitWrite();
-        }
+        _sendChunkData(data, dataSize);
 
         // save data internally as well
         fInfo.chunk.resize(dataSize);
@@ -1382,6 +1397,7 @@ public:
             pData->extraHints |= PLUGIN_EXTRA_HINT_HAS_MIDI_OUT;
 
         bufferSizeChanged(pData->engine->getBufferSize());
+        resizeParameterPool();
         reloadPrograms(true);
 
         carla_debug("CarlaPluginBridge::reload() - end");
@@ -1748,6 +1764,21 @@ public:
         if (! processSingle(audioIn, audioOut, cvIn, cvOut, frames))
             return;
 
+        // --------------------------------------------------------------------------------------------------------
+        // Parameter outputs, written to the parameter pool by the bridge after each process cycle
+
+        if (fShmParameterPool.hasChanges())
+        {
+            uint32_t index;
+            float value;
+
+            while (fShmParameterPool.readNextValue(index, value))
+            {
+                if (index < pData->param.count && fParams != nullptr)
+                    fParams[index].value = pData->param.getFixedValue(index, value);
+            }
+        }
+
         // --------------------------------------------------------------------------------------------------------
         // Control and MIDI Output
 
@@ -2626,6 +2657,41 @@ public:
                 fPendingEmbedCustomUI = fShmNonRtServerControl.readULong();
                 break;
 
+            case kPluginBridgeNonRtServerSetChunkDataShm: {
+                // ulong/size
+                const uint64_t size = fShmNonRtServerControl.readULong();
+                CARLA_SAFE_ASSERT_BREAK(size > 0);
+                CARLA_SAFE_ASSERT_BREAK(fShmServerChunkPool.data != nullptr);
+                CARLA_SAFE_ASSERT_BREAK(size <= fShmServerChunkPool.dataSize);
+
+                fInfo.chunk.assign(fShmServerChunkPool.data, fShmServerChunkPool.data + size);
+            }   break;
+
+            case kPluginBridgeNonRtServerResizeChunkPool: {
+                // ulong/size
+                const uint64_t size = fShmNonRtServerControl.readULong();
+                CARLA_SAFE_ASSERT_BREAK(size > 0);
+
+                // the bridge falls back to a file if the pool is still too small
+                const uint64_t newSize = fShmServerChunkPool.filename.isNotEmpty() &&
+                                         fShmServerChunkPool.resize(static_cast<std::size_t>(size))
+                                       ? static_cast<uint64_t>(fShmServerChunkPool.dataSize)
+                                       : 0;
+
+                const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+
+                fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientSetServerChunkPoolSize);
+                fShmNonRtClientControl.writeULong(newSize);
+
+                // ask again, now that the chunk fits
+                fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientPrepareForSave);
+                fShmNonRtClientControl.commitWrite();
+            }   break;
+
+            case kPluginBridgeNonRtServerChunkDataReceived:
+                fClientChunkPoolBusy = false;
+                break;
+
             case kPluginBridgeNonRtServerResizeEmbedUI: {
                 const uint width = fShmNonRtServerControl.readUInt();
                 const uint height = fShmNonRtServerControl.readUInt();
@@ -2737,6 +2803,8 @@ public:
             return false;
         }
 
+        fShmRtClientControl.setSpinWaitTime(pData->engine->getOptions().bridgeSpinWaitTime);
+
         if (! fShmNonRtClientControl.initializeServer())
         {
             carla_stderr("Failed to initialize Non-RT client control");
@@ -2754,6 +2822,22 @@ public:
             return false;
         }
 
+        // chunk pools are optional, chunks are sent through temporary files without them
+        if (! fShmClientChunkPool.initializeServer(fShmAudioPool.getFilenameSuffix()) ||
+            ! fShmServerChunkPool.initializeServer(fShmAudioPool.getFilenameSuffix()))
+        {
+            carla_stderr("Failed to initialize shared memory chunk pools");
+            fShmClientChunkPool.clear();
+            fShmServerChunkPool.clear();
+        }
+
+        // same for the parameter pool, parameter values are sent through the non-RT control without it
+        if (! fShmParameterPool.initializeServer(fShmAudioPool.getFilenameSuffix()))
+        {
+            carla_stderr("Failed to initialize shared memory parameter pool");
+            fShmParameterPool.clear();
+        }
+
 #ifndef CARLA_OS_WIN
         // ---------------------------------------------------------------
         // set wine prefix
@@ -2906,6 +2990,9 @@ private:
     uint fProcWaitTime;
     uint64_t fPendingEmbedCustomUI;
 
+    // set while the bridge has not read the last chunk sent through shared memory yet
+    bool fClientChunkPoolBusy;
+
     CarlaString             fBridgeBinary;
     CarlaPluginBridgeThread fBridgeThread;
 
@@ -2913,6 +3000,9 @@ private:
     BridgeRtClientControl    fShmRtClientControl;
     BridgeNonRtClientControl fShmNonRtClientControl;
     BridgeNonRtServerControl fShmNonRtServerControl;
+    BridgeChunkPool          fShmClientChunkPool;
+    BridgeChunkPool          fShmServerChunkPool;
+    BridgeParameterPool      fShmParameterPool;
 
 #ifndef CARLA_OS_WIN
     String fWinePrefix;
@@ -3113,6 +3203,28 @@ private:
         waitForClient("resize-pool", 5000);
     }
 
+    void resizeParameterPool()
+    {
+        if (fBridgeVersion < 12 || fShmParameterPool.filename.isEmpty())
+            return;
+
+        // on failure the pool is left empty, and parameter values keep going through the non-RT control
+        if (! fShmParameterPool.resize(pData->param.count))
+            carla_stderr("Failed to resize shared memory parameter pool");
+
+        fShmRtClientControl.writeOpcode(kPluginBridgeRtClientSetParameterPool);
+        fShmRtClientControl.writeUInt(fShmParameterPool.count);
+        fShmRtClientControl.commitWrite();
+
+        waitForClient("parameter-pool", 5000);
+
+        if (fShmParameterPool.count != 0 && fShmParameterPool.data->clientCount != fShmParameterPool.count)
+        {
+            carla_stderr("Bridge did not map the shared memory parameter pool");
+            fShmParameterPool.resize(0);
+        }
+    }
+
     void waitForClient(const char* const action, const uint msecs)
     {
         CARLA_SAFE_ASSERT_RETURN(! fTimedOut,);
@@ -3130,6 +3242,7 @@ private:
         fInitiated  = false;
         fInitError  = false;
         fTimedError = false;
+        fClientChunkPoolBusy = false;
 
         // reset memory
         fShmRtClientControl.data->procFlags = 0;
@@ -3166,6 +3279,14 @@ private:
             fShmRtClientControl.commitWrite();
         }
 
+        // a new bridge process starts from a clean parameter pool
+        if (fShmParameterPool.count != 0 && fShmParameterPool.resize(fShmParameterPool.count))
+        {
+            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientSetParameterPool);
+            fShmRtClientControl.writeUInt(fShmParameterPool.count);
+            fShmRtClientControl.commitWrite();
+        }
+
         fBridgeThread.startThread();
 
         const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin;
@@ -3231,28 +3352,48 @@ private:
 #else
             void* data = &fInfo.chunk.front();
 #endif
-            CarlaString dataBase64(CarlaString::asBase64(data, dataSize));
-            CARLA_SAFE_ASSERT_RETURN(dataBase64.length() > 0, true);
-
-            String filePath(File::getSpecialLocation(File::tempDirectory).getFullPathName());
+            _sendChunkData(data, dataSize);
+        }
 
-            filePath += CARLA_OS_SEP_STR ".CarlaChunk_";
-            filePath += fShmAudioPool.getFilenameSuffix();
+        return true;
+    }
 
-            if (File(filePath).replaceWithText(dataBase64.buffer()))
-            {
-                const uint32_t ulength(static_cast<uint32_t>(filePath.length()));
+    void _sendChunkData(const void* const data, const std::size_t dataSize)
+    {
+        // raw data through shared memory, if the bridge supports it and has read the previous chunk
+        if (fBridgeVersion >= 11 && ! fClientChunkPoolBusy &&
+            fShmClientChunkPool.filename.isNotEmpty() && fShmClientChunkPool.resize(dataSize))
+        {
+            std::memcpy(fShmClientChunkPool.data, data, dataSize);
+            fClientChunkPoolBusy = true;
 
-                const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+            const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
 
-                fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientSetChunkDataFile);
-                fShmNonRtClientControl.writeUInt(ulength);
-                fShmNonRtClientControl.writeCustomData(filePath.toRawUTF8(), ulength);
-                fShmNonRtClientControl.commitWrite();
-            }
+            fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientSetChunkDataShm);
+            fShmNonRtClientControl.writeULong(static_cast<uint64_t>(dataSize));
+            fShmNonRtClientControl.commitWrite();
+            return;
         }
 
-        return true;
+        CarlaString dataBase64(CarlaString::asBase64(data, dataSize));
+        CARLA_SAFE_ASSERT_RETURN(dataBase64.length() > 0,);
+
+        String filePath(File::getSpecialLocation(File::tempDirectory).getFullPathName());
+
+        filePath += CARLA_OS_SEP_STR ".CarlaChunk_";
+        filePath += fShmAudioPool.getFilenameSuffix();
+
+        if (File(filePath).replaceWithText(dataBase64.buffer()))
+        {
+            const uint32_t ulength = static_cast<uint32_t>(filePath.length());
+
+            const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+
+            fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientSetChunkDataFile);
+            fShmNonRtClientControl.writeUInt(ulength);
+            fShmNonRtClientControl.writeCustomData(filePath.toRawUTF8(), ulength);
+            fShmNonRtClientControl.commitWrite();
+        }
     }
 
     void _setUiTitleFromName()
@@ -21,6 +21,7 @@
 #include "CarlaBackendUtils.hpp"
 #include "CarlaClapUtils.hpp"
 #include "CarlaMathUtils.hpp"
+#include "CarlaScopeUtils.hpp"
 
 #include "CarlaPluginUI.hpp"
 
@@ -50,6 +51,12 @@
 
 CARLA_BACKEND_START_NAMESPACE
 
+#ifdef PTW32_DLLPORT
+static const pthread_t kNullThread = {nullptr, 0};
+#else
+static const pthread_t kNullThread = 0;
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 
 struct ClapEventData {
@@ -158,6 +165,11 @@ struct carla_clap_host : clap_host_t {
         virtual void clapRequestCallback() = 0;
         virtual void clapMarkDirty() = 0;
         virtual void clapLatencyChanged() = 0;
+        // thread-check
+        virtual bool clapIsMainThread() const noexcept = 0;
+        virtual bool clapIsAudioThread() const noexcept = 0;
+        // thread-pool
+        virtual bool clapRequestExec(uint32_t numTasks) noexcept = 0;
       #ifdef CLAP_WINDOW_API_NATIVE
         // gui
         virtual void clapGuiResizeHintsChanged() = 0;
@@ -181,6 +193,8 @@ struct carla_clap_host : clap_host_t {
 
     clap_host_latency_t latency;
     clap_host_state_t state;
+    clap_host_thread_check_t threadCheck;
+    clap_host_thread_pool_t threadPool;
   #ifdef CLAP_WINDOW_API_NATIVE
     clap_host_gui_t gui;
    #ifdef _POSIX_VERSION
@@ -208,6 +222,11 @@ struct carla_clap_host : clap_host_t {
 
         state.mark_dirty = carla_mark_dirty;
 
+        threadCheck.is_main_thread = carla_is_main_thread;
+        threadCheck.is_audio_thread = carla_is_audio_thread;
+
+        threadPool.request_exec = carla_request_exec;
+
       #ifdef CLAP_WINDOW_API_NATIVE
         gui.resize_hints_changed = carla_resize_hints_changed;
         gui.request_resize = carla_request_resize;
@@ -234,6 +253,10 @@ struct carla_clap_host : clap_host_t {
             return &self->latency;
         if (std::strcmp(extension_id, CLAP_EXT_STATE) == 0)
             return &self->state;
+        if (std::strcmp(extension_id, CLAP_EXT_THREAD_CHECK) == 0)
+            return &self->threadCheck;
+        if (std::strcmp(extension_id, CLAP_EXT_THREAD_POOL) == 0)
+            return &self->threadPool;
       #ifdef CLAP_WINDOW_API_NATIVE
         if (std::strcmp(extension_id, CLAP_EXT_GUI) == 0)
             return &self->gui;
@@ -274,6 +297,21 @@ struct carla_clap_host : clap_host_t {
         static_cast<const carla_clap_host*>(host->host_data)->hostCallbacks->clapMarkDirty();
     }
 
+    static bool CLAP_ABI carla_is_main_thread(const clap_host_t* const host)
+    {
+        return static_cast<const carla_clap_host*>(host->host_data)->hostCallbacks->clapIsMainThread();
+    }
+
+    static bool CLAP_ABI carla_is_audio_thread(const clap_host_t* const host)
+    {
+        return static_cast<const carla_clap_host*>(host->host_data)->hostCallbacks->clapIsAudioThread();
+    }
+
+    static bool CLAP_ABI carla_request_exec(const clap_host_t* const host, const uint32_t num_tasks)
+    {
+        return static_cast<const carla_clap_host*>(host->host_data)->hostCallbacks->clapRequestExec(num_tasks);
+    }
+
   #ifdef CLAP_WINDOW_API_NATIVE
     static void CLAP_ABI carla_resize_hints_changed(const clap_host_t* const host)
     {
@@ -371,6 +409,27 @@ struct carla_clap_input_audio_buffers {
     {
         return static_cast<const clap_audio_buffer_t*>(static_cast<const void*>(buffers));
     }
+
+    // flag channels that are all zeros, only checked when the input is already known to be quiet
+    void updateConstantMask(const bool quiet, const uint32_t frames) noexcept
+    {
+        for (uint32_t i=0; i<count; ++i)
+        {
+            clap_audio_buffer_const_t& buffer(buffers[i]);
+            buffer.constant_mask = 0;
+
+            if (! quiet)
+                continue;
+
+            for (uint32_t j=0; j<buffer.channel_count && j<64; ++j)
+            {
+                const bool zero = buffer.data64 != nullptr ? carla_isSilentDoubles(buffer.data64[j], frames, 0.0)
+                                                           : carla_isSilentFloats(buffer.data32[j], frames, 0.0f);
+                if (zero)
+                    buffer.constant_mask |= 1ULL << j;
+            }
+        }
+    }
 };
 
 struct carla_clap_output_audio_buffers {
@@ -408,6 +467,37 @@ struct carla_clap_output_audio_buffers {
             extra = nullptr;
         }
     }
+
+    void clearConstantMask() noexcept
+    {
+        for (uint32_t i=0; i<count; ++i)
+            buffers[i].constant_mask = 0;
+    }
+
+    // true if the plugin flagged all output channels as constant zero
+    bool isConstantSilence() const noexcept
+    {
+        if (count == 0)
+            return false;
+
+        for (uint32_t i=0; i<count; ++i)
+        {
+            const clap_audio_buffer_t& buffer(buffers[i]);
+
+            for (uint32_t j=0; j<buffer.channel_count; ++j)
+            {
+                if (j >= 64 || (buffer.constant_mask & (1ULL << j)) == 0)
+                    return false;
+
+                const double value = buffer.data64 != nullptr ? buffer.data64[j][0] : buffer.data32[j][0];
+
+                if (carla_isNotZero(value))
+                    return false;
+            }
+        }
+
+        return true;
+    }
 };
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -721,9 +811,13 @@ public:
           fOutputEvents(),
          #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
           fAudioOutBuffers(nullptr),
+          fAudioOutDoubles(nullptr),
          #endif
           fLastChunk(nullptr),
           fLastKnownLatency(0),
+          fMainThread(pthread_self()),
+          fProcThread(kNullThread),
+          fIsProcessing(false),
           kEngineHasIdleOnMainThread(engine->hasIdleOnMainThread()),
           fNeedsParamFlush(false),
           fNeedsRestart(false),
@@ -803,6 +897,15 @@ public:
         return fLastKnownLatency;
     }
 
+    uint32_t getTailSamples() const noexcept override
+    {
+        if (fExtensions.tail == nullptr)
+            return UINT32_MAX;
+
+        const uint32_t tail = fExtensions.tail->get(fPlugin);
+        return tail >= INT32_MAX ? UINT32_MAX : tail;
+    }
+
     // -------------------------------------------------------------------
     // Information (count)
 
@@ -1385,6 +1488,12 @@ public:
         const clap_plugin_state_t* stateExt = static_cast<const clap_plugin_state_t*>(
             fPlugin->get_extension(fPlugin, CLAP_EXT_STATE));
 
+        const clap_plugin_tail_t* tailExt = static_cast<const clap_plugin_tail_t*>(
+            fPlugin->get_extension(fPlugin, CLAP_EXT_TAIL));
+
+        const clap_plugin_thread_pool_t* threadPoolExt = static_cast<const clap_plugin_thread_pool_t*>(
+            fPlugin->get_extension(fPlugin, CLAP_EXT_THREAD_POOL));
+
         const clap_plugin_timer_support_t* timerExt = static_cast<const clap_plugin_timer_support_t*>(
             fPlugin->get_extension(fPlugin, CLAP_EXT_TIMER_SUPPORT));
 
@@ -1403,12 +1512,23 @@ public:
         if (stateExt != nullptr && (stateExt->save == nullptr || stateExt->load == nullptr))
             stateExt = nullptr;
 
+        if (tailExt != nullptr && tailExt->get == nullptr)
+            tailExt = nullptr;
+
+        if (threadPoolExt != nullptr && threadPoolExt->exec == nullptr)
+            threadPoolExt = nullptr;
+
         if (timerExt != nullptr && timerExt->on_timer == nullptr)
             timerExt = nullptr;
 
         fExtensions.latency = latencyExt;
         fExtensions.params = paramsExt;
         fExtensions.state = stateExt;
+        fExtensions.tail = tailExt;
+        fExtensions.threadPool = threadPoolExt;
+
+        if (threadPoolExt != nullptr && ! pData->engine->startWorkerPool())
+            carla_stdout("CarlaPluginCLAP::reload() - no worker threads available, plugin will process on its own");
         fExtensions.timer = timerExt;
 
        #ifdef CLAP_WINDOW_API_NATIVE
@@ -1459,6 +1579,8 @@ public:
         fInputAudioBuffers.realloc(numAudioInputPorts);
         fOutputAudioBuffers.realloc(numAudioOutputPorts);
 
+        bool supports64Bit = true;
+
         for (uint32_t i=0; i<numAudioInputPorts; ++i)
         {
             clap_audio_port_info_t portInfo = {};
@@ -1469,6 +1591,9 @@ public:
             fInputAudioBuffers.extra[i].offset = aIns;
             fInputAudioBuffers.extra[i].isMain = portInfo.flags & CLAP_AUDIO_PORT_IS_MAIN;
 
+            if ((portInfo.flags & CLAP_AUDIO_PORT_SUPPORTS_64BITS) == 0)
+                supports64Bit = false;
+
             aIns += portInfo.channel_count;
         }
 
@@ -1481,8 +1606,9 @@ public:
             fOutputAudioBuffers.buffers[i].channel_count = portInfo.channel_count;
             fOutputAudioBuffers.extra[i].offset = aOuts;
             fOutputAudioBuffers.extra[i].isMain = portInfo.flags & CLAP_AUDIO_PORT_IS_MAIN;
-            for (uint32_t j=0; j<portInfo.channel_count; ++j)
-                fOutputAudioBuffers.buffers[i].constant_mask |= (1ULL << j);
+
+            if ((portInfo.flags & CLAP_AUDIO_PORT_SUPPORTS_64BITS) == 0)
+                supports64Bit = false;
 
             aOuts += portInfo.channel_count;
         }
@@ -1525,6 +1651,13 @@ public:
             fAudioOutBuffers = new float*[aOuts];
             for (uint32_t i=0; i < aOuts; ++i)
                 fAudioOutBuffers[i] = nullptr;
+
+            if (supports64Bit && pData->engine->getOptions().audioDoublePrecision)
+            {
+                fAudioOutDoubles = new double*[aOuts];
+                for (uint32_t i=0; i < aOuts; ++i)
+                    fAudioOutDoubles[i] = nullptr;
+            }
            #endif
         }
 
@@ -1877,7 +2010,9 @@ public:
 
         // FIXME check return status
         fPlugin->activate(fPlugin, pData->engine->getSampleRate(), 1, pData->engine->getBufferSize());
-        fPlugin->start_processing(fPlugin);
+
+        // start_processing is an audio thread call, done on the first process cycle
+        fIsProcessing = false;
 
         fNeedsParamFlush = false;
         runIdleCallbacksAsNeeded(false);
@@ -1887,8 +2022,17 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
 
+        if (fIsProcessing)
+        {
+            // stop_processing is an audio thread call, but the plugin is locked here and
+            // processing stopped for good, so this thread takes the role of the audio thread
+            const CarlaScopedValueSetter<pthread_t> svs(fProcThread, pthread_self(), kNullThread);
+
+            fPlugin->stop_processing(fPlugin);
+            fIsProcessing = false;
+        }
+
         // FIXME check return status
-        fPlugin->stop_processing(fPlugin);
         fPlugin->deactivate(fPlugin);
 
         runIdleCallbacksAsNeeded(false);
@@ -1900,17 +2044,71 @@ public:
                  float** const,
                  const uint32_t frames) override
     {
+        processCLAP(audioIn, audioOut, nullptr, nullptr, cvIn, frames);
+    }
+
+   #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    bool canProcessDouble() const noexcept override
+    {
+        return fAudioOutDoubles != nullptr;
+    }
+
+    void processDouble(const double* const* const audioIn,
+                       double** const audioOut,
+                       const float* const* const cvIn,
+                       float** const,
+                       const uint32_t frames) override
+    {
+        processCLAP(nullptr, nullptr, audioIn, audioOut, cvIn, frames);
+    }
+   #endif
+
+    void zeroAudioOutputs(float** const audioOut, double** const audioOutDouble, const uint32_t frames) const noexcept
+    {
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+        {
+            if (audioOutDouble != nullptr)
+                carla_zeroDoubles(audioOutDouble[i], frames);
+            else
+                carla_zeroFloats(audioOut[i], frames);
+        }
+    }
+
+    // uses the float buffers, or the double ones when called from processDouble()
+    void processCLAP(const float* const* const audioIn,
+                     float** const audioOut,
+                     const double* const* const audioInDouble,
+                     double** const audioOutDouble,
+                     const float* const* const cvIn,
+                     const uint32_t frames)
+    {
+       #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        const bool isDouble = audioInDouble != nullptr || audioOutDouble != nullptr;
+       #endif
+
         // --------------------------------------------------------------------------------------------------------
         // Check if active
 
         if (! pData->active)
         {
             // disable any output sound
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-                carla_zeroFloats(audioOut[i], frames);
+            zeroAudioOutputs(audioOut, audioOutDouble, frames);
             return;
         }
 
+        const CarlaScopedValueSetter<pthread_t> svs(fProcThread, pthread_self(), kNullThread);
+
+        if (! fIsProcessing)
+        {
+            if (! fPlugin->start_processing(fPlugin))
+            {
+                zeroAudioOutputs(audioOut, audioOutDouble, frames);
+                return;
+            }
+
+            fIsProcessing = true;
+        }
+
         // --------------------------------------------------------------------------------------------------------
         // Check buffers
 
@@ -1918,13 +2116,14 @@ public:
 
         if (pData->audioIn.count > 0)
         {
-            CARLA_SAFE_ASSERT_RETURN(audioIn != nullptr,);
+            CARLA_SAFE_ASSERT_RETURN(audioIn != nullptr || audioInDouble != nullptr,);
         }
         if (pData->audioOut.count > 0)
         {
-            CARLA_SAFE_ASSERT_RETURN(audioOut != nullptr,);
+            CARLA_SAFE_ASSERT_RETURN(audioOut != nullptr || audioOutDouble != nullptr,);
            #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
             CARLA_SAFE_ASSERT_RETURN(fAudioOutBuffers != nullptr,);
+            CARLA_SAFE_ASSERT_RETURN(! isDouble || fAudioOutDoubles != nullptr,);
            #endif
         }
 
@@ -1933,7 +2132,12 @@ public:
 
        #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            carla_zeroFloats(fAudioOutBuffers[i], frames);
+        {
+            if (isDouble)
+                carla_zeroDoubles(fAudioOutDoubles[i], frames);
+            else
+                carla_zeroFloats(fAudioOutBuffers[i], frames);
+        }
        #endif
 
         // --------------------------------------------------------------------------------------------------------
@@ -1945,8 +2149,7 @@ public:
         }
         else if (! pData->singleMutex.tryLock())
         {
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-                carla_zeroFloats(audioOut[i], frames);
+            zeroAudioOutputs(audioOut, audioOutDouble, frames);
             return;
         }
 
@@ -2422,18 +2625,45 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Plugin processing
 
-        for (uint32_t i=0; i<fInputAudioBuffers.count; ++i)
-            fInputAudioBuffers.buffers[i].data32 = audioIn + fInputAudioBuffers.extra[i].offset;
+       #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        if (isDouble)
+        {
+            for (uint32_t i=0; i<fInputAudioBuffers.count; ++i)
+            {
+                fInputAudioBuffers.buffers[i].data32 = nullptr;
+                fInputAudioBuffers.buffers[i].data64 = audioInDouble + fInputAudioBuffers.extra[i].offset;
+            }
 
-        for (uint32_t i=0; i<fOutputAudioBuffers.count; ++i)
+            for (uint32_t i=0; i<fOutputAudioBuffers.count; ++i)
+            {
+                fOutputAudioBuffers.buffers[i].data32 = nullptr;
+                fOutputAudioBuffers.buffers[i].data64 = fAudioOutDoubles + fOutputAudioBuffers.extra[i].offset;
+            }
+        }
+        else
+       #endif
         {
-           #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-            fOutputAudioBuffers.buffers[i].data32 = fAudioOutBuffers + fOutputAudioBuffers.extra[i].offset;
-           #else
-            fOutputAudioBuffers.buffers[i].data32 = audioOut + fOutputAudioBuffers.extra[i].offset;
-           #endif
+            for (uint32_t i=0; i<fInputAudioBuffers.count; ++i)
+            {
+                fInputAudioBuffers.buffers[i].data32 = audioIn + fInputAudioBuffers.extra[i].offset;
+                fInputAudioBuffers.buffers[i].data64 = nullptr;
+            }
+
+            for (uint32_t i=0; i<fOutputAudioBuffers.count; ++i)
+            {
+               #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+                fOutputAudioBuffers.buffers[i].data32 = fAudioOutBuffers + fOutputAudioBuffers.extra[i].offset;
+               #else
+                fOutputAudioBuffers.buffers[i].data32 = audioOut + fOutputAudioBuffers.extra[i].offset;
+               #endif
+                fOutputAudioBuffers.buffers[i].data64 = nullptr;
+            }
         }
 
+        // silent input is reported through constant_mask, and the plugin can report silent output the same way
+        fInputAudioBuffers.updateConstantMask(pData->sleep.quietInput, frames);
+        fOutputAudioBuffers.clearConstantMask();
+
         const clap_process_t process = {
             static_cast<int64_t>(timeInfo.frame),
             frames,
@@ -2446,12 +2676,33 @@ public:
             fOutputEvents.cast()
         };
 
-        fPlugin->process(fPlugin, &process);
+        switch (fPlugin->process(fPlugin, &process))
+        {
+        case CLAP_PROCESS_CONTINUE:
+            pData->sleep.hint = ProtectedData::Sleep::kHintNever;
+            break;
+        case CLAP_PROCESS_CONTINUE_IF_NOT_QUIET:
+            pData->sleep.hint = ProtectedData::Sleep::kHintWhenQuiet;
+            break;
+        case CLAP_PROCESS_SLEEP:
+            pData->sleep.hint = ProtectedData::Sleep::kHintNow;
+            break;
+        default:
+            pData->sleep.hint = ProtectedData::Sleep::kHintNone;
+            break;
+        }
+
+        pData->sleep.silentOutput = fOutputAudioBuffers.isConstantSilence();
 
        #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
 
+        if (isDouble)
+        {
+            postProcessDoubles(audioInDouble, audioOutDouble, frames);
+        }
+        else
         {
             const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
             const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
@@ -2593,6 +2844,55 @@ public:
     }
 
    #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // same as the float post-processing, done in place per frame so no extra buffer is needed
+    void postProcessDoubles(const double* const* const audioIn, double** const audioOut, const uint32_t frames) const noexcept
+    {
+        const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
+        const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
+        const bool isMono    = (pData->audioIn.count == 1);
+
+        const double dryWet = pData->postProc.dryWet;
+        const double volume = pData->postProc.volume;
+        const double balRangeL = (pData->postProc.balanceLeft  + 1.0)/2.0;
+        const double balRangeR = (pData->postProc.balanceRight + 1.0)/2.0;
+
+        // dry/wet needs the input, which may be the same buffer as the output
+        if (doDryWet)
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+            {
+                const double* const dry = audioIn[isMono ? 0 : i];
+
+                for (uint32_t k=0; k < frames; ++k)
+                    fAudioOutDoubles[i][k] = (fAudioOutDoubles[i][k] * dryWet) + (dry[k] * (1.0 - dryWet));
+            }
+        }
+
+        if (doBalance)
+        {
+            for (uint32_t i=0; i+1 < pData->audioOut.count; i += 2)
+            {
+                double* const bufL = fAudioOutDoubles[i];
+                double* const bufR = fAudioOutDoubles[i+1];
+
+                for (uint32_t k=0; k < frames; ++k)
+                {
+                    const double left  = bufL[k];
+                    const double right = bufR[k];
+                    bufL[k] = left * (1.0 - balRangeL) + right * (1.0 - balRangeR);
+                    bufR[k] = right * balRangeR + left * balRangeL;
+                }
+            }
+        }
+
+        // volume (and buffer copy)
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+        {
+            for (uint32_t k=0; k < frames; ++k)
+                audioOut[i][k] = fAudioOutDoubles[i][k] * volume;
+        }
+    }
+
     void bufferSizeChanged(const uint32_t newBufferSize) override
     {
         CARLA_ASSERT_INT(newBufferSize > 0, newBufferSize);
@@ -2608,6 +2908,16 @@ public:
             fAudioOutBuffers[i] = new float[newBufferSize];
         }
 
+        if (fAudioOutDoubles != nullptr)
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+            {
+                if (fAudioOutDoubles[i] != nullptr)
+                    delete[] fAudioOutDoubles[i];
+                fAudioOutDoubles[i] = new double[newBufferSize];
+            }
+        }
+
         if (pData->active)
             activate();
 
@@ -2645,6 +2955,21 @@ public:
             delete[] fAudioOutBuffers;
             fAudioOutBuffers = nullptr;
         }
+
+        if (fAudioOutDoubles != nullptr)
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+            {
+                if (fAudioOutDoubles[i] != nullptr)
+                {
+                    delete[] fAudioOutDoubles[i];
+                    fAudioOutDoubles[i] = nullptr;
+                }
+            }
+
+            delete[] fAudioOutDoubles;
+            fAudioOutDoubles = nullptr;
+        }
        #endif
 
         fInputEvents.clear(pData->event.portIn);
@@ -2773,6 +3098,36 @@ protected:
 
     // -------------------------------------------------------------------
 
+    bool clapIsMainThread() const noexcept override
+    {
+        return pthread_equal(pthread_self(), fMainThread);
+    }
+
+    bool clapIsAudioThread() const noexcept override
+    {
+        return pthread_equal(pthread_self(), fProcThread) || pData->engine->isWorkerThread();
+    }
+
+    // -------------------------------------------------------------------
+
+    bool clapRequestExec(const uint32_t numTasks) noexcept override
+    {
+        // only valid from within process, and not from the pool itself
+        if (fExtensions.threadPool == nullptr || ! pthread_equal(pthread_self(), fProcThread))
+            return false;
+
+        return pData->engine->runWorkerTasks(numTasks, carla_clap_thread_pool_exec, this);
+    }
+
+    static void carla_clap_thread_pool_exec(void* const ptr, const uint32_t taskIndex)
+    {
+        CarlaPluginCLAP* const self = static_cast<CarlaPluginCLAP*>(ptr);
+
+        self->fExtensions.threadPool->exec(self->fPlugin, taskIndex);
+    }
+
+    // -------------------------------------------------------------------
+
   #ifdef CLAP_WINDOW_API_NATIVE
     void clapGuiResizeHintsChanged() override
     {
@@ -3227,6 +3582,8 @@ private:
         const clap_plugin_latency_t* latency;
         const clap_plugin_params_t* params;
         const clap_plugin_state_t* state;
+        const clap_plugin_tail_t* tail;
+        const clap_plugin_thread_pool_t* threadPool;
         const clap_plugin_timer_support_t* timer;
       #ifdef CLAP_WINDOW_API_NATIVE
         const clap_plugin_gui_t* gui;
@@ -3239,6 +3596,8 @@ private:
             : latency(nullptr),
               params(nullptr),
               state(nullptr),
+              tail(nullptr),
+              threadPool(nullptr),
               timer(nullptr)
           #ifdef CLAP_WINDOW_API_NATIVE
             , gui(nullptr)
@@ -3298,9 +3657,13 @@ private:
     carla_clap_output_events fOutputEvents;
    #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     float** fAudioOutBuffers;
+    double** fAudioOutDoubles; // only used in double precision mode, for plugins where all ports support 64-bit
    #endif
     void* fLastChunk;
     uint32_t fLastKnownLatency;
+    const pthread_t fMainThread;
+    pthread_t fProcThread;
+    bool fIsProcessing; // start_processing was called, only used on the audio thread or with the plugin locked
     const bool kEngineHasIdleOnMainThread;
     bool fNeedsParamFlush;
     bool fNeedsRestart;
@@ -0,0 +1,507 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaPluginFreeze.hpp"
+#include "CarlaMathUtils.hpp"
+
+#include "water/files/File.h"
+#include "water/files/FileInputStream.h"
+#include "water/files/FileOutputStream.h"
+
+CARLA_BACKEND_START_NAMESPACE
+
+using water::CharPointer_UTF8;
+using water::File;
+using water::FileInputStream;
+using water::FileOutputStream;
+using water::String;
+
+// -----------------------------------------------------------------------
+
+// playback window length, caches up to this size are kept in memory in full
+static const double kWindowSeconds = 8.0;
+
+// frames converted per disk access
+static const uint32_t kInterleavedFrames = 4096;
+
+// FNV-1a
+static const uint32_t kHashInit  = 2166136261U;
+static const uint32_t kHashPrime = 16777619U;
+
+static inline
+uint32_t hashWord(const uint32_t hash, const uint32_t word) noexcept
+{
+    return (hash ^ word) * kHashPrime;
+}
+
+// -----------------------------------------------------------------------
+// CarlaPluginFreezeCache
+
+CarlaPluginFreezeCache::CarlaPluginFreezeCache(const uint32_t numChannels,
+                                               const double sampleRate,
+                                               const uint64_t startFrame,
+                                               const uint64_t numFrames) noexcept
+    : CarlaThread("CarlaPluginFreezeCache"),
+      fNumChannels(numChannels),
+      fSampleRate(sampleRate),
+      fStartFrame(startFrame),
+      fNumFrames(numFrames),
+      fFilename(),
+      fOutput(nullptr),
+      fFramesRecorded(0),
+      fRecordFailed(false),
+      fInputHashes(nullptr),
+      fNumInputHashes(0),
+      fHashNextFrame(0),
+      fAudioHash(kHashInit),
+      fEventHash(kHashInit),
+      fHashValid(false),
+      fInput(nullptr),
+      fInputMutex(),
+      fInterleaved(nullptr),
+      fWindowSize(0),
+      fCurrentWindow(0),
+      fWindowReady(0),
+      fReadRequested(0),
+      fReadFrame(0)
+{
+    carla_zeroStructs(fWindows, 2);
+}
+
+CarlaPluginFreezeCache::~CarlaPluginFreezeCache() noexcept
+{
+    stopThread(-1);
+    freeResources();
+
+    if (fFilename.isNotEmpty())
+    {
+        const String jfilename = String(CharPointer_UTF8(fFilename.buffer()));
+        File(jfilename).deleteFile();
+    }
+}
+
+bool CarlaPluginFreezeCache::startRecording()
+{
+    CARLA_SAFE_ASSERT_RETURN(fNumChannels > 0, false);
+    CARLA_SAFE_ASSERT_RETURN(fNumFrames > 0, false);
+    CARLA_SAFE_ASSERT_RETURN(fOutput == nullptr, false);
+    carla_debug("CarlaPluginFreezeCache::startRecording()");
+
+    const File file(File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("carla-freeze", ".raw", false));
+    fFilename = file.getFullPathName().toRawUTF8();
+
+    fNumInputHashes = static_cast<uint32_t>((fNumFrames + kHashBlockFrames - 1) / kHashBlockFrames);
+
+    try {
+        fInputHashes = new uint32_t[fNumInputHashes];
+        fInterleaved = new float[kInterleavedFrames * fNumChannels];
+    } CARLA_SAFE_EXCEPTION_RETURN("CarlaPluginFreezeCache::startRecording", false);
+
+    carla_zeroStructs(fInputHashes, fNumInputHashes);
+
+    fOutput = new FileOutputStream(file, 65536);
+
+    if (fOutput->failedToOpen())
+    {
+        delete fOutput;
+        fOutput = nullptr;
+        return false;
+    }
+
+    fFramesRecorded = 0;
+    fRecordFailed = false;
+    fHashValid = false;
+    return true;
+}
+
+bool CarlaPluginFreezeCache::finishRecording()
+{
+    CARLA_SAFE_ASSERT_RETURN(fOutput != nullptr, false);
+    carla_debug("CarlaPluginFreezeCache::finishRecording()");
+
+    fOutput->flush();
+
+    const bool recorded = ! fRecordFailed && fFramesRecorded == fNumFrames && fOutput->getStatus().wasOk();
+
+    delete fOutput;
+    fOutput = nullptr;
+
+    if (! recorded)
+        return false;
+
+    // playback starts hashing from scratch
+    fHashValid = false;
+
+    const String jfilename = String(CharPointer_UTF8(fFilename.buffer()));
+    fInput = new FileInputStream(File(jfilename));
+
+    if (fInput->failedToOpen())
+        return false;
+
+    fWindowSize = static_cast<uint32_t>(std::min<uint64_t>(fNumFrames,
+                                                           static_cast<uint64_t>(fSampleRate * kWindowSeconds)));
+
+    try {
+        fWindows[0].data = new float[fWindowSize * fNumChannels];
+        fWindows[1].data = new float[fWindowSize * fNumChannels];
+    } CARLA_SAFE_EXCEPTION_RETURN("CarlaPluginFreezeCache::finishRecording", false);
+
+    fCurrentWindow = 0;
+    fWindowReady.set(0);
+    fReadRequested.set(0);
+
+    if (! readWindow(fWindows[0], 0))
+        return false;
+
+    // short caches are fully in memory now
+    if (fWindowSize == fNumFrames)
+        return true;
+
+    return startThread();
+}
+
+uint32_t CarlaPluginFreezeCache::getNumChannels() const noexcept
+{
+    return fNumChannels;
+}
+
+double CarlaPluginFreezeCache::getSampleRate() const noexcept
+{
+    return fSampleRate;
+}
+
+// -----------------------------------------------------------------------
+
+bool CarlaPluginFreezeCache::checkInputRT(const uint64_t frame,
+                                          const float* const* const audioIn,
+                                          const uint32_t numAudioIns,
+                                          const CarlaEngineEventPort* const eventIn,
+                                          const uint32_t frames) noexcept
+{
+    const uint64_t endFrame = fStartFrame + fNumFrames;
+
+    if (frame + frames <= fStartFrame || frame >= endFrame)
+    {
+        fHashValid = false;
+        return true;
+    }
+
+    const uint64_t first = std::max(frame, fStartFrame);
+    const uint64_t last  = std::min(frame + frames, endFrame);
+
+    // not continuing the previous cycle, the block in progress cannot be completed
+    if (first - fStartFrame != fHashNextFrame)
+        fHashValid = false;
+
+    const uint32_t eventCount = eventIn != nullptr ? eventIn->getEventCount() : 0;
+    uint32_t eventIndex = 0;
+    bool matches = true;
+
+    for (uint64_t pos = first; pos < last;)
+    {
+        const uint64_t cacheFrame  = pos - fStartFrame;
+        const uint32_t blockOffset = static_cast<uint32_t>(cacheFrame % kHashBlockFrames);
+        const uint64_t blockEnd    = std::min<uint64_t>(cacheFrame - blockOffset + kHashBlockFrames, fNumFrames);
+        const uint32_t offset      = static_cast<uint32_t>(pos - frame);
+        const uint32_t count       = static_cast<uint32_t>(std::min(blockEnd - cacheFrame, last - pos));
+
+        if (blockOffset == 0)
+        {
+            fAudioHash = kHashInit;
+            fEventHash = kHashInit;
+            fHashValid = true;
+        }
+
+        // frame by frame, so the hash does not depend on how the block is split over cycles
+        for (uint32_t i=0; i < count; ++i)
+        {
+            for (uint32_t c=0; c < numAudioIns; ++c)
+            {
+                uint32_t word;
+                std::memcpy(&word, audioIn[c] + offset + i, sizeof(word));
+                fAudioHash = hashWord(fAudioHash, word);
+            }
+        }
+
+        for (; eventIndex < eventCount; ++eventIndex)
+        {
+            const EngineEvent& event(eventIn->getEvent(eventIndex));
+
+            if (event.time >= offset + count)
+                break;
+            if (event.time >= offset)
+                fEventHash = hashEvent(fEventHash, event, event.time - offset + blockOffset);
+        }
+
+        pos += count;
+
+        if (cacheFrame + count != blockEnd || ! fHashValid)
+            continue;
+
+        const uint32_t index = static_cast<uint32_t>(cacheFrame / kHashBlockFrames);
+        CARLA_SAFE_ASSERT_CONTINUE(index < fNumInputHashes);
+
+        const uint32_t hash = hashWord(fAudioHash, fEventHash);
+
+        if (fOutput != nullptr)
+            fInputHashes[index] = hash;
+        else if (fInputHashes[index] != hash)
+            matches = false;
+
+        fHashValid = false;
+    }
+
+    fHashNextFrame = last - fStartFrame;
+    return matches;
+}
+
+void CarlaPluginFreezeCache::recordRT(const uint64_t frame, const float* const* const audioOut, const uint32_t frames) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fOutput != nullptr,);
+
+    if (fRecordFailed || frame + frames <= fStartFrame || frame >= fStartFrame + fNumFrames)
+        return;
+
+    // the range is rendered from its start, in order
+    if (frame < fStartFrame || frame - fStartFrame != fFramesRecorded)
+    {
+        carla_stderr2("CarlaPluginFreezeCache::recordRT() - unexpected frame " P_UINT64 ", expected " P_UINT64,
+                      frame, fStartFrame + fFramesRecorded);
+        fRecordFailed = true;
+        return;
+    }
+
+    const uint32_t toRecord = static_cast<uint32_t>(std::min<uint64_t>(frames, fNumFrames - fFramesRecorded));
+
+    for (uint32_t done = 0; done < toRecord;)
+    {
+        const uint32_t chunk = std::min(toRecord - done, kInterleavedFrames);
+
+        for (uint32_t c=0; c < fNumChannels; ++c)
+        {
+            const float* const src = audioOut[c] + done;
+
+            for (uint32_t i=0; i < chunk; ++i)
+                fInterleaved[i * fNumChannels + c] = src[i];
+        }
+
+        if (! fOutput->write(fInterleaved, chunk * fNumChannels * sizeof(float)))
+        {
+            fRecordFailed = true;
+            return;
+        }
+
+        done += chunk;
+    }
+
+    fFramesRecorded += toRecord;
+}
+
+bool CarlaPluginFreezeCache::playRT(const uint64_t frame,
+                                    float* const* const audioOut,
+                                    const uint32_t frames,
+                                    const bool isOffline) noexcept
+{
+    for (uint32_t c=0; c < fNumChannels; ++c)
+        carla_zeroFloats(audioOut[c], frames);
+
+    const uint64_t endFrame = fStartFrame + fNumFrames;
+
+    if (frame + frames <= fStartFrame || frame >= endFrame)
+        return true;
+
+    // the reader thread has the other window ready, switch to it
+    if (fWindowReady.get() != 0)
+    {
+        fCurrentWindow = 1 - fCurrentWindow;
+        fWindowReady.set(0);
+    }
+
+    const uint64_t first = std::max(frame, fStartFrame);
+    const uint64_t cacheFrame = first - fStartFrame;
+    const uint32_t outOffset = static_cast<uint32_t>(first - frame);
+    const uint32_t count = static_cast<uint32_t>(std::min(frame + frames, endFrame) - first);
+
+    Window* window = &fWindows[fCurrentWindow];
+
+    if (cacheFrame < window->start || cacheFrame + count > window->start + window->frames)
+    {
+        if (! isOffline)
+        {
+            requestRead(cacheFrame);
+            return false;
+        }
+
+        // offline processing can wait for the disk
+        const CarlaMutexLocker cml(fInputMutex);
+
+        if (! readWindow(*window, cacheFrame) || cacheFrame + count > window->start + window->frames)
+            return false;
+    }
+    else if (window->start + window->frames < fNumFrames &&
+             cacheFrame + count > window->start + fWindowSize / 2)
+    {
+        // past the middle of the window, prepare the next one
+        requestRead(cacheFrame);
+    }
+
+    const uint32_t windowOffset = static_cast<uint32_t>(cacheFrame - window->start);
+
+    for (uint32_t c=0; c < fNumChannels; ++c)
+        carla_copyFloats(audioOut[c] + outOffset, window->data + c * fWindowSize + windowOffset, count);
+
+    return true;
+}
+
+// -----------------------------------------------------------------------
+
+void CarlaPluginFreezeCache::run()
+{
+    while (! shouldThreadExit())
+    {
+        if (fReadRequested.get() == 0 || fWindowReady.get() != 0)
+        {
+            carla_msleep(5);
+            continue;
+        }
+
+        const uint64_t frame = fReadFrame;
+
+        {
+            const CarlaMutexLocker cml(fInputMutex);
+            readWindow(fWindows[1 - fCurrentWindow], frame);
+        }
+
+        fWindowReady.set(1);
+        fReadRequested.set(0);
+    }
+}
+
+uint32_t CarlaPluginFreezeCache::hashEvent(uint32_t hash, const EngineEvent& event, const uint32_t offset) noexcept
+{
+    hash = hashWord(hash, static_cast<uint32_t>(event.type));
+    hash = hashWord(hash, offset);
+    hash = hashWord(hash, event.channel);
+
+    switch (event.type)
+    {
+    case kEngineEventTypeNull:
+        break;
+
+    case kEngineEventTypeControl: {
+        uint32_t value;
+        std::memcpy(&value, &event.ctrl.normalizedValue, sizeof(value));
+
+        hash = hashWord(hash, static_cast<uint32_t>(event.ctrl.type));
+        hash = hashWord(hash, event.ctrl.param);
+        hash = hashWord(hash, static_cast<uint32_t>(event.ctrl.midiValue));
+        hash = hashWord(hash, value);
+    }   break;
+
+    case kEngineEventTypeMidi: {
+        const uint8_t* const data = event.midi.size > EngineMidiEvent::kDataSize
+                                  ? event.midi.dataExt
+                                  : event.midi.data;
+
+        hash = hashWord(hash, event.midi.port);
+        hash = hashWord(hash, event.midi.size);
+
+        if (data != nullptr)
+        {
+            for (uint8_t j=0; j < event.midi.size; ++j)
+                hash = hashWord(hash, data[j]);
+        }
+    }   break;
+    }
+
+    return hash;
+}
+
+bool CarlaPluginFreezeCache::readWindow(Window& window, const uint64_t frame) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fInput != nullptr, false);
+    CARLA_SAFE_ASSERT_RETURN(frame < fNumFrames, false);
+
+    const uint32_t toRead = static_cast<uint32_t>(std::min<uint64_t>(fWindowSize, fNumFrames - frame));
+
+    window.start = frame;
+    window.frames = 0;
+
+    if (! fInput->setPosition(static_cast<water::int64>(frame * fNumChannels * sizeof(float))))
+        return false;
+
+    for (uint32_t done = 0; done < toRead;)
+    {
+        const uint32_t chunk = std::min(toRead - done, kInterleavedFrames);
+        const int chunkBytes = static_cast<int>(chunk * fNumChannels * sizeof(float));
+
+        if (fInput->read(fInterleaved, chunkBytes) != chunkBytes)
+            return false;
+
+        for (uint32_t c=0; c < fNumChannels; ++c)
+        {
+            float* const dst = window.data + c * fWindowSize + done;
+
+            for (uint32_t i=0; i < chunk; ++i)
+                dst[i] = fInterleaved[i * fNumChannels + c];
+        }
+
+        done += chunk;
+        window.frames = done;
+    }
+
+    return true;
+}
+
+void CarlaPluginFreezeCache::requestRead(const uint64_t frame) noexcept
+{
+    if (fReadRequested.get() != 0)
+        return;
+
+    fReadFrame = frame;
+    fReadRequested.set(1);
+}
+
+void CarlaPluginFreezeCache::freeResources() noexcept
+{
+    if (fOutput != nullptr)
+    {
+        delete fOutput;
+        fOutput = nullptr;
+    }
+
+    if (fInput != nullptr)
+    {
+        delete fInput;
+        fInput = nullptr;
+    }
+
+    delete[] fInputHashes;
+    fInputHashes = nullptr;
+    fNumInputHashes = 0;
+
+    delete[] fInterleaved;
+    fInterleaved = nullptr;
+
+    delete[] fWindows[0].data;
+    delete[] fWindows[1].data;
+    carla_zeroStructs(fWindows, 2);
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,167 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_PLUGIN_FREEZE_HPP_INCLUDED
+#define CARLA_PLUGIN_FREEZE_HPP_INCLUDED
+
+#include "CarlaEngine.hpp"
+#include "CarlaMutex.hpp"
+#include "CarlaString.hpp"
+#include "CarlaThread.hpp"
+
+#include "CarlaJuceUtils.hpp"
+
+#include "water/memory/Atomic.h"
+
+namespace water {
+class FileInputStream;
+class FileOutputStream;
+}
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaPluginFreezeCache
+
+/*!
+ * On-disk cache of a plugin's audio output over a transport range, used for freezing plugins.
+ *
+ * The cache is recorded while the engine renders the range offline, one engine buffer at a time.
+ * A hash of the plugin input is kept for each block of kHashBlockFrames, so playback can tell when the input
+ * no longer matches what was rendered, whatever buffer size and position it runs at.
+ *
+ * For playback a background thread streams the file into one of two memory windows,
+ * the audio thread switches windows without locking and copies from the current one.
+ * Caches that fit in a single window are loaded once and do not need the thread.
+ */
+class CarlaPluginFreezeCache : private CarlaThread
+{
+public:
+    static const uint32_t kHashBlockFrames = 64;
+
+    CarlaPluginFreezeCache(uint32_t numChannels, double sampleRate, uint64_t startFrame, uint64_t numFrames) noexcept;
+    ~CarlaPluginFreezeCache() noexcept override;
+
+    /*!
+     * Create the cache file in the temporary directory and get ready for recording.
+     */
+    bool startRecording();
+
+    /*!
+     * Finish recording and get ready for playback.
+     * Fails if not all frames were recorded, the cache cannot be used in that case.
+     */
+    bool finishRecording();
+
+    /*!
+     * Get the number of cached audio channels.
+     */
+    uint32_t getNumChannels() const noexcept;
+
+    /*!
+     * Get the sample rate used for recording.
+     */
+    double getSampleRate() const noexcept;
+
+    /*!
+     * Hash the plugin input for the engine buffer starting at transport @a frame.
+     * The hash of each block is continued over consecutive calls and completed at the end of the block.
+     * While recording it is stored, during playback it is compared with the recorded one.
+     * After a jump in position, checking resumes from the next block.
+     * Returns false if the input of a completed block differs from the recorded input.
+     * @note RT call
+     */
+    bool checkInputRT(uint64_t frame, const float* const* audioIn, uint32_t numAudioIns,
+                      const CarlaEngineEventPort* eventIn, uint32_t frames) noexcept;
+
+    /*!
+     * Store the plugin output for the engine buffer starting at transport @a frame.
+     * Frames outside the cached range are ignored.
+     * @note Called from the offline render thread
+     */
+    void recordRT(uint64_t frame, const float* const* audioOut, uint32_t frames) noexcept;
+
+    /*!
+     * Write the cached output for the engine buffer starting at transport @a frame into @a audioOut.
+     * Frames outside the cached range are silent.
+     * Returns false if the needed audio is not in memory yet, the output is silent in that case.
+     * When @a isOffline is true the audio is read from disk right away instead.
+     * @note RT call
+     */
+    bool playRT(uint64_t frame, float* const* audioOut, uint32_t frames, bool isOffline) noexcept;
+
+protected:
+    void run() override;
+
+private:
+    struct Window {
+        float*   data;    // non-interleaved, fWindowSize frames per channel
+        uint64_t start;   // first cache frame
+        uint32_t frames;  // number of valid frames
+    };
+
+    const uint32_t fNumChannels;
+    const double   fSampleRate;
+    const uint64_t fStartFrame;
+    const uint64_t fNumFrames;
+
+    CarlaString fFilename;
+
+    // recording
+    water::FileOutputStream* fOutput;
+    uint64_t fFramesRecorded;
+    bool     fRecordFailed;
+
+    // one input hash per block of kHashBlockFrames
+    uint32_t* fInputHashes;
+    uint32_t  fNumInputHashes;
+
+    // block being hashed by the audio thread, audio and events separately
+    uint64_t fHashNextFrame;
+    uint32_t fAudioHash;
+    uint32_t fEventHash;
+    bool     fHashValid;
+
+    // playback
+    water::FileInputStream* fInput;
+    CarlaMutex fInputMutex;
+    float*   fInterleaved;
+    uint32_t fWindowSize;
+    Window   fWindows[2];
+
+    // window used by the audio thread, only changed while fWindowReady is set
+    volatile int fCurrentWindow;
+
+    // the reader thread sets fWindowReady after filling the other window, the audio thread clears it on switch
+    water::Atomic<int> fWindowReady;
+    water::Atomic<int> fReadRequested;
+    volatile uint64_t fReadFrame;
+
+    static uint32_t hashEvent(uint32_t hash, const EngineEvent& event, uint32_t offset) noexcept;
+
+    bool readWindow(Window& window, uint64_t frame) noexcept;
+    void requestRead(uint64_t frame) noexcept;
+    void freeResources() noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginFreezeCache)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_PLUGIN_FREEZE_HPP_INCLUDED
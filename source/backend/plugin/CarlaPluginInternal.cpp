@@ -16,12 +16,15 @@
  */
 
 #include "CarlaPluginInternal.hpp"
+#include "CarlaPluginFreeze.hpp"
 #include "CarlaEngine.hpp"
 
 #include "CarlaLibCounter.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
 
+#include "water/memory/Atomic.h"
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -------------------------------------------------------------------
@@ -629,6 +632,77 @@ void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChan
 }
 #endif
 
+// -----------------------------------------------------------------------
+// ProtectedData::Sleep
+
+CarlaPlugin::ProtectedData::Sleep::Sleep() noexcept
+    : asleep(false),
+      quietInput(false),
+      silentOutput(false),
+      transportPlaying(false),
+      transportFrame(0),
+      quietFrames(0),
+      tail(UINT32_MAX),
+      userTail(-1),
+      hint(kHintNone),
+      wakeRequested(false) {}
+
+void CarlaPlugin::ProtectedData::Sleep::reset() noexcept
+{
+    asleep = false;
+    quietInput = false;
+    silentOutput = false;
+    quietFrames = 0;
+    hint = kHintNone;
+}
+
+// -----------------------------------------------------------------------
+// ProtectedData::Freeze
+
+CarlaPlugin::ProtectedData::Freeze::Freeze() noexcept
+    : cache(nullptr),
+      recording(false),
+      invalidated(false) {}
+
+CarlaPlugin::ProtectedData::Freeze::~Freeze() noexcept
+{
+    delete cache;
+}
+
+void CarlaPlugin::ProtectedData::Freeze::invalidate() noexcept
+{
+    if (cache != nullptr && ! recording)
+        invalidated = true;
+}
+
+// -----------------------------------------------------------------------
+// ProtectedData::Changes
+
+CarlaPlugin::ProtectedData::Changes::Changes() noexcept
+    : mutex(),
+      counter(0),
+      values(nullptr),
+      valueCount(0),
+      program(-1),
+      midiProgram(-1)
+{
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    carla_zeroFloats(internals, 7);
+#endif
+}
+
+CarlaPlugin::ProtectedData::Changes::~Changes() noexcept
+{
+    delete[] values;
+}
+
+uint64_t CarlaPlugin::ProtectedData::Changes::nextCounter() noexcept
+{
+    static water::Atomic<int64_t> sCounter;
+
+    return static_cast<uint64_t>(++sCounter);
+}
+
 // -----------------------------------------------------------------------
 // ProtectedData::PostRtEvents
 
@@ -727,6 +801,7 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       needsReset(false),
       engineBridged(eng->getType() == kEngineTypeBridge),
       enginePlugin(eng->getType() == kEngineTypePlugin),
+      uiShown(false),
       lib(nullptr),
       uiLib(nullptr),
       ctrlChannel(0),
@@ -754,6 +829,9 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       uiTitle(),
       extNotes(),
       latency(),
+      sleep(),
+      freeze(),
+      changes(),
       postRtEvents(),
       postUiEvents()
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -1008,6 +1086,9 @@ void CarlaPlugin::ProtectedData::updateParameterValues(CarlaPlugin* const plugin
 {
     CARLA_SAFE_ASSERT_RETURN(sendOsc || sendCallback || useDefault,);
 
+    // called after loading a new plugin state
+    freeze.invalidate();
+
     for (uint32_t i=0; i < param.count; ++i)
     {
         const float value(param.ranges[i].getFixedValue(plugin->getParameterValue(i)));
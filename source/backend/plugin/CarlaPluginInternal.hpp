@@ -31,6 +31,8 @@
 
 CARLA_BACKEND_START_NAMESPACE
 
+class CarlaPluginFreezeCache;
+
 // -----------------------------------------------------------------------
 // Engine helper macro, sets lastError and returns false/NULL
 
@@ -253,6 +255,9 @@ struct CarlaPlugin::ProtectedData {
     bool engineBridged;
     bool enginePlugin;
 
+    // custom UI shown, read by the engine graph
+    volatile bool uiShown;
+
     lib_t lib;
     lib_t uiLib;
 
@@ -320,6 +325,68 @@ struct CarlaPlugin::ProtectedData {
 
     } latency;
 
+    struct Sleep {
+        enum Hint {
+            kHintNone,       // use the plugin tail
+            kHintNever,      // plugin asked to keep processing
+            kHintWhenQuiet,  // plugin can sleep once the output is silent
+            kHintNow         // plugin can sleep as soon as the input is silent
+        };
+
+        bool asleep;
+        bool quietInput;
+        bool silentOutput;  // set by plugins that know their output is silent, like CLAP constant_mask
+        bool transportPlaying;
+        uint64_t transportFrame; // expected transport frame of the next cycle
+        uint32_t quietFrames;
+        uint32_t tail;
+        int32_t userTail;
+        Hint hint;
+        volatile bool wakeRequested;
+
+        Sleep() noexcept;
+        void reset() noexcept;
+
+        CARLA_DECLARE_NON_COPYABLE(Sleep)
+
+    } sleep;
+
+    struct Freeze {
+        CarlaPluginFreezeCache* cache;
+        bool recording;
+        volatile bool invalidated;
+
+        Freeze() noexcept;
+        ~Freeze() noexcept;
+
+        // stop using the cache, it is deleted later on idle
+        void invalidate() noexcept;
+
+        CARLA_DECLARE_NON_COPYABLE(Freeze)
+
+    } freeze;
+
+    struct Changes {
+        CarlaMutex mutex;
+        uint64_t counter;       // 0 if never checked
+        float* values;          // parameter values seen on the last check
+        uint32_t valueCount;
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        float internals[7];     // PARAMETER_ACTIVE down to PARAMETER_CTRL_CHANNEL
+#endif
+        int32_t program;
+        int32_t midiProgram;
+
+        Changes() noexcept;
+        ~Changes() noexcept;
+
+        // new counter value, unique within the process
+        static uint64_t nextCounter() noexcept;
+
+        CARLA_DECLARE_NON_COPYABLE(Changes)
+
+    } changes;
+
     class PostRtEvents {
     public:
         PostRtEvents() noexcept;
@@ -515,6 +515,27 @@ public:
     void process(const float* const* const audioIn, float** const audioOut,
                  const float* const* const, float**,
                  const uint32_t frames) override
+    {
+        processJSFX(audioIn, audioOut, nullptr, nullptr, frames);
+    }
+
+    // EEL code runs in double precision, so give it the graph buffers directly when possible
+    bool canProcessDouble() const noexcept override
+    {
+        return fEffect != nullptr && pData->engine->getOptions().audioDoublePrecision;
+    }
+
+    void processDouble(const double* const* const audioIn, double** const audioOut,
+                       const float* const* const, float**,
+                       const uint32_t frames) override
+    {
+        processJSFX(nullptr, nullptr, audioIn, audioOut, frames);
+    }
+
+    // only one of the float or double buffer pairs is used
+    void processJSFX(const float* const* const audioIn, float** const audioOut,
+                     const double* const* const audioInDouble, double** const audioOutDouble,
+                     const uint32_t frames)
     {
         CARLA_SAFE_ASSERT_RETURN(fEffect,);
 
@@ -845,7 +866,10 @@ public:
 
         const uint32_t numInputs = ysfx_get_num_inputs(fEffect);
         const uint32_t numOutputs = ysfx_get_num_outputs(fEffect);
-        ysfx_process_float(fEffect, audioIn, audioOut, numInputs, numOutputs, frames);
+        if (audioOutDouble != nullptr || audioInDouble != nullptr)
+            ysfx_process_double(fEffect, audioInDouble, audioOutDouble, numInputs, numOutputs, frames);
+        else
+            ysfx_process_float(fEffect, audioIn, audioOut, numInputs, numOutputs, frames);
 
         // End of Plugin processing (no events)
 
@@ -1551,6 +1551,13 @@ public:
             case kPluginBridgeNonRtServerVersion:
             case kPluginBridgeNonRtServerRespEmbedUI:
             case kPluginBridgeNonRtServerResizeEmbedUI:
+            case kPluginBridgeNonRtServerChunkDataReceived:
+                break;
+
+            case kPluginBridgeNonRtServerSetChunkDataShm:
+            case kPluginBridgeNonRtServerResizeChunkPool:
+                // ulong/size
+                fShmNonRtServerControl.readULong();
                 break;
 
             case kPluginBridgeNonRtServerSetChunkDataFile:
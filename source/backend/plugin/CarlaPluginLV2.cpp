@@ -23,6 +23,7 @@
 #include "CarlaEngine.hpp"
 
 #include "CarlaLv2Utils.hpp"
+#include "CarlaPluginLV2Index.hpp"
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
@@ -6488,14 +6489,18 @@ public:
         // ---------------------------------------------------------------
         // Init LV2 World if needed, sets LV2_PATH for lilv
 
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+        // only the bundles needed for this plugin are loaded while the cached index is valid
+
+        const char* lv2path;
 
         if (opts.pathLV2 != nullptr && opts.pathLV2[0] != '\0')
-            lv2World.initIfNeeded(opts.pathLV2);
+            lv2path = opts.pathLV2;
         else if (const char* const LV2_PATH = std::getenv("LV2_PATH"))
-            lv2World.initIfNeeded(LV2_PATH);
+            lv2path = LV2_PATH;
         else
-            lv2World.initIfNeeded(LILV_DEFAULT_LV2_PATH);
+            lv2path = LILV_DEFAULT_LV2_PATH;
+
+        CarlaPluginLV2Index::initWorldForURI(lv2path, uri);
 
         // ---------------------------------------------------------------
         // get plugin from lv2_rdf (lilv)
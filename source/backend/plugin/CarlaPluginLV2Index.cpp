@@ -0,0 +1,273 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaPluginLV2Index.hpp"
+#include "CarlaCacheUtils.hpp"
+#include "CarlaLv2Utils.hpp"
+
+#include "water/files/File.h"
+#include "water/text/StringArray.h"
+
+#include <algorithm>
+
+CARLA_BACKEND_START_NAMESPACE
+
+using water::CharPointer_UTF8;
+using water::File;
+using water::String;
+using water::StringArray;
+
+// -----------------------------------------------------------------------
+
+// first line of the index file, change the version when the format changes
+static const char* const kIndexHeader = "carla-lv2-index\t1";
+
+// -----------------------------------------------------------------------
+
+CarlaPluginLV2Index::CarlaPluginLV2Index(const char* const lv2path)
+    : fLv2Path(CharPointer_UTF8(lv2path)),
+      fBundles() {}
+
+void CarlaPluginLV2Index::initWorldForURI(const char* const lv2path, const char* const uri)
+{
+    CARLA_SAFE_ASSERT_RETURN(lv2path != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
+
+    Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+
+    if (! lv2World.needsInit)
+        return;
+
+    // loaded before, together with another plugin
+    if (lv2World.allPlugins != nullptr && lv2World.getPluginFromURI(uri) != nullptr)
+        return;
+
+    CarlaPluginLV2Index index(lv2path);
+    index.scanBundles();
+
+    std::vector<String> bundleURIs;
+    const bool indexIsValid = index.readIndex(uri, bundleURIs);
+
+    if (indexIsValid)
+    {
+        std::vector<const char*> bundleURIsPtr;
+        bundleURIsPtr.reserve(bundleURIs.size() + 1);
+
+        for (std::vector<String>::const_iterator it = bundleURIs.begin(); it != bundleURIs.end(); ++it)
+            bundleURIsPtr.push_back(it->toRawUTF8());
+
+        bundleURIsPtr.push_back(nullptr);
+
+        // the bundles did not change since the index was written,
+        // so a plugin not listed in it is not installed and a full load would not find it either
+        lv2World.load_bundles_partially(bundleURIsPtr.data());
+        return;
+    }
+
+    lv2World.initIfNeeded(lv2path);
+    index.writeIndex();
+}
+
+// -----------------------------------------------------------------------
+
+void CarlaPluginLV2Index::scanBundles()
+{
+    fBundles.clear();
+
+    const StringArray splitPaths(StringArray::fromTokens(fLv2Path, CARLA_OS_SPLIT_STR, ""));
+
+    for (String *it = splitPaths.begin(), *end = splitPaths.end(); it != end; ++it)
+    {
+        if (! File::isAbsolutePath(*it))
+            continue;
+
+        const File dir(*it);
+
+        if (! dir.isDirectory())
+            continue;
+
+        std::vector<File> results;
+        dir.findChildFiles(results, File::findDirectories, false);
+        std::sort(results.begin(), results.end());
+
+        for (std::vector<File>::const_iterator it2 = results.begin(); it2 != results.end(); ++it2)
+        {
+            const File manifest(it2->getChildFile("manifest.ttl"));
+
+            if (! manifest.existsAsFile())
+                continue;
+
+            const Bundle bundle = {
+                it2->getFullPathName(),
+                manifest.getLastModificationTime(),
+                manifest.getSize()
+            };
+            fBundles.push_back(bundle);
+        }
+    }
+}
+
+bool CarlaPluginLV2Index::readIndex(const char* const uri, std::vector<String>& bundleURIs) const
+{
+    const File indexFile(getIndexFilename());
+
+    if (! indexFile.existsAsFile())
+        return false;
+
+    StringArray lines;
+    indexFile.readLines(lines);
+
+    if (lines.size() < 2 || lines[0] != kIndexHeader || lines[1] != "path\t" + fLv2Path)
+        return false;
+
+    const String uriStr = String(CharPointer_UTF8(uri));
+    String pluginBundleURI;
+    std::size_t numBundles = 0;
+
+    for (int i = 2, count = lines.size(); i < count; ++i)
+    {
+        const StringArray tokens(StringArray::fromTokens(lines[i], "\t", ""));
+
+        if (tokens.size() == 0)
+            continue;
+
+        if (tokens[0] == "bundle")
+        {
+            // bundles are compared in order, any difference means the index is stale
+            if (tokens.size() != 4 || numBundles >= fBundles.size())
+                return false;
+
+            const Bundle& bundle(fBundles[numBundles++]);
+
+            if (tokens[1].getLargeIntValue() != bundle.mtime ||
+                tokens[2].getLargeIntValue() != bundle.size ||
+                tokens[3] != bundle.path)
+            {
+                return false;
+            }
+        }
+        else if (tokens[0] == "load")
+        {
+            CARLA_SAFE_ASSERT_RETURN(tokens.size() == 2, false);
+            bundleURIs.push_back(tokens[1]);
+        }
+        else if (tokens[0] == "plugin")
+        {
+            CARLA_SAFE_ASSERT_RETURN(tokens.size() == 3, false);
+
+            if (tokens[1] == uriStr)
+                pluginBundleURI = tokens[2];
+        }
+    }
+
+    if (numBundles != fBundles.size())
+        return false;
+
+    if (pluginBundleURI.isNotEmpty())
+        bundleURIs.insert(bundleURIs.begin(), pluginBundleURI);
+
+    return true;
+}
+
+void CarlaPluginLV2Index::writeIndex() const
+{
+    Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+    CARLA_SAFE_ASSERT_RETURN(! lv2World.needsInit,);
+
+    std::vector<bool> bundleHasPlugins(fBundles.size(), false);
+    String plugins;
+
+    for (uint i=0, count=lv2World.getPluginCount(); i < count; ++i)
+    {
+        const LilvPlugin* const cPlugin(lv2World.getPluginFromIndex(i));
+        CARLA_SAFE_ASSERT_CONTINUE(cPlugin != nullptr);
+
+        const char* const pluginURI(lilv_node_as_uri(lilv_plugin_get_uri(cPlugin)));
+        const char* const bundleURI(lilv_node_as_uri(lilv_plugin_get_bundle_uri(cPlugin)));
+        CARLA_SAFE_ASSERT_CONTINUE(pluginURI != nullptr && bundleURI != nullptr);
+
+        char* const bundlePath(lilv_file_uri_parse(bundleURI, nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(bundlePath != nullptr);
+
+        const String bundleFullPath(File(CharPointer_UTF8(bundlePath)).getFullPathName());
+        lilv_free(bundlePath);
+
+        bool found = false;
+
+        for (std::size_t j=0; j < fBundles.size(); ++j)
+        {
+            if (fBundles[j].path == bundleFullPath)
+            {
+                bundleHasPlugins[j] = found = true;
+                break;
+            }
+        }
+
+        // an index without this plugin would make it look uninstalled, better not to have one
+        if (! found)
+        {
+            carla_stderr("LV2 bundle '%s' is not in the LV2 path, not writing index", bundleFullPath.toRawUTF8());
+            return;
+        }
+
+        plugins << "plugin\t" << String(CharPointer_UTF8(pluginURI)) << "\t" << String(CharPointer_UTF8(bundleURI)) << "\n";
+    }
+
+    String text;
+    text << kIndexHeader << "\n";
+    text << "path\t" << fLv2Path << "\n";
+
+    for (std::size_t i=0; i < fBundles.size(); ++i)
+    {
+        const Bundle& bundle(fBundles[i]);
+        text << "bundle\t" << String(bundle.mtime) << "\t" << String(bundle.size) << "\t" << bundle.path << "\n";
+    }
+
+    // bundles without plugins, like specifications and presets, are always loaded
+    for (std::size_t i=0; i < fBundles.size(); ++i)
+    {
+        if (bundleHasPlugins[i])
+            continue;
+
+        LilvNode* const bundleNode(lilv_new_file_uri(lv2World.me, nullptr, (fBundles[i].path + "/").toRawUTF8()));
+        CARLA_SAFE_ASSERT_CONTINUE(bundleNode != nullptr);
+
+        text << "load\t" << String(CharPointer_UTF8(lilv_node_as_uri(bundleNode))) << "\n";
+        lilv_node_free(bundleNode);
+    }
+
+    text << plugins;
+
+    const File indexFile(getIndexFilename());
+
+    if (! indexFile.getParentDirectory().createDirectory())
+        return;
+
+    if (! indexFile.replaceWithText(text))
+        carla_stderr("Failed to write LV2 index '%s'", indexFile.getFullPathName().toRawUTF8());
+}
+
+String CarlaPluginLV2Index::getIndexFilename() const
+{
+    const uint64_t hash = static_cast<uint64_t>(fLv2Path.hashCode64());
+
+    return carla_get_cache_directory().getChildFile("lv2-index-" + String(hash) + ".txt").getFullPathName();
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,83 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_PLUGIN_LV2_INDEX_HPP_INCLUDED
+#define CARLA_PLUGIN_LV2_INDEX_HPP_INCLUDED
+
+#include "CarlaBackend.h"
+#include "CarlaJuceUtils.hpp"
+
+#include "water/text/String.h"
+
+#include <vector>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaPluginLV2Index
+
+/*!
+ * On-disk index of the LV2 bundle that provides each plugin URI.
+ *
+ * Loading the whole LV2 world reads the manifest of every installed bundle,
+ * which takes seconds when there are many of them.
+ * With the index only the bundle of the requested plugin is loaded,
+ * together with the bundles that have no plugins (specifications and presets).
+ *
+ * The index is kept in the user cache directory, one file per LV2 path.
+ * It is valid while the bundles and the size and modification time of their manifests stay the same,
+ * otherwise the whole world is loaded and the index written again.
+ */
+class CarlaPluginLV2Index
+{
+public:
+    /*!
+     * Load the LV2 world as needed for the plugin @a uri.
+     */
+    static void initWorldForURI(const char* lv2path, const char* uri);
+
+private:
+    struct Bundle {
+        water::String path;
+        int64_t mtime;
+        int64_t size;
+    };
+
+    const water::String fLv2Path;
+    std::vector<Bundle> fBundles;
+
+    CarlaPluginLV2Index(const char* lv2path);
+
+    // scan the bundles currently installed in the LV2 path
+    void scanBundles();
+
+    // find the bundle URIs needed for @a uri, returns false if the index file is not valid
+    bool readIndex(const char* uri, std::vector<water::String>& bundleURIs) const;
+
+    // write a new index file, the LV2 world must be fully loaded
+    void writeIndex() const;
+
+    water::String getIndexFilename() const;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginLV2Index)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_PLUGIN_LV2_INDEX_HPP_INCLUDED
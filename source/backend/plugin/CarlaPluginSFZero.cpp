@@ -61,6 +61,7 @@ public:
         : CarlaPlugin(engine, id),
           fSynth(),
           fNumVoices(0.0f),
+          fInterpolation(sfzero::Voice::linear),
           fLabel(nullptr),
           fRealName(nullptr)
     {
@@ -114,7 +115,16 @@ public:
     // -------------------------------------------------------------------
     // Information (count)
 
-    // nothing
+    uint32_t getParameterScalePointCount(const uint32_t parameterId) const noexcept override
+    {
+        switch (parameterId)
+        {
+        case SFZeroInterpolation:
+            return 2;
+        default:
+            return 0;
+        }
+    }
 
     // -------------------------------------------------------------------
     // Information (current data)
@@ -140,9 +150,34 @@ public:
 
     float getParameterValue(const uint32_t parameterId) const noexcept override
     {
-        CARLA_SAFE_ASSERT_RETURN(parameterId == 0, 0.0f);
+        switch (parameterId)
+        {
+        case SFZeroVoiceCount:
+            return fNumVoices;
+        case SFZeroInterpolation:
+            return fInterpolation;
+        default:
+            return 0.0f;
+        }
+    }
 
-        return fNumVoices;
+    float getParameterScalePointValue(const uint32_t parameterId, const uint32_t scalePointId) const noexcept override
+    {
+        switch (parameterId)
+        {
+        case SFZeroInterpolation:
+            switch (scalePointId)
+            {
+            case 0:
+                return sfzero::Voice::linear;
+            case 1:
+                return sfzero::Voice::cubic;
+            default:
+                return sfzero::Voice::linear;
+            }
+        default:
+            return 0.0f;
+        }
     }
 
     bool getLabel(char* const strBuf) const noexcept override
@@ -181,10 +216,42 @@ public:
 
     bool getParameterName(const uint32_t parameterId, char* const strBuf) const noexcept override
     {
-        CARLA_SAFE_ASSERT_RETURN(parameterId == 0, false);
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count, false);
 
-        std::strncpy(strBuf, "Voice Count", STR_MAX);
-        return true;
+        switch (parameterId)
+        {
+        case SFZeroVoiceCount:
+            std::strncpy(strBuf, "Voice Count", STR_MAX);
+            return true;
+        case SFZeroInterpolation:
+            std::strncpy(strBuf, "Interpolation", STR_MAX);
+            return true;
+        }
+
+        return CarlaPlugin::getParameterName(parameterId, strBuf);
+    }
+
+    bool getParameterScalePointLabel(const uint32_t parameterId, const uint32_t scalePointId, char* const strBuf) const noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count, false);
+        CARLA_SAFE_ASSERT_RETURN(scalePointId < getParameterScalePointCount(parameterId), false);
+
+        switch (parameterId)
+        {
+        case SFZeroInterpolation:
+            switch (scalePointId)
+            {
+            case 0:
+                std::strncpy(strBuf, "Linear", STR_MAX);
+                return true;
+            case 1:
+                std::strncpy(strBuf, "Cubic", STR_MAX);
+                return true;
+            }
+            break;
+        }
+
+        return CarlaPlugin::getParameterScalePointLabel(parameterId, scalePointId, strBuf);
     }
 
     // -------------------------------------------------------------------
@@ -200,7 +267,36 @@ public:
     // -------------------------------------------------------------------
     // Set data (plugin-specific stuff)
 
-    // nothing
+    void setParameterValue(const uint32_t parameterId, const float value, const bool sendGui, const bool sendOsc, const bool sendCallback) noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
+
+        const float fixedValue = setParameterValueInSFZero(parameterId, value);
+
+        CarlaPlugin::setParameterValue(parameterId, fixedValue, sendGui, sendOsc, sendCallback);
+    }
+
+    void setParameterValueRT(const uint32_t parameterId, const float value, const uint32_t frameOffset, const bool sendCallbackLater) noexcept override
+    {
+        const float fixedValue = setParameterValueInSFZero(parameterId, value);
+
+        CarlaPlugin::setParameterValueRT(parameterId, fixedValue, frameOffset, sendCallbackLater);
+    }
+
+    float setParameterValueInSFZero(const uint32_t parameterId, const float value) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count, value);
+
+        const float fixedValue(pData->param.getFixedValue(parameterId, value));
+
+        if (parameterId == SFZeroInterpolation)
+        {
+            fInterpolation = fixedValue;
+            fSynth.setInterpolation(fixedValue > 0.5f ? sfzero::Voice::cubic : sfzero::Voice::linear);
+        }
+
+        return fixedValue;
+    }
 
     // -------------------------------------------------------------------
     // Set ui stuff
@@ -226,7 +322,7 @@ public:
         clearBuffers();
 
         pData->audioOut.createNew(2);
-        pData->param.createNew(1, false);
+        pData->param.createNew(SFZeroParametersMax, false);
 
         const uint portNameSize(pData->engine->getMaxPortNameSize());
         CarlaString portName;
@@ -283,16 +379,29 @@ public:
         // ---------------------------------------
         // Parameters
 
-        pData->param.data[0].type   = PARAMETER_OUTPUT;
-        pData->param.data[0].hints  = PARAMETER_IS_ENABLED | PARAMETER_IS_AUTOMATABLE | PARAMETER_IS_INTEGER;
-        pData->param.data[0].index  = 0;
-        pData->param.data[0].rindex = 0;
-        pData->param.ranges[0].min = 0.0f;
-        pData->param.ranges[0].max = 128;
-        pData->param.ranges[0].def = 0.0f;
-        pData->param.ranges[0].step = 1.0f;
-        pData->param.ranges[0].stepSmall = 1.0f;
-        pData->param.ranges[0].stepLarge = 1.0f;
+        uint32_t j = SFZeroVoiceCount;
+        pData->param.data[j].type   = PARAMETER_OUTPUT;
+        pData->param.data[j].hints  = PARAMETER_IS_ENABLED | PARAMETER_IS_AUTOMATABLE | PARAMETER_IS_INTEGER;
+        pData->param.data[j].index  = j;
+        pData->param.data[j].rindex = j;
+        pData->param.ranges[j].min = 0.0f;
+        pData->param.ranges[j].max = 128;
+        pData->param.ranges[j].def = 0.0f;
+        pData->param.ranges[j].step = 1.0f;
+        pData->param.ranges[j].stepSmall = 1.0f;
+        pData->param.ranges[j].stepLarge = 1.0f;
+
+        j = SFZeroInterpolation;
+        pData->param.data[j].type   = PARAMETER_INPUT;
+        pData->param.data[j].hints  = PARAMETER_IS_ENABLED | PARAMETER_IS_INTEGER | PARAMETER_USES_SCALEPOINTS;
+        pData->param.data[j].index  = j;
+        pData->param.data[j].rindex = j;
+        pData->param.ranges[j].min = sfzero::Voice::linear;
+        pData->param.ranges[j].max = sfzero::Voice::cubic;
+        pData->param.ranges[j].def = sfzero::Voice::linear;
+        pData->param.ranges[j].step = 1.0f;
+        pData->param.ranges[j].stepSmall = 1.0f;
+        pData->param.ranges[j].stepLarge = 1.0f;
 
         // ---------------------------------------
 
@@ -764,8 +873,15 @@ public:
     // -------------------------------------------------------------------
 
 private:
+    enum SFZeroParameters {
+        SFZeroVoiceCount    = 0,
+        SFZeroInterpolation = 1,
+        SFZeroParametersMax = 2
+    };
+
     sfzero::Synth fSynth;
     float fNumVoices;
+    float fInterpolation;
 
     const char* fLabel;
     const char* fRealName;
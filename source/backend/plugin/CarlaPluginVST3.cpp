@@ -1278,6 +1278,17 @@ public:
         return fLastKnownLatency;
     }
 
+    uint32_t getTailSamples() const noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fV3.processor != nullptr, UINT32_MAX);
+
+        const uint32_t tail = v3_cpp_obj(fV3.processor)->get_tail_samples(fV3.processor);
+
+        // kNoTail is the SDK default, also returned by reverbs and delays that never override it,
+        // so it means unknown just like kInfiniteTail; a user tail can still be set for such plugins
+        return tail == 0 ? UINT32_MAX : tail;
+    }
+
     // ----------------------------------------------------------------------------------------------------------------
     // Information (count)
 
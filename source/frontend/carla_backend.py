@@ -28,7 +28,7 @@ from struct import pack
 from ctypes import (
     c_bool, c_char_p, c_double, c_float, c_int, c_long, c_longdouble, c_longlong, c_ubyte, c_uint, c_void_p,
     c_int8, c_int16, c_int32, c_int64, c_uint8, c_uint16, c_uint32, c_uint64,
-    cast, Structure,
+    byref, cast, Structure,
     CDLL, CFUNCTYPE, RTLD_GLOBAL, RTLD_LOCAL, POINTER
 )
 
@@ -841,6 +841,18 @@ ENGINE_CALLBACK_PARAMETER_MAPPED_RANGE_CHANGED = 46
 # @a valuef   Y position 2
 ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED = 47
 
+# Offline rendering progress.
+# Sent periodically while rendering, and once more with 100% when done.
+# @a value1   Progress in percent, from 0 to 100
+# @a valuef   Render speed relative to realtime
+# @a valueStr Output filename
+ENGINE_CALLBACK_RENDER_PROGRESS = 49
+
+# A plugin has been frozen or unfrozen.
+# @a pluginId Plugin Id
+# @a value1   1 if the plugin now plays from its freeze cache, 0 otherwise
+ENGINE_CALLBACK_PLUGIN_FREEZE_CHANGED = 50
+
 # ---------------------------------------------------------------------------------------------------------------------
 # NSM Callback Opcode
 # NSM callback opcodes.
@@ -1026,6 +1038,51 @@ ENGINE_OPTION_CLIENT_NAME_PREFIX = 34
 # Treat loaded plugins as standalone (that is, there is no host UI to manage them)
 ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35
 
+# Process patchbay graphs in double precision.
+# Audio between plugins that support 64-bit processing is kept as double,
+# and is only converted to float where a float-only plugin or the audio driver is reached.
+# Only used in patchbay mode.
+# Default is false.
+ENGINE_OPTION_AUDIO_DOUBLE_PRECISION = 36
+
+# Time in microseconds that plugin bridges busy-wait for the other side before sleeping.
+# Lowers the wake-up latency of bridged plugins with small buffer sizes, at the cost of extra CPU usage.
+# Spinning is skipped for a while when the other side keeps taking longer than this.
+# Maximum is 1000, default is 0 (always sleep).
+ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME = 37
+
+# Set of CPUs a thread class is allowed to run on.
+# Value is the thread class, valueStr is a list of CPU numbers and ranges, like "2,3" or "4-7".
+# An empty list leaves the CPU set unchanged, which is the default.
+# @see EngineThreadClass
+ENGINE_OPTION_THREAD_CPU_SET = 38
+
+# Scheduling priority of a thread class.
+# Value is the thread class, valueStr is the priority as a number:
+# 1 to 99 for realtime (FIFO) scheduling, 0 for normal scheduling, or -1 to leave it unchanged (default).
+# @see EngineThreadClass
+ENGINE_OPTION_THREAD_PRIORITY = 39
+
+# ---------------------------------------------------------------------------------------------------------------------
+# Engine Thread Class
+# Engine thread class.
+# Threads are grouped by what they do, each group can be given its own CPU set and priority.
+# @see ENGINE_OPTION_THREAD_CPU_SET and ENGINE_OPTION_THREAD_PRIORITY
+
+# Audio thread, as given by the audio driver.
+# In plugin bridges this is the thread that processes audio in sync with the host.
+ENGINE_THREAD_AUDIO = 0
+
+# Worker threads, used by plugins to spread their processing over several CPUs.
+ENGINE_THREAD_WORKER = 1
+
+# Engine idle thread, which also handles OSC when the engine has no main thread to do so.
+ENGINE_THREAD_IDLE = 2
+
+# Plugin bridge processes.
+# Applies to all threads a bridge creates after startup, except for its audio thread.
+ENGINE_THREAD_BRIDGE = 3
+
 # ---------------------------------------------------------------------------------------------------------------------
 # Engine Process Mode
 # Engine process mode.
@@ -1433,6 +1490,57 @@ class CarlaRuntimeEngineDriverDeviceInfo(Structure):
         ("sampleRates", POINTER(c_double))
     ]
 
+# Plugin processing time information.
+# All times are in microseconds.
+class CarlaPluginTimingInfo(Structure):
+    _fields_ = [
+        # Number of measured process cycles.
+        ("cycles", c_uint32),
+
+        # Fastest process cycle.
+        ("min", c_float),
+
+        # Average process cycle.
+        ("avg", c_float),
+
+        # Slowest process cycle.
+        ("max", c_float),
+
+        # 95th percentile, approximate.
+        ("p95", c_float),
+
+        # 99th percentile, approximate.
+        ("p99", c_float)
+    ]
+
+# Plugin state inside an engine snapshot.
+# @see carla_get_engine_snapshot()
+class CarlaPluginSnapshot(Structure):
+    _fields_ = [
+        # Change counter of this plugin.
+        # Changes whenever a parameter value, internal parameter, current program or MIDI program changes.
+        # Counters are unique, a different plugin never has the same counter.
+        ("changeCounter", c_uint64),
+
+        # Number of parameters.
+        ("parameterCount", c_uint32),
+
+        # Index of this plugin's first parameter value inside the snapshot values array.
+        ("parameterOffset", c_uint32),
+
+        # Number of parameter values copied into the snapshot values array.
+        ("parametersCopied", c_uint32),
+
+        # Current program number (-1 if unset).
+        ("currentProgram", c_int32),
+
+        # Current MIDI program number (-1 if unset).
+        ("currentMidiProgram", c_int32),
+
+        # Peak values, input left and right, then output left and right.
+        ("peaks", c_float * 4)
+    ]
+
 # Image data for LV2 inline display API.
 # raw image pixmap format is ARGB32,
 class CarlaInlineDisplayImageSurface(Structure):
@@ -1510,6 +1618,27 @@ PyCarlaRuntimeEngineDriverDeviceInfo = {
     'sampleRates': []
 }
 
+# @see CarlaPluginTimingInfo
+PyCarlaPluginTimingInfo = {
+    'cycles': 0,
+    'min': 0.0,
+    'avg': 0.0,
+    'max': 0.0,
+    'p95': 0.0,
+    'p99': 0.0
+}
+
+# @see CarlaPluginSnapshot
+# Parameter values are given per plugin instead of offsets into a shared array.
+PyCarlaPluginSnapshot = {
+    'changeCounter': 0,
+    'parameterCount': 0,
+    'currentProgram': -1,
+    'currentMidiProgram': -1,
+    'peaks': [0.0, 0.0, 0.0, 0.0],
+    'values': []
+}
+
 # ---------------------------------------------------------------------------------------------------------------------
 # Set BINARY_NATIVE
 
@@ -1641,6 +1770,21 @@ class CarlaHostMeta():
     def clear_engine_xruns(self):
         raise NotImplementedError
 
+    # Get the engine cycle statistics, as a JSON string.
+    # This includes log-scale histograms of cycle time and start jitter,
+    # plus the slowest cycles so far with the individual cost of each plugin that ran.
+    def get_engine_cycle_stats(self):
+        raise NotImplementedError
+
+    # Clear the engine cycle statistics.
+    def clear_engine_cycle_stats(self):
+        raise NotImplementedError
+
+    # Get the requested and effective CPU set and priority of each engine thread class, as a JSON string.
+    # Classes whose threads have not started yet are reported as not applied.
+    def get_engine_thread_placement(self):
+        raise NotImplementedError
+
     # Tell the engine to stop the current cancelable action.
     # @see ENGINE_CALLBACK_CANCELABLE_ACTION
     @abstractmethod
@@ -1760,6 +1904,15 @@ class CarlaHostMeta():
     def get_transport_info(self):
         raise NotImplementedError
 
+    # Render the engine output into an audio file, as fast as possible.
+    # Transport is relocated to startFrame and rolls for numFrames, with plugins set to offline mode.
+    # The file format is taken from the extension, either "wav" or "flac".
+    # Blocks until done, reporting progress via ENGINE_CALLBACK_RENDER_PROGRESS.
+    # The audio device outputs silence meanwhile.
+    # Needs the rack or patchbay processing mode, and is not possible while running as a plugin.
+    def engine_render_to_file(self, filename, startFrame, numFrames):
+        raise NotImplementedError
+
     # Current number of plugins loaded.
     @abstractmethod
     def get_current_plugin_count(self):
@@ -2020,6 +2173,12 @@ class CarlaHostMeta():
     def get_current_parameter_value(self, pluginId, parameterId):
         raise NotImplementedError
 
+    # Get all of a plugin's current parameter values in a single call.
+    # @param pluginId Plugin
+    @abstractmethod
+    def get_current_parameter_values(self, pluginId):
+        raise NotImplementedError
+
     # Get a plugin's internal parameter value.
     # @param pluginId    Plugin
     # @param parameterId Parameter index, maybe be negative
@@ -2042,6 +2201,29 @@ class CarlaHostMeta():
     def get_output_peak_value(self, pluginId, isLeft):
         raise NotImplementedError
 
+    # Get a plugin's processing time information, collected since it was added or last cleared.
+    # @param pluginId Plugin
+    @abstractmethod
+    def get_plugin_timing_info(self, pluginId):
+        raise NotImplementedError
+
+    # Clear the processing time information of all plugins.
+    @abstractmethod
+    def clear_plugin_timings(self):
+        raise NotImplementedError
+
+    # Get the peak values of all plugins in a single call, as a list of 4 values per plugin.
+    @abstractmethod
+    def get_all_peak_values(self):
+        raise NotImplementedError
+
+    # Get the state of all plugins in a single call.
+    # Returns a dictionary with the snapshot 'version' and a list of 'plugins', see PyCarlaPluginSnapshot.
+    # Plugins whose 'changeCounter' is the same as before can be skipped, or everything if 'version' is the same.
+    @abstractmethod
+    def get_engine_snapshot(self):
+        raise NotImplementedError
+
     # Render a plugin's inline display.
     # @param pluginId Plugin
     @abstractmethod
@@ -2063,6 +2245,32 @@ class CarlaHostMeta():
     def set_active(self, pluginId, onOff):
         raise NotImplementedError
 
+    # Set a custom tail for a plugin, in sample frames, used to put it to sleep while its input is silent.
+    # @param pluginId Plugin
+    # @param samples  Tail length, or -1 to use the tail reported by the plugin
+    def set_plugin_tail_samples(self, pluginId, samples):
+        raise NotImplementedError
+
+    # Freeze a plugin, rendering its output over a transport range into a cache it plays back from.
+    # The engine renders the range offline, blocking until done like engine_render_to_file().
+    # Plugins with CV or MIDI outputs cannot be frozen.
+    # The plugin is unfrozen automatically when its input, parameters or state change.
+    # @param pluginId   Plugin
+    # @param startFrame First transport frame to freeze
+    # @param numFrames  Number of frames to freeze
+    def freeze_plugin(self, pluginId, startFrame, numFrames):
+        raise NotImplementedError
+
+    # Unfreeze a plugin, deleting its freeze cache.
+    # @param pluginId Plugin
+    def unfreeze_plugin(self, pluginId):
+        raise NotImplementedError
+
+    # Check if a plugin is currently playing from its freeze cache.
+    # @param pluginId Plugin
+    def is_plugin_frozen(self, pluginId):
+        raise NotImplementedError
+
     # Change a plugin's internal dry/wet.
     # @param pluginId Plugin
     # @param value    New dry/wet value
@@ -2318,6 +2526,15 @@ class CarlaHostNull(CarlaHostMeta):
     def clear_engine_xruns(self):
         return
 
+    def get_engine_cycle_stats(self):
+        return "{}"
+
+    def clear_engine_cycle_stats(self):
+        return
+
+    def get_engine_thread_placement(self):
+        return "{}"
+
     def cancel_engine_action(self):
         return
 
@@ -2375,6 +2592,9 @@ class CarlaHostNull(CarlaHostMeta):
     def get_transport_info(self):
         return PyCarlaTransportInfo
 
+    def engine_render_to_file(self, filename, startFrame, numFrames):
+        return False
+
     def get_current_plugin_count(self):
         return 0
 
@@ -2483,6 +2703,9 @@ class CarlaHostNull(CarlaHostMeta):
     def get_current_parameter_value(self, pluginId, parameterId):
         return 0.0
 
+    def get_current_parameter_values(self, pluginId):
+        return []
+
     def get_internal_parameter_value(self, pluginId, parameterId):
         return 0.0
 
@@ -2492,6 +2715,18 @@ class CarlaHostNull(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return 0.0
 
+    def get_plugin_timing_info(self, pluginId):
+        return PyCarlaPluginTimingInfo
+
+    def clear_plugin_timings(self):
+        return
+
+    def get_all_peak_values(self):
+        return []
+
+    def get_engine_snapshot(self):
+        return { 'version': 0, 'plugins': [] }
+
     def render_inline_display(self, pluginId, width, height):
         return None
 
@@ -2501,6 +2736,18 @@ class CarlaHostNull(CarlaHostMeta):
     def set_active(self, pluginId, onOff):
         return
 
+    def set_plugin_tail_samples(self, pluginId, samples):
+        return
+
+    def freeze_plugin(self, pluginId, startFrame, numFrames):
+        return False
+
+    def unfreeze_plugin(self, pluginId):
+        return
+
+    def is_plugin_frozen(self, pluginId):
+        return False
+
     def set_drywet(self, pluginId, value):
         return
 
@@ -2639,6 +2886,15 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_clear_engine_xruns.argtypes = (c_void_p,)
         self.lib.carla_clear_engine_xruns.restype = None
 
+        self.lib.carla_get_engine_cycle_stats.argtypes = (c_void_p,)
+        self.lib.carla_get_engine_cycle_stats.restype = c_char_p
+
+        self.lib.carla_clear_engine_cycle_stats.argtypes = (c_void_p,)
+        self.lib.carla_clear_engine_cycle_stats.restype = None
+
+        self.lib.carla_get_engine_thread_placement.argtypes = (c_void_p,)
+        self.lib.carla_get_engine_thread_placement.restype = c_char_p
+
         self.lib.carla_cancel_engine_action.argtypes = (c_void_p,)
         self.lib.carla_cancel_engine_action.restype = None
 
@@ -2696,6 +2952,9 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_get_transport_info.argtypes = (c_void_p,)
         self.lib.carla_get_transport_info.restype = POINTER(CarlaTransportInfo)
 
+        self.lib.carla_engine_render_to_file.argtypes = (c_void_p, c_char_p, c_uint64, c_uint64)
+        self.lib.carla_engine_render_to_file.restype = c_bool
+
         self.lib.carla_get_current_plugin_count.argtypes = (c_void_p,)
         self.lib.carla_get_current_plugin_count.restype = c_uint32
 
@@ -2805,6 +3064,9 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_get_current_parameter_value.argtypes = (c_void_p, c_uint, c_uint32)
         self.lib.carla_get_current_parameter_value.restype = c_float
 
+        self.lib.carla_get_current_parameter_values.argtypes = (c_void_p, c_uint, POINTER(c_float), c_uint32)
+        self.lib.carla_get_current_parameter_values.restype = c_uint32
+
         self.lib.carla_get_internal_parameter_value.argtypes = (c_void_p, c_uint, c_int32)
         self.lib.carla_get_internal_parameter_value.restype = c_float
 
@@ -2814,6 +3076,20 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_get_output_peak_value.argtypes = (c_void_p, c_uint, c_bool)
         self.lib.carla_get_output_peak_value.restype = c_float
 
+        self.lib.carla_get_plugin_timing_info.argtypes = (c_void_p, c_uint)
+        self.lib.carla_get_plugin_timing_info.restype = POINTER(CarlaPluginTimingInfo)
+
+        self.lib.carla_clear_plugin_timings.argtypes = (c_void_p,)
+        self.lib.carla_clear_plugin_timings.restype = None
+
+        self.lib.carla_get_all_peak_values.argtypes = (c_void_p, POINTER(c_float), c_uint)
+        self.lib.carla_get_all_peak_values.restype = c_uint
+
+        self.lib.carla_get_engine_snapshot.argtypes = (c_void_p, POINTER(CarlaPluginSnapshot), c_uint,
+                                                       POINTER(c_float), c_uint32,
+                                                       POINTER(c_uint), POINTER(c_uint32))
+        self.lib.carla_get_engine_snapshot.restype = c_uint64
+
         self.lib.carla_render_inline_display.argtypes = (c_void_p, c_uint, c_uint, c_uint)
         self.lib.carla_render_inline_display.restype = POINTER(CarlaInlineDisplayImageSurface)
 
@@ -2823,6 +3099,18 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_set_active.argtypes = (c_void_p, c_uint, c_bool)
         self.lib.carla_set_active.restype = None
 
+        self.lib.carla_set_plugin_tail_samples.argtypes = (c_void_p, c_uint, c_int32)
+        self.lib.carla_set_plugin_tail_samples.restype = None
+
+        self.lib.carla_freeze_plugin.argtypes = (c_void_p, c_uint, c_uint64, c_uint64)
+        self.lib.carla_freeze_plugin.restype = c_bool
+
+        self.lib.carla_unfreeze_plugin.argtypes = (c_void_p, c_uint)
+        self.lib.carla_unfreeze_plugin.restype = None
+
+        self.lib.carla_is_plugin_frozen.argtypes = (c_void_p, c_uint)
+        self.lib.carla_is_plugin_frozen.restype = c_bool
+
         self.lib.carla_set_drywet.argtypes = (c_void_p, c_uint, c_float)
         self.lib.carla_set_drywet.restype = None
 
@@ -2909,6 +3197,10 @@ class CarlaHostDLL(CarlaHostMeta):
         self._engineCallback = None
         self._fileCallback = None
 
+        # reused between snapshots, grown as needed
+        self._snapshotPlugins = (CarlaPluginSnapshot * 0)()
+        self._snapshotValues = (c_float * 0)()
+
     # --------------------------------------------------------------------------------------------------------
 
     def get_engine_driver_count(self):
@@ -2953,6 +3245,15 @@ class CarlaHostDLL(CarlaHostMeta):
     def clear_engine_xruns(self):
         self.lib.carla_clear_engine_xruns(self.handle)
 
+    def get_engine_cycle_stats(self):
+        return charPtrToString(self.lib.carla_get_engine_cycle_stats(self.handle))
+
+    def clear_engine_cycle_stats(self):
+        self.lib.carla_clear_engine_cycle_stats(self.handle)
+
+    def get_engine_thread_placement(self):
+        return charPtrToString(self.lib.carla_get_engine_thread_placement(self.handle))
+
     def cancel_engine_action(self):
         self.lib.carla_cancel_engine_action(self.handle)
 
@@ -3012,6 +3313,9 @@ class CarlaHostDLL(CarlaHostMeta):
     def get_transport_info(self):
         return structToDict(self.lib.carla_get_transport_info(self.handle).contents)
 
+    def engine_render_to_file(self, filename, startFrame, numFrames):
+        return bool(self.lib.carla_engine_render_to_file(self.handle, filename.encode("utf-8"), startFrame, numFrames))
+
     def get_current_plugin_count(self):
         return int(self.lib.carla_get_current_plugin_count(self.handle))
 
@@ -3134,6 +3438,12 @@ class CarlaHostDLL(CarlaHostMeta):
     def get_current_parameter_value(self, pluginId, parameterId):
         return float(self.lib.carla_get_current_parameter_value(self.handle, pluginId, parameterId))
 
+    def get_current_parameter_values(self, pluginId):
+        count = int(self.lib.carla_get_parameter_count(self.handle, pluginId))
+        values = (c_float * count)()
+        count = min(count, int(self.lib.carla_get_current_parameter_values(self.handle, pluginId, values, count)))
+        return values[:count]
+
     def get_internal_parameter_value(self, pluginId, parameterId):
         return float(self.lib.carla_get_internal_parameter_value(self.handle, pluginId, parameterId))
 
@@ -3143,6 +3453,50 @@ class CarlaHostDLL(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return float(self.lib.carla_get_output_peak_value(self.handle, pluginId, isLeft))
 
+    def get_plugin_timing_info(self, pluginId):
+        return structToDict(self.lib.carla_get_plugin_timing_info(self.handle, pluginId).contents)
+
+    def clear_plugin_timings(self):
+        self.lib.carla_clear_plugin_timings(self.handle)
+
+    def get_all_peak_values(self):
+        count = int(self.lib.carla_get_current_plugin_count(self.handle))
+        peaks = (c_float * (count * 4))()
+        count = min(count, int(self.lib.carla_get_all_peak_values(self.handle, peaks, count)))
+        return [peaks[i*4:i*4+4] for i in range(count)]
+
+    def get_engine_snapshot(self):
+        pluginCount = c_uint(0)
+        valueCount = c_uint32(0)
+
+        while True:
+            version = int(self.lib.carla_get_engine_snapshot(self.handle,
+                                                             self._snapshotPlugins, len(self._snapshotPlugins),
+                                                             self._snapshotValues, len(self._snapshotValues),
+                                                             byref(pluginCount), byref(valueCount)))
+
+            if pluginCount.value <= len(self._snapshotPlugins) and valueCount.value <= len(self._snapshotValues):
+                break
+
+            self._snapshotPlugins = (CarlaPluginSnapshot * max(pluginCount.value, len(self._snapshotPlugins)))()
+            self._snapshotValues = (c_float * max(valueCount.value, len(self._snapshotValues)))()
+
+        plugins = []
+
+        for i in range(pluginCount.value):
+            snapshot = self._snapshotPlugins[i]
+            offset = snapshot.parameterOffset
+            plugins.append({
+                'changeCounter': int(snapshot.changeCounter),
+                'parameterCount': int(snapshot.parameterCount),
+                'currentProgram': int(snapshot.currentProgram),
+                'currentMidiProgram': int(snapshot.currentMidiProgram),
+                'peaks': snapshot.peaks[:],
+                'values': self._snapshotValues[offset:offset+snapshot.parametersCopied]
+            })
+
+        return { 'version': version, 'plugins': plugins }
+
     def render_inline_display(self, pluginId, width, height):
         ptr = self.lib.carla_render_inline_display(self.handle, pluginId, width, height)
         if not ptr or not ptr.contents:
@@ -3164,6 +3518,18 @@ class CarlaHostDLL(CarlaHostMeta):
     def set_active(self, pluginId, onOff):
         self.lib.carla_set_active(self.handle, pluginId, onOff)
 
+    def set_plugin_tail_samples(self, pluginId, samples):
+        self.lib.carla_set_plugin_tail_samples(self.handle, pluginId, samples)
+
+    def freeze_plugin(self, pluginId, startFrame, numFrames):
+        return bool(self.lib.carla_freeze_plugin(self.handle, pluginId, startFrame, numFrames))
+
+    def unfreeze_plugin(self, pluginId):
+        self.lib.carla_unfreeze_plugin(self.handle, pluginId)
+
+    def is_plugin_frozen(self, pluginId):
+        return bool(self.lib.carla_is_plugin_frozen(self.handle, pluginId))
+
     def set_drywet(self, pluginId, value):
         self.lib.carla_set_drywet(self.handle, pluginId, value)
 
@@ -3277,6 +3643,9 @@ class PluginStoreInfo():
         self.customDataCount = 0
         self.customData      = []
         self.peaks = [0.0, 0.0, 0.0, 0.0]
+        self.timingInfo = PyCarlaPluginTimingInfo.copy()
+        self.changeCounter = 0
+        self.changeState   = None
 
 # ---------------------------------------------------------------------------------------------------------------------
 # Carla Host object for plugins (using pipes)
@@ -3313,6 +3682,11 @@ class CarlaHostPlugin(CarlaHostMeta):
             "bpm": 0.0
         }
 
+        # engine snapshot info, counters work the same as in the backend
+        self.fLastChangeCounter = 0
+        self.fSnapshotVersion   = 0
+        self.fSnapshotCounters  = []
+
         # some other vars
         self.fBufferSize = 0
         self.fSampleRate = 0.0
@@ -3542,6 +3916,9 @@ class CarlaHostPlugin(CarlaHostMeta):
     def get_current_parameter_value(self, pluginId, parameterId):
         return self.fPluginsInfo[pluginId].parameterValues[parameterId]
 
+    def get_current_parameter_values(self, pluginId):
+        return self.fPluginsInfo.get(pluginId, self.fFallbackPluginInfo).parameterValues[:]
+
     def get_internal_parameter_value(self, pluginId, parameterId):
         if parameterId == PARAMETER_NULL or parameterId <= PARAMETER_MAX:
             return 0.0
@@ -3556,6 +3933,45 @@ class CarlaHostPlugin(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return self.fPluginsInfo[pluginId].peaks[2 if isLeft else 3]
 
+    def get_plugin_timing_info(self, pluginId):
+        return self.fPluginsInfo.get(pluginId, self.fFallbackPluginInfo).timingInfo
+
+    def clear_plugin_timings(self):
+        self.sendMsg(["clear_plugin_timings"])
+
+    def get_all_peak_values(self):
+        return [self.fPluginsInfo[i].peaks[:] for i in range(len(self.fPluginsInfo))]
+
+    def get_engine_snapshot(self):
+        plugins  = []
+        counters = []
+
+        for i in range(len(self.fPluginsInfo)):
+            pluginInfo = self.fPluginsInfo[i]
+            state = (tuple(pluginInfo.parameterValues), tuple(pluginInfo.internalValues),
+                     pluginInfo.programCurrent, pluginInfo.midiProgramCurrent)
+
+            if pluginInfo.changeState != state:
+                self.fLastChangeCounter += 1
+                pluginInfo.changeCounter = self.fLastChangeCounter
+                pluginInfo.changeState = state
+
+            counters.append(pluginInfo.changeCounter)
+            plugins.append({
+                'changeCounter': pluginInfo.changeCounter,
+                'parameterCount': len(pluginInfo.parameterValues),
+                'currentProgram': pluginInfo.programCurrent,
+                'currentMidiProgram': pluginInfo.midiProgramCurrent,
+                'peaks': pluginInfo.peaks[:],
+                'values': pluginInfo.parameterValues[:]
+            })
+
+        if counters != self.fSnapshotCounters:
+            self.fSnapshotCounters = counters
+            self.fSnapshotVersion += 1
+
+        return { 'version': self.fSnapshotVersion, 'plugins': plugins }
+
     def render_inline_display(self, pluginId, width, height):
         return None
 
@@ -3566,6 +3982,9 @@ class CarlaHostPlugin(CarlaHostMeta):
         self.sendMsg(["set_active", pluginId, onOff])
         self.fPluginsInfo[pluginId].internalValues[0] = 1.0 if onOff else 0.0
 
+    def set_plugin_tail_samples(self, pluginId, samples):
+        self.sendMsg(["set_plugin_tail_samples", pluginId, samples])
+
     def set_drywet(self, pluginId, value):
         self.sendMsg(["set_drywet", pluginId, value])
         self.fPluginsInfo[pluginId].internalValues[1] = value
@@ -3936,6 +4355,18 @@ class CarlaHostPlugin(CarlaHostMeta):
         if pluginInfo is not None:
             pluginInfo.peaks = [in1, in2, out1, out2]
 
+    def _set_pluginTimings(self, pluginId, cycles, minTime, avgTime, maxTime, p95, p99):
+        pluginInfo = self.fPluginsInfo.get(pluginId, None)
+        if pluginInfo is not None:
+            pluginInfo.timingInfo = {
+                'cycles': cycles,
+                'min': minTime,
+                'avg': avgTime,
+                'max': maxTime,
+                'p95': p95,
+                'p99': p99
+            }
+
     def _removePlugin(self, pluginId):
         pluginCountM1 = len(self.fPluginsInfo)-1
 
@@ -504,6 +504,12 @@ class CarlaControlServerUDP(Server):
         pluginId, in1, in2, out1, out2 = args
         self.host._set_peaks(pluginId, in1, in2, out1, out2)
 
+    @make_method('/ctrl/timings', 'iifffff')
+    def carla_timings(self, path, args):
+        self.fReceivedMsgs = True
+        pluginId, cycles, minTime, avgTime, maxTime, p95, p99 = args
+        self.host._set_pluginTimings(pluginId, cycles, minTime, avgTime, maxTime, p95, p99)
+
     @make_method(None, None)
     def fallback(self, path, args):
         print("ControlServerUDP::fallback(\"%s\") - unknown message, args =" % path, args)
@@ -412,6 +412,7 @@ JACKBRIDGE_API bool jackbridge_sem_init(void* sem) noexcept;
 JACKBRIDGE_API void jackbridge_sem_destroy(void* sem) noexcept;
 JACKBRIDGE_API bool jackbridge_sem_connect(void* sem) noexcept;
 JACKBRIDGE_API void jackbridge_sem_post(void* sem, bool server) noexcept;
+JACKBRIDGE_API bool jackbridge_sem_trywait(void* sem, bool server) noexcept;
 #ifndef CARLA_OS_WASM
 JACKBRIDGE_API bool jackbridge_sem_timedwait(void* sem, uint msecs, bool server) noexcept;
 #endif
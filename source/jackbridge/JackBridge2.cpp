@@ -64,6 +64,17 @@ void jackbridge_sem_post(void* sem, bool server) noexcept
 #endif
 }
 
+bool jackbridge_sem_trywait(void* sem, bool server) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(sem != nullptr, false);
+
+#ifdef JACKBRIDGE_DUMMY
+    return false;
+#else
+    return carla_sem_trywait(*(carla_sem_t*)sem, server);
+#endif
+}
+
 #ifndef CARLA_OS_WASM
 bool jackbridge_sem_timedwait(void* sem, uint msecs, bool server) noexcept
 {
@@ -568,6 +568,11 @@ bool jackbridge_sem_timedwait(void* sem, uint msecs, bool server) noexcept
     return getBridgeInstance().sem_timedwait_ptr(sem, msecs, server);
 }
 
+bool jackbridge_sem_trywait(void* sem, bool server) noexcept
+{
+    return getBridgeInstance().sem_trywait_ptr(sem, server);
+}
+
 bool jackbridge_shm_is_valid(const void* shm) noexcept
 {
     return getBridgeInstance().shm_is_valid_ptr(shm);
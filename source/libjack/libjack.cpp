@@ -1125,6 +1125,11 @@ bool CarlaJackAppClient::handleRtData()
             break;
         }
 
+        case kPluginBridgeRtClientSetParameterPool:
+            // not used for jack applications
+            fShmRtClientControl.readUInt();
+            break;
+
         case kPluginBridgeRtClientQuit:
             ret = true;
             break;
@@ -1284,6 +1289,11 @@ bool CarlaJackAppClient::handleNonRtData()
 
         case kPluginBridgeNonRtClientReload:
             break;
+
+        case kPluginBridgeNonRtClientSetChunkDataShm:
+        case kPluginBridgeNonRtClientSetServerChunkPoolSize:
+            fShmNonRtClientControl.readULong();
+            break;
         }
 
 #ifdef DEBUG
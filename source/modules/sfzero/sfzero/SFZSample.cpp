@@ -8,6 +8,10 @@
 #include "SFZSample.h"
 #include "SFZDebug.h"
 
+#include "CarlaMutex.hpp"
+
+#include <map>
+
 #if 0
 #include "water/audioformat/AudioFormatManager.h"
 #include "water/audioformat/AudioFormatReader.h"
@@ -21,95 +25,195 @@ extern "C" {
 namespace sfzero
 {
 
-bool Sample::load()
+// Process-wide cache of decoded sample files, so instances using the same library share the audio data.
+// Files are identified by their full path, modification time and size, an edited file is loaded again.
+// Only weak references are kept here, the data is freed once the last sample using it goes away.
+class SampleCache
 {
-#if 0
-    static water::AudioFormatManager afm;
-    static bool needsInit = true;
-    if (needsInit)
-    {
-        needsInit = false;
-        afm.registerBasicFormats();
-    }
+public:
+  static SampleCache &getInstance()
+  {
+    static SampleCache cache;
+    return cache;
+  }
 
-    water::AudioFormatReader* reader = afm.createReaderFor(file_);
-    CARLA_SAFE_ASSERT_RETURN(reader != nullptr, false);
+  std::shared_ptr<const SampleData> find(const water::String &path, water::int64 modificationTime, water::int64 size)
+  {
+    const CarlaMutexLocker cml(mutex_);
 
-    sampleRate_ = reader->sampleRate;
-    sampleLength_ = (water::uint64) reader->lengthInSamples;
+    const std::map<water::String, Entry>::const_iterator it = entries_.find(path);
 
-    // Read some extra samples, which will be filled with zeros, so interpolation
-    // can be done without having to check for the edge all the time.
-    CARLA_SAFE_ASSERT_RETURN(sampleLength_ < std::numeric_limits<int>::max(), false);
+    if (it == entries_.end() || it->second.modificationTime != modificationTime || it->second.size != size)
+      return std::shared_ptr<const SampleData>();
 
-    water::AudioSampleBuffer* buf = new water::AudioSampleBuffer((int) reader->numChannels, static_cast<int>(sampleLength_ + 4), true);
-    reader->read(buf, 0, static_cast<int>(sampleLength_ + 4), 0, true, true);
-    buffer_ = buf;
+    return it->second.data.lock();
+  }
+
+  // Returns the data to use, which is not @a data if another thread stored the same file in the meantime.
+  std::shared_ptr<const SampleData> insert(const water::String &path, water::int64 modificationTime, water::int64 size,
+                                           const std::shared_ptr<const SampleData> &data)
+  {
+    const CarlaMutexLocker cml(mutex_);
 
-    water::StringPairArray *metadata = &reader->metadataValues;
-    int numLoops = metadata->getValue("NumSampleLoops", "0").getIntValue();
-    if (numLoops > 0)
+    for (std::map<water::String, Entry>::iterator it = entries_.begin(); it != entries_.end();)
     {
-        loopStart_ = (water::uint64) metadata->getValue("Loop0Start", "0").getLargeIntValue();
-        loopEnd_ = (water::uint64) metadata->getValue("Loop0End", "0").getLargeIntValue();
+      if (it->second.data.expired())
+        entries_.erase(it++);
+      else
+        ++it;
     }
-    delete reader;
-#else
-    const water::String filename(file_.getFullPathName());
 
-    struct adinfo info;
-    carla_zeroStruct(info);
+    Entry &entry(entries_[path]);
 
-    void* const handle = ad_open(filename.toRawUTF8(), &info);
-    CARLA_SAFE_ASSERT_RETURN(handle != nullptr, false);
-
-    if (info.frames >= std::numeric_limits<int>::max())
+    if (entry.modificationTime == modificationTime && entry.size == size)
     {
-        carla_stderr2("sfzero::Sample::load() - file is too big!");
-        ad_close(handle);
-        return false;
+      if (const std::shared_ptr<const SampleData> existing = entry.data.lock())
+        return existing;
     }
 
-    sampleRate_ = info.sample_rate;
-    sampleLength_ = info.frames/info.channels;
-    // TODO loopStart_, loopEnd_
+    entry.modificationTime = modificationTime;
+    entry.size = size;
+    entry.data = data;
+    return data;
+  }
 
-    // read interleaved buffer
-    float* const rbuffer = (float*)std::calloc(1, sizeof(float)*info.frames);
+private:
+  struct Entry
+  {
+    water::int64 modificationTime;
+    water::int64 size;
+    std::weak_ptr<const SampleData> data;
 
-    if (rbuffer == nullptr)
-    {
-        carla_stderr2("sfzero::Sample::load() - out of memory");
-        ad_close(handle);
-        return false;
-    }
+    Entry() : modificationTime(0), size(0), data() {}
+  };
 
-    // Fix for misinformation using libsndfile
-    if (info.frames % info.channels)
-        --info.frames;
+  CarlaMutex mutex_;
+  std::map<water::String, Entry> entries_;
 
-    const ssize_t r = ad_read(handle, rbuffer, info.frames);
-    if (r != info.frames)
-    {
-        if (r != 0)
-            carla_stderr2("sfzero::Sample::load() - failed to read complete file: " P_SSIZE " vs " P_INT64, r, info.frames);
-        ad_close(handle);
-        return false;
-    }
+  SampleCache() : mutex_(), entries_() {}
+
+  CARLA_DECLARE_NON_COPYABLE(SampleCache)
+};
+
+static SampleData *decodeFile(const water::File &file)
+{
+#if 0
+  static water::AudioFormatManager afm;
+  static bool needsInit = true;
+  if (needsInit)
+  {
+    needsInit = false;
+    afm.registerBasicFormats();
+  }
+
+  water::AudioFormatReader* reader = afm.createReaderFor(file);
+  CARLA_SAFE_ASSERT_RETURN(reader != nullptr, nullptr);
+
+  SampleData *const data = new SampleData();
+  data->sampleRate = reader->sampleRate;
+  data->sampleLength = (water::uint64) reader->lengthInSamples;
+
+  // Read some extra samples, which will be filled with zeros, so interpolation
+  // can be done without having to check for the edge all the time.
+  CARLA_SAFE_ASSERT_RETURN(data->sampleLength < std::numeric_limits<int>::max(), nullptr);
+
+  water::AudioSampleBuffer* buf = new water::AudioSampleBuffer((int) reader->numChannels, static_cast<int>(data->sampleLength + 4), true);
+  reader->read(buf, 0, static_cast<int>(data->sampleLength + 4), 0, true, true);
+  data->buffer = buf;
+
+  water::StringPairArray *metadata = &reader->metadataValues;
+  int numLoops = metadata->getValue("NumSampleLoops", "0").getIntValue();
+  if (numLoops > 0)
+  {
+    data->loopStart = (water::uint64) metadata->getValue("Loop0Start", "0").getLargeIntValue();
+    data->loopEnd = (water::uint64) metadata->getValue("Loop0End", "0").getLargeIntValue();
+  }
+  delete reader;
+
+  return data;
+#else
+  const water::String filename(file.getFullPathName());
+
+  struct adinfo info;
+  carla_zeroStruct(info);
 
-    // NOTE: We add some extra samples, which will be filled with zeros,
-    // so interpolation can be done without having to check for the edge all the time.
+  void *const handle = ad_open(filename.toRawUTF8(), &info);
+  CARLA_SAFE_ASSERT_RETURN(handle != nullptr, nullptr);
 
-    buffer_ = new water::AudioSampleBuffer(info.channels, sampleLength_ + 4, true);
+  if (info.frames >= std::numeric_limits<int>::max())
+  {
+    carla_stderr2("sfzero::Sample::load() - file is too big!");
+    ad_close(handle);
+    return nullptr;
+  }
 
-    for (int i=info.channels; --i >= 0;)
-        buffer_->copyFromInterleavedSource(i, rbuffer, r);
+  const water::uint64 sampleLength = info.frames/info.channels;
+  // TODO loopStart, loopEnd
 
-    std::free(rbuffer);
+  // read interleaved buffer
+  float *const rbuffer = (float *)std::calloc(1, sizeof(float)*info.frames);
+
+  if (rbuffer == nullptr)
+  {
+    carla_stderr2("sfzero::Sample::load() - out of memory");
     ad_close(handle);
+    return nullptr;
+  }
+
+  // Fix for misinformation using libsndfile
+  if (info.frames % info.channels)
+    --info.frames;
+
+  const ssize_t r = ad_read(handle, rbuffer, info.frames);
+  if (r != info.frames)
+  {
+    if (r != 0)
+      carla_stderr2("sfzero::Sample::load() - failed to read complete file: " P_SSIZE " vs " P_INT64, r, info.frames);
+    ad_close(handle);
+    return nullptr;
+  }
+
+  // NOTE: We add some extra samples, which will be filled with zeros,
+  // so interpolation can be done without having to check for the edge all the time.
+
+  SampleData *const data = new SampleData();
+  data->sampleRate = info.sample_rate;
+  data->sampleLength = sampleLength;
+  data->buffer = new water::AudioSampleBuffer(info.channels, sampleLength + 4, true);
+
+  for (int i=info.channels; --i >= 0;)
+    data->buffer->copyFromInterleavedSource(i, rbuffer, r);
+
+  std::free(rbuffer);
+  ad_close(handle);
+
+  return data;
 #endif
+}
+
+bool Sample::load()
+{
+  const water::String path(file_.getFullPathName());
+  const water::int64 modificationTime = file_.getLastModificationTime();
+  const water::int64 size = file_.getSize();
 
+  SampleCache &cache(SampleCache::getInstance());
+
+  data_ = cache.find(path, modificationTime, size);
+
+  if (data_ != nullptr)
+  {
+    carla_debug("Sample '%s' already loaded, sharing it", path.toRawUTF8());
     return true;
+  }
+
+  SampleData *const data = decodeFile(file_);
+
+  if (data == nullptr)
+    return false;
+
+  data_ = cache.insert(path, modificationTime, size, std::shared_ptr<const SampleData>(data));
+  return true;
 }
 
 Sample::~Sample() { }
@@ -118,13 +222,19 @@ water::String Sample::getShortName() { return (file_.getFileName()); }
 
 void Sample::setBuffer(water::AudioSampleBuffer *newBuffer)
 {
-  buffer_ = newBuffer;
-  sampleLength_ = buffer_->getNumSamples();
-}
+  // not from a file, so never shared; sample rate and loop points stay as they were
+  SampleData *const data = new SampleData();
+  data->buffer = newBuffer;
+  data->sampleLength = newBuffer->getNumSamples();
 
-water::AudioSampleBuffer *Sample::detachBuffer()
-{
-  return buffer_.release();
+  if (data_ != nullptr)
+  {
+    data->sampleRate = data_->sampleRate;
+    data->loopStart = data_->loopStart;
+    data->loopEnd = data_->loopEnd;
+  }
+
+  data_ = std::shared_ptr<const SampleData>(data);
 }
 
 water::String Sample::dump() { return file_.getFullPathName() + "\n"; }
@@ -132,15 +242,16 @@ water::String Sample::dump() { return file_.getFullPathName() + "\n"; }
 #ifdef DEBUG
 void Sample::checkIfZeroed(const char *where)
 {
-  if (buffer_ == nullptr)
+  const water::AudioSampleBuffer *const buffer = getBuffer();
+  if (buffer == nullptr)
   {
     dbgprintf("SFZSample::checkIfZeroed(%s): no buffer!", where);
     return;
   }
 
-  int samplesLeft = buffer_->getNumSamples();
+  int samplesLeft = buffer->getNumSamples();
   water::int64 nonzero = 0, zero = 0;
-  const float *p = buffer_->getReadPointer(0);
+  const float *p = buffer->getReadPointer(0);
   for (; samplesLeft > 0; --samplesLeft)
   {
     if (*p++ == 0.0)
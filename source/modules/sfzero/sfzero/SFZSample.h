@@ -14,27 +14,43 @@
 
 #include "CarlaScopeUtils.hpp"
 
+#include <memory>
+
 namespace sfzero
 {
 
+// Decoded audio of a sample file, shared by all samples using the same file.
+// Never modified after loading, so it can be read by any number of voices.
+struct SampleData
+{
+  CarlaScopedPointer<water::AudioSampleBuffer> buffer;
+  double sampleRate;
+  water::uint64 sampleLength, loopStart, loopEnd;
+
+  SampleData() : buffer(nullptr), sampleRate(0), sampleLength(0), loopStart(0), loopEnd(0) {}
+
+  CARLA_DECLARE_NON_COPYABLE(SampleData)
+};
+
 class Sample
 {
 public:
-  explicit Sample(const water::File &fileIn) : file_(fileIn), buffer_(nullptr), sampleRate_(0), sampleLength_(0), loopStart_(0), loopEnd_(0) {}
+  explicit Sample(const water::File &fileIn) : file_(fileIn), data_() {}
   virtual ~Sample();
 
+  // Loads the sample file, or reuses its data if another sample in this process already loaded it.
+  // Can be called from any thread.
   bool load();
 
   water::File getFile() { return (file_); }
-  water::AudioSampleBuffer *getBuffer() { return (buffer_); }
-  double getSampleRate() { return (sampleRate_); }
+  const water::AudioSampleBuffer *getBuffer() { return (data_ != nullptr ? data_->buffer.get() : nullptr); }
+  double getSampleRate() { return (data_ != nullptr ? data_->sampleRate : 0.0); }
   water::String getShortName();
   void setBuffer(water::AudioSampleBuffer *newBuffer);
-  water::AudioSampleBuffer *detachBuffer();
   water::String dump();
-  water::uint64 getSampleLength() const { return sampleLength_; }
-  water::uint64 getLoopStart() const { return loopStart_; }
-  water::uint64 getLoopEnd() const { return loopEnd_; }
+  water::uint64 getSampleLength() const { return data_ != nullptr ? data_->sampleLength : 0; }
+  water::uint64 getLoopStart() const { return data_ != nullptr ? data_->loopStart : 0; }
+  water::uint64 getLoopEnd() const { return data_ != nullptr ? data_->loopEnd : 0; }
 
 #ifdef DEBUG
   void checkIfZeroed(const char *where);
@@ -42,9 +58,7 @@ public:
 
 private:
   water::File file_;
-  CarlaScopedPointer<water::AudioSampleBuffer> buffer_;
-  double sampleRate_;
-  water::uint64 sampleLength_, loopStart_, loopEnd_;
+  std::shared_ptr<const SampleData> data_;
 
   CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Sample)
 };
@@ -10,6 +10,10 @@
 #include "SFZRegion.h"
 #include "SFZSample.h"
 
+#include "CarlaThread.hpp"
+
+#include <vector>
+
 namespace sfzero
 {
 
@@ -82,22 +86,121 @@ void Sound::loadRegions()
   reader.read(file_);
 }
 
+// Samples are decoded by a few threads at once, each one taking the next sample nobody took yet.
+struct SampleLoader
+{
+  std::vector<Sample *> samples;
+  std::vector<char> results;
+  water::Atomic<int> nextSample;
+  water::Atomic<int> numFinished;
+
+  SampleLoader() : samples(), results(), nextSample(0), numFinished(0) {}
+
+  // returns false once there is nothing left to load
+  bool loadNext()
+  {
+    const int index = ++nextSample - 1;
+
+    if (index >= static_cast<int>(samples.size()))
+      return false;
+
+    results[index] = samples[index]->load() ? 1 : 0;
+    ++numFinished;
+    return true;
+  }
+
+  CARLA_DECLARE_NON_COPYABLE(SampleLoader)
+};
+
+class SampleLoaderThread : public CarlaThread
+{
+public:
+  SampleLoaderThread(SampleLoader &loader) : CarlaThread("SFZeroSampleLoader"), loader_(loader) {}
+
+protected:
+  void run() override
+  {
+    while (loader_.loadNext()) {}
+  }
+
+private:
+  SampleLoader &loader_;
+
+  CARLA_DECLARE_NON_COPYABLE(SampleLoaderThread)
+};
+
 void Sound::loadSamples(const LoadingIdleCallback& cb)
 {
-    for (water::HashMap<water::String, Sample *>::Iterator i(samples_); i.next();)
+  SampleLoader loader;
+  loader.samples.reserve(static_cast<size_t>(samples_.size()));
+
+  for (water::HashMap<water::String, Sample *>::Iterator i(samples_); i.next();)
+    loader.samples.push_back(i.getValue());
+
+  if (loader.samples.empty())
+    return;
+
+  const int total = static_cast<int>(loader.samples.size());
+  loader.results.resize(loader.samples.size(), 0);
+
+  // decoding is mostly CPU bound, but leave some room for the file reads
+  const int numThreads = std::min(std::min(static_cast<int>(carla_get_cpu_count()), 8), total);
+
+  std::vector<SampleLoaderThread *> threads;
+  threads.reserve(static_cast<size_t>(numThreads));
+
+  for (int i = 0; i < numThreads; ++i)
+  {
+    SampleLoaderThread *const thread = new SampleLoaderThread(loader);
+
+    if (! thread->startThread())
+    {
+      delete thread;
+      break;
+    }
+
+    threads.push_back(thread);
+  }
+
+  if (threads.empty())
+  {
+    // no threads could be started, load everything here
+    while (loader.loadNext())
+      cb.callback(cb.callbackPtr);
+  }
+  else
+  {
+    // keep the host responsive meanwhile, as done before after each loaded sample
+    for (int numReported = 0; numReported < total;)
     {
-        Sample* const sample = i.getValue();
-
-        if (sample->load())
-        {
-            carla_debug("Loaded sample '%s'", sample->getShortName().toRawUTF8());
-            cb.callback(cb.callbackPtr);
-        }
-        else
-        {
-            addError("Couldn't load sample \"" + sample->getShortName() + "\"");
-        }
+      const int finished = loader.numFinished.get();
+
+      if (finished == numReported)
+      {
+        carla_msleep(5);
+        continue;
+      }
+
+      numReported = finished;
+      cb.callback(cb.callbackPtr);
+    }
+
+    for (std::vector<SampleLoaderThread *>::iterator it = threads.begin(); it != threads.end(); ++it)
+    {
+      (*it)->stopThread(-1);
+      delete *it;
     }
+  }
+
+  for (int i = 0; i < total; ++i)
+  {
+    Sample *const sample = loader.samples[i];
+
+    if (loader.results[i] != 0)
+      carla_debug("Loaded sample '%s'", sample->getShortName().toRawUTF8());
+    else
+      addError("Couldn't load sample \"" + sample->getShortName() + "\"");
+  }
 }
 
 Region *Sound::getRegionFor(int note, int velocity, Region::Trigger trigger)
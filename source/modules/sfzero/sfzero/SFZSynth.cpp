@@ -9,10 +9,12 @@
 #include "SFZSound.h"
 #include "SFZVoice.h"
 
+#include <algorithm>
+
 namespace sfzero
 {
 
-Synth::Synth() : Synthesiser()
+Synth::Synth() : Synthesiser(), activeVoices_()
 {
     carla_zeroStructs(noteVelocities_, 128);
 }
@@ -97,6 +99,7 @@ void Synth::noteOn(int midiChannel, int midiNoteNumber, float velocity)
         {
           voice->setRegion(region);
           startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+          addActiveVoice(voice);
         }
       }
     }
@@ -123,18 +126,61 @@ void Synth::noteOff(int midiChannel, int midiNoteNumber, float velocity, bool al
         // we have to use a "setRegion()" mechanism.
         voice->setRegion(region);
         startVoice(voice, sound, midiChannel, midiNoteNumber, noteVelocities_[midiNoteNumber] / 127.0f);
+        addActiveVoice(voice);
       }
     }
   }
 }
 
+void Synth::setCurrentPlaybackSampleRate(double sampleRate)
+{
+  Synthesiser::setCurrentPlaybackSampleRate(sampleRate);
+
+  activeVoices_.reserve(static_cast<size_t>(voices.size()));
+}
+
+void Synth::renderVoices(water::AudioSampleBuffer &outputAudio, int startSample, int numSamples)
+{
+  for (size_t i = activeVoices_.size(); i-- > 0;)
+  {
+    Voice *voice = activeVoices_[i];
+    voice->renderNextBlock(outputAudio, startSample, numSamples);
+
+    if (!voice->isVoiceActive())
+    {
+      activeVoices_[i] = activeVoices_.back();
+      activeVoices_.pop_back();
+    }
+  }
+}
+
+void Synth::setInterpolation(Voice::Interpolation interpolation)
+{
+  for (int i = voices.size(); --i >= 0;)
+  {
+    Voice *voice = dynamic_cast<Voice *>(voices.getUnchecked(i));
+    if (voice != nullptr)
+    {
+      voice->setInterpolation(interpolation);
+    }
+  }
+}
+
+void Synth::addActiveVoice(Voice *voice)
+{
+  if (std::find(activeVoices_.begin(), activeVoices_.end(), voice) == activeVoices_.end())
+  {
+    activeVoices_.push_back(voice);
+  }
+}
+
 int Synth::numVoicesUsed()
 {
   int numUsed = 0;
 
-  for (int i = voices.size(); --i >= 0;)
+  for (size_t i = 0; i < activeVoices_.size(); ++i)
   {
-    if (voices.getUnchecked(i)->getCurrentlyPlayingNote() >= 0)
+    if (activeVoices_[i]->isVoiceActive())
     {
       numUsed += 1;
     }
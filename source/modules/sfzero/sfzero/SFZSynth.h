@@ -9,9 +9,12 @@
 #define SFZSYNTH_H_INCLUDED
 
 #include "SFZCommon.h"
+#include "SFZVoice.h"
 
 #include "water/synthesisers/Synthesiser.h"
 
+#include <vector>
+
 namespace sfzero
 {
 
@@ -23,12 +26,22 @@ public:
 
   void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
   void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+  void setCurrentPlaybackSampleRate(double sampleRate) override;
+  void renderVoices(water::AudioSampleBuffer &outputAudio, int startSample, int numSamples) override;
+
+  void setInterpolation(Voice::Interpolation interpolation);
 
   int numVoicesUsed();
   water::String voiceInfoString();
 
 private:
   int noteVelocities_[128];
+
+  // Voices started since they were last rendered idle, only these get rendered.
+  // Storage for all voices is reserved when setting the sample rate, so this does not allocate while running.
+  std::vector<Voice *> activeVoices_;
+
+  void addActiveVoice(Voice *voice);
   CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Synth)
 };
 }
@@ -13,6 +13,7 @@
 
 #include "water/midi/MidiMessage.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace sfzero
@@ -20,9 +21,13 @@ namespace sfzero
 
 static const float globalGain = -1.0;
 
+// Voices are rendered in chunks of up to this many samples, each within a single envelope segment and loop pass.
+static const int renderChunkSize = 64;
+
 Voice::Voice()
     : region_(nullptr), curMidiNote_(0), curPitchWheel_(0), pitchRatio_(0), noteGainLeft_(0), noteGainRight_(0),
-      sourceSamplePosition_(0), sampleEnd_(0), loopStart_(0), loopEnd_(0), numLoops_(0), curVelocity_(0)
+      sourceSamplePosition_(0), sampleEnd_(0), loopStart_(0), loopEnd_(0), interpolation_(linear), numLoops_(0),
+      curVelocity_(0)
 {
   ampeg_.setExponentialDecay(true);
 }
@@ -163,6 +168,72 @@ void Voice::pitchWheelMoved(int newValue)
 }
 
 void Voice::controllerMoved(int /*controllerNumber*/, int /*newValue*/) { /***/}
+
+// Index of the sample read for an interpolation tap at pos + tap, past the loop end it continues from the loop start.
+static int getTapIndex(int pos, int tap, bool looping, int loopStart, int loopEnd, int bufferNumSamples)
+{
+  int index = pos + tap;
+  if (looping && (index > loopEnd))
+  {
+    index = loopStart + index - std::max(pos, loopEnd) - 1;
+  }
+  if (index < 0)
+  {
+    return 0;
+  }
+  if (index >= bufferNumSamples)
+  {
+    return bufferNumSamples - 1;
+  }
+  return index;
+}
+
+static void interpolateLinear(const float *in, const int *positions, const float *alphas, float *out, int numSamples)
+{
+  for (int i = 0; i < numSamples; ++i)
+  {
+    const float *x = in + positions[i];
+    out[i] = x[0] * (1.0f - alphas[i]) + x[1] * alphas[i];
+  }
+}
+
+// 4-point, 3rd-order Hermite (Catmull-Rom).
+// The taps are gathered first, so the arithmetic runs over contiguous arrays.
+static void interpolateCubic(const float *in, const int *positions, const float *alphas, float *out, int numSamples)
+{
+  float xm1[renderChunkSize], x0[renderChunkSize], x1[renderChunkSize], x2[renderChunkSize];
+
+  for (int i = 0; i < numSamples; ++i)
+  {
+    const float *x = in + positions[i];
+    xm1[i] = x[-1];
+    x0[i] = x[0];
+    x1[i] = x[1];
+    x2[i] = x[2];
+  }
+
+  for (int i = 0; i < numSamples; ++i)
+  {
+    const float c1 = 0.5f * (x1[i] - xm1[i]);
+    const float c3 = 1.5f * (x0[i] - x1[i]) + 0.5f * (x2[i] - xm1[i]);
+    const float c2 = xm1[i] - x0[i] + c1 - c3;
+    out[i] = ((c3 * alphas[i] + c2) * alphas[i] + c1) * alphas[i] + x0[i];
+  }
+}
+
+static void interpolate(Voice::Interpolation interpolation, const float *in, const int *positions, const float *alphas,
+                        float *out, int numSamples)
+{
+  if (interpolation == Voice::cubic)
+  {
+    interpolateCubic(in, positions, alphas, out, numSamples);
+  }
+  else
+  {
+    interpolateLinear(in, positions, alphas, out, numSamples);
+  }
+}
+
 void Voice::renderNextBlock(water::AudioSampleBuffer &outputBuffer, int startSample, int numSamples)
 {
   if (region_ == nullptr)
@@ -170,83 +241,183 @@ void Voice::renderNextBlock(water::AudioSampleBuffer &outputBuffer, int startSam
     return;
   }
 
-  water::AudioSampleBuffer *buffer = region_->sample->getBuffer();
+  const water::AudioSampleBuffer *buffer = region_->sample->getBuffer();
   const float *inL = buffer->getReadPointer(0, 0);
   const float *inR = buffer->getNumChannels() > 1 ? buffer->getReadPointer(1, 0) : nullptr;
 
   float *outL = outputBuffer.getWritePointer(0, startSample);
   float *outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
 
-  int bufferNumSamples = buffer->getNumSamples(); // leoo
+  const int bufferNumSamples = buffer->getNumSamples(); // leoo
 
   // Cache some values, to give them at least some chance of ending up in
   // registers.
   double sourceSamplePosition = this->sourceSamplePosition_;
+  const double pitchRatio = this->pitchRatio_;
+  const float noteGainLeft = this->noteGainLeft_;
+  const float noteGainRight = this->noteGainRight_;
   float ampegGain = ampeg_.getLevel();
   float ampegSlope = ampeg_.getSlope();
   int samplesUntilNextAmpSegment = ampeg_.getSamplesUntilNextSegment();
   bool ampSegmentIsExponential = ampeg_.getSegmentIsExponential();
-  float loopStart = static_cast<float>(this->loopStart_);
-  float loopEnd = static_cast<float>(this->loopEnd_);
-  float sampleEnd = static_cast<float>(this->sampleEnd_);
-
-  while (--numSamples >= 0)
+  const float loopStart = static_cast<float>(this->loopStart_);
+  const float loopEnd = static_cast<float>(this->loopEnd_);
+  const float sampleEnd = static_cast<float>(this->sampleEnd_);
+  const bool looping = loopStart < loopEnd;
+  const int loopStartIndex = static_cast<int>(this->loopStart_);
+  const int loopEndIndex = static_cast<int>(this->loopEnd_);
+
+  // Taps of the interpolation, relative to the sample position.
+  const int firstTap = (interpolation_ == cubic) ? -1 : 0;
+  const int numTaps = (interpolation_ == cubic) ? 4 : 2;
+  const int lastTap = firstTap + numTaps - 1;
+  const int lastContiguousIndex = looping ? std::min(loopEndIndex, bufferNumSamples - 1) : bufferNumSamples - 1;
+
+  // Splitting the block at envelope segment and loop boundaries leaves the per-sample work
+  // as a few straight loops over small buffers, which the compiler can vectorize.
+  int positions[renderChunkSize];
+  float alphas[renderChunkSize];
+  float gains[renderChunkSize];
+  float chunkL[renderChunkSize], chunkR[renderChunkSize];
+
+  // Near the sample and loop edges the taps are copied here first, 4 per position.
+  int edgePositions[renderChunkSize];
+  float edgeL[renderChunkSize * 4], edgeR[renderChunkSize * 4];
+
+  while (numSamples > 0)
   {
-    const int pos = static_cast<int>(sourceSamplePosition);
-    CARLA_SAFE_ASSERT_CONTINUE(pos >= 0 && pos < bufferNumSamples); // leoo
-
-    float alpha = static_cast<float>(sourceSamplePosition - pos);
-    float invAlpha = 1.0f - alpha;
-    int nextPos = pos + 1;
-    if ((loopStart < loopEnd) && (nextPos > loopEnd))
+    int count = std::min(numSamples, renderChunkSize);
+    if (samplesUntilNextAmpSegment < count)
     {
-      nextPos = static_cast<int>(loopStart);
+      count = std::max(samplesUntilNextAmpSegment + 1, 1);
     }
 
-    // Simple linear interpolation with buffer overrun check
-    float nextL = nextPos < bufferNumSamples ? inL[nextPos] : inL[pos];
-    float nextR = inR ? (nextPos < bufferNumSamples ? inR[nextPos] : inR[pos]) : nextL;
-    float l = (inL[pos] * invAlpha + nextL * alpha);
-    float r = inR ? (inR[pos] * invAlpha + nextR * alpha) : l;
+    // Positions, up to the sample that wraps around the loop or reaches the end.
+    // Those that are well before both need no checks.
+    int n = 0;
+    if (pitchRatio > 0.0)
+    {
+      const double limit = looping ? std::min(loopEnd, sampleEnd) : sampleEnd;
+      const double steps = (limit - sourceSamplePosition) / pitchRatio - 1.0;
+      if (steps > 0.0)
+      {
+        n = (steps < count) ? static_cast<int>(steps) : count;
+      }
+    }
+    for (int i = 0; i < n; ++i)
+    {
+      const double position = sourceSamplePosition + i * pitchRatio;
+      positions[i] = static_cast<int>(position);
+      alphas[i] = static_cast<float>(position - positions[i]);
+    }
+    sourceSamplePosition += n * pitchRatio;
 
-    //// Simple linear interpolation, old version (possible buffer overrun with non-loop??)
-    // float l = (inL[pos] * invAlpha + inL[nextPos] * alpha);
-    // float r = inR ? (inR[pos] * invAlpha + inR[nextPos] * alpha) : l;
+    bool reachedEnd = false;
+    while (n < count)
+    {
+      const int pos = static_cast<int>(sourceSamplePosition);
+      positions[n] = pos;
+      alphas[n] = static_cast<float>(sourceSamplePosition - pos);
+      ++n;
+
+      sourceSamplePosition += pitchRatio;
+      bool wrapped = false;
+      if (looping && (sourceSamplePosition > loopEnd))
+      {
+        sourceSamplePosition = loopStart;
+        numLoops_ += 1;
+        wrapped = true;
+      }
+      if (sourceSamplePosition >= sampleEnd)
+      {
+        reachedEnd = true;
+        break;
+      }
+      if (wrapped)
+      {
+        break;
+      }
+    }
 
-    float gainLeft = noteGainLeft_ * ampegGain;
-    float gainRight = noteGainRight_ * ampegGain;
-    l *= gainLeft;
-    r *= gainRight;
-    // Shouldn't we dither here?
+    // Positions only go up within a chunk.
+    if ((positions[0] < 0) || (positions[n - 1] >= bufferNumSamples))
+    {
+      carla_stderr2("sfzero::Voice::renderNextBlock() - sample position %i out of range", positions[0]);
+      killNote();
+      return;
+    }
 
-    if (outR)
+    // Interpolate straight from the sample, unless the chunk is near an edge.
+    if ((positions[0] + firstTap >= 0) && (positions[n - 1] + lastTap <= lastContiguousIndex))
     {
-      *outL++ += l;
-      *outR++ += r;
+      interpolate(interpolation_, inL, positions, alphas, chunkL, n);
+      if (inR != nullptr)
+      {
+        interpolate(interpolation_, inR, positions, alphas, chunkR, n);
+      }
     }
     else
     {
-      *outL++ += (l + r) * 0.5f;
+      for (int i = 0; i < n; ++i)
+      {
+        edgePositions[i] = i * 4 - firstTap;
+        for (int t = 0; t < numTaps; ++t)
+        {
+          const int index =
+              getTapIndex(positions[i], firstTap + t, looping, loopStartIndex, loopEndIndex, bufferNumSamples);
+          edgeL[i * 4 + t] = inL[index];
+          edgeR[i * 4 + t] = (inR != nullptr) ? inR[index] : 0.0f;
+        }
+      }
+      interpolate(interpolation_, edgeL, edgePositions, alphas, chunkL, n);
+      if (inR != nullptr)
+      {
+        interpolate(interpolation_, edgeR, edgePositions, alphas, chunkR, n);
+      }
     }
+    const float *chunkRight = (inR != nullptr) ? chunkR : chunkL;
 
-    // Next sample.
-    sourceSamplePosition += pitchRatio_;
-    if ((loopStart < loopEnd) && (sourceSamplePosition > loopEnd))
+    // EG, a single segment within the chunk.
+    if (ampSegmentIsExponential)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        gains[i] = ampegGain;
+        ampegGain *= ampegSlope;
+      }
+    }
+    else
     {
-      sourceSamplePosition = loopStart;
-      numLoops_ += 1;
+      for (int i = 0; i < n; ++i)
+      {
+        gains[i] = ampegGain;
+        ampegGain += ampegSlope;
+      }
     }
 
-    // Update EG.
-    if (ampSegmentIsExponential)
+    // Shouldn't we dither here?
+    if (outR)
     {
-      ampegGain *= ampegSlope;
+      for (int i = 0; i < n; ++i)
+      {
+        outL[i] += chunkL[i] * (noteGainLeft * gains[i]);
+        outR[i] += chunkRight[i] * (noteGainRight * gains[i]);
+      }
+      outR += n;
     }
     else
     {
-      ampegGain += ampegSlope;
+      for (int i = 0; i < n; ++i)
+      {
+        outL[i] += (chunkL[i] * (noteGainLeft * gains[i]) + chunkRight[i] * (noteGainRight * gains[i])) * 0.5f;
+      }
     }
-    if (--samplesUntilNextAmpSegment < 0)
+    outL += n;
+    numSamples -= n;
+
+    // Update EG.
+    samplesUntilNextAmpSegment -= n;
+    if (samplesUntilNextAmpSegment < 0)
     {
       ampeg_.setLevel(ampegGain);
       ampeg_.nextSegment();
@@ -256,10 +427,10 @@ void Voice::renderNextBlock(water::AudioSampleBuffer &outputBuffer, int startSam
       ampSegmentIsExponential = ampeg_.getSegmentIsExponential();
     }
 
-    if ((sourceSamplePosition >= sampleEnd) || ampeg_.isDone())
+    if (reachedEnd || ampeg_.isDone())
     {
       killNote();
-      break;
+      return;
     }
   }
 
@@ -20,6 +20,12 @@ struct Region;
 class Voice : public water::SynthesiserVoice
 {
 public:
+  enum Interpolation
+  {
+    linear,
+    cubic
+  };
+
   Voice();
   virtual ~Voice();
 
@@ -40,6 +46,9 @@ public:
   // Set the region to be used by the next startNote().
   void setRegion(Region *nextRegion);
 
+  // Cubic interpolation sounds cleaner when pitching up, for about twice the cost.
+  void setInterpolation(Interpolation newInterpolation) { interpolation_ = newInterpolation; }
+
   water::String infoString();
 
 private:
@@ -51,6 +60,7 @@ private:
   EG ampeg_;
   water::int64 sampleEnd_;
   water::int64 loopStart_, loopEnd_;
+  Interpolation interpolation_;
 
   // Info only.
   int numLoops_;
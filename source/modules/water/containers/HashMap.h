@@ -29,6 +29,7 @@
 #include "Array.h"
 #include "../text/String.h"
 
+#include "CarlaJuceUtils.hpp"
 #include "CarlaScopeUtils.hpp"
 
 namespace water {
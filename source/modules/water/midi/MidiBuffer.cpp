@@ -83,6 +83,20 @@ namespace MidiBufferHelpers
 
         return d;
     }
+
+    static void insertEvent (Array<uint8>& data, const int offset,
+                             const void* const newData, const int numBytes, const int sampleNumber)
+    {
+        const size_t newItemSize = (size_t) numBytes + sizeof (int32) + sizeof (uint16);
+
+        if (! data.insertMultiple (offset, 0, (int) newItemSize))
+            return;
+
+        uint8* const d = data.begin() + offset;
+        writeUnaligned<int32>  (d, sampleNumber);
+        writeUnaligned<uint16> (d + 4, static_cast<uint16> (numBytes));
+        memcpy (d + 6, newData, (size_t) numBytes);
+    }
 }
 
 //==============================================================================
@@ -93,7 +107,15 @@ MidiBuffer::MidiBuffer (const MidiBuffer& other) noexcept  : data (other.data) {
 
 MidiBuffer& MidiBuffer::operator= (const MidiBuffer& other) noexcept
 {
-    data = other.data;
+    // reuse the existing storage, the graph copies between its buffers on every block
+    if (this != &other)
+    {
+        data.clearQuick();
+
+        if (data.ensureStorageAllocated (other.data.size()))
+            data.addArray (other.data);
+    }
+
     return *this;
 }
 
@@ -126,18 +148,20 @@ void MidiBuffer::addEvent (const void* const newData, const int maxBytes, const
 
     if (numBytes > 0)
     {
-        const size_t newItemSize = (size_t) numBytes + sizeof (int32) + sizeof (uint16);
         const int offset = (int) (MidiBufferHelpers::findEventAfter (data.begin(), data.end(), sampleNumber) - data.begin());
 
-        data.insertMultiple (offset, 0, (int) newItemSize);
-
-        uint8* const d = data.begin() + offset;
-        writeUnaligned<int32>  (d, sampleNumber);
-        writeUnaligned<uint16> (d + 4, static_cast<uint16> (numBytes));
-        memcpy (d + 6, newData, (size_t) numBytes);
+        MidiBufferHelpers::insertEvent (data, offset, newData, numBytes, sampleNumber);
     }
 }
 
+void MidiBuffer::addEventAtEnd (const void* const newData, const int maxBytes, const int sampleNumber)
+{
+    const int numBytes = MidiBufferHelpers::findActualEventLength (static_cast<const uint8*> (newData), maxBytes);
+
+    if (numBytes > 0)
+        MidiBufferHelpers::insertEvent (data, data.size(), newData, numBytes, sampleNumber);
+}
+
 void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
                             const int startSample,
                             const int numSamples,
@@ -147,13 +171,52 @@ void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
     i.setNextSamplePosition (startSample);
 
     const uint8* eventData;
-    int eventSize, position;
+    int eventSize, position, numBytes;
+
+    // merge into the spare array and swap, inserting in place would move the rest of the buffer for every event
+    const int maxSize = data.size() + otherBuffer.data.size();
+
+    mergeData.clearQuick();
+
+    if (otherBuffer.isEmpty() || ! mergeData.insertMultiple (0, 0, maxSize))
+        return;
+
+    uint8* d = data.begin();
+    uint8* const endData = data.end();
+    uint8* out = mergeData.begin();
 
     while (i.getNextEvent (eventData, eventSize, position)
             && (position < startSample + numSamples || numSamples < 0))
     {
-        addEvent (eventData, eventSize, position + sampleDeltaToAdd);
+        numBytes = MidiBufferHelpers::findActualEventLength (eventData, eventSize);
+
+        if (numBytes <= 0)
+            continue;
+
+        // events of this buffer with the same position go first
+        uint8* const next = MidiBufferHelpers::findEventAfter (d, endData, position + sampleDeltaToAdd);
+
+        if (next != d)
+        {
+            memcpy (out, d, (size_t) (next - d));
+            out += next - d;
+            d = next;
+        }
+
+        writeUnaligned<int32>  (out, position + sampleDeltaToAdd);
+        writeUnaligned<uint16> (out + 4, static_cast<uint16> (numBytes));
+        memcpy (out + 6, eventData, (size_t) numBytes);
+        out += numBytes + (int) (sizeof (int32) + sizeof (uint16));
     }
+
+    if (endData != d)
+    {
+        memcpy (out, d, (size_t) (endData - d));
+        out += endData - d;
+    }
+
+    mergeData.removeRange ((int) (out - mergeData.begin()), maxSize);
+    data.swapWith (mergeData);
 }
 
 int MidiBuffer::getNumEvents() const noexcept
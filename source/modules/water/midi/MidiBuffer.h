@@ -120,8 +120,22 @@ public:
                    int maxBytesOfMidiData,
                    int sampleNumber);
 
+    /** Adds an event from raw midi data to the end of the buffer.
+
+        Unlike addEvent(), this does not search for the position of the event, so it's the
+        fast way of filling a buffer from a list of events that is already sorted.
+        The sample number must not be lower than the one of the last event in the buffer.
+    */
+    void addEventAtEnd (const void* rawMidiData,
+                        int maxBytesOfMidiData,
+                        int sampleNumber);
+
     /** Adds some events from another buffer to this one.
 
+        Both buffers are sorted, so this merges them in a single pass that copies each event once.
+        Events from the other buffer are placed after any events of this buffer that have the same
+        sample position.
+
         @param otherBuffer          the buffer containing the events you want to add
         @param startSample          the lowest sample number in the source buffer for which
                                     events should be added. Any source events whose timestamp is
@@ -230,6 +244,10 @@ public:
         change in future, so don't write code that relies on it!
     */
     Array<uint8> data;
+
+private:
+    // spare storage for addEvents(), swapped with data on every merge so both stay allocated
+    Array<uint8> mergeData;
 };
 
 }
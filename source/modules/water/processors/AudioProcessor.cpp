@@ -89,6 +89,22 @@ void AudioProcessor::suspendProcessing (const bool shouldBeSuspended)
 void AudioProcessor::reset() {}
 void AudioProcessor::reconfigure() {}
 
+void AudioProcessor::processBlockDoubleWithCV (double* const* const audioChannels,
+                                               const uint numAudioChannels,
+                                               const AudioSampleBuffer&,
+                                               AudioSampleBuffer& cvOutBuffer,
+                                               MidiBuffer&,
+                                               const int numSamples)
+{
+    // only called for processors that support double precision
+    CARLA_SAFE_ASSERT(supportsDoublePrecisionProcessing());
+
+    for (uint i = 0; i < numAudioChannels; ++i)
+        carla_zeroDoubles (audioChannels[i], static_cast<size_t> (numSamples));
+
+    cvOutBuffer.clear();
+}
+
 uint AudioProcessor::getTotalNumInputChannels(ChannelType t) const noexcept
 {
     switch (t)
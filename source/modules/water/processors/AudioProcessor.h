@@ -159,6 +159,26 @@ public:
                                      AudioSampleBuffer& cvOutBuffer,
                                      MidiBuffer& midiMessages) = 0;
 
+    /** Returns true if the processor can currently process audio in double precision.
+
+        An AudioProcessorGraph in double precision mode calls processBlockDoubleWithCV()
+        instead of processBlockWithCV() for such processors, so audio passed between two of
+        them never gets truncated to float. This is checked on every block, from the audio thread.
+    */
+    virtual bool supportsDoublePrecisionProcessing() const noexcept     { return false; }
+
+    /** Renders the next block in double precision.
+
+        Works like processBlockWithCV(), with @a audioChannels being used for both input and output.
+        Only called when supportsDoublePrecisionProcessing() returns true.
+    */
+    virtual void processBlockDoubleWithCV (double* const* audioChannels,
+                                           uint numAudioChannels,
+                                           const AudioSampleBuffer& cvInBuffer,
+                                           AudioSampleBuffer& cvOutBuffer,
+                                           MidiBuffer& midiMessages,
+                                           int numSamples);
+
     //==============================================================================
     /** Returns the total number of input channels. */
     uint getTotalNumInputChannels(ChannelType t) const noexcept;
@@ -263,6 +283,23 @@ public:
     */
     bool isSuspended() const noexcept                                   { return suspended; }
 
+    /** Returns true if the processor currently produces no output at all.
+
+        An AudioProcessorGraph leaves inactive processors out of its rendering sequence,
+        and treats their outputs as silent. The graph checks this again every time
+        AudioProcessorGraph::reorderNowIfNeeded() is called, so changes are picked up
+        on the next reorder instead of immediately.
+    */
+    virtual bool isInactive() const noexcept                            { return false; }
+
+    /** Returns true if the processor must run even when its outputs are not used.
+
+        An AudioProcessorGraph normally leaves processors that don't feed any output
+        out of its rendering sequence. Like isInactive(), this is checked again every
+        time AudioProcessorGraph::reorderNowIfNeeded() is called.
+    */
+    virtual bool isAlwaysNeeded() const noexcept                        { return false; }
+
     /** A plugin can override this to be told when it should reset any playing voices.
 
         The default implementation does nothing, but a host may call this to tell the
@@ -19,7 +19,7 @@
 */
 
 #include "AudioProcessorGraph.h"
-#include "../containers/SortedSet.h"
+#include "../containers/HashMap.h"
 
 namespace water {
 
@@ -27,14 +27,92 @@ namespace water {
 namespace GraphRenderingOps
 {
 
+//==============================================================================
+/** Double precision copies of the shared audio channels, used when the graph processes in double precision.
+
+    Each channel remembers which of its two copies holds the current data, so conversions only
+    happen when a float processor follows a double one (or the other way around).
+*/
+struct DoubleChannels
+{
+    DoubleChannels() noexcept
+        : numChannels (0), numSamplesAllocated (0) {}
+
+    bool setSize (const int newNumChannels, const int newNumSamples) noexcept
+    {
+        numChannels = 0;
+        numSamplesAllocated = 0;
+
+        if (! data.calloc (static_cast<size_t> (newNumChannels * newNumSamples)))
+            return false;
+        if (! isDouble.calloc (static_cast<size_t> (newNumChannels)))
+            return false;
+
+        numChannels = newNumChannels;
+        numSamplesAllocated = newNumSamples;
+        return true;
+    }
+
+    void release() noexcept
+    {
+        data.free();
+        isDouble.free();
+        numChannels = numSamplesAllocated = 0;
+    }
+
+    void resetFormats() noexcept
+    {
+        if (numChannels != 0)
+            isDouble.clear (static_cast<size_t> (numChannels));
+    }
+
+    double* getChannel (const int channel) const noexcept
+    {
+        return data + channel * numSamplesAllocated;
+    }
+
+    /** Makes sure the double copy of a channel is current and returns it. */
+    double* makeDouble (AudioSampleBuffer& floats, const int channel, const int numSamples) noexcept
+    {
+        double* const doubles = getChannel (channel);
+
+        if (! isDouble[channel])
+        {
+            carla_convertFloatsToDoubles (doubles, floats.getReadPointer (channel), static_cast<size_t> (numSamples));
+            isDouble[channel] = true;
+        }
+
+        return doubles;
+    }
+
+    /** Makes sure the float copy of a channel is current. */
+    void makeFloat (AudioSampleBuffer& floats, const int channel, const int numSamples) noexcept
+    {
+        if (isDouble[channel])
+        {
+            carla_convertDoublesToFloats (floats.getWritePointer (channel), getChannel (channel), static_cast<size_t> (numSamples));
+            isDouble[channel] = false;
+        }
+    }
+
+    HeapBlock<double> data;
+    HeapBlock<bool> isDouble;
+    int numChannels, numSamplesAllocated;
+
+    CARLA_DECLARE_NON_COPYABLE (DoubleChannels)
+};
+
+//==============================================================================
 struct AudioGraphRenderingOpBase
 {
     AudioGraphRenderingOpBase() noexcept {}
     virtual ~AudioGraphRenderingOpBase() {}
 
+    // doubles is null unless the graph is processing in double precision
     virtual void perform (AudioSampleBuffer& sharedAudioBufferChans,
                           AudioSampleBuffer& sharedCVBufferChans,
                           const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                          DoubleChannels* doubles,
                           const int numSamples) = 0;
 };
 
@@ -45,11 +123,13 @@ struct AudioGraphRenderingOp  : public AudioGraphRenderingOpBase
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                  DoubleChannels* const doubles,
                   const int numSamples) override
     {
         static_cast<Child*> (this)->perform (sharedAudioBufferChans,
                                              sharedCVBufferChans,
                                              sharedMidiBuffers,
+                                             doubles,
                                              numSamples);
     }
 };
@@ -63,12 +143,20 @@ struct ClearChannelOp  : public AudioGraphRenderingOp<ClearChannelOp>
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>&,
+                  DoubleChannels* const doubles,
                   const int numSamples)
     {
         if (isCV)
+        {
             sharedCVBufferChans.clear (channelNum, 0, numSamples);
+        }
         else
+        {
             sharedAudioBufferChans.clear (channelNum, 0, numSamples);
+
+            if (doubles != nullptr)
+                doubles->isDouble[channelNum] = false;
+        }
     }
 
     const int channelNum;
@@ -86,12 +174,26 @@ struct CopyChannelOp  : public AudioGraphRenderingOp<CopyChannelOp>
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>&,
+                  DoubleChannels* const doubles,
                   const int numSamples)
     {
         if (isCV)
+        {
             sharedCVBufferChans.copyFrom (dstChannelNum, 0, sharedCVBufferChans, srcChannelNum, 0, numSamples);
+        }
+        else if (doubles != nullptr && doubles->isDouble[srcChannelNum])
+        {
+            std::memcpy (doubles->getChannel (dstChannelNum), doubles->getChannel (srcChannelNum),
+                         sizeof (double) * static_cast<size_t> (numSamples));
+            doubles->isDouble[dstChannelNum] = true;
+        }
         else
+        {
             sharedAudioBufferChans.copyFrom (dstChannelNum, 0, sharedAudioBufferChans, srcChannelNum, 0, numSamples);
+
+            if (doubles != nullptr)
+                doubles->isDouble[dstChannelNum] = false;
+        }
     }
 
     const int srcChannelNum, dstChannelNum;
@@ -109,12 +211,24 @@ struct AddChannelOp  : public AudioGraphRenderingOp<AddChannelOp>
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>&,
+                  DoubleChannels* const doubles,
                   const int numSamples)
     {
         if (isCV)
+        {
             sharedCVBufferChans.addFrom (dstChannelNum, 0, sharedCVBufferChans, srcChannelNum, 0, numSamples);
+        }
+        else if (doubles != nullptr && (doubles->isDouble[srcChannelNum] || doubles->isDouble[dstChannelNum]))
+        {
+            // mix in double precision as soon as one side has it
+            carla_addDoubles (doubles->makeDouble (sharedAudioBufferChans, dstChannelNum, numSamples),
+                              doubles->makeDouble (sharedAudioBufferChans, srcChannelNum, numSamples),
+                              static_cast<size_t> (numSamples));
+        }
         else
+        {
             sharedAudioBufferChans.addFrom (dstChannelNum, 0, sharedAudioBufferChans, srcChannelNum, 0, numSamples);
+        }
     }
 
     const int srcChannelNum, dstChannelNum;
@@ -130,6 +244,7 @@ struct ClearMidiBufferOp  : public AudioGraphRenderingOp<ClearMidiBufferOp>
 
     void perform (AudioSampleBuffer&, AudioSampleBuffer&,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                  DoubleChannels*,
                   const int)
     {
         sharedMidiBuffers.getUnchecked (bufferNum)->clear();
@@ -149,6 +264,7 @@ struct CopyMidiBufferOp  : public AudioGraphRenderingOp<CopyMidiBufferOp>
 
     void perform (AudioSampleBuffer&, AudioSampleBuffer&,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                  DoubleChannels*,
                   const int)
     {
         *sharedMidiBuffers.getUnchecked (dstBufferNum) = *sharedMidiBuffers.getUnchecked (srcBufferNum);
@@ -168,6 +284,7 @@ struct AddMidiBufferOp  : public AudioGraphRenderingOp<AddMidiBufferOp>
 
     void perform (AudioSampleBuffer&, AudioSampleBuffer&,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                  DoubleChannels*,
                   const int numSamples)
     {
         sharedMidiBuffers.getUnchecked (dstBufferNum)
@@ -182,25 +299,56 @@ struct AddMidiBufferOp  : public AudioGraphRenderingOp<AddMidiBufferOp>
 //==============================================================================
 struct DelayChannelOp  : public AudioGraphRenderingOp<DelayChannelOp>
 {
-    DelayChannelOp (const int chan, const int delaySize, const bool cv)
+    DelayChannelOp (const int chan, const int delaySize, const bool cv, const bool useDoubles)
         : channel (chan),
           bufferSize (delaySize + 1),
           readIndex (0), writeIndex (delaySize),
           isCV (cv)
     {
-        buffer.calloc ((size_t) bufferSize);
+        if (useDoubles && ! cv)
+            doubleBuffer.calloc ((size_t) bufferSize);
+        else
+            buffer.calloc ((size_t) bufferSize);
     }
 
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>&,
+                  DoubleChannels* const doubles,
                   const int numSamples)
     {
-        float* data = isCV
-                    ? sharedCVBufferChans.getWritePointer (channel, 0)
-                    : sharedAudioBufferChans.getWritePointer (channel, 0);
-        HeapBlock<float>& block = buffer;
+        if (doubleBuffer != nullptr)
+        {
+            if (doubles != nullptr)
+                return delay (doubles->makeDouble (sharedAudioBufferChans, channel, numSamples),
+                              doubleBuffer, numSamples);
+
+            // block too big for the double buffers, process it in float
+            float* data = sharedAudioBufferChans.getWritePointer (channel, 0);
+
+            for (int i = numSamples; --i >= 0;)
+            {
+                doubleBuffer [writeIndex] = *data;
+                *data++ = static_cast<float> (doubleBuffer [readIndex]);
 
+                if (++readIndex  >= bufferSize) readIndex = 0;
+                if (++writeIndex >= bufferSize) writeIndex = 0;
+            }
+            return;
+        }
+
+        if (doubles != nullptr && ! isCV)
+            doubles->makeFloat (sharedAudioBufferChans, channel, numSamples);
+
+        delay (isCV ? sharedCVBufferChans.getWritePointer (channel, 0)
+                    : sharedAudioBufferChans.getWritePointer (channel, 0),
+               buffer, numSamples);
+    }
+
+private:
+    template <typename SampleType>
+    void delay (SampleType* data, HeapBlock<SampleType>& block, const int numSamples) noexcept
+    {
         for (int i = numSamples; --i >= 0;)
         {
             block [writeIndex] = *data;
@@ -211,8 +359,8 @@ struct DelayChannelOp  : public AudioGraphRenderingOp<DelayChannelOp>
         }
     }
 
-private:
     HeapBlock<float> buffer;
+    HeapBlock<double> doubleBuffer;
     const int channel, bufferSize;
     int readIndex, writeIndex;
     const bool isCV;
@@ -240,6 +388,7 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
           midiBufferToUse (midiBuffer)
     {
         audioChannels.calloc (totalAudioChans);
+        doubleAudioChannels.calloc (totalAudioChans);
         cvInChannels.calloc (totalCVIns);
         cvOutChannels.calloc (totalCVOuts);
 
@@ -250,14 +399,21 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                  DoubleChannels* const doubles,
                   const int numSamples)
     {
-        HeapBlock<float*>& audioChannelsCopy = audioChannels;
-        HeapBlock<float*>& cvInChannelsCopy  = cvInChannels;
-        HeapBlock<float*>& cvOutChannelsCopy = cvOutChannels;
+        if (doubles != nullptr && processor->supportsDoublePrecisionProcessing() && ! processor->isSuspended())
+            return performDouble (sharedCVBufferChans, sharedMidiBuffers, *doubles,
+                                  sharedAudioBufferChans, numSamples);
+
+        if (doubles != nullptr)
+        {
+            for (uint i = 0; i < totalAudioChans; ++i)
+                doubles->makeFloat (sharedAudioBufferChans, static_cast<int> (audioChannelsToUse.getUnchecked (i)), numSamples);
+        }
 
         for (uint i = 0; i < totalAudioChans; ++i)
-            audioChannelsCopy[i] = sharedAudioBufferChans.getWritePointer (audioChannelsToUse.getUnchecked (i), 0);
+            audioChannels[i] = sharedAudioBufferChans.getWritePointer (audioChannelsToUse.getUnchecked (i), 0);
 
         for (uint i = 0; i < totalCVIns; ++i)
             cvInChannels[i] = sharedCVBufferChans.getWritePointer (cvInChannelsToUse.getUnchecked (i), 0);
@@ -265,9 +421,9 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
         for (uint i = 0; i < totalCVOuts; ++i)
             cvOutChannels[i] = sharedCVBufferChans.getWritePointer (cvOutChannelsToUse.getUnchecked (i), 0);
 
-        AudioSampleBuffer audioBuffer (audioChannelsCopy, totalAudioChans, numSamples);
-        AudioSampleBuffer cvInBuffer  (cvInChannelsCopy, totalCVIns, numSamples);
-        AudioSampleBuffer cvOutBuffer (cvOutChannelsCopy, totalCVOuts, numSamples);
+        AudioSampleBuffer audioBuffer (audioChannels, totalAudioChans, numSamples);
+        AudioSampleBuffer cvInBuffer  (cvInChannels, totalCVIns, numSamples);
+        AudioSampleBuffer cvOutBuffer (cvOutChannels, totalCVOuts, numSamples);
 
         if (processor->isSuspended())
         {
@@ -282,6 +438,34 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
         }
     }
 
+    void performDouble (AudioSampleBuffer& sharedCVBufferChans,
+                        const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                        DoubleChannels& doubles,
+                        AudioSampleBuffer& sharedAudioBufferChans,
+                        const int numSamples)
+    {
+        for (uint i = 0; i < totalAudioChans; ++i)
+            doubleAudioChannels[i] = doubles.makeDouble (sharedAudioBufferChans,
+                                                         static_cast<int> (audioChannelsToUse.getUnchecked (i)),
+                                                         numSamples);
+
+        for (uint i = 0; i < totalCVIns; ++i)
+            cvInChannels[i] = sharedCVBufferChans.getWritePointer (cvInChannelsToUse.getUnchecked (i), 0);
+
+        for (uint i = 0; i < totalCVOuts; ++i)
+            cvOutChannels[i] = sharedCVBufferChans.getWritePointer (cvOutChannelsToUse.getUnchecked (i), 0);
+
+        AudioSampleBuffer cvInBuffer  (cvInChannels, totalCVIns, numSamples);
+        AudioSampleBuffer cvOutBuffer (cvOutChannels, totalCVOuts, numSamples);
+
+        const CarlaRecursiveMutexLocker cml (processor->getCallbackLock());
+
+        processor->processBlockDoubleWithCV (doubleAudioChannels, totalAudioChans,
+                                             cvInBuffer, cvOutBuffer,
+                                             *sharedMidiBuffers.getUnchecked (midiBufferToUse),
+                                             numSamples);
+    }
+
     void callProcess (AudioSampleBuffer& audioBuffer,
                       AudioSampleBuffer& cvInBuffer,
                       AudioSampleBuffer& cvOutBuffer,
@@ -298,9 +482,9 @@ private:
     Array<uint> cvInChannelsToUse;
     Array<uint> cvOutChannelsToUse;
     HeapBlock<float*> audioChannels;
+    HeapBlock<double*> doubleAudioChannels;
     HeapBlock<float*> cvInChannels;
     HeapBlock<float*> cvOutChannels;
-    AudioSampleBuffer tempBuffer;
     const uint totalAudioChans;
     const uint totalCVIns;
     const uint totalCVOuts;
@@ -309,6 +493,17 @@ private:
     CARLA_DECLARE_NON_COPYABLE (ProcessBufferOp)
 };
 
+//==============================================================================
+/** A rendering channel that holds one of the graph inputs.
+    While processing, the graph points it at the caller's input buffer instead of copying.
+*/
+struct GraphInputChannel
+{
+    int renderingChannel;
+    uint inputChannel;
+    float* ownData; // the rendering channel's own memory, restored after processing
+};
+
 //==============================================================================
 /** Used to calculate the correct sequence of rendering ops needed, based on
     the best re-use of shared buffers at each stage.
@@ -317,10 +512,16 @@ struct RenderingOpSequenceCalculator
 {
     RenderingOpSequenceCalculator (AudioProcessorGraph& g,
                                    const Array<AudioProcessorGraph::Node*>& nodes,
-                                   Array<void*>& renderingOps)
+                                   Array<void*>& renderingOps,
+                                   Array<GraphInputChannel>& audioInputs,
+                                   Array<GraphInputChannel>& cvInputs)
         : graph (g),
           orderedNodes (nodes),
-          totalLatency (0)
+          audioInputChannels (audioInputs),
+          cvInputChannels (cvInputs),
+          useDoubles (g.isUsingDoublePrecision()),
+          totalLatency (0),
+          currentStep (0)
     {
         audioNodeIds.add ((uint32) zeroNodeID); // first buffer is read-only zeros
         audioChannels.add (0);
@@ -330,8 +531,12 @@ struct RenderingOpSequenceCalculator
 
         midiNodeIds.add ((uint32) zeroNodeID);
 
+        findGraphInputNodes();
+        buildConnectionTables();
+
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
+            currentStep = i;
             createRenderingOpsForNode (*orderedNodes.getUnchecked(i), renderingOps, i);
             markAnyUnusedBuffersAsFree (i);
         }
@@ -347,47 +552,220 @@ private:
     //==============================================================================
     AudioProcessorGraph& graph;
     const Array<AudioProcessorGraph::Node*>& orderedNodes;
+    Array<GraphInputChannel>& audioInputChannels;
+    Array<GraphInputChannel>& cvInputChannels;
+    const bool useDoubles;
     Array<uint> audioChannels, cvChannels;
     Array<uint32> audioNodeIds, cvNodeIds, midiNodeIds;
 
     enum { freeNodeID = 0xffffffff, zeroNodeID = 0xfffffffe, anonymousNodeID = 0xfffffffd };
 
-    static bool isNodeBusy (uint32 nodeID) noexcept     { return nodeID != freeNodeID; }
+    // rendering index of each node, by node id
+    HashMap<int, int> nodeIndexes;
+
+    // audio and CV input nodes, their outputs are read-only, see findGraphInputNodes()
+    Array<uint32> graphInputNodeIds;
+
+    // connections going into each node, grouped by the rendering index of the destination
+    Array<const AudioProcessorGraph::Connection*> inputConnections;
+    Array<int> inputConnectionsStart;
+
+    // last rendering step that reads each node output, see isBufferNeededLater()
+    struct OutputUsage
+    {
+        OutputUsage() noexcept : lastStep (-1), lastInputChannel (0), usedByManyChannels (false) {}
+
+        int lastStep;
+        uint lastInputChannel;
+        bool usedByManyChannels;
+    };
+
+    struct OutputKeyHash
+    {
+        int generateHash (const int64 key, const int upperLimit) const noexcept
+        {
+            return (int) ((((uint64) key * 0x9e3779b97f4a7c15ULL) >> 32) % (uint64) upperLimit);
+        }
+    };
+
+    HashMap<int64, OutputUsage, OutputKeyHash> outputUsages;
+
+    // buffer holding each node output, see getBufferContaining()
+    HashMap<int64, int, OutputKeyHash> bufferIndexes;
+
+    // Busy buffers are only checked again at the step after their contents are last read,
+    // instead of checking all of them after every step.
+    struct ReleaseSchedule
+    {
+        Array<int> bufferSteps;
+        Array<int> stepHeads;
+        Array<int> entryBuffers, entryNext;
+
+        void schedule (const int bufferNum, const int step)
+        {
+            while (bufferSteps.size() <= bufferNum)
+                bufferSteps.add (-1);
+
+            bufferSteps.set (bufferNum, step);
+
+            if (step >= stepHeads.size())
+                return;
+
+            entryBuffers.add (bufferNum);
+            entryNext.add (stepHeads.getUnchecked (step));
+            stepHeads.set (step, entryBuffers.size() - 1);
+        }
+
+        void getBuffersDueAt (const int step, Array<int>& buffers) const
+        {
+            buffers.clearQuick();
+
+            for (int i = stepHeads.getUnchecked (step); i >= 0; i = entryNext.getUnchecked (i))
+            {
+                const int bufferNum = entryBuffers.getUnchecked (i);
+
+                // skip buffers that got new contents since this entry was added
+                if (bufferSteps.getUnchecked (bufferNum) == step)
+                    buffers.add (bufferNum);
+            }
+        }
+    };
+
+    ReleaseSchedule audioReleases, midiReleases;
+    Array<int> buffersToRelease;
+
+    static int64 getOutputKey (const AudioProcessor::ChannelType channelType,
+                               const uint32 nodeId, const uint outputChannel) noexcept
+    {
+        return (int64) (((uint64) nodeId << 32) | ((uint64) channelType << 30) | (outputChannel & 0x3fffffff));
+    }
 
-    Array<uint32> nodeDelayIDs;
     Array<int> nodeDelays;
     int totalLatency;
+    int currentStep;
 
-    int getNodeDelay (const uint32 nodeID) const        { return nodeDelays [nodeDelayIDs.indexOf (nodeID)]; }
+    int getNodeIndex (const uint32 nodeID) const
+    {
+        return nodeIndexes.contains ((int) nodeID) ? nodeIndexes [(int) nodeID] : -1;
+    }
+
+    int getNodeDelay (const uint32 nodeID) const        { return nodeDelays [getNodeIndex (nodeID)]; }
 
     void setNodeDelay (const uint32 nodeID, const int latency)
     {
-        const int index = nodeDelayIDs.indexOf (nodeID);
+        const int index = getNodeIndex (nodeID);
 
         if (index >= 0)
-        {
             nodeDelays.set (index, latency);
-        }
-        else
+    }
+
+    int getInputLatencyForNode (const int nodeIndex) const
+    {
+        int maxLatency = 0;
+
+        for (int i = inputConnectionsStart.getUnchecked (nodeIndex); i < inputConnectionsStart.getUnchecked (nodeIndex + 1); ++i)
+            maxLatency = jmax (maxLatency, getNodeDelay (inputConnections.getUnchecked (i)->sourceNodeId));
+
+        return maxLatency;
+    }
+
+    //==============================================================================
+    // The rendering channels with the graph inputs point to the caller's buffers while processing,
+    // so no node may process them in place, delay them or reuse them for anything else.
+    // Double precision graphs keep copying the inputs, converting a channel back to float writes into it.
+    void findGraphInputNodes()
+    {
+        if (useDoubles)
+            return;
+
+        typedef AudioProcessorGraph::AudioGraphIOProcessor IOProcessor;
+
+        for (int i = 0; i < orderedNodes.size(); ++i)
         {
-            nodeDelayIDs.add (nodeID);
-            nodeDelays.add (latency);
+            const AudioProcessorGraph::Node* const node = orderedNodes.getUnchecked (i);
+
+            if (const IOProcessor* const ioProc = dynamic_cast<const IOProcessor*> (node->getProcessor()))
+                if (ioProc->getType() == IOProcessor::audioInputNode || ioProc->getType() == IOProcessor::cvInputNode)
+                    graphInputNodeIds.add (node->nodeId);
         }
     }
 
-    int getInputLatencyForNode (const uint32 nodeID) const
+    bool isGraphInput (const AudioProcessor::ChannelType channelType, const uint32 nodeId) const noexcept
     {
-        int maxLatency = 0;
+        return channelType != AudioProcessor::ChannelTypeMIDI && graphInputNodeIds.contains (nodeId);
+    }
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
+    //==============================================================================
+    // Indexes the graph connections once, so that each step only has to look at its own inputs.
+    void buildConnectionTables()
+    {
+        const int numNodes = orderedNodes.size();
+
+        for (int i = 0; i < numNodes; ++i)
+            nodeIndexes.set ((int) orderedNodes.getUnchecked(i)->nodeId, i);
+
+        nodeDelays.insertMultiple (0, 0, numNodes);
+        audioReleases.stepHeads.insertMultiple (0, -1, numNodes);
+        midiReleases.stepHeads.insertMultiple (0, -1, numNodes);
+        inputConnectionsStart.insertMultiple (0, 0, numNodes + 1);
+
+        Array<int> destIndexes;
+
+        for (size_t i = 0; i < graph.getNumConnections(); ++i)
         {
             const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+            const int destIndex = getNodeIndex (c->destNodeId);
+
+            destIndexes.add (destIndex);
+
+            if (destIndex < 0 || getNodeIndex (c->sourceNodeId) < 0)
+                continue;
+
+            inputConnectionsStart.set (destIndex + 1, inputConnectionsStart.getUnchecked (destIndex + 1) + 1);
 
-            if (c->destNodeId == nodeID)
-                maxLatency = jmax (maxLatency, getNodeDelay (c->sourceNodeId));
+            // same rules as the old per-step search, inputs beyond the channel count are never read
+            const AudioProcessorGraph::Node* const dest = orderedNodes.getUnchecked (destIndex);
+
+            if (c->destChannelIndex >= dest->getProcessor()->getTotalNumInputChannels (c->channelType))
+                continue;
+
+            const int64 key = getOutputKey (c->channelType, c->sourceNodeId, c->sourceChannelIndex);
+            OutputUsage usage (outputUsages [key]);
+
+            if (destIndex > usage.lastStep)
+            {
+                usage.lastStep = destIndex;
+                usage.lastInputChannel = c->destChannelIndex;
+                usage.usedByManyChannels = false;
+            }
+            else if (destIndex == usage.lastStep && c->destChannelIndex != usage.lastInputChannel)
+            {
+                usage.usedByManyChannels = true;
+            }
+
+            outputUsages.set (key, usage);
         }
 
-        return maxLatency;
+        for (int i = 0; i < numNodes; ++i)
+            inputConnectionsStart.set (i + 1, inputConnectionsStart.getUnchecked (i + 1) + inputConnectionsStart.getUnchecked (i));
+
+        inputConnections.insertMultiple (0, nullptr, inputConnectionsStart.getUnchecked (numNodes));
+
+        Array<int> fillPositions (inputConnectionsStart);
+
+        // keep the same input order as when scanning the connection list backwards
+        for (int i = static_cast<int> (graph.getNumConnections()); --i >= 0;)
+        {
+            const AudioProcessorGraph::Connection* const c = graph.getConnection ((size_t) i);
+            const int destIndex = destIndexes.getUnchecked (i);
+
+            if (destIndex < 0 || getNodeIndex (c->sourceNodeId) < 0)
+                continue;
+
+            const int pos = fillPositions.getUnchecked (destIndex);
+            inputConnections.set (pos, c);
+            fillPositions.set (destIndex, pos + 1);
+        }
     }
 
     //==============================================================================
@@ -405,7 +783,10 @@ private:
         Array<uint> audioChannelsToUse, cvInChannelsToUse, cvOutChannelsToUse;
         int midiBufferToUse = -1;
 
-        int maxLatency = getInputLatencyForNode (node.nodeId);
+        const int inputsStart = inputConnectionsStart.getUnchecked (ourRenderingIndex);
+        const int inputsEnd = inputConnectionsStart.getUnchecked (ourRenderingIndex + 1);
+
+        int maxLatency = getInputLatencyForNode (ourRenderingIndex);
 
         for (uint inputChan = 0; inputChan < numAudioIns; ++inputChan)
         {
@@ -413,12 +794,11 @@ private:
             Array<uint32> sourceNodes;
             Array<uint> sourceOutputChans;
 
-            for (int i = graph.getNumConnections(); --i >= 0;)
+            for (int i = inputsStart; i < inputsEnd; ++i)
             {
-                const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+                const AudioProcessorGraph::Connection* const c = inputConnections.getUnchecked (i);
 
-                if (c->destNodeId == node.nodeId
-                    && c->destChannelIndex == inputChan
+                if (c->destChannelIndex == inputChan
                     && c->channelType == AudioProcessor::ChannelTypeAudio)
                 {
                     sourceNodes.add (c->sourceNodeId);
@@ -449,7 +829,10 @@ private:
                     wassert (bufIndex >= 0);
                 }
 
-                if (inputChan < numAudioOuts
+                const int nodeDelay = getNodeDelay (srcNode);
+
+                if ((inputChan < numAudioOuts
+                     || (nodeDelay < maxLatency && isGraphInput (AudioProcessor::ChannelTypeAudio, srcNode)))
                      && isBufferNeededLater (AudioProcessor::ChannelTypeAudio,
                                              ourRenderingIndex,
                                              inputChan,
@@ -464,10 +847,8 @@ private:
                     bufIndex = newFreeBuffer;
                 }
 
-                const int nodeDelay = getNodeDelay (srcNode);
-
                 if (nodeDelay < maxLatency)
-                    renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay, false));
+                    renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay, false, useDoubles));
             }
             else
             {
@@ -495,7 +876,7 @@ private:
 
                         const int nodeDelay = getNodeDelay (sourceNodes.getUnchecked (i));
                         if (nodeDelay < maxLatency)
-                            renderingOps.add (new DelayChannelOp (sourceBufIndex, maxLatency - nodeDelay, false));
+                            renderingOps.add (new DelayChannelOp (sourceBufIndex, maxLatency - nodeDelay, false, useDoubles));
 
                         break;
                     }
@@ -527,7 +908,7 @@ private:
                     const int nodeDelay = getNodeDelay (sourceNodes.getFirst());
 
                     if (nodeDelay < maxLatency)
-                        renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay, false));
+                        renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay, false, useDoubles));
                 }
 
                 for (int j = 0; j < sourceNodes.size(); ++j)
@@ -548,13 +929,13 @@ private:
                                                            sourceNodes.getUnchecked(j),
                                                            sourceOutputChans.getUnchecked(j)))
                                 {
-                                    renderingOps.add (new DelayChannelOp (srcIndex, maxLatency - nodeDelay, false));
+                                    renderingOps.add (new DelayChannelOp (srcIndex, maxLatency - nodeDelay, false, useDoubles));
                                 }
                                 else // buffer is reused elsewhere, can't be delayed
                                 {
                                     const int bufferToDelay = getFreeBuffer (AudioProcessor::ChannelTypeAudio);
                                     renderingOps.add (new CopyChannelOp (srcIndex, bufferToDelay, false));
-                                    renderingOps.add (new DelayChannelOp (bufferToDelay, maxLatency - nodeDelay, false));
+                                    renderingOps.add (new DelayChannelOp (bufferToDelay, maxLatency - nodeDelay, false, useDoubles));
                                     srcIndex = bufferToDelay;
                                 }
                             }
@@ -578,6 +959,12 @@ private:
             CARLA_SAFE_ASSERT_CONTINUE (bufIndex > 0);
             audioChannelsToUse.add (bufIndex);
             markBufferAsContaining (AudioProcessor::ChannelTypeAudio, bufIndex, node.nodeId, outputChan);
+
+            if (isGraphInput (AudioProcessor::ChannelTypeAudio, node.nodeId))
+            {
+                const GraphInputChannel input = { bufIndex, outputChan, nullptr };
+                audioInputChannels.add (input);
+            }
         }
 
         for (uint inputChan = 0; inputChan < numCVIns; ++inputChan)
@@ -586,12 +973,11 @@ private:
             Array<uint32> sourceNodes;
             Array<uint> sourceOutputChans;
 
-            for (int i = graph.getNumConnections(); --i >= 0;)
+            for (int i = inputsStart; i < inputsEnd; ++i)
             {
-                const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+                const AudioProcessorGraph::Connection* const c = inputConnections.getUnchecked (i);
 
-                if (c->destNodeId == node.nodeId
-                    && c->destChannelIndex == inputChan
+                if (c->destChannelIndex == inputChan
                     && c->channelType == AudioProcessor::ChannelTypeCV)
                 {
                     sourceNodes.add (c->sourceNodeId);
@@ -631,7 +1017,7 @@ private:
                 const int nodeDelay = getNodeDelay (srcNode);
 
                 if (nodeDelay < maxLatency)
-                    renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay, true));
+                    renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay, true, useDoubles));
             }
             else
             {
@@ -657,7 +1043,7 @@ private:
                     const int nodeDelay = getNodeDelay (sourceNodes.getFirst());
 
                     if (nodeDelay < maxLatency)
-                        renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay, true));
+                        renderingOps.add (new DelayChannelOp (bufIndex, maxLatency - nodeDelay, true, useDoubles));
                 }
 
                 for (int j = 1; j < sourceNodes.size(); ++j)
@@ -673,7 +1059,7 @@ private:
                         {
                             const int bufferToDelay = getFreeBuffer (AudioProcessor::ChannelTypeCV);
                             renderingOps.add (new CopyChannelOp (srcIndex, bufferToDelay, true));
-                            renderingOps.add (new DelayChannelOp (bufferToDelay, maxLatency - nodeDelay, true));
+                            renderingOps.add (new DelayChannelOp (bufferToDelay, maxLatency - nodeDelay, true, useDoubles));
                             srcIndex = bufferToDelay;
                         }
 
@@ -693,16 +1079,22 @@ private:
             CARLA_SAFE_ASSERT_CONTINUE (bufIndex > 0);
             cvOutChannelsToUse.add (bufIndex);
             markBufferAsContaining (AudioProcessor::ChannelTypeCV, bufIndex, node.nodeId, outputChan);
+
+            if (isGraphInput (AudioProcessor::ChannelTypeCV, node.nodeId))
+            {
+                const GraphInputChannel input = { bufIndex, outputChan, nullptr };
+                cvInputChannels.add (input);
+            }
         }
 
         // Now the same thing for midi..
         Array<uint32> midiSourceNodes;
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
+        for (int i = inputsStart; i < inputsEnd; ++i)
         {
-            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+            const AudioProcessorGraph::Connection* const c = inputConnections.getUnchecked (i);
 
-            if (c->destNodeId == node.nodeId && c->channelType == AudioProcessor::ChannelTypeMIDI)
+            if (c->channelType == AudioProcessor::ChannelTypeMIDI)
                 midiSourceNodes.add (c->sourceNodeId);
         }
 
@@ -799,8 +1191,9 @@ private:
 
         setNodeDelay (node.nodeId, maxLatency + processor.getLatencySamples());
 
+        // nodes without audio outputs are where the graph ends, use the longest path into them
         if (numAudioOuts == 0)
-            totalLatency = maxLatency;
+            totalLatency = jmax (totalLatency, maxLatency);
 
         renderingOps.add (new ProcessBufferOp (&node,
                                                audioChannelsToUse,
@@ -854,26 +1247,29 @@ private:
                              const uint32 nodeId,
                              const uint outputChannel) const noexcept
     {
+        const int64 key = getOutputKey (channelType, nodeId, outputChannel);
+
+        if (! bufferIndexes.contains (key))
+            return -1;
+
+        const int i = bufferIndexes [key];
+
+        // the buffer might have been released or reused since
         switch (channelType)
         {
         case AudioProcessor::ChannelTypeAudio:
-            for (int i = audioNodeIds.size(); --i >= 0;)
-                if (audioNodeIds.getUnchecked(i) == nodeId && audioChannels.getUnchecked(i) == outputChannel)
-                    return i;
+            if (audioNodeIds.getUnchecked(i) == nodeId && audioChannels.getUnchecked(i) == outputChannel)
+                return i;
             break;
 
         case AudioProcessor::ChannelTypeCV:
-            for (int i = cvNodeIds.size(); --i >= 0;)
-                if (cvNodeIds.getUnchecked(i) == nodeId && cvChannels.getUnchecked(i) == outputChannel)
-                    return i;
+            if (cvNodeIds.getUnchecked(i) == nodeId && cvChannels.getUnchecked(i) == outputChannel)
+                return i;
             break;
 
         case AudioProcessor::ChannelTypeMIDI:
-            for (int i = midiNodeIds.size(); --i >= 0;)
-            {
-                if (midiNodeIds.getUnchecked(i) == nodeId)
-                    return i;
-            }
+            if (midiNodeIds.getUnchecked(i) == nodeId)
+                return i;
             break;
         }
 
@@ -882,54 +1278,52 @@ private:
 
     void markAnyUnusedBuffersAsFree (const int stepIndex)
     {
-        for (int i = 0; i < audioNodeIds.size(); ++i)
-        {
-            if (isNodeBusy (audioNodeIds.getUnchecked(i))
-                 && ! isBufferNeededLater (AudioProcessor::ChannelTypeAudio,
-                                           stepIndex, -1,
-                                           audioNodeIds.getUnchecked(i),
-                                           audioChannels.getUnchecked(i)))
-            {
-                audioNodeIds.set (i, (uint32) freeNodeID);
-            }
-        }
+        audioReleases.getBuffersDueAt (stepIndex, buffersToRelease);
+
+        for (int i = 0; i < buffersToRelease.size(); ++i)
+            audioNodeIds.set (buffersToRelease.getUnchecked(i), (uint32) freeNodeID);
 
         // NOTE: CV skipped on purpose
 
-        for (int i = 0; i < midiNodeIds.size(); ++i)
-        {
-            if (isNodeBusy (midiNodeIds.getUnchecked(i))
-                 && ! isBufferNeededLater (AudioProcessor::ChannelTypeMIDI,
-                                           stepIndex, -1,
-                                           midiNodeIds.getUnchecked(i), 0))
-            {
-                midiNodeIds.set (i, (uint32) freeNodeID);
-            }
-        }
+        midiReleases.getBuffersDueAt (stepIndex, buffersToRelease);
+
+        for (int i = 0; i < buffersToRelease.size(); ++i)
+            midiNodeIds.set (buffersToRelease.getUnchecked(i), (uint32) freeNodeID);
+    }
+
+    // first step where the buffer with this output is no longer needed
+    int getReleaseStep (const AudioProcessor::ChannelType channelType,
+                        const uint32 nodeId, const uint outputChanIndex) const
+    {
+        const int64 key = getOutputKey (channelType, nodeId, outputChanIndex);
+
+        if (! outputUsages.contains (key))
+            return currentStep;
+
+        return jmax (currentStep, outputUsages [key].lastStep + 1);
     }
 
     bool isBufferNeededLater (const AudioProcessor::ChannelType channelType,
-                              int stepIndexToSearchFrom,
-                              uint inputChannelOfIndexToIgnore,
+                              const int stepIndexToSearchFrom,
+                              const uint inputChannelOfIndexToIgnore,
                               const uint32 nodeId,
                               const uint outputChanIndex) const
     {
-        while (stepIndexToSearchFrom < orderedNodes.size())
-        {
-            const AudioProcessorGraph::Node* const node = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (stepIndexToSearchFrom);
+        if (isGraphInput (channelType, nodeId))
+            return true;
 
-            for (uint i = 0; i < node->getProcessor()->getTotalNumInputChannels(channelType); ++i)
-                if (i != inputChannelOfIndexToIgnore
-                        && graph.getConnectionBetween (channelType,
-                                                       nodeId, outputChanIndex,
-                                                       node->nodeId, i) != nullptr)
-                    return true;
+        const int64 key = getOutputKey (channelType, nodeId, outputChanIndex);
 
-            inputChannelOfIndexToIgnore = (uint)-1;
-            ++stepIndexToSearchFrom;
-        }
+        if (! outputUsages.contains (key))
+            return false;
 
-        return false;
+        const OutputUsage usage (outputUsages [key]);
+
+        if (usage.lastStep != stepIndexToSearchFrom)
+            return usage.lastStep > stepIndexToSearchFrom;
+
+        // only the current step reads this output, check if any other input channel does
+        return usage.usedByManyChannels || usage.lastInputChannel != inputChannelOfIndexToIgnore;
     }
 
     void markBufferAsContaining (const AudioProcessor::ChannelType channelType,
@@ -938,136 +1332,32 @@ private:
         switch (channelType)
         {
         case AudioProcessor::ChannelTypeAudio:
-            CARLA_SAFE_ASSERT_BREAK (bufferNum >= 0 && bufferNum < audioNodeIds.size());
+            CARLA_SAFE_ASSERT_RETURN (bufferNum >= 0 && bufferNum < audioNodeIds.size(),);
             audioNodeIds.set (bufferNum, nodeId);
             audioChannels.set (bufferNum, outputIndex);
+
+            // graph inputs keep their channels for the whole sequence
+            if (! isGraphInput (channelType, nodeId))
+                audioReleases.schedule (bufferNum, getReleaseStep (channelType, nodeId, outputIndex));
             break;
 
         case AudioProcessor::ChannelTypeCV:
-            CARLA_SAFE_ASSERT_BREAK (bufferNum >= 0 && bufferNum < cvNodeIds.size());
+            CARLA_SAFE_ASSERT_RETURN (bufferNum >= 0 && bufferNum < cvNodeIds.size(),);
             cvNodeIds.set (bufferNum, nodeId);
             cvChannels.set (bufferNum, outputIndex);
             break;
 
         case AudioProcessor::ChannelTypeMIDI:
-            CARLA_SAFE_ASSERT_BREAK (bufferNum > 0 && bufferNum < midiNodeIds.size());
+            CARLA_SAFE_ASSERT_RETURN (bufferNum > 0 && bufferNum < midiNodeIds.size(),);
             midiNodeIds.set (bufferNum, nodeId);
+            midiReleases.schedule (bufferNum, getReleaseStep (channelType, nodeId, outputIndex));
             break;
         }
-    }
-
-    CARLA_DECLARE_NON_COPYABLE (RenderingOpSequenceCalculator)
-};
 
-//==============================================================================
-// Holds a fast lookup table for checking which nodes are inputs to others.
-class ConnectionLookupTable
-{
-public:
-    explicit ConnectionLookupTable (const OwnedArray<AudioProcessorGraph::Connection>& connections)
-    {
-        for (int i = 0; i < static_cast<int>(connections.size()); ++i)
-        {
-            const AudioProcessorGraph::Connection* const c = connections.getUnchecked(i);
-
-            int index;
-            Entry* entry = findEntry (c->destNodeId, index);
-
-            if (entry == nullptr)
-            {
-                entry = new Entry (c->destNodeId);
-                entries.insert (index, entry);
-            }
-
-            entry->srcNodes.add (c->sourceNodeId);
-        }
+        bufferIndexes.set (getOutputKey (channelType, nodeId, outputIndex), bufferNum);
     }
 
-    bool isAnInputTo (const uint32 possibleInputId,
-                      const uint32 possibleDestinationId) const noexcept
-    {
-        return isAnInputToRecursive (possibleInputId, possibleDestinationId, entries.size());
-    }
-
-private:
-    //==============================================================================
-    struct Entry
-    {
-        explicit Entry (const uint32 destNodeId_) noexcept : destNodeId (destNodeId_) {}
-
-        const uint32 destNodeId;
-        SortedSet<uint32> srcNodes;
-
-        CARLA_DECLARE_NON_COPYABLE (Entry)
-    };
-
-    OwnedArray<Entry> entries;
-
-    bool isAnInputToRecursive (const uint32 possibleInputId,
-                               const uint32 possibleDestinationId,
-                               int recursionCheck) const noexcept
-    {
-        int index;
-
-        if (const Entry* const entry = findEntry (possibleDestinationId, index))
-        {
-            const SortedSet<uint32>& srcNodes = entry->srcNodes;
-
-            if (srcNodes.contains (possibleInputId))
-                return true;
-
-            if (--recursionCheck >= 0)
-            {
-                for (int i = 0; i < srcNodes.size(); ++i)
-                    if (isAnInputToRecursive (possibleInputId, srcNodes.getUnchecked(i), recursionCheck))
-                        return true;
-            }
-        }
-
-        return false;
-    }
-
-    Entry* findEntry (const uint32 destNodeId, int& insertIndex) const noexcept
-    {
-        Entry* result = nullptr;
-
-        int start = 0;
-        int end = entries.size();
-
-        for (;;)
-        {
-            if (start >= end)
-            {
-                break;
-            }
-            else if (destNodeId == entries.getUnchecked (start)->destNodeId)
-            {
-                result = entries.getUnchecked (start);
-                break;
-            }
-            else
-            {
-                const int halfway = (start + end) / 2;
-
-                if (halfway == start)
-                {
-                    if (destNodeId >= entries.getUnchecked (halfway)->destNodeId)
-                        ++start;
-
-                    break;
-                }
-                else if (destNodeId >= entries.getUnchecked (halfway)->destNodeId)
-                    start = halfway;
-                else
-                    end = halfway;
-            }
-        }
-
-        insertIndex = start;
-        return result;
-    }
-
-    CARLA_DECLARE_NON_COPYABLE (ConnectionLookupTable)
+    CARLA_DECLARE_NON_COPYABLE (RenderingOpSequenceCalculator)
 };
 
 //==============================================================================
@@ -1103,7 +1393,7 @@ AudioProcessorGraph::Connection::Connection (ChannelType ct,
 
 //==============================================================================
 AudioProcessorGraph::Node::Node (const uint32 nodeID, AudioProcessor* const p) noexcept
-    : nodeId (nodeID), processor (p), isPrepared (false)
+    : nodeId (nodeID), processor (p), isPrepared (false), wasInactive (false), wasAlwaysNeeded (false)
 {
     wassert (processor != nullptr);
 }
@@ -1142,19 +1432,43 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
 {
     AudioProcessorGraphBufferHelpers() noexcept
         : currentAudioInputBuffer (nullptr),
-          currentCVInputBuffer (nullptr) {}
-
-    void setRenderingBufferSize (int newNumAudioChannels, int newNumCVChannels, int newNumSamples) noexcept
+          currentCVInputBuffer (nullptr),
+          externalAudioIns (nullptr),
+          externalAudioOuts (nullptr),
+          externalCVIns (nullptr),
+          externalCVOuts (nullptr),
+          useDoubles (false) {}
+
+    void setRenderingBufferSize (int newNumAudioChannels, int newNumCVChannels, int newNumSamples, bool withDoubles) noexcept
     {
         renderingAudioBuffers.setSize (newNumAudioChannels, newNumSamples);
         renderingAudioBuffers.clear();
 
         renderingCVBuffers.setSize (newNumCVChannels, newNumSamples);
         renderingCVBuffers.clear();
+
+        if (withDoubles)
+            useDoubles = renderingDoubleBuffers.setSize (newNumAudioChannels, newNumSamples);
+        else
+            useDoubles = false;
+
+        if (! useDoubles)
+            renderingDoubleBuffers.release();
+    }
+
+    GraphRenderingOps::DoubleChannels* getDoubleBuffers (const int numSamples) noexcept
+    {
+        if (! useDoubles || numSamples > renderingDoubleBuffers.numSamplesAllocated)
+            return nullptr;
+
+        renderingDoubleBuffers.resetFormats();
+        return &renderingDoubleBuffers;
     }
 
     void release() noexcept
     {
+        renderingDoubleBuffers.release();
+        useDoubles = false;
         renderingAudioBuffers.setSize (1, 1);
         currentAudioInputBuffer = nullptr;
         currentCVInputBuffer = nullptr;
@@ -1164,6 +1478,51 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
         renderingCVBuffers.setSize (1, 1);
     }
 
+    // Points the rendering channels that hold the graph inputs at the caller's buffers, so the input
+    // nodes don't need to copy them. The rendering sequence makes sure nothing writes into these channels.
+    void bindInputs (const float* const* const audioIns, const uint32_t numAudioIns,
+                     const float* const* const cvIns, const uint32_t numCVIns) noexcept
+    {
+        bindChannels (renderingAudioBuffers, audioInputChannels, audioIns, numAudioIns);
+        bindChannels (renderingCVBuffers, cvInputChannels, cvIns, numCVIns);
+    }
+
+    void unbindInputs() noexcept
+    {
+        unbindChannels (renderingAudioBuffers, audioInputChannels);
+        unbindChannels (renderingCVBuffers, cvInputChannels);
+    }
+
+    static void bindChannels (AudioSampleBuffer& buffer, Array<GraphRenderingOps::GraphInputChannel>& inputs,
+                              const float* const* const ins, const uint32_t numIns) noexcept
+    {
+        float** const channels = buffer.getArrayOfWritePointers();
+
+        for (int i = 0; i < inputs.size(); ++i)
+        {
+            GraphRenderingOps::GraphInputChannel& input (inputs.getReference (i));
+            CARLA_SAFE_ASSERT_CONTINUE (input.renderingChannel < static_cast<int> (buffer.getNumChannels()));
+
+            input.ownData = channels[input.renderingChannel];
+
+            if (input.inputChannel < numIns)
+                channels[input.renderingChannel] = const_cast<float*> (ins[input.inputChannel]);
+        }
+    }
+
+    static void unbindChannels (AudioSampleBuffer& buffer, Array<GraphRenderingOps::GraphInputChannel>& inputs) noexcept
+    {
+        float** const channels = buffer.getArrayOfWritePointers();
+
+        for (int i = 0; i < inputs.size(); ++i)
+        {
+            const GraphRenderingOps::GraphInputChannel& input (inputs.getReference (i));
+            CARLA_SAFE_ASSERT_CONTINUE (input.renderingChannel < static_cast<int> (buffer.getNumChannels()));
+
+            channels[input.renderingChannel] = input.ownData;
+        }
+    }
+
     void prepareInOutBuffers (int newNumAudioChannels, int newNumCVChannels, int newNumSamples) noexcept
     {
         currentAudioInputBuffer = nullptr;
@@ -1178,12 +1537,27 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
     const AudioSampleBuffer* currentCVInputBuffer;
     AudioSampleBuffer        currentAudioOutputBuffer;
     AudioSampleBuffer        currentCVOutputBuffer;
+
+    // set only during processWithExternalBuffers(), used by the IO nodes instead of the buffers above
+    const float* const*      externalAudioIns;
+    float* const*            externalAudioOuts;
+    const float* const*      externalCVIns;
+    float* const*            externalCVOuts;
+
+    // rendering channels that hold the graph inputs, see bindInputs()
+    Array<GraphRenderingOps::GraphInputChannel> audioInputChannels;
+    Array<GraphRenderingOps::GraphInputChannel> cvInputChannels;
+
+    // used when processing in double precision, mirrors renderingAudioBuffers
+    GraphRenderingOps::DoubleChannels renderingDoubleBuffers;
+    bool useDoubles;
 };
 
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
     : lastNodeId (0), audioAndCVBuffers (new AudioProcessorGraphBufferHelpers),
-      currentMidiInputBuffer (nullptr), isPrepared (false), needsReorder (false)
+      currentMidiInputBuffer (nullptr), isPrepared (false), needsReorder (false),
+      doublePrecision (false)
 {
 }
 
@@ -1447,34 +1821,223 @@ void AudioProcessorGraph::clearRenderingSequence()
     {
         const CarlaRecursiveMutexLocker cml (getCallbackLock());
         renderingOps.swapWith (oldOps);
+        audioAndCVBuffers->audioInputChannels.clearQuick();
+        audioAndCVBuffers->cvInputChannels.clearQuick();
     }
 
     deleteRenderOpArray (oldOps);
 }
 
-bool AudioProcessorGraph::isAnInputTo (const uint32 possibleInputId,
-                                       const uint32 possibleDestinationId,
-                                       const int recursionCheck) const
+// Orders nodes so that each one comes after all of its inputs, using Kahn's algorithm.
+// Feedback loops are broken where they have the least inputs still pending.
+static void getNodesInRenderingOrder (const ReferenceCountedArray<AudioProcessorGraph::Node>& nodes,
+                                      const OwnedArray<AudioProcessorGraph::Connection>& connections,
+                                      Array<AudioProcessorGraph::Node*>& orderedNodes)
 {
-    if (recursionCheck > 0)
+    const int numNodes = nodes.size();
+
+    HashMap<int, int> nodeIndexes;
+
+    for (int i = 0; i < numNodes; ++i)
+        nodeIndexes.set ((int) nodes.getUnchecked(i)->nodeId, i);
+
+    // connections are sorted by source and then destination node, so edges between the same
+    // pair of nodes are next to each other and only need to be counted once
+    Array<int> edgeSources, edgeDests;
+    Array<int> numOutputs, numPendingInputs;
+    numOutputs.insertMultiple (0, 0, numNodes + 1);
+    numPendingInputs.insertMultiple (0, 0, numNodes);
+
+    for (size_t i = 0; i < connections.size(); ++i)
+    {
+        const AudioProcessorGraph::Connection* const c = connections.getUnchecked (i);
+
+        if (c->sourceNodeId == c->destNodeId
+            || ! nodeIndexes.contains ((int) c->sourceNodeId)
+            || ! nodeIndexes.contains ((int) c->destNodeId))
+            continue;
+
+        const int src = nodeIndexes [(int) c->sourceNodeId];
+        const int dst = nodeIndexes [(int) c->destNodeId];
+
+        if (edgeSources.size() != 0 && edgeSources.getLast() == src && edgeDests.getLast() == dst)
+            continue;
+
+        edgeSources.add (src);
+        edgeDests.add (dst);
+        numOutputs.set (src + 1, numOutputs.getUnchecked (src + 1) + 1);
+        numPendingInputs.set (dst, numPendingInputs.getUnchecked (dst) + 1);
+    }
+
+    // adjacency lists, as offsets into a single array
+    Array<int> outputsStart (numOutputs);
+
+    for (int i = 0; i < numNodes; ++i)
+        outputsStart.set (i + 1, outputsStart.getUnchecked (i + 1) + outputsStart.getUnchecked (i));
+
+    Array<int> outputs, fillPositions (outputsStart);
+    outputs.insertMultiple (0, 0, edgeSources.size());
+
+    for (int i = 0; i < edgeSources.size(); ++i)
+    {
+        const int src = edgeSources.getUnchecked (i);
+        const int pos = fillPositions.getUnchecked (src);
+        outputs.set (pos, edgeDests.getUnchecked (i));
+        fillPositions.set (src, pos + 1);
+    }
+
+    // ready nodes are processed in the order they were added, which keeps the result stable
+    Array<int> queue;
+    Array<bool> done;
+    queue.ensureStorageAllocated (numNodes);
+    done.insertMultiple (0, false, numNodes);
+
+    for (int i = 0; i < numNodes; ++i)
+        if (numPendingInputs.getUnchecked (i) == 0)
+            queue.add (i);
+
+    int queuePos = 0, nextUnfinished = 0;
+    orderedNodes.ensureStorageAllocated (numNodes);
+
+    while (orderedNodes.size() < numNodes)
     {
-        for (int i = connections.size(); --i >= 0;)
+        if (queuePos == queue.size())
         {
-            const AudioProcessorGraph::Connection* const c = connections.getUnchecked (i);
+            // only feedback loops are left, break one by picking the node with the least inputs
+            // still pending, which is usually where the loop goes back into the rest of the graph
+            while (done.getUnchecked (nextUnfinished))
+                ++nextUnfinished;
 
-            if (c->destNodeId == possibleDestinationId
-                 && (c->sourceNodeId == possibleInputId
-                      || isAnInputTo (possibleInputId, c->sourceNodeId, recursionCheck - 1)))
-                return true;
+            int best = nextUnfinished;
+
+            for (int i = nextUnfinished + 1; i < numNodes; ++i)
+                if (! done.getUnchecked (i) && numPendingInputs.getUnchecked (i) < numPendingInputs.getUnchecked (best))
+                    best = i;
+
+            queue.add (best);
+        }
+
+        const int index = queue.getUnchecked (queuePos++);
+
+        if (done.getUnchecked (index))
+            continue;
+
+        done.set (index, true);
+        orderedNodes.add (nodes.getUnchecked (index));
+
+        for (int i = outputsStart.getUnchecked (index); i < outputsStart.getUnchecked (index + 1); ++i)
+        {
+            const int dst = outputs.getUnchecked (i);
+            const int pending = numPendingInputs.getUnchecked (dst) - 1;
+
+            numPendingInputs.set (dst, pending);
+
+            if (pending == 0 && ! done.getUnchecked (dst))
+                queue.add (dst);
         }
     }
+}
 
-    return false;
+// Removes nodes that can't affect any output, keeping the order of the others.
+// Nodes without audio or CV outputs (graph outputs, meters, MIDI generators) and nodes that ask for it
+// are always needed, other nodes only if they feed a needed node. Inactive nodes are never needed and don't pass
+// this on. MIDI outputs are ignored here as plugins also use them for parameter output changes.
+static void removeUnneededNodes (const OwnedArray<AudioProcessorGraph::Connection>& connections,
+                                 const Array<bool>& inactiveNodes,
+                                 const Array<bool>& alwaysNeededNodes,
+                                 Array<AudioProcessorGraph::Node*>& orderedNodes)
+{
+    const int numNodes = orderedNodes.size();
+
+    HashMap<int, int> nodeIndexes;
+
+    for (int i = 0; i < numNodes; ++i)
+        nodeIndexes.set ((int) orderedNodes.getUnchecked(i)->nodeId, i);
+
+    // sources of each node, as offsets into a single array
+    Array<int> inputsStart, inputs;
+    inputsStart.insertMultiple (0, 0, numNodes + 1);
+
+    for (size_t i = 0; i < connections.size(); ++i)
+    {
+        const AudioProcessorGraph::Connection* const c = connections.getUnchecked (i);
+
+        if (nodeIndexes.contains ((int) c->sourceNodeId) && nodeIndexes.contains ((int) c->destNodeId))
+        {
+            const int dst = nodeIndexes [(int) c->destNodeId];
+            inputsStart.set (dst + 1, inputsStart.getUnchecked (dst + 1) + 1);
+        }
+    }
+
+    for (int i = 0; i < numNodes; ++i)
+        inputsStart.set (i + 1, inputsStart.getUnchecked (i + 1) + inputsStart.getUnchecked (i));
+
+    Array<int> fillPositions (inputsStart);
+    inputs.insertMultiple (0, 0, inputsStart.getUnchecked (numNodes));
+
+    for (size_t i = 0; i < connections.size(); ++i)
+    {
+        const AudioProcessorGraph::Connection* const c = connections.getUnchecked (i);
+
+        if (nodeIndexes.contains ((int) c->sourceNodeId) && nodeIndexes.contains ((int) c->destNodeId))
+        {
+            const int dst = nodeIndexes [(int) c->destNodeId];
+            const int pos = fillPositions.getUnchecked (dst);
+            inputs.set (pos, nodeIndexes [(int) c->sourceNodeId]);
+            fillPositions.set (dst, pos + 1);
+        }
+    }
+
+    // walk backwards from the nodes that are always needed
+    Array<bool> needed;
+    Array<int> pending;
+    needed.insertMultiple (0, false, numNodes);
+
+    for (int i = 0; i < numNodes; ++i)
+    {
+        const AudioProcessor* const processor = orderedNodes.getUnchecked(i)->getProcessor();
+
+        if (inactiveNodes.getUnchecked (i))
+            continue;
+
+        if (! alwaysNeededNodes.getUnchecked (i)
+            && (processor->getTotalNumOutputChannels (AudioProcessor::ChannelTypeAudio) != 0
+                || processor->getTotalNumOutputChannels (AudioProcessor::ChannelTypeCV) != 0))
+            continue;
+
+        needed.set (i, true);
+        pending.add (i);
+    }
+
+    while (pending.size() != 0)
+    {
+        const int index = pending.removeAndReturn (pending.size() - 1);
+
+        for (int i = inputsStart.getUnchecked (index); i < inputsStart.getUnchecked (index + 1); ++i)
+        {
+            const int src = inputs.getUnchecked (i);
+
+            if (needed.getUnchecked (src) || inactiveNodes.getUnchecked (src))
+                continue;
+
+            needed.set (src, true);
+            pending.add (src);
+        }
+    }
+
+    int numNeeded = 0;
+
+    for (int i = 0; i < numNodes; ++i)
+        if (needed.getUnchecked (i))
+            orderedNodes.set (numNeeded++, orderedNodes.getUnchecked (i));
+
+    orderedNodes.removeRange (numNeeded, numNodes - numNeeded);
 }
 
 void AudioProcessorGraph::buildRenderingSequence()
 {
     Array<void*> newRenderingOps;
+    Array<GraphRenderingOps::GraphInputChannel> newAudioInputChannels, newCVInputChannels;
     int numAudioRenderingBuffersNeeded = 2;
     int numCVRenderingBuffersNeeded = 0;
     int numMidiBuffersNeeded = 1;
@@ -1482,27 +2045,27 @@ void AudioProcessorGraph::buildRenderingSequence()
     {
         const CarlaRecursiveMutexLocker cml (reorderMutex);
 
-        Array<Node*> orderedNodes;
-
-        {
-            const GraphRenderingOps::ConnectionLookupTable table (connections);
+        for (int i = 0; i < nodes.size(); ++i)
+            nodes.getUnchecked(i)->prepare (getSampleRate(), getBlockSize(), this);
 
-            for (int i = 0; i < nodes.size(); ++i)
-            {
-                Node* const node = nodes.getUnchecked(i);
-
-                node->prepare (getSampleRate(), getBlockSize(), this);
+        Array<Node*> orderedNodes;
+        getNodesInRenderingOrder (nodes, connections, orderedNodes);
 
-                int j = 0;
-                for (; j < orderedNodes.size(); ++j)
-                    if (table.isAnInputTo (node->nodeId, ((Node*) orderedNodes.getUnchecked(j))->nodeId))
-                      break;
+        Array<bool> inactiveNodes, alwaysNeededNodes;
 
-                orderedNodes.insert (j, node);
-            }
+        for (int i = 0; i < orderedNodes.size(); ++i)
+        {
+            Node* const node = orderedNodes.getUnchecked (i);
+            node->wasInactive = node->processor->isInactive();
+            node->wasAlwaysNeeded = node->processor->isAlwaysNeeded();
+            inactiveNodes.add (node->wasInactive);
+            alwaysNeededNodes.add (node->wasAlwaysNeeded);
         }
 
-        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps);
+        removeUnneededNodes (connections, inactiveNodes, alwaysNeededNodes, orderedNodes);
+
+        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps,
+                                                                     newAudioInputChannels, newCVInputChannels);
 
         numAudioRenderingBuffersNeeded = calculator.getNumAudioBuffersNeeded();
         numCVRenderingBuffersNeeded = calculator.getNumCVBuffersNeeded();
@@ -1515,7 +2078,8 @@ void AudioProcessorGraph::buildRenderingSequence()
 
         audioAndCVBuffers->setRenderingBufferSize (numAudioRenderingBuffersNeeded,
                                                    numCVRenderingBuffersNeeded,
-                                                   getBlockSize());
+                                                   getBlockSize(),
+                                                   doublePrecision);
 
         for (int i = static_cast<int>(midiBuffers.size()); --i >= 0;)
             midiBuffers.getUnchecked(i)->clear();
@@ -1524,6 +2088,8 @@ void AudioProcessorGraph::buildRenderingSequence()
             midiBuffers.add (new MidiBuffer());
 
         renderingOps.swapWith (newRenderingOps);
+        audioAndCVBuffers->audioInputChannels.swapWith (newAudioInputChannels);
+        audioAndCVBuffers->cvInputChannels.swapWith (newCVInputChannels);
     }
 
     // delete the old ones..
@@ -1627,8 +2193,6 @@ void AudioProcessorGraph::processAudioAndCV (AudioSampleBuffer& audioBuffer,
     const AudioSampleBuffer*& currentCVInputBuffer     = audioAndCVBuffers->currentCVInputBuffer;
     AudioSampleBuffer&        currentAudioOutputBuffer = audioAndCVBuffers->currentAudioOutputBuffer;
     AudioSampleBuffer&        currentCVOutputBuffer    = audioAndCVBuffers->currentCVOutputBuffer;
-    AudioSampleBuffer&        renderingAudioBuffers    = audioAndCVBuffers->renderingAudioBuffers;
-    AudioSampleBuffer&        renderingCVBuffers       = audioAndCVBuffers->renderingCVBuffers;
 
     const int numSamples = audioBuffer.getNumSamples();
 
@@ -1648,13 +2212,11 @@ void AudioProcessorGraph::processAudioAndCV (AudioSampleBuffer& audioBuffer,
     currentCVOutputBuffer.clear();
     currentMidiOutputBuffer.clear();
 
-    for (int i = 0; i < renderingOps.size(); ++i)
-    {
-        GraphRenderingOps::AudioGraphRenderingOpBase* const op
-            = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
-
-        op->perform (renderingAudioBuffers, renderingCVBuffers, midiBuffers, numSamples);
-    }
+    // audioBuffer is only written after all rendering ops, so the inputs can be read from it directly
+    audioAndCVBuffers->bindInputs (audioBuffer.getArrayOfReadPointers(), audioBuffer.getNumChannels(),
+                                   cvInBuffer.getArrayOfReadPointers(), cvInBuffer.getNumChannels());
+    performRenderingOps (numSamples);
+    audioAndCVBuffers->unbindInputs();
 
     for (uint32_t i = 0; i < audioBuffer.getNumChannels(); ++i)
         audioBuffer.copyFrom (i, 0, currentAudioOutputBuffer, i, 0, numSamples);
@@ -1666,6 +2228,60 @@ void AudioProcessorGraph::processAudioAndCV (AudioSampleBuffer& audioBuffer,
     midiMessages.addEvents (currentMidiOutputBuffer, 0, audioBuffer.getNumSamples(), 0);
 }
 
+void AudioProcessorGraph::processWithExternalBuffers (const float* const* const audioIns,
+                                                      float* const* const audioOuts,
+                                                      const float* const* const cvIns,
+                                                      float* const* const cvOuts,
+                                                      const uint32_t numSamples,
+                                                      MidiBuffer& midiMessages)
+{
+    if (! audioAndCVBuffers->renderingAudioBuffers.setSizeRT(numSamples))
+        return;
+    if (! audioAndCVBuffers->renderingCVBuffers.setSizeRT(numSamples))
+        return;
+
+    for (uint32_t i = 0, count = getTotalNumOutputChannels(AudioProcessor::ChannelTypeAudio); i < count; ++i)
+        carla_zeroFloats (audioOuts[i], numSamples);
+
+    for (uint32_t i = 0, count = getTotalNumOutputChannels(AudioProcessor::ChannelTypeCV); i < count; ++i)
+        carla_zeroFloats (cvOuts[i], numSamples);
+
+    audioAndCVBuffers->externalAudioIns = audioIns;
+    audioAndCVBuffers->externalAudioOuts = audioOuts;
+    audioAndCVBuffers->externalCVIns = cvIns;
+    audioAndCVBuffers->externalCVOuts = cvOuts;
+    currentMidiInputBuffer = &midiMessages;
+    currentMidiOutputBuffer.clear();
+
+    audioAndCVBuffers->bindInputs (audioIns, getTotalNumInputChannels(AudioProcessor::ChannelTypeAudio),
+                                   cvIns, getTotalNumInputChannels(AudioProcessor::ChannelTypeCV));
+    performRenderingOps (static_cast<int>(numSamples));
+    audioAndCVBuffers->unbindInputs();
+
+    audioAndCVBuffers->externalAudioIns = nullptr;
+    audioAndCVBuffers->externalAudioOuts = nullptr;
+    audioAndCVBuffers->externalCVIns = nullptr;
+    audioAndCVBuffers->externalCVOuts = nullptr;
+
+    midiMessages.clear();
+    midiMessages.addEvents (currentMidiOutputBuffer, 0, static_cast<int>(numSamples), 0);
+}
+
+void AudioProcessorGraph::performRenderingOps (const int numSamples)
+{
+    AudioSampleBuffer& renderingAudioBuffers = audioAndCVBuffers->renderingAudioBuffers;
+    AudioSampleBuffer& renderingCVBuffers    = audioAndCVBuffers->renderingCVBuffers;
+    GraphRenderingOps::DoubleChannels* const renderingDoubleBuffers = audioAndCVBuffers->getDoubleBuffers (numSamples);
+
+    for (int i = 0; i < renderingOps.size(); ++i)
+    {
+        GraphRenderingOps::AudioGraphRenderingOpBase* const op
+            = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
+
+        op->perform (renderingAudioBuffers, renderingCVBuffers, midiBuffers, renderingDoubleBuffers, numSamples);
+    }
+}
+
 bool AudioProcessorGraph::acceptsMidi() const                       { return true; }
 bool AudioProcessorGraph::producesMidi() const                      { return true; }
 
@@ -1686,6 +2302,23 @@ void AudioProcessorGraph::processBlockWithCV (AudioSampleBuffer& audioBuffer,
 
 void AudioProcessorGraph::reorderNowIfNeeded()
 {
+    if (! needsReorder)
+    {
+        const CarlaRecursiveMutexLocker cml (reorderMutex);
+
+        for (int i = 0; i < nodes.size(); ++i)
+        {
+            const Node* const node = nodes.getUnchecked (i);
+
+            if (node->processor->isInactive() != node->wasInactive
+                || node->processor->isAlwaysNeeded() != node->wasAlwaysNeeded)
+            {
+                needsReorder = true;
+                break;
+            }
+        }
+    }
+
     if (needsReorder)
     {
         needsReorder = false;
@@ -1698,6 +2331,22 @@ const CarlaRecursiveMutex& AudioProcessorGraph::getReorderMutex() const
     return reorderMutex;
 }
 
+void AudioProcessorGraph::setDoublePrecisionProcessing (const bool shouldUseDoubles)
+{
+    if (doublePrecision == shouldUseDoubles)
+        return;
+
+    doublePrecision = shouldUseDoubles;
+
+    if (isPrepared)
+        buildRenderingSequence();
+}
+
+bool AudioProcessorGraph::isUsingDoublePrecision() const noexcept
+{
+    return doublePrecision;
+}
+
 //==============================================================================
 AudioProcessorGraph::AudioGraphIOProcessor::AudioGraphIOProcessor (const IODeviceType deviceType)
     : type (deviceType), graph (nullptr)
@@ -1744,6 +2393,17 @@ void AudioProcessorGraph::AudioGraphIOProcessor::processAudioAndCV (AudioSampleB
     {
         case audioOutputNode:
         {
+            if (float* const* const externalAudioOuts = graph->audioAndCVBuffers->externalAudioOuts)
+            {
+                for (uint32_t i = 0, count = jmin (graph->getTotalNumOutputChannels (ChannelTypeAudio),
+                                                   audioBuffer.getNumChannels()); i < count; ++i)
+                {
+                    carla_addFloats (externalAudioOuts[i], audioBuffer.getReadPointer (i), audioBuffer.getNumSamples());
+                }
+
+                break;
+            }
+
             AudioSampleBuffer&  currentAudioOutputBuffer =
                 graph->audioAndCVBuffers->currentAudioOutputBuffer;
 
@@ -1758,13 +2418,27 @@ void AudioProcessorGraph::AudioGraphIOProcessor::processAudioAndCV (AudioSampleB
 
         case audioInputNode:
         {
+            if (const float* const* const externalAudioIns = graph->audioAndCVBuffers->externalAudioIns)
+            {
+                for (uint32_t i = 0, count = jmin (graph->getTotalNumInputChannels (ChannelTypeAudio),
+                                                   audioBuffer.getNumChannels()); i < count; ++i)
+                {
+                    // channels usually point to the input already, see bindInputs()
+                    if (audioBuffer.getReadPointer (i) != externalAudioIns[i])
+                        audioBuffer.copyFrom (i, 0, externalAudioIns[i], audioBuffer.getNumSamples());
+                }
+
+                break;
+            }
+
             AudioSampleBuffer*& currentAudioInputBuffer =
                 graph->audioAndCVBuffers->currentAudioInputBuffer;
 
             for (int i = jmin (currentAudioInputBuffer->getNumChannels(),
                                audioBuffer.getNumChannels()); --i >= 0;)
             {
-                audioBuffer.copyFrom (i, 0, *currentAudioInputBuffer, i, 0, audioBuffer.getNumSamples());
+                if (audioBuffer.getReadPointer (i) != currentAudioInputBuffer->getReadPointer (i))
+                    audioBuffer.copyFrom (i, 0, *currentAudioInputBuffer, i, 0, audioBuffer.getNumSamples());
             }
 
             break;
@@ -1772,6 +2446,17 @@ void AudioProcessorGraph::AudioGraphIOProcessor::processAudioAndCV (AudioSampleB
 
         case cvOutputNode:
         {
+            if (float* const* const externalCVOuts = graph->audioAndCVBuffers->externalCVOuts)
+            {
+                for (uint32_t i = 0, count = jmin (graph->getTotalNumOutputChannels (ChannelTypeCV),
+                                                   cvInBuffer.getNumChannels()); i < count; ++i)
+                {
+                    carla_addFloats (externalCVOuts[i], cvInBuffer.getReadPointer (i), cvInBuffer.getNumSamples());
+                }
+
+                break;
+            }
+
             AudioSampleBuffer&  currentCVOutputBuffer =
                 graph->audioAndCVBuffers->currentCVOutputBuffer;
 
@@ -1786,13 +2471,26 @@ void AudioProcessorGraph::AudioGraphIOProcessor::processAudioAndCV (AudioSampleB
 
         case cvInputNode:
         {
+            if (const float* const* const externalCVIns = graph->audioAndCVBuffers->externalCVIns)
+            {
+                for (uint32_t i = 0, count = jmin (graph->getTotalNumInputChannels (ChannelTypeCV),
+                                                   cvOutBuffer.getNumChannels()); i < count; ++i)
+                {
+                    if (cvOutBuffer.getReadPointer (i) != externalCVIns[i])
+                        cvOutBuffer.copyFrom (i, 0, externalCVIns[i], cvOutBuffer.getNumSamples());
+                }
+
+                break;
+            }
+
             const AudioSampleBuffer*& currentCVInputBuffer =
                 graph->audioAndCVBuffers->currentCVInputBuffer;
 
             for (int i = jmin (currentCVInputBuffer->getNumChannels(),
                                cvOutBuffer.getNumChannels()); --i >= 0;)
             {
-                cvOutBuffer.copyFrom (i, 0, *currentCVInputBuffer, i, 0, cvOutBuffer.getNumSamples());
+                if (cvOutBuffer.getReadPointer (i) != currentCVInputBuffer->getReadPointer (i))
+                    cvOutBuffer.copyFrom (i, 0, *currentCVInputBuffer, i, 0, cvOutBuffer.getNumSamples());
             }
 
             break;
@@ -114,6 +114,8 @@ public:
 
         const CarlaScopedPointer<AudioProcessor> processor;
         bool isPrepared;
+        bool wasInactive; // value of processor->isInactive() used by the current rendering sequence
+        bool wasAlwaysNeeded; // same for processor->isAlwaysNeeded()
 
         Node (uint32 nodeId, AudioProcessor*) noexcept;
 
@@ -385,9 +387,38 @@ public:
     bool acceptsMidi() const override;
     bool producesMidi() const override;
 
+    /** Processes the graph using external channel buffers for its audio and CV inputs and outputs.
+
+        The IO nodes read and write these buffers directly, instead of going through the
+        intermediate buffers used by processBlockWithCV().
+        The number of channels for each array must match the graph configuration.
+        Output buffers are cleared first, so they must not be the same as any input buffer.
+    */
+    void processWithExternalBuffers (const float* const* audioIns, float* const* audioOuts,
+                                     const float* const* cvIns, float* const* cvOuts,
+                                     uint32_t numSamples, MidiBuffer& midiMessages);
+
+    /** Rebuilds the rendering sequence if the graph has changed since the last time.
+
+        Besides node and connection changes, this also notices processors that became
+        active or inactive. Nodes are only rendered when they can reach a node without
+        audio or CV outputs, such as the graph output nodes, so unused chains cost nothing.
+    */
     void reorderNowIfNeeded();
     const CarlaRecursiveMutex& getReorderMutex() const;
 
+    /** Enables or disables double precision processing.
+
+        When enabled, audio between processors that support double precision is kept as double,
+        and only converted where a float processor (including the IO nodes) reads or writes it.
+        Connections that mix both kinds are summed in double precision.
+        Float-only graphs behave the same as before, apart from the extra memory.
+    */
+    void setDoublePrecisionProcessing (bool shouldUseDoubles);
+
+    /** Returns true if double precision processing is enabled. */
+    bool isUsingDoublePrecision() const noexcept;
+
 private:
     //==============================================================================
     // void processAudio (AudioSampleBuffer& audioBuffer, MidiBuffer& midiMessages);
@@ -396,6 +427,8 @@ private:
                             AudioSampleBuffer& cvOutBuffer,
                             MidiBuffer& midiMessages);
 
+    void performRenderingOps (int numSamples);
+
     //==============================================================================
     ReferenceCountedArray<Node> nodes;
     OwnedArray<Connection> connections;
@@ -410,13 +443,12 @@ private:
     MidiBuffer* currentMidiInputBuffer;
     MidiBuffer currentMidiOutputBuffer;
 
-    bool isPrepared, needsReorder;
+    bool isPrepared, needsReorder, doublePrecision;
     CarlaRecursiveMutex reorderMutex;
 
 public:
     void clearRenderingSequence();
     void buildRenderingSequence();
-    bool isAnInputTo (uint32 possibleInputId, uint32 possibleDestinationId, int recursionCheck) const;
 
     CARLA_DECLARE_NON_COPYABLE (AudioProcessorGraph)
 };
@@ -0,0 +1,493 @@
+// ----------------------------------------------------------------------------
+//
+//  Copyright (C) 2006-2012 Fons Adriaensen <fons@linuxaudio.org>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// ----------------------------------------------------------------------------
+
+
+#include "resampler-kernels.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+# define RESAMPLER_HAVE_SSE
+# include <xmmintrin.h>
+# if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+// built with the 'avx' target attribute, only used if the CPU supports it
+#  define RESAMPLER_HAVE_AVX
+#  include <immintrin.h>
+# endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define RESAMPLER_HAVE_NEON
+# include <arm_neon.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+// Plain C++, same as the original zita-resampler loops.
+
+
+static inline float fir_scalar_chan (const float *q1,
+                                     const float *q2,
+                                     const float *c1,
+                                     const float *c2,
+                                     unsigned int hl,
+                                     unsigned int nchan,
+                                     float        bias)
+{
+    float s = bias;
+    for (unsigned int i = 0; i < hl; i++)
+    {
+        q2 -= nchan;
+        s += *q1 * c1 [i] + *q2 * c2 [i];
+        q1 += nchan;
+    }
+    return s - bias;
+}
+
+
+static void fir_scalar (const float *p1,
+                        const float *p2,
+                        const float *c1,
+                        const float *c2,
+                        unsigned int hl,
+                        unsigned int nchan,
+                        float        bias,
+                        float       *out)
+{
+    for (unsigned int c = 0; c < nchan; c++)
+    {
+        out [c] = fir_scalar_chan (p1 + c, p2 + c, c1, c2, hl, nchan, bias);
+    }
+}
+
+
+// Adds the taps from 'i' to 'hl' of a single channel, after a vector loop.
+
+static inline float fir_scalar_tail (const float *p1,
+                                     const float *p2,
+                                     const float *c1,
+                                     const float *c2,
+                                     unsigned int i,
+                                     unsigned int hl,
+                                     unsigned int nchan,
+                                     float        s)
+{
+    for (; i < hl; i++)
+    {
+        s += p1 [i * nchan] * c1 [i] + p2 [-(int)((i + 1) * nchan)] * c2 [i];
+    }
+    return s;
+}
+
+
+// ----------------------------------------------------------------------------
+// SSE, 4 taps at a time for mono and stereo, 4 channels at a time otherwise.
+// Stereo frames are multiplied as they are, with each coefficient duplicated.
+// The backward half loads the frames in memory order and reverses the coefficients.
+
+
+#ifdef RESAMPLER_HAVE_SSE
+
+static inline __m128 reverse_sse (__m128 v)
+{
+    return _mm_shuffle_ps (v, v, _MM_SHUFFLE (0, 1, 2, 3));
+}
+
+
+static inline float hsum_sse (__m128 v)
+{
+    v = _mm_add_ps (v, _mm_movehl_ps (v, v));
+    v = _mm_add_ss (v, _mm_shuffle_ps (v, v, _MM_SHUFFLE (1, 1, 1, 1)));
+    return _mm_cvtss_f32 (v);
+}
+
+
+static inline unsigned int fir_mono_sse (const float *p1,
+                                         const float *p2,
+                                         const float *c1,
+                                         const float *c2,
+                                         unsigned int i,
+                                         unsigned int hl,
+                                         __m128      &acc1,
+                                         __m128      &acc2)
+{
+    for (; i + 4 <= hl; i += 4)
+    {
+        acc1 = _mm_add_ps (acc1, _mm_mul_ps (_mm_loadu_ps (p1 + i), _mm_loadu_ps (c1 + i)));
+        acc2 = _mm_add_ps (acc2, _mm_mul_ps (_mm_loadu_ps (p2 - i - 4), reverse_sse (_mm_loadu_ps (c2 + i))));
+    }
+    return i;
+}
+
+
+static inline unsigned int fir_stereo_sse (const float *p1,
+                                           const float *p2,
+                                           const float *c1,
+                                           const float *c2,
+                                           unsigned int i,
+                                           unsigned int hl,
+                                           __m128      &acc1,
+                                           __m128      &acc2)
+{
+    for (; i + 4 <= hl; i += 4)
+    {
+        const __m128 k1 = _mm_loadu_ps (c1 + i);
+        const __m128 k2 = reverse_sse (_mm_loadu_ps (c2 + i));
+        const float *q1 = p1 + 2 * i;
+        const float *q2 = p2 - 2 * (i + 4);
+        acc1 = _mm_add_ps (acc1, _mm_mul_ps (_mm_loadu_ps (q1), _mm_unpacklo_ps (k1, k1)));
+        acc2 = _mm_add_ps (acc2, _mm_mul_ps (_mm_loadu_ps (q1 + 4), _mm_unpackhi_ps (k1, k1)));
+        acc1 = _mm_add_ps (acc1, _mm_mul_ps (_mm_loadu_ps (q2), _mm_unpacklo_ps (k2, k2)));
+        acc2 = _mm_add_ps (acc2, _mm_mul_ps (_mm_loadu_ps (q2 + 4), _mm_unpackhi_ps (k2, k2)));
+    }
+    return i;
+}
+
+
+static inline __m128 fir_quad_sse (const float *q1,
+                                   const float *q2,
+                                   const float *c1,
+                                   const float *c2,
+                                   unsigned int hl,
+                                   unsigned int nchan,
+                                   __m128       acc)
+{
+    for (unsigned int i = 0; i < hl; i++)
+    {
+        q2 -= nchan;
+        acc = _mm_add_ps (acc, _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (q1), _mm_set1_ps (c1 [i])),
+                                           _mm_mul_ps (_mm_loadu_ps (q2), _mm_set1_ps (c2 [i]))));
+        q1 += nchan;
+    }
+    return acc;
+}
+
+
+static void fir_sse (const float *p1,
+                     const float *p2,
+                     const float *c1,
+                     const float *c2,
+                     unsigned int hl,
+                     unsigned int nchan,
+                     float        bias,
+                     float       *out)
+{
+    unsigned int c, i;
+
+    if (nchan == 1)
+    {
+        __m128 acc1 = _mm_set_ss (bias);
+        __m128 acc2 = _mm_setzero_ps ();
+        i = fir_mono_sse (p1, p2, c1, c2, 0, hl, acc1, acc2);
+        out [0] = fir_scalar_tail (p1, p2, c1, c2, i, hl, 1, hsum_sse (_mm_add_ps (acc1, acc2))) - bias;
+        return;
+    }
+
+    if (nchan == 2)
+    {
+        __m128 acc1 = _mm_setr_ps (bias, bias, 0.0f, 0.0f);
+        __m128 acc2 = _mm_setzero_ps ();
+        i = fir_stereo_sse (p1, p2, c1, c2, 0, hl, acc1, acc2);
+        acc1 = _mm_add_ps (acc1, acc2);
+        acc1 = _mm_add_ps (acc1, _mm_movehl_ps (acc1, acc1));
+        float s [4];
+        _mm_storeu_ps (s, acc1);
+        out [0] = fir_scalar_tail (p1,     p2,     c1, c2, i, hl, 2, s [0]) - bias;
+        out [1] = fir_scalar_tail (p1 + 1, p2 + 1, c1, c2, i, hl, 2, s [1]) - bias;
+        return;
+    }
+
+    const __m128 vbias = _mm_set1_ps (bias);
+
+    for (c = 0; c + 4 <= nchan; c += 4)
+    {
+        const __m128 acc = fir_quad_sse (p1 + c, p2 + c, c1, c2, hl, nchan, vbias);
+        _mm_storeu_ps (out + c, _mm_sub_ps (acc, vbias));
+    }
+    for (; c < nchan; c++)
+    {
+        out [c] = fir_scalar_chan (p1 + c, p2 + c, c1, c2, hl, nchan, bias);
+    }
+}
+
+#endif
+
+
+// ----------------------------------------------------------------------------
+// AVX, as SSE but 8 taps or 8 channels at a time.
+
+
+#ifdef RESAMPLER_HAVE_AVX
+
+__attribute__((target("avx")))
+static inline __m256 reverse_avx (__m256 v)
+{
+    v = _mm256_permute_ps (v, _MM_SHUFFLE (0, 1, 2, 3));
+    return _mm256_permute2f128_ps (v, v, 1);
+}
+
+
+__attribute__((target("avx")))
+static inline __m128 fold_avx (__m256 v)
+{
+    return _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+}
+
+
+__attribute__((target("avx")))
+static void fir_avx (const float *p1,
+                     const float *p2,
+                     const float *c1,
+                     const float *c2,
+                     unsigned int hl,
+                     unsigned int nchan,
+                     float        bias,
+                     float       *out)
+{
+    unsigned int c, i;
+
+    if (nchan == 1)
+    {
+        __m256 acc1 = _mm256_setr_ps (bias, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+        __m256 acc2 = _mm256_setzero_ps ();
+        for (i = 0; i + 8 <= hl; i += 8)
+        {
+            acc1 = _mm256_add_ps (acc1, _mm256_mul_ps (_mm256_loadu_ps (p1 + i), _mm256_loadu_ps (c1 + i)));
+            acc2 = _mm256_add_ps (acc2, _mm256_mul_ps (_mm256_loadu_ps (p2 - i - 8), reverse_avx (_mm256_loadu_ps (c2 + i))));
+        }
+        __m128 acc3 = fold_avx (acc1);
+        __m128 acc4 = fold_avx (acc2);
+        i = fir_mono_sse (p1, p2, c1, c2, i, hl, acc3, acc4);
+        out [0] = fir_scalar_tail (p1, p2, c1, c2, i, hl, 1, hsum_sse (_mm_add_ps (acc3, acc4))) - bias;
+        return;
+    }
+
+    if (nchan == 2)
+    {
+        __m256 acc1 = _mm256_setr_ps (bias, bias, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+        __m256 acc2 = _mm256_setzero_ps ();
+        for (i = 0; i + 8 <= hl; i += 8)
+        {
+            const __m256 k1 = _mm256_loadu_ps (c1 + i);
+            const __m256 k2 = reverse_avx (_mm256_loadu_ps (c2 + i));
+            const __m256 l1 = _mm256_unpacklo_ps (k1, k1);
+            const __m256 h1 = _mm256_unpackhi_ps (k1, k1);
+            const __m256 l2 = _mm256_unpacklo_ps (k2, k2);
+            const __m256 h2 = _mm256_unpackhi_ps (k2, k2);
+            const float *q1 = p1 + 2 * i;
+            const float *q2 = p2 - 2 * (i + 8);
+            acc1 = _mm256_add_ps (acc1, _mm256_mul_ps (_mm256_loadu_ps (q1),     _mm256_permute2f128_ps (l1, h1, 0x20)));
+            acc2 = _mm256_add_ps (acc2, _mm256_mul_ps (_mm256_loadu_ps (q1 + 8), _mm256_permute2f128_ps (l1, h1, 0x31)));
+            acc1 = _mm256_add_ps (acc1, _mm256_mul_ps (_mm256_loadu_ps (q2),     _mm256_permute2f128_ps (l2, h2, 0x20)));
+            acc2 = _mm256_add_ps (acc2, _mm256_mul_ps (_mm256_loadu_ps (q2 + 8), _mm256_permute2f128_ps (l2, h2, 0x31)));
+        }
+        __m128 acc3 = fold_avx (acc1);
+        __m128 acc4 = fold_avx (acc2);
+        i = fir_stereo_sse (p1, p2, c1, c2, i, hl, acc3, acc4);
+        acc3 = _mm_add_ps (acc3, acc4);
+        acc3 = _mm_add_ps (acc3, _mm_movehl_ps (acc3, acc3));
+        float s [4];
+        _mm_storeu_ps (s, acc3);
+        out [0] = fir_scalar_tail (p1,     p2,     c1, c2, i, hl, 2, s [0]) - bias;
+        out [1] = fir_scalar_tail (p1 + 1, p2 + 1, c1, c2, i, hl, 2, s [1]) - bias;
+        return;
+    }
+
+    const __m256 vbias = _mm256_set1_ps (bias);
+
+    for (c = 0; c + 8 <= nchan; c += 8)
+    {
+        const float *q1 = p1 + c;
+        const float *q2 = p2 + c;
+        __m256 acc = vbias;
+        for (i = 0; i < hl; i++)
+        {
+            q2 -= nchan;
+            acc = _mm256_add_ps (acc, _mm256_add_ps (_mm256_mul_ps (_mm256_loadu_ps (q1), _mm256_set1_ps (c1 [i])),
+                                                     _mm256_mul_ps (_mm256_loadu_ps (q2), _mm256_set1_ps (c2 [i]))));
+            q1 += nchan;
+        }
+        _mm256_storeu_ps (out + c, _mm256_sub_ps (acc, vbias));
+    }
+    for (; c + 4 <= nchan; c += 4)
+    {
+        const __m128 vbias4 = _mm256_castps256_ps128 (vbias);
+        const __m128 acc = fir_quad_sse (p1 + c, p2 + c, c1, c2, hl, nchan, vbias4);
+        _mm_storeu_ps (out + c, _mm_sub_ps (acc, vbias4));
+    }
+    for (; c < nchan; c++)
+    {
+        out [c] = fir_scalar_chan (p1 + c, p2 + c, c1, c2, hl, nchan, bias);
+    }
+}
+
+#endif
+
+
+// ----------------------------------------------------------------------------
+// NEON, same layout as SSE.
+
+
+#ifdef RESAMPLER_HAVE_NEON
+
+static inline float32x4_t reverse_neon (float32x4_t v)
+{
+    v = vrev64q_f32 (v);
+    return vcombine_f32 (vget_high_f32 (v), vget_low_f32 (v));
+}
+
+
+static inline float32x2_t fold_neon (float32x4_t v)
+{
+    return vadd_f32 (vget_low_f32 (v), vget_high_f32 (v));
+}
+
+
+static void fir_neon (const float *p1,
+                      const float *p2,
+                      const float *c1,
+                      const float *c2,
+                      unsigned int hl,
+                      unsigned int nchan,
+                      float        bias,
+                      float       *out)
+{
+    unsigned int c, i;
+
+    if (nchan == 1)
+    {
+        float32x4_t acc1 = vsetq_lane_f32 (bias, vdupq_n_f32 (0.0f), 0);
+        float32x4_t acc2 = vdupq_n_f32 (0.0f);
+        for (i = 0; i + 4 <= hl; i += 4)
+        {
+            acc1 = vmlaq_f32 (acc1, vld1q_f32 (p1 + i), vld1q_f32 (c1 + i));
+            acc2 = vmlaq_f32 (acc2, vld1q_f32 (p2 - i - 4), reverse_neon (vld1q_f32 (c2 + i)));
+        }
+        const float32x2_t s = fold_neon (vaddq_f32 (acc1, acc2));
+        out [0] = fir_scalar_tail (p1, p2, c1, c2, i, hl, 1, vget_lane_f32 (vpadd_f32 (s, s), 0)) - bias;
+        return;
+    }
+
+    if (nchan == 2)
+    {
+        float32x4_t acc1 = vcombine_f32 (vdup_n_f32 (bias), vdup_n_f32 (0.0f));
+        float32x4_t acc2 = vdupq_n_f32 (0.0f);
+        for (i = 0; i + 4 <= hl; i += 4)
+        {
+            const float32x4x2_t k1 = vzipq_f32 (vld1q_f32 (c1 + i), vld1q_f32 (c1 + i));
+            const float32x4_t   r2 = reverse_neon (vld1q_f32 (c2 + i));
+            const float32x4x2_t k2 = vzipq_f32 (r2, r2);
+            const float *q1 = p1 + 2 * i;
+            const float *q2 = p2 - 2 * (i + 4);
+            acc1 = vmlaq_f32 (acc1, vld1q_f32 (q1),     k1.val [0]);
+            acc2 = vmlaq_f32 (acc2, vld1q_f32 (q1 + 4), k1.val [1]);
+            acc1 = vmlaq_f32 (acc1, vld1q_f32 (q2),     k2.val [0]);
+            acc2 = vmlaq_f32 (acc2, vld1q_f32 (q2 + 4), k2.val [1]);
+        }
+        const float32x2_t s = fold_neon (vaddq_f32 (acc1, acc2));
+        out [0] = fir_scalar_tail (p1,     p2,     c1, c2, i, hl, 2, vget_lane_f32 (s, 0)) - bias;
+        out [1] = fir_scalar_tail (p1 + 1, p2 + 1, c1, c2, i, hl, 2, vget_lane_f32 (s, 1)) - bias;
+        return;
+    }
+
+    const float32x4_t vbias = vdupq_n_f32 (bias);
+
+    for (c = 0; c + 4 <= nchan; c += 4)
+    {
+        const float *q1 = p1 + c;
+        const float *q2 = p2 + c;
+        float32x4_t acc = vbias;
+        for (i = 0; i < hl; i++)
+        {
+            q2 -= nchan;
+            acc = vmlaq_n_f32 (acc, vld1q_f32 (q1), c1 [i]);
+            acc = vmlaq_n_f32 (acc, vld1q_f32 (q2), c2 [i]);
+            q1 += nchan;
+        }
+        vst1q_f32 (out + c, vsubq_f32 (acc, vbias));
+    }
+    for (; c < nchan; c++)
+    {
+        out [c] = fir_scalar_chan (p1 + c, p2 + c, c1, c2, hl, nchan, bias);
+    }
+}
+
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+static Resampler_fir select_best (void)
+{
+    Resampler_fir fir;
+
+    if ((fir = Resampler_kernels::get (Resampler_kernels::ISA_AVX)) != nullptr) return fir;
+    if ((fir = Resampler_kernels::get (Resampler_kernels::ISA_NEON)) != nullptr) return fir;
+    if ((fir = Resampler_kernels::get (Resampler_kernels::ISA_SSE)) != nullptr) return fir;
+    return fir_scalar;
+}
+
+
+Resampler_fir Resampler_kernels::get (int isa)
+{
+    switch (isa)
+    {
+    case ISA_DEFAULT:
+    {
+        static const Resampler_fir best = select_best ();
+        return best;
+    }
+    case ISA_SCALAR:
+        return fir_scalar;
+    case ISA_SSE:
+#ifdef RESAMPLER_HAVE_SSE
+        return fir_sse;
+#else
+        return nullptr;
+#endif
+    case ISA_AVX:
+#ifdef RESAMPLER_HAVE_AVX
+        __builtin_cpu_init ();
+        return __builtin_cpu_supports ("avx") ? fir_avx : nullptr;
+#else
+        return nullptr;
+#endif
+    case ISA_NEON:
+#ifdef RESAMPLER_HAVE_NEON
+        return fir_neon;
+#else
+        return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+
+const char *Resampler_kernels::name (int isa)
+{
+    switch (isa)
+    {
+    case ISA_DEFAULT: return "default";
+    case ISA_SCALAR:  return "scalar";
+    case ISA_SSE:     return "sse";
+    case ISA_AVX:     return "avx";
+    case ISA_NEON:    return "neon";
+    }
+    return "unknown";
+}
+
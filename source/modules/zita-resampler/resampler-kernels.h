@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+//
+//  Copyright (C) 2006-2012 Fons Adriaensen <fons@linuxaudio.org>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef __RESAMPLER_KERNELS_H
+#define __RESAMPLER_KERNELS_H
+
+
+// Computes one output frame of 'nchan' interleaved channels into 'out'.
+// 'p1' points to the oldest input frame of the filter, 'p2' one frame past
+// the newest one. The first half of the filter 'c1' runs forward from 'p1',
+// the second half 'c2' runs backward from 'p2', both have 'hl' taps.
+// 'bias' is added to the sums and removed again, to avoid denormals.
+
+typedef void (*Resampler_fir) (const float *p1,
+                               const float *p2,
+                               const float *c1,
+                               const float *c2,
+                               unsigned int hl,
+                               unsigned int nchan,
+                               float        bias,
+                               float       *out);
+
+
+class Resampler_kernels
+{
+public:
+
+    enum
+    {
+        ISA_DEFAULT = -1,  // best one supported by this CPU
+        ISA_SCALAR,
+        ISA_SSE,
+        ISA_AVX,
+        ISA_NEON,
+        ISA_COUNT
+    };
+
+    // Returns nullptr if 'isa' is not supported by this build or CPU.
+    static Resampler_fir get (int isa = ISA_DEFAULT);
+    static const char *name (int isa);
+};
+
+
+#endif
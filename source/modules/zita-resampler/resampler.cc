@@ -51,7 +51,9 @@ static unsigned int gcd (unsigned int a, unsigned int b)
 Resampler::Resampler (void) noexcept :
     _table (0),
     _nchan (0),
-    _buff  (0)
+    _buff  (0),
+    _obuf  (0),
+    _fir   (Resampler_kernels::get ())
 {
     reset ();
 }
@@ -82,6 +84,7 @@ int Resampler::setup (unsigned int fs_inp,
     unsigned int       g, h, k, n, s;
     double             r;
     float              *B = 0;
+    float              *O = 0;
     Resampler_table    *T = 0;
 
     k = s = 0;
@@ -103,6 +106,7 @@ int Resampler::setup (unsigned int fs_inp,
             }
             T = Resampler_table::create (frel, h, n);
             B = new float [nchan * (2 * h - 1 + k)];
+            O = new float [nchan];
         }
     }
     clear ();
@@ -110,6 +114,7 @@ int Resampler::setup (unsigned int fs_inp,
     {
         _table = T;
         _buff  = B;
+        _obuf  = O;
         _nchan = nchan;
         _inmax = k;
         _pstep = s;
@@ -123,7 +128,9 @@ void Resampler::clear (void)
 {
     Resampler_table::destroy (_table);
     delete[] _buff;
+    delete[] _obuf;
     _buff  = 0;
+    _obuf  = 0;
     _table = 0;
     _nchan = 0;
     _inmax = 0;
@@ -154,6 +161,8 @@ bool Resampler::reset (void) noexcept
     out_count = 0;
     inp_data = nullptr;
     out_data = nullptr;
+    inp_list = nullptr;
+    out_list = nullptr;
     _index = 0;
     _nread = 0;
     _nzero = 0;
@@ -163,10 +172,35 @@ bool Resampler::reset (void) noexcept
 }
 
 
+int Resampler::set_kernel (int isa)
+{
+    Resampler_fir fir = Resampler_kernels::get (isa);
+
+    if (!fir) return 1;
+    _fir = fir;
+    return 0;
+}
+
+
 bool Resampler::process (void)
 {
-    unsigned int   hl, ph, np, dp, in, nr, nz, i, n, c;
-    float          *p1, *p2;
+    return process_frames (false);
+}
+
+
+// Same as process(), but using one buffer per channel. The channel pointers
+// in inp_list and out_list are advanced as inp_data and out_data would be.
+
+bool Resampler::process_planar (void)
+{
+    return process_frames (true);
+}
+
+
+bool Resampler::process_frames (bool planar)
+{
+    unsigned int   hl, ph, np, dp, in, nr, nz, n, c;
+    float          *p1, *p2, *q;
 
     if (!_table) return false;
 
@@ -186,10 +220,14 @@ bool Resampler::process (void)
         if (nr)
         {
             if (inp_count == 0) break;
-            if (inp_data)
+            if (planar ? inp_list != nullptr : inp_data != nullptr)
             {
-                for (c = 0; c < _nchan; c++) p2 [c] = inp_data [c];
-                inp_data += _nchan;
+                if (planar) for (c = 0; c < _nchan; c++) p2 [c] = *inp_list [c]++;
+                else
+                {
+                    for (c = 0; c < _nchan; c++) p2 [c] = inp_data [c];
+                    inp_data += _nchan;
+                }
               nz = 0;
             }
             else
@@ -203,30 +241,21 @@ bool Resampler::process (void)
         }
         else
         {
-            if (out_data)
+            if (planar ? out_list != nullptr : out_data != nullptr)
             {
+                q = planar ? _obuf : out_data;
                 if (nz < 2 * hl)
                 {
                     float *c1 = _table->_ctab + hl * ph;
                     float *c2 = _table->_ctab + hl * (np - ph);
-                    for (c = 0; c < _nchan; c++)
-                    {
-                        float *q1 = p1 + c;
-                        float *q2 = p2 + c;
-                        float s = 1e-20f;
-                        for (i = 0; i < hl; i++)
-                        {
-                            q2 -= _nchan;
-                            s += *q1 * c1 [i] + *q2 * c2 [i];
-                            q1 += _nchan;
-                        }
-                        *out_data++ = s - 1e-20f;
-                    }
+                    _fir (p1, p2, c1, c2, hl, _nchan, 1e-20f, q);
                 }
                 else
                 {
-                    for (c = 0; c < _nchan; c++) *out_data++ = 0;
+                    for (c = 0; c < _nchan; c++) q [c] = 0;
                 }
+                if (planar) for (c = 0; c < _nchan; c++) *out_list [c]++ = q [c];
+                else out_data += _nchan;
             }
             out_count--;
 
@@ -23,6 +23,7 @@
 
 
 #include "resampler-table.h"
+#include "resampler-kernels.h"
 
 
 class Resampler
@@ -50,16 +51,20 @@ public:
     unsigned int inpsize (void) const noexcept;
     double       inpdist (void) const noexcept;
     bool         process (void);
+    bool         process_planar (void);
+    int          set_kernel (int isa);
 
     unsigned int         inp_count;
     unsigned int         out_count;
     float               *inp_data;
     float               *out_data;
-    void                *inp_list;
-    void                *out_list;
+    float              **inp_list;
+    float              **out_list;
 
 private:
 
+    bool         process_frames (bool planar);
+
     Resampler_table     *_table;
     unsigned int         _nchan;
     unsigned int         _inmax;
@@ -69,6 +74,8 @@ private:
     unsigned int         _phase;
     unsigned int         _pstep;
     float               *_buff;
+    float               *_obuf;
+    Resampler_fir        _fir;
 };
 
 
@@ -30,7 +30,9 @@ VResampler::VResampler (void) :
     _nchan (0),
     _buff  (0),
     _c1 (0),
-    _c2 (0)
+    _c2 (0),
+    _obuf (0),
+    _fir (Resampler_kernels::get ())
 {
     reset ();
 }
@@ -79,6 +81,7 @@ int VResampler::setup (double       ratio,
 	_buff  = new float [nchan * (2 * h - 1 + k)];
 	_c1 = new float [2 * h];
 	_c2 = new float [2 * h];
+	_obuf = new float [nchan];
 	_nchan = nchan;
 	_inmax = k;
 	_ratio = ratio;
@@ -97,9 +100,11 @@ void VResampler::clear (void)
     delete[] _buff;
     delete[] _c1;
     delete[] _c2;
+    delete[] _obuf;
     _buff  = 0;
     _c1 = 0;
     _c2 = 0;
+    _obuf = 0;
     _table = 0;
     _nchan = 0;
     _inmax = 0;
@@ -155,6 +160,8 @@ int VResampler::reset (void)
     out_count = 0;
     inp_data = 0;
     out_data = 0;
+    inp_list = 0;
+    out_list = 0;
     _index = 0;
     _phase = 0; 
     _nread = 2 * _table->_hl;
@@ -163,12 +170,37 @@ int VResampler::reset (void)
 }
 
 
+int VResampler::set_kernel (int isa)
+{
+    Resampler_fir fir = Resampler_kernels::get (isa);
+
+    if (!fir) return 1;
+    _fir = fir;
+    return 0;
+}
+
+
 int VResampler::process (void)
+{
+    return process_frames (false);
+}
+
+
+// Same as process(), but using one buffer per channel. The channel pointers
+// in inp_list and out_list are advanced as inp_data and out_data would be.
+
+int VResampler::process_planar (void)
+{
+    return process_frames (true);
+}
+
+
+int VResampler::process_frames (bool planar)
 {
     unsigned int   k, np, in, nr, n, c;
     int            i, hl, nz;
     double         ph, dp, dd; 
-    float          a, b, *p1, *p2, *q1, *q2;
+    float          a, b, *p1, *p2, *q1, *q2, *q;
 
     if (!_table) return 1;
 
@@ -188,10 +220,14 @@ int VResampler::process (void)
 	if (nr)
 	{
 	    if (inp_count == 0) break;
-  	    if (inp_data)
+  	    if (planar ? inp_list != 0 : inp_data != 0)
 	    {
-                for (c = 0; c < _nchan; c++) p2 [c] = inp_data [c];
-		inp_data += _nchan;
+                if (planar) for (c = 0; c < _nchan; c++) p2 [c] = *inp_list [c]++;
+                else
+                {
+                    for (c = 0; c < _nchan; c++) p2 [c] = inp_data [c];
+		    inp_data += _nchan;
+                }
 		nz = 0;
 	    }
 	    else
@@ -205,8 +241,9 @@ int VResampler::process (void)
 	}
 	else
 	{
-	    if (out_data)
+	    if (planar ? out_list != 0 : out_data != 0)
 	    {
+		q = planar ? _obuf : out_data;
 		if (nz < 2 * hl)
 		{
 		    k = (unsigned int) ph;
@@ -219,24 +256,14 @@ int VResampler::process (void)
                         _c1 [i] = a * q1 [i] + b * q1 [i + hl];
     		        _c2 [i] = a * q2 [i] + b * q2 [i - hl];
 		    }
-		    for (c = 0; c < _nchan; c++)
-		    {
-			q1 = p1 + c;
-			q2 = p2 + c;
-			a = 1e-25f;
-			for (i = 0; i < hl; i++)
-			{
-			    q2 -= _nchan;
-			    a += *q1 * _c1 [i] + *q2 * _c2 [i];
-			    q1 += _nchan;
-			}
-			*out_data++ = a - 1e-25f;
-		    }
+		    _fir (p1, p2, _c1, _c2, hl, _nchan, 1e-25f, q);
 		}
 		else
 		{
-		    for (c = 0; c < _nchan; c++) *out_data++ = 0;
+		    for (c = 0; c < _nchan; c++) q [c] = 0;
 		}
+		if (planar) for (c = 0; c < _nchan; c++) *out_list [c]++ = q [c];
+		else out_data += _nchan;
 	    }
 	    out_count--;
 
@@ -23,6 +23,7 @@
 
 
 #include "resampler-table.h"
+#include "resampler-kernels.h"
 
 
 class VResampler
@@ -47,6 +48,8 @@ public:
     int    inpsize (void) const;
     double inpdist (void) const;
     int    process (void);
+    int    process_planar (void);
+    int    set_kernel (int isa);
     
     void set_phase (double p);
     void set_rrfilt (double t);
@@ -56,11 +59,13 @@ public:
     unsigned int         out_count;
     float               *inp_data;
     float               *out_data;
-    void                *inp_list;
-    void                *out_list;
+    float              **inp_list;
+    float              **out_list;
 
 private:
 
+    int    process_frames (bool planar);
+
     enum { NPHASE = 256 };
 
     Resampler_table     *_table;
@@ -77,6 +82,8 @@ private:
     float               *_buff;
     float               *_c1;
     float               *_c2;
+    float               *_obuf;
+    Resampler_fir        _fir;
 };
 
 
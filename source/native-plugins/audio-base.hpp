@@ -24,6 +24,8 @@ extern "C" {
 #include "audio_decoder/ad.h"
 }
 
+#include "audio-peaks.hpp"
+
 #include "water/threads/ScopedLock.h"
 #include "water/threads/SpinLock.h"
 
@@ -244,7 +246,8 @@ public:
           fPoolMutex(),
           fPoolReadyToSwap(false),
           fResampler(),
-          fReaderMutex()
+          fReaderMutex(),
+          fPeaks()
     {
         ad_clear_nfo(&fFileNfo);
     }
@@ -257,6 +260,7 @@ public:
     void cleanup()
     {
         fPool.destroy();
+        fPeaks.clear();
         fCurrentBitRate = 0;
         fEntireFileLoaded = false;
 
@@ -352,6 +356,8 @@ public:
         if ((fFileNfo.channels == 1 || fFileNfo.channels == 2) && fFileNfo.frames > 0)
         {
             // valid
+            fPeaks.setFile(filename, fFileNfo.channels);
+
             const uint32_t fileNumFrames = static_cast<uint32_t>(fFileNfo.frames);
             const uint32_t maxPoolNumFrames = sampleRate * 30;
             const bool needsResample = fFileNfo.sample_rate != sampleRate;
@@ -389,13 +395,16 @@ public:
                 ad_close(fFilePtr);
                 fFilePtr = nullptr;
 
-                const float fileNumFramesF = static_cast<float>(fileNumFrames);
-                const float previewDataSizeF = static_cast<float>(previewDataSize);
-                for (uint i=0; i<previewDataSize; ++i)
+                if (! fPeaks.readPreview(previewDataSize, previewData))
                 {
-                    const float stepF = static_cast<float>(i)/previewDataSizeF * fileNumFramesF;
-                    const uint step = carla_fixedValue(0U, fileNumFrames-1U, static_cast<uint>(stepF + 0.5f));
-                    previewData[i] = std::max(std::fabs(fPool.buffer[0][step]), std::fabs(fPool.buffer[1][step]));
+                    const float fileNumFramesF = static_cast<float>(fileNumFrames);
+                    const float previewDataSizeF = static_cast<float>(previewDataSize);
+                    for (uint i=0; i<previewDataSize; ++i)
+                    {
+                        const float stepF = static_cast<float>(i)/previewDataSizeF * fileNumFramesF;
+                        const uint step = carla_fixedValue(0U, fileNumFrames-1U, static_cast<uint>(stepF + 0.5f));
+                        previewData[i] = std::max(std::fabs(fPool.buffer[0][step]), std::fabs(fPool.buffer[1][step]));
+                    }
                 }
             }
             else
@@ -405,7 +414,12 @@ public:
                 const uint pollTempSize = poolNumFrames * fFileNfo.channels;
                 uint resampleTempSize = 0;
 
-                readFilePreview(previewDataSize, previewData);
+                // peaks need a full decode, do it in the background and use a rough preview meanwhile
+                if (! fPeaks.readPreview(previewDataSize, previewData))
+                {
+                    readFilePreview(previewDataSize, previewData);
+                    fPeaks.startBuilding();
+                }
 
                 fPool.create(poolNumFrames, maxFrame, true);
 
@@ -514,6 +528,23 @@ public:
         return ret;
     }
 
+    // true once peaks computed in the background can replace the rough preview from loadFilename
+    bool needsPreviewUpdate() const noexcept
+    {
+        return fPeaks.hasNewPeaks();
+    }
+
+    bool updatePreview(const uint32_t previewDataSize, float* const previewData)
+    {
+        const CarlaMutexLocker cml(fReaderMutex);
+
+        if (! fPeaks.hasNewPeaks())
+            return false;
+
+        fPeaks.takeNewPeaks();
+        return fPeaks.readPreview(previewDataSize, previewData);
+    }
+
     void readFilePreview(uint32_t previewDataSize, float* previewData)
     {
         carla_zeroFloats(previewData, previewDataSize);
@@ -560,6 +591,9 @@ public:
 
         fCurrentBitRate = ad_get_bitrate(fFilePtr);
 
+        if (! fPeaks.isReady())
+            fPeaks.createFromBuffer(buffer, fileNumFrames);
+
         float* rbuffer;
 
         if (needsResample)
@@ -822,6 +856,8 @@ private:
     Resampler     fResampler;
     CarlaMutex    fReaderMutex;
 
+    AudioFilePeaks fPeaks;
+
     // try a pool data swap if possible and relevant
     // NOTE it is assumed that `pool` mutex is locked
     void _tryPoolSwap(AudioFilePool& pool)
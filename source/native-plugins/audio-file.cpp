@@ -344,6 +344,10 @@ protected:
 
         const water::GenericScopedLock<water::SpinLock> gsl(fPool.mutex);
 
+        // peaks built in the background usually finish while stopped, check before any early return
+        if (fReader.needsPreviewUpdate())
+            hostRequestIdle();
+
         if (! fDoProcess)
         {
             // carla_stderr("P: no process");
@@ -566,6 +570,14 @@ protected:
             fNeedsFileRead = false;
         }
 
+        if (fReader.needsPreviewUpdate())
+        {
+            const uint32_t previewDataSize = sizeof(fPreviewData)/sizeof(float);
+
+            if (fReader.updatePreview(previewDataSize, fPreviewData))
+                hostSendPreviewBufferData('f', previewDataSize, fPreviewData);
+        }
+
 #ifndef __MOD_DEVICES__
         if (fInlineDisplay.pending == InlineDisplayNeedRequest)
         {
@@ -0,0 +1,446 @@
+/*
+ * Carla Native Plugins
+ * Copyright (C) 2013-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the GPL.txt file
+ */
+
+#ifndef AUDIO_PEAKS_HPP_INCLUDED
+#define AUDIO_PEAKS_HPP_INCLUDED
+
+#include "CarlaCacheUtils.hpp"
+#include "CarlaMathUtils.hpp"
+#include "CarlaThread.hpp"
+
+extern "C" {
+#include "audio_decoder/ad.h"
+}
+
+#include "water/files/File.h"
+#include "water/memory/Atomic.h"
+#include "water/memory/MemoryBlock.h"
+#include "water/streams/MemoryInputStream.h"
+#include "water/streams/MemoryOutputStream.h"
+
+#include <vector>
+
+// -----------------------------------------------------------------------
+// Multi-resolution min/max peaks of an audio file, used for its waveform preview.
+// The first level has one min/max pair per channel for every 256 frames,
+// each following level combines 4 blocks of the previous one.
+// Peaks are kept in the user cache dir, so files only need to be decoded once for them.
+
+class AudioFilePeaks : private CarlaThread
+{
+public:
+    static const uint kBaseBlockSize = 256;
+    static const uint kLevelFactor = 4;
+
+    AudioFilePeaks()
+        : CarlaThread("AudioFilePeaks"),
+          fFilename(),
+          fFileSize(0),
+          fFileTime(0),
+          fNumChannels(0),
+          fNumFrames(0),
+          fLevels(),
+          fReady(0),
+          fNewlyReady(0) {}
+
+    ~AudioFilePeaks()
+    {
+        clear();
+    }
+
+    // forget the current peaks, stopping a background build if needed
+    void clear()
+    {
+        stopThread(-1);
+
+        fFilename.clear();
+        fFileSize = fFileTime = 0;
+        fNumChannels = 0;
+        fNumFrames = 0;
+        fLevels.clear();
+        fReady = 0;
+        fNewlyReady = 0;
+    }
+
+    // set the file to work with, and load its peaks from the cache if they are still valid
+    bool setFile(const char* const filename, const uint numChannels)
+    {
+        clear();
+
+        const water::File file = water::File(water::CharPointer_UTF8(filename));
+
+        fFilename = file.getFullPathName();
+        fFileSize = file.getSize();
+        fFileTime = file.getLastModificationTime();
+        fNumChannels = numChannels;
+
+        if (! readCache())
+        {
+            fLevels.clear();
+            fNumFrames = 0;
+            return false;
+        }
+
+        fReady = 1;
+        return true;
+    }
+
+    bool isReady() const noexcept
+    {
+        return fReady.get() != 0;
+    }
+
+    // true once peaks computed in the background are ready, until takeNewPeaks() is called
+    bool hasNewPeaks() const noexcept
+    {
+        return fNewlyReady.get() != 0;
+    }
+
+    void takeNewPeaks() noexcept
+    {
+        fNewlyReady = 0;
+    }
+
+    // compute the peaks from the fully decoded file, as interleaved samples
+    void createFromBuffer(const float* const buffer, const uint64_t numFrames)
+    {
+        CARLA_SAFE_ASSERT_RETURN(fNumChannels != 0,);
+        CARLA_SAFE_ASSERT_RETURN(! isThreadRunning(),);
+
+        Builder builder(fNumChannels, fLevels);
+        builder.addFrames(buffer, numFrames);
+        fNumFrames = builder.finish();
+
+        writeCache();
+        fReady = 1;
+    }
+
+    // decode the file in a background thread to compute the peaks
+    bool startBuilding()
+    {
+        CARLA_SAFE_ASSERT_RETURN(fNumChannels != 0, false);
+        CARLA_SAFE_ASSERT_RETURN(fFilename.isNotEmpty(), false);
+        CARLA_SAFE_ASSERT_RETURN(! isThreadRunning(), false);
+
+        return startThread();
+    }
+
+    // absolute peak of each preview point between 'startFrame' and 'startFrame + numFrames'
+    bool readPreview(const uint64_t startFrame, uint64_t numFrames, const uint32_t previewDataSize, float* const previewData) const
+    {
+        CARLA_SAFE_ASSERT_RETURN(previewDataSize != 0, false);
+
+        if (! isReady() || fLevels.empty() || fNumFrames == 0 || startFrame >= fNumFrames)
+            return false;
+
+        if (numFrames > fNumFrames - startFrame)
+            numFrames = fNumFrames - startFrame;
+
+        // use the coarsest level that still has a few blocks per point
+        const uint64_t framesPerPoint = std::max<uint64_t>(1, numFrames / previewDataSize);
+        uint64_t blockSize = kBaseBlockSize;
+        std::size_t level = 0;
+
+        for (; level + 1 < fLevels.size() && blockSize * kLevelFactor <= framesPerPoint; ++level)
+            blockSize *= kLevelFactor;
+
+        const std::vector<int16_t>& blocks(fLevels[level]);
+        const uint64_t numBlocks = blocks.size() / (fNumChannels * 2);
+        CARLA_SAFE_ASSERT_RETURN(numBlocks != 0, false);
+
+        for (uint32_t i=0; i<previewDataSize; ++i)
+        {
+            const uint64_t start = startFrame + numFrames * i / previewDataSize;
+            const uint64_t end   = std::max(start + 1, startFrame + numFrames * (i + 1) / previewDataSize);
+            const uint64_t first = std::min(numBlocks - 1, start / blockSize);
+            const uint64_t last  = std::min(numBlocks - 1, (end - 1) / blockSize);
+            int peak = 0;
+
+            for (const int16_t* it = &blocks[first * fNumChannels * 2],
+                              * const itEnd = &blocks[(last + 1) * fNumChannels * 2 - 1] + 1; it != itEnd; ++it)
+            {
+                peak = std::max(peak, std::abs(static_cast<int>(*it)));
+            }
+
+            previewData[i] = static_cast<float>(peak) / 32767.0f;
+        }
+
+        return true;
+    }
+
+    bool readPreview(const uint32_t previewDataSize, float* const previewData) const
+    {
+        return readPreview(0, fNumFrames, previewDataSize, previewData);
+    }
+
+private:
+    water::String fFilename;
+    water::int64 fFileSize;
+    water::int64 fFileTime;
+    uint fNumChannels;
+    uint64_t fNumFrames;
+
+    // per level, min/max pairs of each channel for each block
+    std::vector<std::vector<int16_t> > fLevels;
+
+    water::Atomic<int> fReady;
+    water::Atomic<int> fNewlyReady;
+
+    static const int kCacheMagic = 0x4b504c43; // "CLPK"
+    static const int kCacheVersion = 1;
+
+    // total size of all peak files, the oldest ones are removed past this
+    static const water::int64 kMaxCacheSize = 256 * 1024 * 1024;
+
+    // accumulates min/max of every block while the file is decoded
+    struct Builder {
+        const uint numChannels;
+        std::vector<std::vector<int16_t> >& levels;
+        std::vector<float> blockMin, blockMax;
+        uint framesInBlock;
+        uint64_t numFrames;
+
+        Builder(const uint numChannels_, std::vector<std::vector<int16_t> >& levels_)
+            : numChannels(numChannels_),
+              levels(levels_),
+              blockMin(numChannels_, 0.0f),
+              blockMax(numChannels_, 0.0f),
+              framesInBlock(0),
+              numFrames(0)
+        {
+            levels.clear();
+            levels.resize(1);
+        }
+
+        void addFrames(const float* buffer, const uint64_t frames)
+        {
+            for (uint64_t i=0; i<frames; ++i)
+            {
+                for (uint c=0; c<numChannels; ++c, ++buffer)
+                {
+                    if (framesInBlock == 0 || *buffer < blockMin[c])
+                        blockMin[c] = *buffer;
+                    if (framesInBlock == 0 || *buffer > blockMax[c])
+                        blockMax[c] = *buffer;
+                }
+
+                if (++framesInBlock == kBaseBlockSize)
+                    flushBlock();
+            }
+
+            numFrames += frames;
+        }
+
+        // returns the number of frames
+        uint64_t finish()
+        {
+            if (framesInBlock != 0)
+                flushBlock();
+
+            // each level combines 4 blocks of the previous one, down to a single block
+            while (levels.back().size() > numChannels * 2)
+            {
+                const std::vector<int16_t>& prev(levels[levels.size() - 1]);
+                const std::size_t prevBlocks = prev.size() / (numChannels * 2);
+                std::vector<int16_t> next;
+                next.reserve((prevBlocks + kLevelFactor - 1) / kLevelFactor * numChannels * 2);
+
+                for (std::size_t b=0; b<prevBlocks; b+=kLevelFactor)
+                {
+                    const std::size_t bEnd = std::min<std::size_t>(prevBlocks, b + kLevelFactor);
+
+                    for (uint c=0; c<numChannels; ++c)
+                    {
+                        int16_t minValue = prev[(b * numChannels + c) * 2];
+                        int16_t maxValue = prev[(b * numChannels + c) * 2 + 1];
+
+                        for (std::size_t b2=b+1; b2<bEnd; ++b2)
+                        {
+                            minValue = std::min(minValue, prev[(b2 * numChannels + c) * 2]);
+                            maxValue = std::max(maxValue, prev[(b2 * numChannels + c) * 2 + 1]);
+                        }
+
+                        next.push_back(minValue);
+                        next.push_back(maxValue);
+                    }
+                }
+
+                levels.push_back(next);
+            }
+
+            return numFrames;
+        }
+
+        void flushBlock()
+        {
+            std::vector<int16_t>& level0(levels.front());
+
+            for (uint c=0; c<numChannels; ++c)
+            {
+                level0.push_back(static_cast<int16_t>(carla_fixedValue(-32767.0f, 32767.0f, std::floor(blockMin[c] * 32767.0f))));
+                level0.push_back(static_cast<int16_t>(carla_fixedValue(-32767.0f, 32767.0f, std::ceil(blockMax[c] * 32767.0f))));
+            }
+
+            framesInBlock = 0;
+        }
+
+        CARLA_DECLARE_NON_COPYABLE(Builder)
+    };
+
+    void run() override
+    {
+        struct adinfo info;
+        ad_clear_nfo(&info);
+
+        void* const handle = ad_open(fFilename.toRawUTF8(), &info);
+        CARLA_SAFE_ASSERT_RETURN(handle != nullptr,);
+
+        if (info.channels != fNumChannels)
+        {
+            carla_stderr2("AudioFilePeaks: channel count changed, not building peaks");
+            ad_close(handle);
+            ad_free_nfo(&info);
+            return;
+        }
+
+        const uint readFrames = 16384;
+        std::vector<float> buffer(readFrames * fNumChannels);
+        std::vector<std::vector<int16_t> > levels;
+        Builder builder(fNumChannels, levels);
+
+        for (; ! shouldThreadExit();)
+        {
+            const ssize_t rv = ad_read(handle, buffer.data(), buffer.size());
+
+            if (rv <= 0)
+                break;
+
+            builder.addFrames(buffer.data(), static_cast<uint64_t>(rv) / fNumChannels);
+        }
+
+        ad_close(handle);
+        ad_free_nfo(&info);
+
+        if (shouldThreadExit())
+            return;
+
+        fNumFrames = builder.finish();
+        fLevels.swap(levels);
+
+        writeCache();
+
+        fReady = 1;
+        fNewlyReady = 1;
+    }
+
+    // -------------------------------------------------------------------
+    // cache file, native byte order
+
+    water::File getCacheFile() const
+    {
+        const uint64_t hash = static_cast<uint64_t>(fFilename.hashCode64());
+
+        return carla_get_cache_directory().getChildFile("peaks").getChildFile(water::String(hash) + ".peaks");
+    }
+
+    bool readCache()
+    {
+        water::MemoryBlock data;
+
+        if (! getCacheFile().loadFileAsData(data))
+            return false;
+
+        water::MemoryInputStream stream(data, false);
+
+        if (stream.readInt() != kCacheMagic || stream.readInt() != kCacheVersion)
+            return false;
+        if (stream.readString() != fFilename)
+            return false;
+        if (stream.readInt64() != fFileSize || stream.readInt64() != fFileTime)
+            return false;
+        if (stream.readInt() != static_cast<int>(fNumChannels))
+            return false;
+
+        const int64_t numFrames = stream.readInt64();
+        const int numLevels = stream.readInt();
+
+        if (numFrames <= 0 || numLevels <= 0 || numLevels > 64)
+            return false;
+
+        fNumFrames = static_cast<uint64_t>(numFrames);
+        fLevels.resize(static_cast<std::size_t>(numLevels));
+
+        for (int i=0; i<numLevels; ++i)
+        {
+            const int numValues = stream.readInt();
+
+            if (numValues <= 0 || numValues % (fNumChannels * 2) != 0)
+                return false;
+
+            const int numBytes = numValues * static_cast<int>(sizeof(int16_t));
+
+            if (stream.getNumBytesRemaining() < numBytes)
+                return false;
+
+            fLevels[i].resize(static_cast<std::size_t>(numValues));
+
+            if (stream.read(fLevels[i].data(), numBytes) != numBytes)
+                return false;
+        }
+
+        return true;
+    }
+
+    void writeCache() const
+    {
+        water::MemoryOutputStream stream;
+
+        stream.writeInt(kCacheMagic);
+        stream.writeInt(kCacheVersion);
+        stream.writeString(fFilename);
+        stream.writeInt64(fFileSize);
+        stream.writeInt64(fFileTime);
+        stream.writeInt(static_cast<int>(fNumChannels));
+        stream.writeInt64(static_cast<int64_t>(fNumFrames));
+        stream.writeInt(static_cast<int>(fLevels.size()));
+
+        for (std::size_t i=0; i<fLevels.size(); ++i)
+        {
+            stream.writeInt(static_cast<int>(fLevels[i].size()));
+            stream.write(fLevels[i].data(), fLevels[i].size() * sizeof(int16_t));
+        }
+
+        const water::File cacheFile(getCacheFile());
+
+        if (! cacheFile.getParentDirectory().createDirectory())
+            return;
+
+        if (! cacheFile.replaceWithData(stream.getData(), stream.getDataSize()))
+        {
+            carla_stderr("AudioFilePeaks: failed to write '%s'", cacheFile.getFullPathName().toRawUTF8());
+            return;
+        }
+
+        carla_trim_cache_directory(cacheFile.getParentDirectory(), "*.peaks", kMaxCacheSize);
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(AudioFilePeaks)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // AUDIO_PEAKS_HPP_INCLUDED
@@ -0,0 +1,671 @@
+/*
+ * Carla batch offline renderer
+ * Copyright (C) 2011-2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Renders many independent jobs, each one being a project plus optional parameter changes.
+// Every job runs in its own process with its own Dummy engine, so jobs cannot affect each other
+// and a crashing plugin only fails its own job. At most N jobs run at once, N defaults to the number of CPUs.
+
+#include "CarlaHost.h"
+
+#include "CarlaString.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// --------------------------------------------------------------------------------------------------------------------
+
+struct RenderParameter {
+    uint pluginId;
+    uint32_t parameterId;
+    float value;
+};
+
+struct RenderJob {
+    CarlaString project;
+    CarlaString output;
+    double startSecs;
+    double lengthSecs;
+    std::vector<RenderParameter> parameters;
+
+    RenderJob()
+        : project(),
+          output(),
+          startSecs(-1.0),
+          lengthSecs(-1.0),
+          parameters() {}
+};
+
+struct RenderOptions {
+    EngineProcessMode processMode;
+    uint bufferSize;
+    uint sampleRate;
+    uint maxJobs;
+    double startSecs;
+    double lengthSecs;
+    const char* format;
+    const char* outputDir;
+    bool verbose;
+
+    RenderOptions()
+        : processMode(ENGINE_PROCESS_MODE_CONTINUOUS_RACK),
+          bufferSize(512),
+          sampleRate(48000),
+          maxJobs(0),
+          startSecs(0.0),
+          lengthSecs(0.0),
+          format("wav"),
+          outputDir(nullptr),
+          verbose(false) {}
+};
+
+// result written by a job process into its pipe, read by the main process once the job has finished
+struct RenderJobResult {
+    bool ok;
+    uint64_t frames;
+    uint64_t loadTimeUs;
+    uint64_t renderTimeUs;
+    char error[256];
+};
+
+struct RunningJob {
+    pid_t pid;
+    int pipeFd;
+    uint index;
+    uint64_t startTimeUs;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static void printUsage(const char* const progname)
+{
+    std::fprintf(stderr,
+        "usage: %s [options] project.carxp...\n"
+        "       %s [options] --jobs-file FILE\n"
+        "\n"
+        "Renders each project (or each line of the jobs file) into an audio file, running one\n"
+        "isolated engine per job and up to --jobs engines at the same time.\n"
+        "\n"
+        "options:\n"
+        "  -j, --jobs N         maximum number of jobs running at once (default: number of CPUs)\n"
+        "  -f, --jobs-file FILE read jobs from FILE, one per line\n"
+        "  -o, --output-dir DIR folder for outputs not set explicitly (default: next to the project)\n"
+        "  --format wav|flac    format for outputs not set explicitly (default: wav)\n"
+        "  --start SECS         transport position to start rendering from (default: 0)\n"
+        "  --length SECS        length to render, required unless set per job\n"
+        "  --buffer-size N      engine buffer size (default: 512)\n"
+        "  --sample-rate N      engine sample rate (default: 48000)\n"
+        "  --patchbay           use patchbay process mode instead of rack\n"
+        "  -v, --verbose        show engine output of each job\n"
+        "\n"
+        "jobs file syntax, '#' starts a comment:\n"
+        "  project.carxp [output=FILE] [start=SECS] [length=SECS] [param=PLUGIN:INDEX:VALUE]...\n"
+        "\n"
+        "one JSON line is printed per finished job, exit status is non-zero if any job failed.\n",
+        progname, progname);
+}
+
+static bool parseSeconds(const char* const str, double& secs)
+{
+    char* end = nullptr;
+    const double value = std::strtod(str, &end);
+
+    if (end == str || *end != '\0' || value < 0.0)
+        return false;
+
+    secs = value;
+    return true;
+}
+
+static bool parseUInt(const char* const str, uint& ret)
+{
+    char* end = nullptr;
+    const long value = std::strtol(str, &end, 10);
+
+    if (end == str || *end != '\0' || value <= 0)
+        return false;
+
+    ret = static_cast<uint>(value);
+    return true;
+}
+
+static bool parseParameter(const char* const str, RenderParameter& param)
+{
+    uint pluginId, parameterId;
+    float value;
+    char extra;
+
+    if (std::sscanf(str, "%u:%u:%f%c", &pluginId, &parameterId, &value, &extra) != 3)
+        return false;
+
+    param.pluginId    = pluginId;
+    param.parameterId = parameterId;
+    param.value       = value;
+    return true;
+}
+
+static void writeJsonString(const char* const str)
+{
+    std::putchar('"');
+
+    for (const char* s = str; *s != '\0'; ++s)
+    {
+        switch (*s)
+        {
+        case '"':  std::fputs("\\\"", stdout); break;
+        case '\\': std::fputs("\\\\", stdout); break;
+        case '\n': std::fputs("\\n", stdout); break;
+        case '\t': std::fputs("\\t", stdout); break;
+        default:
+            if (static_cast<uchar>(*s) < 0x20)
+                std::printf("\\u%04x", static_cast<uint>(static_cast<uchar>(*s)));
+            else
+                std::putchar(*s);
+            break;
+        }
+    }
+
+    std::putchar('"');
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// jobs file
+
+static bool parseJobLine(char* const line, const uint lineNumber, RenderJob& job)
+{
+    bool hasProject = false;
+
+    for (char* token = std::strtok(line, " \t\r\n"); token != nullptr; token = std::strtok(nullptr, " \t\r\n"))
+    {
+        if (token[0] == '#')
+            break;
+
+        bool valid = true;
+
+        if (std::strncmp(token, "output=", 7) == 0)
+        {
+            job.output = token + 7;
+            valid = job.output.isNotEmpty();
+        }
+        else if (std::strncmp(token, "start=", 6) == 0)
+        {
+            valid = parseSeconds(token + 6, job.startSecs);
+        }
+        else if (std::strncmp(token, "length=", 7) == 0)
+        {
+            valid = parseSeconds(token + 7, job.lengthSecs) && job.lengthSecs > 0.0;
+        }
+        else if (std::strncmp(token, "param=", 6) == 0)
+        {
+            RenderParameter param;
+            valid = parseParameter(token + 6, param);
+
+            if (valid)
+                job.parameters.push_back(param);
+        }
+        else if (! hasProject && std::strchr(token, '=') == nullptr)
+        {
+            job.project = token;
+            hasProject = true;
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (! valid)
+        {
+            std::fprintf(stderr, "jobs file line %u: invalid argument '%s'\n", lineNumber, token);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool readJobsFile(const char* const filename, std::vector<RenderJob>& jobs)
+{
+    FILE* const file = std::fopen(filename, "r");
+
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "failed to open jobs file '%s'\n", filename);
+        return false;
+    }
+
+    char line[4096];
+    uint lineNumber = 0;
+    bool ok = true;
+
+    while (std::fgets(line, sizeof(line), file) != nullptr)
+    {
+        ++lineNumber;
+
+        RenderJob job;
+
+        if (! parseJobLine(line, lineNumber, job))
+        {
+            ok = false;
+            break;
+        }
+
+        // empty or comment line
+        if (job.project.isEmpty() && job.output.isEmpty() && job.parameters.empty())
+            continue;
+
+        if (job.project.isEmpty())
+        {
+            std::fprintf(stderr, "jobs file line %u: missing project\n", lineNumber);
+            ok = false;
+            break;
+        }
+
+        jobs.push_back(job);
+    }
+
+    std::fclose(file);
+    return ok;
+}
+
+// pick output filenames for jobs that did not set one, adding the job number when a project is used more than once
+static void setDefaultOutputs(std::vector<RenderJob>& jobs, const RenderOptions& options)
+{
+    for (std::size_t i=0; i < jobs.size(); ++i)
+    {
+        RenderJob& job(jobs[i]);
+
+        if (job.output.isNotEmpty())
+            continue;
+
+        bool projectIsShared = false;
+
+        for (std::size_t j=0; j < jobs.size() && ! projectIsShared; ++j)
+            projectIsShared = i != j && job.project == jobs[j].project;
+
+        CarlaString basename(job.project);
+
+        if (options.outputDir != nullptr)
+        {
+            const char* const slash = std::strrchr(job.project.buffer(), '/');
+            basename  = options.outputDir;
+            basename += "/";
+            basename += slash != nullptr ? slash + 1 : job.project.buffer();
+        }
+
+        bool hasDot, hasSlash;
+        const std::size_t dotPos = basename.rfind('.', &hasDot);
+        const std::size_t slashPos = basename.rfind('/', &hasSlash);
+
+        if (hasDot && dotPos > 0 && (! hasSlash || dotPos > slashPos + 1))
+            basename.truncate(dotPos);
+
+        if (projectIsShared)
+        {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "-%03u", static_cast<uint>(i + 1));
+            basename += suffix;
+        }
+
+        basename += ".";
+        basename += options.format;
+        job.output = basename;
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// job process
+
+static bool runJob(const RenderJob& job, const RenderOptions& options, RenderJobResult& result)
+{
+    const CarlaHostHandle handle = carla_standalone_host_init();
+
+    if (handle == nullptr)
+    {
+        std::snprintf(result.error, sizeof(result.error), "failed to create host");
+        return false;
+    }
+
+    carla_set_engine_option(handle, ENGINE_OPTION_PROCESS_MODE, options.processMode, nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_TRANSPORT_MODE, ENGINE_TRANSPORT_MODE_INTERNAL, nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_BUFFER_SIZE, static_cast<int>(options.bufferSize), nullptr);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_SAMPLE_RATE, static_cast<int>(options.sampleRate), nullptr);
+
+    if (! carla_engine_init(handle, "Dummy", "carla-render"))
+    {
+        std::snprintf(result.error, sizeof(result.error), "engine init failed: %s", carla_get_last_error(handle));
+        return false;
+    }
+
+    const uint64_t loadStartTime = carla_gettime_us();
+    bool ok = carla_load_project(handle, job.project);
+
+    if (! ok)
+        std::snprintf(result.error, sizeof(result.error), "failed to load project: %s", carla_get_last_error(handle));
+
+    for (std::size_t i=0; ok && i < job.parameters.size(); ++i)
+    {
+        const RenderParameter& param(job.parameters[i]);
+
+        if (param.pluginId >= carla_get_current_plugin_count(handle) ||
+            param.parameterId >= carla_get_parameter_count(handle, param.pluginId))
+        {
+            std::snprintf(result.error, sizeof(result.error), "invalid parameter %u:%u",
+                          param.pluginId, param.parameterId);
+            ok = false;
+            break;
+        }
+
+        carla_set_parameter_value(handle, param.pluginId, param.parameterId, param.value);
+    }
+
+    // let postponed events and plugin idle run once before rendering
+    if (ok)
+        carla_engine_idle(handle);
+
+    result.loadTimeUs = carla_gettime_us() - loadStartTime;
+
+    if (ok)
+    {
+        const double startSecs  = job.startSecs  >= 0.0 ? job.startSecs  : options.startSecs;
+        const double lengthSecs = job.lengthSecs >= 0.0 ? job.lengthSecs : options.lengthSecs;
+        const uint64_t startFrame = static_cast<uint64_t>(startSecs * options.sampleRate + 0.5);
+
+        result.frames = static_cast<uint64_t>(lengthSecs * options.sampleRate + 0.5);
+
+        const uint64_t renderStartTime = carla_gettime_us();
+        ok = carla_engine_render_to_file(handle, job.output, startFrame, result.frames);
+        result.renderTimeUs = carla_gettime_us() - renderStartTime;
+
+        if (! ok)
+            std::snprintf(result.error, sizeof(result.error), "render failed: %s", carla_get_last_error(handle));
+    }
+
+    carla_engine_close(handle);
+    return ok;
+}
+
+static pid_t startJob(const RenderJob& job, const RenderOptions& options, int& pipeFd)
+{
+    int fds[2];
+
+    if (pipe(fds) != 0)
+        return -1;
+
+    const pid_t pid = fork();
+
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+
+        if (! options.verbose)
+        {
+            const int devnull = open("/dev/null", O_WRONLY);
+
+            if (devnull >= 0)
+            {
+                dup2(devnull, STDOUT_FILENO);
+                dup2(devnull, STDERR_FILENO);
+                close(devnull);
+            }
+        }
+        else
+        {
+            // keep the JSON results on stdout clean
+            dup2(STDERR_FILENO, STDOUT_FILENO);
+        }
+
+        RenderJobResult result;
+        carla_zeroStruct(result);
+        result.ok = runJob(job, options, result);
+
+        const ssize_t written = write(fds[1], &result, sizeof(result));
+        close(fds[1]);
+        _exit(written == static_cast<ssize_t>(sizeof(result)) && result.ok ? 0 : 1);
+    }
+
+    close(fds[1]);
+    pipeFd = fds[0];
+    return pid;
+}
+
+static bool finishJob(const RenderJob& job, const RenderOptions& options, const RunningJob& running, const int status)
+{
+    RenderJobResult result;
+    carla_zeroStruct(result);
+
+    const ssize_t r = read(running.pipeFd, &result, sizeof(result));
+    close(running.pipeFd);
+
+    if (r != static_cast<ssize_t>(sizeof(result)))
+    {
+        result.ok = false;
+
+        if (WIFSIGNALED(status))
+            std::snprintf(result.error, sizeof(result.error), "job crashed with signal %i", WTERMSIG(status));
+        else
+            std::snprintf(result.error, sizeof(result.error), "job exited with status %i", WEXITSTATUS(status));
+    }
+
+    const double wallMs   = static_cast<double>(carla_gettime_us() - running.startTimeUs) / 1000.0;
+    const double renderMs = static_cast<double>(result.renderTimeUs) / 1000.0;
+    const double lengthMs = static_cast<double>(result.frames) * 1000.0 / options.sampleRate;
+
+    std::printf("{\"job\":%u,\"project\":", running.index + 1);
+    writeJsonString(job.project);
+    std::printf(",\"output\":");
+    writeJsonString(job.output);
+    std::printf(",\"ok\":%s,\"frames\":" P_UINT64 ",\"wall_ms\":%.1f,\"load_ms\":%.1f,\"render_ms\":%.1f",
+                result.ok ? "true" : "false",
+                result.frames,
+                wallMs,
+                static_cast<double>(result.loadTimeUs) / 1000.0,
+                renderMs);
+
+    if (result.ok)
+        std::printf(",\"speed\":%.2f}\n", renderMs > 0.0 ? lengthMs / renderMs : 0.0);
+    else
+    {
+        std::printf(",\"error\":");
+        result.error[sizeof(result.error)-1] = '\0';
+        writeJsonString(result.error);
+        std::printf("}\n");
+    }
+
+    std::fflush(stdout);
+    return result.ok;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    RenderOptions options;
+    std::vector<RenderJob> jobs;
+    const char* jobsFile = nullptr;
+
+    for (int i=1; i < argc; ++i)
+    {
+        const char* const arg = argv[i];
+        const char* const next = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool valid = true;
+
+        if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--help") == 0)
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (std::strcmp(arg, "-v") == 0 || std::strcmp(arg, "--verbose") == 0)
+        {
+            options.verbose = true;
+        }
+        else if (std::strcmp(arg, "--patchbay") == 0)
+        {
+            options.processMode = ENGINE_PROCESS_MODE_PATCHBAY;
+        }
+        else if (arg[0] == '-')
+        {
+            if (next == nullptr)
+            {
+                std::fprintf(stderr, "missing value for '%s'\n", arg);
+                return 1;
+            }
+
+            ++i;
+
+            if (std::strcmp(arg, "-j") == 0 || std::strcmp(arg, "--jobs") == 0)
+                valid = parseUInt(next, options.maxJobs);
+            else if (std::strcmp(arg, "-f") == 0 || std::strcmp(arg, "--jobs-file") == 0)
+                jobsFile = next;
+            else if (std::strcmp(arg, "-o") == 0 || std::strcmp(arg, "--output-dir") == 0)
+                options.outputDir = next;
+            else if (std::strcmp(arg, "--format") == 0)
+            {
+                options.format = next;
+                valid = std::strcmp(next, "wav") == 0 || std::strcmp(next, "flac") == 0;
+            }
+            else if (std::strcmp(arg, "--start") == 0)
+                valid = parseSeconds(next, options.startSecs);
+            else if (std::strcmp(arg, "--length") == 0)
+                valid = parseSeconds(next, options.lengthSecs) && options.lengthSecs > 0.0;
+            else if (std::strcmp(arg, "--buffer-size") == 0)
+                valid = parseUInt(next, options.bufferSize);
+            else if (std::strcmp(arg, "--sample-rate") == 0)
+                valid = parseUInt(next, options.sampleRate);
+            else
+            {
+                std::fprintf(stderr, "unknown option '%s'\n", arg);
+                return 1;
+            }
+
+            if (! valid)
+            {
+                std::fprintf(stderr, "invalid value '%s' for '%s'\n", next, arg);
+                return 1;
+            }
+        }
+        else
+        {
+            RenderJob job;
+            job.project = arg;
+            jobs.push_back(job);
+        }
+    }
+
+    if (jobsFile != nullptr && ! readJobsFile(jobsFile, jobs))
+        return 1;
+
+    if (jobs.empty())
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    for (std::size_t i=0; i < jobs.size(); ++i)
+    {
+        if (jobs[i].lengthSecs < 0.0 && options.lengthSecs <= 0.0)
+        {
+            std::fprintf(stderr, "no length set for job %u, use --length or length= in the jobs file\n",
+                         static_cast<uint>(i + 1));
+            return 1;
+        }
+    }
+
+    setDefaultOutputs(jobs, options);
+
+    if (options.maxJobs == 0)
+        options.maxJobs = carla_get_cpu_count();
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // job pool
+
+    std::vector<RunningJob> running;
+    uint nextJob = 0, numFailed = 0;
+    const uint64_t startTime = carla_gettime_us();
+
+    while (nextJob < jobs.size() || ! running.empty())
+    {
+        while (nextJob < jobs.size() && running.size() < options.maxJobs)
+        {
+            RunningJob job;
+            job.index = nextJob++;
+            job.startTimeUs = carla_gettime_us();
+            job.pid = startJob(jobs[job.index], options, job.pipeFd);
+
+            if (job.pid < 0)
+            {
+                std::fprintf(stderr, "failed to start job %u: %s\n", job.index + 1, std::strerror(errno));
+                ++numFailed;
+                continue;
+            }
+
+            running.push_back(job);
+        }
+
+        if (running.empty())
+            continue;
+
+        int status = 0;
+        const pid_t pid = waitpid(-1, &status, 0);
+
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            std::fprintf(stderr, "waitpid failed: %s\n", std::strerror(errno));
+            return 1;
+        }
+
+        for (std::vector<RunningJob>::iterator it = running.begin(); it != running.end(); ++it)
+        {
+            if (it->pid != pid)
+                continue;
+
+            if (! finishJob(jobs[it->index], options, *it, status))
+                ++numFailed;
+
+            running.erase(it);
+            break;
+        }
+    }
+
+    std::fprintf(stderr, "rendered %u of %u jobs in %.2fs using up to %u engines\n",
+                 static_cast<uint>(jobs.size()) - numFailed, static_cast<uint>(jobs.size()),
+                 static_cast<double>(carla_gettime_us() - startTime) / 1000000.0,
+                 options.maxJobs);
+
+    return numFailed == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
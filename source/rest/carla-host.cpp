@@ -156,6 +156,26 @@ void handle_carla_set_engine_about_to_close(const std::shared_ptr<Session> sessi
     session->close(OK, buf, { { "Content-Length", size_buf(buf) } } );
 }
 
+void handle_carla_get_engine_cycle_stats(const std::shared_ptr<Session> session)
+{
+    // already in JSON format
+    const char* const buf = carla_get_engine_cycle_stats();
+    session->close(OK, buf, { { "Content-Length", size_buf(buf) } } );
+}
+
+void handle_carla_clear_engine_cycle_stats(const std::shared_ptr<Session> session)
+{
+    carla_clear_engine_cycle_stats();
+    session->close(OK);
+}
+
+void handle_carla_get_engine_thread_placement(const std::shared_ptr<Session> session)
+{
+    // already in JSON format
+    const char* const buf = carla_get_engine_thread_placement();
+    session->close(OK, buf, { { "Content-Length", size_buf(buf) } } );
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 void handle_carla_set_engine_option(const std::shared_ptr<Session> session)
@@ -908,6 +928,34 @@ void handle_carla_get_output_peak_value(const std::shared_ptr<Session> session)
     session->close(OK, buf, { { "Content-Length", size_buf(buf) } } );
 }
 
+void handle_carla_get_plugin_timing_info(const std::shared_ptr<Session> session)
+{
+    const std::shared_ptr<const Request> request = session->get_request();
+
+    const int pluginId = std::atoi(request->get_query_parameter("pluginId").c_str());
+    CARLA_SAFE_ASSERT_RETURN(pluginId >= 0,)
+
+    const CarlaPluginTimingInfo* const info = carla_get_plugin_timing_info(pluginId);
+
+    char* jsonBuf;
+    jsonBuf = json_buf_start();
+    jsonBuf = json_buf_add_uint(jsonBuf, "cycles", info->cycles);
+    jsonBuf = json_buf_add_float(jsonBuf, "min", info->min);
+    jsonBuf = json_buf_add_float(jsonBuf, "avg", info->avg);
+    jsonBuf = json_buf_add_float(jsonBuf, "max", info->max);
+    jsonBuf = json_buf_add_float(jsonBuf, "p95", info->p95);
+    jsonBuf = json_buf_add_float(jsonBuf, "p99", info->p99);
+
+    const char* const buf = json_buf_end(jsonBuf);
+    session->close(OK, buf, { { "Content-Length", size_buf(buf) } } );
+}
+
+void handle_carla_clear_plugin_timings(const std::shared_ptr<Session> session)
+{
+    carla_clear_plugin_timings();
+    session->close(OK);
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 void handle_carla_set_active(const std::shared_ptr<Session> session)
@@ -336,6 +336,9 @@ int main(int, const char**)
     make_resource(service, "/engine_close", handle_carla_engine_close);
     make_resource(service, "/is_engine_running", handle_carla_is_engine_running);
     make_resource(service, "/set_engine_about_to_close", handle_carla_set_engine_about_to_close);
+    make_resource(service, "/get_engine_cycle_stats", handle_carla_get_engine_cycle_stats);
+    make_resource(service, "/clear_engine_cycle_stats", handle_carla_clear_engine_cycle_stats);
+    make_resource(service, "/get_engine_thread_placement", handle_carla_get_engine_thread_placement);
 
     make_resource(service, "/set_engine_option", handle_carla_set_engine_option);
     make_resource(service, "/load_file", handle_carla_load_file);
@@ -400,6 +403,8 @@ int main(int, const char**)
     make_resource(service, "/get_internal_parameter_value", handle_carla_get_internal_parameter_value);
     make_resource(service, "/get_input_peak_value", handle_carla_get_input_peak_value);
     make_resource(service, "/get_output_peak_value", handle_carla_get_output_peak_value);
+    make_resource(service, "/get_plugin_timing_info", handle_carla_get_plugin_timing_info);
+    make_resource(service, "/clear_plugin_timings", handle_carla_clear_plugin_timings);
 
     make_resource(service, "/set_active", handle_carla_set_active);
     make_resource(service, "/set_drywet", handle_carla_set_drywet);
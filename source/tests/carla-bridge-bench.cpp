@@ -0,0 +1,207 @@
+/*
+ * Carla plugin bridge round-trip benchmark
+ * Copyright (C) 2026 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaBridgeUtils.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkResult {
+    double minUs;
+    double medianUs;
+    double p99Us;
+    double maxUs;
+    uint timeouts;
+};
+
+static void busyWait(const uint usecs) noexcept
+{
+    if (usecs == 0)
+        return;
+
+    const uint64_t end = carla_gettime_ns() + usecs * 1000ULL;
+
+    while (carla_gettime_ns() < end) {}
+}
+
+/* Client side, as in the bridge process: wait for the server, read all opcodes, do some fake work, reply. */
+static int runClient(const char* const basename, const uint spinTime, const uint workTime)
+{
+    BridgeRtClientControl control;
+
+    if (! control.attachClient(basename) || ! control.mapData())
+        return 1;
+
+    control.setSpinWaitTime(spinTime);
+
+    for (bool quit = false; ! quit;)
+    {
+        const BridgeRtClientControl::WaitHelper helper(control);
+
+        if (! helper.ok)
+            continue;
+
+        for (; control.isDataAvailableForReading();)
+        {
+            if (control.readOpcode() == kPluginBridgeRtClientQuit)
+                quit = true;
+        }
+
+        busyWait(workTime);
+    }
+
+    control.unmapData();
+    control.clear();
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool runBenchmark(const uint spinTime, const uint workTime, const uint iterations, BenchmarkResult& result)
+{
+    BridgeRtClientControl control;
+
+    if (! control.initializeServer())
+        return false;
+
+    control.setSpinWaitTime(spinTime);
+
+    const pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        // the client gets the random part of the shared memory name, as the bridge does
+        _exit(runClient(&control.filename[control.filename.length()-6], spinTime, workTime));
+    }
+
+    if (pid < 0)
+    {
+        control.clear();
+        return false;
+    }
+
+    std::vector<uint64_t> times;
+    times.reserve(iterations);
+    result.timeouts = 0;
+
+    // first round-trips include the client startup, not measured
+    for (uint i = 0; i < iterations + 100; ++i)
+    {
+        const uint64_t startTime = carla_gettime_ns();
+
+        control.writeOpcode(kPluginBridgeRtClientNull);
+        control.commitWrite();
+
+        if (! control.waitForClient(2000))
+        {
+            ++result.timeouts;
+            continue;
+        }
+
+        if (i >= 100)
+            times.push_back(carla_gettime_ns() - startTime);
+    }
+
+    control.writeOpcode(kPluginBridgeRtClientQuit);
+    control.commitWrite();
+    control.waitForClient(2000);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    control.clear();
+
+    if (times.empty())
+        return false;
+
+    std::sort(times.begin(), times.end());
+
+    result.minUs    = static_cast<double>(times.front()) / 1000.0;
+    result.medianUs = static_cast<double>(times[times.size() / 2]) / 1000.0;
+    result.p99Us    = static_cast<double>(times[std::min(times.size() - 1, times.size() * 99 / 100)]) / 1000.0;
+    result.maxUs    = static_cast<double>(times.back()) / 1000.0;
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::vector<uint> spinTimes;
+    uint iterations = 10000;
+    uint workTime = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = static_cast<uint>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (std::strcmp(argv[i], "--work") == 0 && i + 1 < argc)
+        {
+            workTime = static_cast<uint>(std::max(0, std::atoi(argv[++i])));
+        }
+        else if (std::strcmp(argv[i], "0") == 0 || std::atoi(argv[i]) > 0)
+        {
+            spinTimes.push_back(static_cast<uint>(std::atoi(argv[i])));
+        }
+        else
+        {
+            std::fprintf(stderr,
+                         "usage: %s [--iterations N] [--work USECS] [SPIN-USECS...]\n"
+                         "Measures the time of a process cycle round-trip between host and bridge.\n"
+                         "Results are written as one JSON object per line.\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    if (spinTimes.empty())
+    {
+        static const uint kDefaultSpinTimes[] = { 0, 10, 50, 200 };
+        spinTimes.assign(kDefaultSpinTimes, kDefaultSpinTimes + sizeof(kDefaultSpinTimes)/sizeof(kDefaultSpinTimes[0]));
+    }
+
+    for (std::vector<uint>::const_iterator spinTime = spinTimes.begin(); spinTime != spinTimes.end(); ++spinTime)
+    {
+        BenchmarkResult result;
+
+        if (! runBenchmark(*spinTime, workTime, iterations, result))
+        {
+            std::fprintf(stderr, "benchmark failed for spin time %u\n", *spinTime);
+            return 1;
+        }
+
+        std::printf("{\"spin_us\":%u,\"work_us\":%u,\"iterations\":%u,\"timeouts\":%u,"
+                    "\"min_us\":%.2f,\"median_us\":%.2f,\"p99_us\":%.2f,\"max_us\":%.2f}\n",
+                    *spinTime, workTime, iterations, result.timeouts,
+                    result.minUs, result.medianUs, result.p99Us, result.maxUs);
+        std::fflush(stdout);
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
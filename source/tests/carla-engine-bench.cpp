@@ -0,0 +1,516 @@
+/*
+ * Carla engine benchmark, using a free-running Dummy engine
+ * Copyright (C) 2026 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaHost.h"
+
+#include "CarlaString.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// --------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkOptions {
+    std::vector<EngineProcessMode> modes;
+    std::vector<uint> bufferSizes;
+    std::vector<uint> pluginCounts;
+    std::vector<CarlaString> plugins;
+    uint sampleRate;
+    uint midiEventsPerCycle;
+    uint durationMs;
+    uint warmupMs;
+    int tailSamples;
+    bool doublePrecision;
+    const char* outputFilename;
+
+    BenchmarkOptions()
+        : modes(),
+          bufferSizes(),
+          pluginCounts(),
+          plugins(),
+          sampleRate(48000),
+          midiEventsPerCycle(16),
+          durationMs(1000),
+          warmupMs(200),
+          tailSamples(-1),
+          doublePrecision(false),
+          outputFilename(nullptr) {}
+};
+
+struct BenchmarkResult {
+    uint64_t cycles;
+    double nsPerBlock;
+    double nsPerPlugin;
+    double eventsPerSecond;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static std::vector<CarlaString> splitString(const char* const str)
+{
+    std::vector<CarlaString> ret;
+    CarlaString current;
+
+    for (const char* s = str;; ++s)
+    {
+        if (*s == ',' || *s == '\0')
+        {
+            if (current.isNotEmpty())
+                ret.push_back(current);
+
+            current.clear();
+
+            if (*s == '\0')
+                break;
+
+            continue;
+        }
+
+        const char tmp[2] = { *s, '\0' };
+        current += tmp;
+    }
+
+    return ret;
+}
+
+static std::vector<uint> splitNumbers(const char* const str)
+{
+    std::vector<uint> ret;
+    const std::vector<CarlaString> values(splitString(str));
+
+    for (std::vector<CarlaString>::const_iterator it = values.begin(); it != values.end(); ++it)
+    {
+        const int value = std::atoi(it->buffer());
+
+        if (value > 0)
+            ret.push_back(static_cast<uint>(value));
+    }
+
+    return ret;
+}
+
+static void printUsage(const char* const argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --modes LIST          process modes to test, rack and/or patchbay (default: rack,patchbay)\n"
+                 "  --buffer-sizes LIST   buffer sizes to sweep (default: 64,256,1024)\n"
+                 "  --plugin-counts LIST  number of plugins to sweep (default: 1,8,32)\n"
+                 "  --plugins LIST        internal plugin labels or .jsfx files, loaded in round-robin order\n"
+                 "                        (default: audiogain_s,bypass,midithrough,lfo)\n"
+                 "  --sample-rate N       sample rate (default: 48000)\n"
+                 "  --midi-events N       MIDI events injected per cycle (default: 16)\n"
+                 "  --duration MS         measurement time per run (default: 1000)\n"
+                 "  --warmup MS           time to run before measuring (default: 200)\n"
+                 "  --tail N              plugin tail in samples, lets plugins sleep on silent input\n"
+                 "                        (default: use the plugin's own tail)\n"
+                 "  --double 0|1          process the patchbay in double precision (default: 0)\n"
+                 "  --output FILE         write results to FILE instead of stdout\n"
+                 "\n"
+                 "Results are written as one JSON object per line.\n",
+                 argv0);
+}
+
+static bool parseArgs(const int argc, char* argv[], BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* const arg = argv[i];
+
+        if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--help") == 0)
+            return false;
+
+        if (i + 1 >= argc)
+        {
+            std::fprintf(stderr, "missing value for '%s'\n", arg);
+            return false;
+        }
+
+        const char* const value = argv[++i];
+
+        if (std::strcmp(arg, "--modes") == 0)
+        {
+            const std::vector<CarlaString> modes(splitString(value));
+
+            for (std::vector<CarlaString>::const_iterator it = modes.begin(); it != modes.end(); ++it)
+            {
+                if (*it == "rack")
+                {
+                    options.modes.push_back(ENGINE_PROCESS_MODE_CONTINUOUS_RACK);
+                }
+                else if (*it == "patchbay")
+                {
+                    options.modes.push_back(ENGINE_PROCESS_MODE_PATCHBAY);
+                }
+                else
+                {
+                    std::fprintf(stderr, "invalid process mode '%s'\n", it->buffer());
+                    return false;
+                }
+            }
+        }
+        else if (std::strcmp(arg, "--buffer-sizes") == 0)
+            options.bufferSizes = splitNumbers(value);
+        else if (std::strcmp(arg, "--plugin-counts") == 0)
+            options.pluginCounts = splitNumbers(value);
+        else if (std::strcmp(arg, "--plugins") == 0)
+            options.plugins = splitString(value);
+        else if (std::strcmp(arg, "--sample-rate") == 0)
+            options.sampleRate = static_cast<uint>(std::max(1, std::atoi(value)));
+        else if (std::strcmp(arg, "--midi-events") == 0)
+            options.midiEventsPerCycle = static_cast<uint>(std::max(0, std::atoi(value)));
+        else if (std::strcmp(arg, "--duration") == 0)
+            options.durationMs = static_cast<uint>(std::max(1, std::atoi(value)));
+        else if (std::strcmp(arg, "--warmup") == 0)
+            options.warmupMs = static_cast<uint>(std::max(0, std::atoi(value)));
+        else if (std::strcmp(arg, "--tail") == 0)
+            options.tailSamples = std::max(-1, std::atoi(value));
+        else if (std::strcmp(arg, "--double") == 0)
+            options.doublePrecision = std::atoi(value) != 0;
+        else if (std::strcmp(arg, "--output") == 0)
+            options.outputFilename = value;
+        else
+        {
+            std::fprintf(stderr, "unknown option '%s'\n", arg);
+            return false;
+        }
+    }
+
+    if (options.modes.empty())
+    {
+        options.modes.push_back(ENGINE_PROCESS_MODE_CONTINUOUS_RACK);
+        options.modes.push_back(ENGINE_PROCESS_MODE_PATCHBAY);
+    }
+
+    if (options.bufferSizes.empty())
+    {
+        options.bufferSizes.push_back(64);
+        options.bufferSizes.push_back(256);
+        options.bufferSizes.push_back(1024);
+    }
+
+    if (options.pluginCounts.empty())
+    {
+        options.pluginCounts.push_back(1);
+        options.pluginCounts.push_back(8);
+        options.pluginCounts.push_back(32);
+    }
+
+    if (options.plugins.empty())
+    {
+        options.plugins.push_back(CarlaString("audiogain_s"));
+        options.plugins.push_back(CarlaString("bypass"));
+        options.plugins.push_back(CarlaString("midithrough"));
+        options.plugins.push_back(CarlaString("lfo"));
+    }
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static void idleFor(const CarlaHostHandle handle, const uint ms)
+{
+    for (uint i = 0; i < ms; i += 10)
+    {
+        carla_engine_idle(handle);
+        carla_msleep(10);
+    }
+}
+
+struct PatchbayPort {
+    uint groupId;
+    uint portId;
+    uint hints;
+};
+
+struct PatchbayLayout {
+    std::vector<uint> groupIds;
+    std::vector<int> groupPluginIds;
+    std::vector<PatchbayPort> ports;
+
+    std::vector<uint> getPorts(const uint groupId, const uint type, const bool isInput) const
+    {
+        std::vector<uint> ret;
+
+        for (std::vector<PatchbayPort>::const_iterator it = ports.begin(); it != ports.end(); ++it)
+        {
+            if (it->groupId == groupId && (it->hints & type) != 0
+                && ((it->hints & PATCHBAY_PORT_IS_INPUT) != 0) == isInput)
+                ret.push_back(it->portId);
+        }
+
+        return ret;
+    }
+
+    uint getGroupForPlugin(const int pluginId) const
+    {
+        for (size_t i = 0; i < groupIds.size(); ++i)
+            if (groupPluginIds[i] == pluginId)
+                return groupIds[i];
+
+        return 0;
+    }
+
+    // graph IO groups are not plugins, and only have ports in one direction
+    uint getIOGroup(const uint type, const bool isInput) const
+    {
+        for (size_t i = 0; i < groupIds.size(); ++i)
+            if (groupPluginIds[i] < 0 && ! getPorts(groupIds[i], type, isInput).empty())
+                return groupIds[i];
+
+        return 0;
+    }
+};
+
+static void patchbayLayoutCallback(void* const ptr, const EngineCallbackOpcode action, const uint pluginId,
+                                   const int value1, const int value2, int, float, const char*)
+{
+    PatchbayLayout* const layout = static_cast<PatchbayLayout*>(ptr);
+
+    switch (action)
+    {
+    case ENGINE_CALLBACK_PATCHBAY_CLIENT_ADDED:
+        layout->groupIds.push_back(pluginId);
+        layout->groupPluginIds.push_back(value2);
+        break;
+    case ENGINE_CALLBACK_PATCHBAY_PORT_ADDED: {
+        const PatchbayPort port = { pluginId, static_cast<uint>(value1), static_cast<uint>(value2) };
+        layout->ports.push_back(port);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// the log thread keeps using the last callback, so never reset it to null
+static void ignoreCallback(void*, EngineCallbackOpcode, uint, int, int, int, float, const char*)
+{
+}
+
+/* The patchbay only renders plugins that reach an output, so chain the audio ports like the rack does,
+   and connect all MIDI ports to the graph MIDI input and output. */
+static void connectPatchbayChain(const CarlaHostHandle handle, const uint pluginCount)
+{
+    PatchbayLayout layout;
+    carla_set_engine_callback(handle, patchbayLayoutCallback, &layout);
+    carla_patchbay_refresh(handle, false);
+    carla_set_engine_callback(handle, ignoreCallback, nullptr);
+
+    const uint audioOutGroup = layout.getIOGroup(PATCHBAY_PORT_TYPE_AUDIO, true);
+    const uint midiInGroup   = layout.getIOGroup(PATCHBAY_PORT_TYPE_MIDI, false);
+    const uint midiOutGroup  = layout.getIOGroup(PATCHBAY_PORT_TYPE_MIDI, true);
+    const std::vector<uint> midiIns  = layout.getPorts(midiInGroup, PATCHBAY_PORT_TYPE_MIDI, false);
+    const std::vector<uint> midiOuts = layout.getPorts(midiOutGroup, PATCHBAY_PORT_TYPE_MIDI, true);
+
+    uint sourceGroup = layout.getIOGroup(PATCHBAY_PORT_TYPE_AUDIO, false);
+    std::vector<uint> sources = layout.getPorts(sourceGroup, PATCHBAY_PORT_TYPE_AUDIO, false);
+
+    for (uint i = 0; i < pluginCount; ++i)
+    {
+        const uint group = layout.getGroupForPlugin(static_cast<int>(i));
+        const std::vector<uint> audioIns  = layout.getPorts(group, PATCHBAY_PORT_TYPE_AUDIO, true);
+        const std::vector<uint> audioOuts = layout.getPorts(group, PATCHBAY_PORT_TYPE_AUDIO, false);
+        const std::vector<uint> eventIns  = layout.getPorts(group, PATCHBAY_PORT_TYPE_MIDI, true);
+        const std::vector<uint> eventOuts = layout.getPorts(group, PATCHBAY_PORT_TYPE_MIDI, false);
+
+        if (! sources.empty())
+        {
+            for (size_t j = 0; j < audioIns.size(); ++j)
+                carla_patchbay_connect(handle, false, sourceGroup, sources[j % sources.size()], group, audioIns[j]);
+        }
+
+        if (! audioOuts.empty())
+        {
+            sourceGroup = group;
+            sources = audioOuts;
+        }
+
+        if (! midiIns.empty() && ! eventIns.empty())
+            carla_patchbay_connect(handle, false, midiInGroup, midiIns[0], group, eventIns[0]);
+
+        if (! midiOuts.empty() && ! eventOuts.empty())
+            carla_patchbay_connect(handle, false, group, eventOuts[0], midiOutGroup, midiOuts[0]);
+    }
+
+    const std::vector<uint> outputs = layout.getPorts(audioOutGroup, PATCHBAY_PORT_TYPE_AUDIO, true);
+
+    if (! sources.empty())
+    {
+        for (size_t j = 0; j < outputs.size(); ++j)
+            carla_patchbay_connect(handle, false, sourceGroup, sources[j % sources.size()], audioOutGroup, outputs[j]);
+    }
+}
+
+static bool runBenchmark(const CarlaHostHandle handle,
+                         const BenchmarkOptions& options,
+                         const EngineProcessMode mode,
+                         const uint bufferSize,
+                         const uint pluginCount,
+                         BenchmarkResult& result)
+{
+    char deviceName[64];
+    std::snprintf(deviceName, sizeof(deviceName), "Free-running:%u", options.midiEventsPerCycle);
+
+    carla_set_engine_option(handle, ENGINE_OPTION_PROCESS_MODE, mode, "");
+    carla_set_engine_option(handle, ENGINE_OPTION_TRANSPORT_MODE, ENGINE_TRANSPORT_MODE_INTERNAL, "");
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_BUFFER_SIZE, static_cast<int>(bufferSize), "");
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_SAMPLE_RATE, static_cast<int>(options.sampleRate), "");
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_DEVICE, 0, deviceName);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_DOUBLE_PRECISION, options.doublePrecision ? 1 : 0, "");
+
+    if (! carla_engine_init(handle, "Dummy", "carla-engine-bench"))
+    {
+        std::fprintf(stderr, "failed to start engine: %s\n", carla_get_last_error(handle));
+        return false;
+    }
+
+    bool ok = true;
+
+    for (uint i = 0; i < pluginCount; ++i)
+    {
+        const CarlaString& plugin(options.plugins[i % options.plugins.size()]);
+        const char* const label = plugin.buffer();
+        const bool isJSFX = plugin.endsWith(".jsfx");
+
+        if (! carla_add_plugin(handle, BINARY_NATIVE, isJSFX ? PLUGIN_JSFX : PLUGIN_INTERNAL,
+                               isJSFX ? label : "", "", isJSFX ? "" : label, 0, nullptr, 0x0))
+        {
+            std::fprintf(stderr, "failed to load plugin '%s': %s\n", label, carla_get_last_error(handle));
+            ok = false;
+            break;
+        }
+
+        if (options.tailSamples >= 0)
+            carla_set_plugin_tail_samples(handle, i, options.tailSamples);
+    }
+
+    if (ok && mode == ENGINE_PROCESS_MODE_PATCHBAY)
+        connectPatchbayChain(handle, pluginCount);
+
+    if (ok)
+    {
+        idleFor(handle, options.warmupMs);
+
+        carla_clear_plugin_timings(handle);
+        carla_clear_engine_cycle_stats(handle);
+
+        const uint64_t startTime = carla_gettime_ns();
+        idleFor(handle, options.durationMs);
+        const uint64_t elapsed = carla_gettime_ns() - startTime;
+
+        // every plugin runs once per cycle, so any of them gives us the cycle count
+        double pluginsTotalNs = 0.0;
+        result.cycles = carla_get_plugin_timing_info(handle, 0)->cycles;
+
+        for (uint i = 0; i < pluginCount; ++i)
+            pluginsTotalNs += carla_get_plugin_timing_info(handle, i)->avg * 1000.0;
+
+        if (result.cycles != 0)
+        {
+            const double seconds = static_cast<double>(elapsed) / 1000000000.0;
+
+            result.nsPerBlock = static_cast<double>(elapsed) / static_cast<double>(result.cycles);
+            result.nsPerPlugin = pluginsTotalNs / pluginCount;
+            result.eventsPerSecond = static_cast<double>(result.cycles * options.midiEventsPerCycle) / seconds;
+        }
+        else
+        {
+            std::fprintf(stderr, "no cycles were processed\n");
+            ok = false;
+        }
+    }
+
+    carla_remove_all_plugins(handle);
+    carla_engine_close(handle);
+    return ok;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    if (! parseArgs(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* const output = options.outputFilename != nullptr ? std::fopen(options.outputFilename, "w") : stdout;
+
+    if (output == nullptr)
+    {
+        std::fprintf(stderr, "failed to open '%s' for writing\n", options.outputFilename);
+        return 1;
+    }
+
+    CarlaString pluginList;
+
+    for (std::vector<CarlaString>::const_iterator it = options.plugins.begin(); it != options.plugins.end(); ++it)
+    {
+        if (pluginList.isNotEmpty())
+            pluginList += ",";
+        pluginList += *it;
+    }
+
+    const CarlaHostHandle handle = carla_standalone_host_init();
+    int ret = 0;
+
+    for (std::vector<EngineProcessMode>::const_iterator mode = options.modes.begin(); mode != options.modes.end(); ++mode)
+    {
+        for (std::vector<uint>::const_iterator bufferSize = options.bufferSizes.begin(); bufferSize != options.bufferSizes.end(); ++bufferSize)
+        {
+            for (std::vector<uint>::const_iterator pluginCount = options.pluginCounts.begin(); pluginCount != options.pluginCounts.end(); ++pluginCount)
+            {
+                BenchmarkResult result;
+                carla_zeroStruct(result);
+
+                if (! runBenchmark(handle, options, *mode, *bufferSize, *pluginCount, result))
+                {
+                    ret = 1;
+                    continue;
+                }
+
+                std::fprintf(output,
+                             "{\"mode\":\"%s\",\"buffer_size\":%u,\"sample_rate\":%u,\"plugin_count\":%u,"
+                             "\"plugins\":\"%s\",\"midi_events_per_cycle\":%u,\"tail\":%d,\"double\":%s,\"cycles\":%llu,"
+                             "\"ns_per_block\":%.1f,\"ns_per_plugin\":%.1f,\"events_per_second\":%.1f}\n",
+                             *mode == ENGINE_PROCESS_MODE_PATCHBAY ? "patchbay" : "rack",
+                             *bufferSize, options.sampleRate, *pluginCount,
+                             pluginList.buffer(), options.midiEventsPerCycle, options.tailSamples,
+                             options.doublePrecision ? "true" : "false",
+                             static_cast<unsigned long long>(result.cycles),
+                             result.nsPerBlock, result.nsPerPlugin, result.eventsPerSecond);
+                std::fflush(output);
+            }
+        }
+    }
+
+    if (output != stdout)
+        std::fclose(output);
+
+    return ret;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,263 @@
+/*
+ * Carla patchbay graph compiler benchmark
+ * Copyright (C) 2026 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaTimeUtils.hpp"
+
+#include "water/processors/AudioProcessorGraph.h"
+#include "water/buffers/AudioSampleBuffer.h"
+#include "water/midi/MidiBuffer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using water::AudioProcessor;
+using water::AudioProcessorGraph;
+using water::AudioSampleBuffer;
+using water::MidiBuffer;
+using water::String;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint kBufferSize = 128;
+static const double kSampleRate = 48000.0;
+
+/* Stereo processor with a MIDI input, similar to what the patchbay uses for plugins. */
+class BenchProcessor : public AudioProcessor
+{
+public:
+    explicit BenchProcessor(const int latency)
+    {
+        setPlayConfigDetails(2, 2, 0, 0, 1, 0, kSampleRate, kBufferSize);
+        setLatencySamples(latency);
+    }
+
+    const String getName() const override { return "bench"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return false; }
+
+    void processBlockWithCV(AudioSampleBuffer& audio, const AudioSampleBuffer&, AudioSampleBuffer&, MidiBuffer&) override
+    {
+        for (uint32_t c = 0; c < 2; ++c)
+        {
+            float* const data = audio.getWritePointer(c);
+
+            for (uint32_t i = 0, count = audio.getNumSamples(); i < count; ++i)
+                data[i] *= 0.5f;
+        }
+    }
+};
+
+struct Topology {
+    const char* name;
+    void (*connect)(AudioProcessorGraph& graph, const std::vector<uint32_t>& ids, uint32_t in, uint32_t out);
+};
+
+static void connectStereo(AudioProcessorGraph& graph, const uint32_t src, const uint32_t dst)
+{
+    graph.addConnection(AudioProcessor::ChannelTypeAudio, src, 0, dst, 0);
+    graph.addConnection(AudioProcessor::ChannelTypeAudio, src, 1, dst, 1);
+}
+
+/* in -> 1 -> 2 -> ... -> N -> out */
+static void connectChain(AudioProcessorGraph& graph, const std::vector<uint32_t>& ids, const uint32_t in, const uint32_t out)
+{
+    uint32_t prev = in;
+
+    for (std::vector<uint32_t>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    {
+        connectStereo(graph, prev, *it);
+        prev = *it;
+    }
+
+    connectStereo(graph, prev, out);
+}
+
+/* in -> every node -> out */
+static void connectParallel(AudioProcessorGraph& graph, const std::vector<uint32_t>& ids, const uint32_t in, const uint32_t out)
+{
+    for (std::vector<uint32_t>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    {
+        connectStereo(graph, in, *it);
+        connectStereo(graph, *it, out);
+    }
+}
+
+/* Each node takes input from up to 3 random nodes added before it, nodes without outputs go to out.
+   Connections are made starting from the last node, so the insertion order is the reverse of the data flow. */
+static void connectRandom(AudioProcessorGraph& graph, const std::vector<uint32_t>& ids, const uint32_t in, const uint32_t out)
+{
+    uint32_t seed = 0x1234567;
+    std::vector<bool> hasOutput(ids.size(), false);
+
+    for (size_t i = ids.size(); i-- > 0;)
+    {
+        if (i == 0)
+        {
+            connectStereo(graph, in, ids[i]);
+            continue;
+        }
+
+        for (int j = 0; j < 3; ++j)
+        {
+            seed = seed * 1103515245U + 12345U;
+            const size_t src = (seed >> 8) % i;
+            connectStereo(graph, ids[src], ids[i]);
+            hasOutput[src] = true;
+        }
+    }
+
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        if (! hasOutput[i])
+            connectStereo(graph, ids[i], out);
+    }
+}
+
+static const Topology kTopologies[] = {
+    { "chain", connectChain },
+    { "parallel", connectParallel },
+    { "random", connectRandom },
+};
+
+struct BenchmarkResult {
+    size_t connections;
+    double buildMs;
+    double reconnectMs;
+    double nsPerBlock;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static void runBenchmark(const Topology& topology, const uint nodeCount, const uint iterations, BenchmarkResult& result)
+{
+    AudioProcessorGraph graph;
+    graph.setPlayConfigDetails(2, 2, 0, 0, 1, 1, kSampleRate, kBufferSize);
+
+    const uint32_t in = graph.addNode(new AudioProcessorGraph::AudioGraphIOProcessor(
+                                      AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode))->nodeId;
+    const uint32_t out = graph.addNode(new AudioProcessorGraph::AudioGraphIOProcessor(
+                                       AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode))->nodeId;
+    const uint32_t midiIn = graph.addNode(new AudioProcessorGraph::AudioGraphIOProcessor(
+                                          AudioProcessorGraph::AudioGraphIOProcessor::midiInputNode))->nodeId;
+
+    std::vector<uint32_t> ids;
+
+    for (uint i = 0; i < nodeCount; ++i)
+        ids.push_back(graph.addNode(new BenchProcessor(static_cast<int>(i % 7) * 16))->nodeId);
+
+    topology.connect(graph, ids, in, out);
+    result.connections = graph.getNumConnections();
+
+    // initial build, also prepares all nodes
+    graph.prepareToPlay(kSampleRate, kBufferSize);
+
+    uint64_t startTime = carla_gettime_ns();
+
+    for (uint i = 0; i < iterations; ++i)
+        graph.buildRenderingSequence();
+
+    result.buildMs = static_cast<double>(carla_gettime_ns() - startTime) / iterations / 1000000.0;
+
+    // toggle a connection in the middle of the graph, as done when patching from the UI
+    const uint32_t middle = ids[ids.size() / 2];
+    startTime = carla_gettime_ns();
+
+    for (uint i = 0; i < iterations; ++i)
+    {
+        if (i % 2 == 0)
+            graph.addConnection(AudioProcessor::ChannelTypeMIDI, midiIn, 0, middle, 0);
+        else
+            graph.removeConnection(AudioProcessor::ChannelTypeMIDI, midiIn, 0, middle, 0);
+
+        graph.reorderNowIfNeeded();
+    }
+
+    result.reconnectMs = static_cast<double>(carla_gettime_ns() - startTime) / iterations / 1000000.0;
+
+    AudioSampleBuffer audio(2, kBufferSize);
+    AudioSampleBuffer cvIn(1, kBufferSize), cvOut(1, kBufferSize);
+    MidiBuffer midi;
+    audio.clear();
+    cvIn.clear();
+
+    startTime = carla_gettime_ns();
+
+    for (uint i = 0; i < iterations; ++i)
+        graph.processBlockWithCV(audio, cvIn, cvOut, midi);
+
+    result.nsPerBlock = static_cast<double>(carla_gettime_ns() - startTime) / iterations;
+
+    graph.releaseResources();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::vector<uint> nodeCounts;
+    uint iterations = 10;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = static_cast<uint>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (std::atoi(argv[i]) > 0)
+        {
+            nodeCounts.push_back(static_cast<uint>(std::atoi(argv[i])));
+        }
+        else
+        {
+            std::fprintf(stderr,
+                         "usage: %s [--iterations N] [NODE-COUNT...]\n"
+                         "Results are written as one JSON object per line.\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    if (nodeCounts.empty())
+    {
+        static const uint kDefaultCounts[] = { 10, 50, 100, 300, 1000, 2000 };
+        nodeCounts.assign(kDefaultCounts, kDefaultCounts + sizeof(kDefaultCounts)/sizeof(kDefaultCounts[0]));
+    }
+
+    for (size_t t = 0; t < sizeof(kTopologies)/sizeof(kTopologies[0]); ++t)
+    {
+        for (std::vector<uint>::const_iterator nodeCount = nodeCounts.begin(); nodeCount != nodeCounts.end(); ++nodeCount)
+        {
+            BenchmarkResult result;
+            runBenchmark(kTopologies[t], *nodeCount, iterations, result);
+
+            std::printf("{\"topology\":\"%s\",\"nodes\":%u,\"connections\":%u,"
+                        "\"build_ms\":%.3f,\"reconnect_ms\":%.3f,\"ns_per_block\":%.1f}\n",
+                        kTopologies[t].name, *nodeCount, static_cast<uint>(result.connections),
+                        result.buildMs, result.reconnectMs, result.nsPerBlock);
+            std::fflush(stdout);
+        }
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
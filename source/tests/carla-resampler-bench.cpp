@@ -0,0 +1,256 @@
+/*
+ * Carla resampler throughput benchmark
+ * Copyright (C) 2026 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaTimeUtils.hpp"
+
+#include "zita-resampler/resampler.h"
+#include "zita-resampler/vresampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const uint kBlockFrames = 4096;
+
+struct Config {
+    const char* resampler; // "fixed" or "variable"
+    uint srcRate;
+    uint dstRate;
+    uint channels;
+    bool planar;
+};
+
+struct Result {
+    double framesPerSecond;
+    float maxError; // against the scalar kernel
+};
+
+static void fillInput(std::vector<float>& buffer, const uint channels)
+{
+    uint32_t seed = 1;
+
+    for (std::size_t i = 0; i < buffer.size(); ++i)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        const float noise = static_cast<float>(seed >> 9) / static_cast<float>(1U << 23) - 0.5f;
+        const double t = static_cast<double>(i / channels);
+        buffer[i] = 0.5f * static_cast<float>(std::sin(t * 0.01 * (1 + i % channels))) + 0.1f * noise;
+    }
+}
+
+// Runs the resampler over 'input' until 'seconds' have passed, returns the output of the first pass.
+template <class ResamplerType, typename ProcessResult>
+static bool runResampler(ResamplerType& resampler,
+                         ProcessResult (ResamplerType::*process)(void),
+                         const Config& config,
+                         const std::vector<float>& input,
+                         const double seconds,
+                         std::vector<float>& firstOutput,
+                         Result& result)
+{
+    const uint channels = config.channels;
+    const uint inputFrames = static_cast<uint>(input.size() / channels);
+    const uint outputFrames = static_cast<uint>(static_cast<double>(inputFrames) * config.dstRate / config.srcRate) + 1;
+
+    std::vector<float> output(outputFrames * channels);
+    std::vector<float> planarInput(input.size()), planarOutput(output.size());
+    std::vector<float*> inputList(channels), outputList(channels);
+
+    for (uint c = 0; c < channels; ++c)
+        for (uint i = 0; i < inputFrames; ++i)
+            planarInput[c * inputFrames + i] = input[i * channels + c];
+
+    uint64_t totalFrames = 0;
+    const uint64_t startTime = carla_gettime_ns();
+    uint64_t now = startTime;
+
+    for (uint pass = 0; pass == 0 || now - startTime < static_cast<uint64_t>(seconds * 1e9); ++pass)
+    {
+        resampler.reset();
+
+        if (config.planar)
+        {
+            for (uint c = 0; c < channels; ++c)
+            {
+                inputList[c] = &planarInput[c * inputFrames];
+                outputList[c] = &planarOutput[c * outputFrames];
+            }
+
+            resampler.inp_count = inputFrames;
+            resampler.out_count = outputFrames;
+            resampler.inp_list = inputList.data();
+            resampler.out_list = outputList.data();
+        }
+        else
+        {
+            resampler.inp_count = inputFrames;
+            resampler.out_count = outputFrames;
+            resampler.inp_data = const_cast<float*>(input.data());
+            resampler.out_data = output.data();
+        }
+
+        (resampler.*process)();
+        totalFrames += outputFrames - resampler.out_count;
+
+        if (pass == 0)
+        {
+            if (config.planar)
+            {
+                for (uint c = 0; c < channels; ++c)
+                    for (uint i = 0; i < outputFrames; ++i)
+                        output[i * channels + c] = planarOutput[c * outputFrames + i];
+            }
+
+            firstOutput.assign(output.begin(), output.begin() + (outputFrames - resampler.out_count) * channels);
+        }
+
+        now = carla_gettime_ns();
+    }
+
+    result.framesPerSecond = static_cast<double>(totalFrames) / (static_cast<double>(now - startTime) / 1e9);
+    return true;
+}
+
+static bool runBenchmark(const Config& config, const int isa, const double seconds,
+                         const std::vector<float>& input, std::vector<float>& output, Result& result)
+{
+    if (std::strcmp(config.resampler, "fixed") == 0)
+    {
+        Resampler resampler;
+        resampler.setup(config.srcRate, config.dstRate, config.channels, 32);
+
+        if (resampler.nchan() != config.channels)
+            return false;
+        if (resampler.set_kernel(isa) != 0)
+            return false;
+
+        return runResampler(resampler,
+                            config.planar ? &Resampler::process_planar : &Resampler::process,
+                            config, input, seconds, output, result);
+    }
+
+    VResampler resampler;
+
+    if (resampler.setup(static_cast<double>(config.dstRate) / config.srcRate, config.channels, 32) != 0)
+        return false;
+    if (resampler.set_kernel(isa) != 0)
+        return false;
+
+    return runResampler(resampler,
+                        config.planar ? &VResampler::process_planar : &VResampler::process,
+                        config, input, seconds, output, result);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    double seconds = 0.5;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = std::max(0.01, std::atof(argv[++i]));
+        }
+        else
+        {
+            std::fprintf(stderr,
+                         "usage: %s [--seconds N]\n"
+                         "Measures the throughput of each resampler kernel against the scalar one.\n"
+                         "Results are written as one JSON object per line.\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    static const uint kChannels[] = { 1, 2, 6, 8 };
+    static const uint kRates[][2] = { { 44100, 48000 }, { 48000, 44100 } };
+    static const char* const kResamplers[] = { "fixed", "variable" };
+
+    for (uint r = 0; r < sizeof(kResamplers)/sizeof(kResamplers[0]); ++r)
+    for (uint s = 0; s < sizeof(kRates)/sizeof(kRates[0]); ++s)
+    for (uint c = 0; c < sizeof(kChannels)/sizeof(kChannels[0]); ++c)
+    for (uint p = 0; p < 2; ++p)
+    {
+        const Config config = { kResamplers[r], kRates[s][0], kRates[s][1], kChannels[c], p != 0 };
+
+        std::vector<float> input(kBlockFrames * config.channels);
+        fillInput(input, config.channels);
+
+        std::vector<float> reference;
+        Result scalarResult = {};
+
+        if (! runBenchmark(config, Resampler_kernels::ISA_SCALAR, seconds, input, reference, scalarResult))
+        {
+            std::fprintf(stderr, "benchmark setup failed\n");
+            return 1;
+        }
+
+        for (int isa = Resampler_kernels::ISA_SCALAR; isa < Resampler_kernels::ISA_COUNT; ++isa)
+        {
+            if (Resampler_kernels::get(isa) == nullptr)
+                continue;
+
+            std::vector<float> output;
+            Result result = {};
+
+            if (isa == Resampler_kernels::ISA_SCALAR)
+                result = scalarResult;
+            else if (! runBenchmark(config, isa, seconds, input, output, result))
+                continue;
+
+            if (isa != Resampler_kernels::ISA_SCALAR)
+            {
+                if (output.size() != reference.size())
+                {
+                    std::fprintf(stderr, "%s kernel produced a different number of frames\n",
+                                 Resampler_kernels::name(isa));
+                    return 1;
+                }
+
+                for (std::size_t i = 0; i < output.size(); ++i)
+                    result.maxError = std::max(result.maxError, std::fabs(output[i] - reference[i]));
+            }
+
+            std::printf("{\"resampler\":\"%s\",\"src_rate\":%u,\"dst_rate\":%u,\"channels\":%u,\"layout\":\"%s\","
+                        "\"kernel\":\"%s\",\"frames_per_sec\":%.0f,\"speedup\":%.2f,\"max_error\":%g}\n",
+                        config.resampler, config.srcRate, config.dstRate, config.channels,
+                        config.planar ? "planar" : "interleaved",
+                        Resampler_kernels::name(isa), result.framesPerSecond,
+                        result.framesPerSecond / scalarResult.framesPerSecond,
+                        static_cast<double>(result.maxError));
+            std::fflush(stdout);
+
+            // sums are reordered, but must not drift away from the scalar result
+            if (result.maxError > 1e-4f)
+            {
+                std::fprintf(stderr, "%s kernel output differs from the scalar one\n", Resampler_kernels::name(isa));
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
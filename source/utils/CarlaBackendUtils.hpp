@@ -325,6 +325,10 @@ const char* EngineCallbackOpcode2Str(const EngineCallbackOpcode opcode) noexcept
         return "ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED";
     case ENGINE_CALLBACK_EMBED_UI_RESIZED:
         return "ENGINE_CALLBACK_EMBED_UI_RESIZED";
+    case ENGINE_CALLBACK_RENDER_PROGRESS:
+        return "ENGINE_CALLBACK_RENDER_PROGRESS";
+    case ENGINE_CALLBACK_PLUGIN_FREEZE_CHANGED:
+        return "ENGINE_CALLBACK_PLUGIN_FREEZE_CHANGED";
     }
 
     carla_stderr("CarlaBackend::EngineCallbackOpcode2Str(%i) - invalid opcode", opcode);
@@ -414,6 +418,14 @@ const char* EngineOption2Str(const EngineOption option) noexcept
         return "ENGINE_OPTION_CLIENT_NAME_PREFIX";
     case ENGINE_OPTION_PLUGINS_ARE_STANDALONE:
         return "ENGINE_OPTION_PLUGINS_ARE_STANDALONE";
+    case ENGINE_OPTION_AUDIO_DOUBLE_PRECISION:
+        return "ENGINE_OPTION_AUDIO_DOUBLE_PRECISION";
+    case ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME:
+        return "ENGINE_OPTION_BRIDGE_SPIN_WAIT_TIME";
+    case ENGINE_OPTION_THREAD_CPU_SET:
+        return "ENGINE_OPTION_THREAD_CPU_SET";
+    case ENGINE_OPTION_THREAD_PRIORITY:
+        return "ENGINE_OPTION_THREAD_PRIORITY";
     }
 
     carla_stderr("CarlaBackend::EngineOption2Str(%i) - invalid option", option);
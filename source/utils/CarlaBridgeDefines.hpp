@@ -24,7 +24,7 @@
 #define CARLA_PLUGIN_BRIDGE_API_VERSION_MINIMUM 6
 
 // current API version, bumped when something is added
-#define CARLA_PLUGIN_BRIDGE_API_VERSION_CURRENT 10
+#define CARLA_PLUGIN_BRIDGE_API_VERSION_CURRENT 12
 
 // -------------------------------------------------------------------------------------------------------------------
 
@@ -50,7 +50,9 @@ enum PluginBridgeRtClientOpcode {
     kPluginBridgeRtClientControlEventAllNotesOff, // uint/frame, byte/chan
     kPluginBridgeRtClientMidiEvent,               // uint/frame, byte/port, byte/size, byte[]/data
     kPluginBridgeRtClientProcess,                 // uint/frames
-    kPluginBridgeRtClientQuit
+    kPluginBridgeRtClientQuit,
+    // stuff added in API 12
+    kPluginBridgeRtClientSetParameterPool         // uint/count
 };
 
 // Server sends these to client during non-RT
@@ -91,6 +93,9 @@ enum PluginBridgeNonRtClientOpcode {
     kPluginBridgeNonRtClientEmbedUI,                        // ulong
     // stuff added in API 10
     kPluginBridgeNonRtClientReload,
+    // stuff added in API 11
+    kPluginBridgeNonRtClientSetChunkDataShm,                // ulong/size (data in client chunk pool)
+    kPluginBridgeNonRtClientSetServerChunkPoolSize,         // ulong/size
 };
 
 // Client sends these to server during non-RT
@@ -130,6 +135,10 @@ enum PluginBridgeNonRtServerOpcode {
     // stuff added in API 9
     kPluginBridgeNonRtServerRespEmbedUI,        // ulong/window-id
     kPluginBridgeNonRtServerResizeEmbedUI,      // uint/width, uint/height
+    // stuff added in API 11
+    kPluginBridgeNonRtServerSetChunkDataShm,    // ulong/size (data in server chunk pool)
+    kPluginBridgeNonRtServerResizeChunkPool,    // ulong/size
+    kPluginBridgeNonRtServerChunkDataReceived,
 };
 
 // used for kPluginBridgeNonRtServerPortName
@@ -24,11 +24,17 @@
 
 #if defined(CARLA_OS_WIN) && !defined(BUILDING_CARLA_FOR_WINE)
 # define PLUGIN_BRIDGE_NAMEPREFIX_AUDIO_POOL    "Local\\carla-bridge_shm_ap_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_CLIENT_CHUNK  "Local\\carla-bridge_shm_chkC_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_SERVER_CHUNK  "Local\\carla-bridge_shm_chkS_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_PARAMETERS    "Local\\carla-bridge_shm_prm_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_RT_CLIENT     "Local\\carla-bridge_shm_rtC_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_CLIENT "Local\\carla-bridge_shm_nonrtC_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_SERVER "Local\\carla-bridge_shm_nonrtS_"
 #else
 # define PLUGIN_BRIDGE_NAMEPREFIX_AUDIO_POOL    "/crlbrdg_shm_ap_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_CLIENT_CHUNK  "/crlbrdg_shm_chkC_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_SERVER_CHUNK  "/crlbrdg_shm_chkS_"
+# define PLUGIN_BRIDGE_NAMEPREFIX_PARAMETERS    "/crlbrdg_shm_prm_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_RT_CLIENT     "/crlbrdg_shm_rtC_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_CLIENT "/crlbrdg_shm_nonrtC_"
 # define PLUGIN_BRIDGE_NAMEPREFIX_NON_RT_SERVER "/crlbrdg_shm_nonrtS_"
@@ -43,6 +49,64 @@ bool jackbridge_shm_map2(void* shm, T*& value) noexcept
     return (value != nullptr);
 }
 
+// -------------------------------------------------------------------------------------------------------------------
+// busy-waiting
+
+// upper limit for the spin time, in microseconds
+static constexpr const uint kBridgeSpinWaitMaxTime = 1000;
+
+// number of consecutive waits where spinning ran out before spinning is skipped,
+// and for how many waits it is skipped
+static constexpr const uint32_t kBridgeSpinMaxMisses    = 16;
+static constexpr const uint32_t kBridgeSpinBackoffWaits = 256;
+
+static inline
+void carla_cpu_pause() noexcept
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// measure how many spin iterations fit in a microsecond on this machine, done only once
+static uint32_t calibrateSpinIterations() noexcept
+{
+    // with a single CPU the other side cannot run while we spin
+    if (carla_get_cpu_count() < 2)
+        return 0;
+
+    static const uint32_t kIterations = 20000;
+
+    int dummy = 0;
+    uint64_t best = 0;
+
+    for (int run = 0; run < 3; ++run)
+    {
+        const uint64_t start = carla_gettime_ns();
+
+        for (uint32_t i=0; i < kIterations; ++i)
+        {
+            __sync_bool_compare_and_swap(&dummy, 1, 0);
+            carla_cpu_pause();
+        }
+
+        const uint64_t elapsed = carla_gettime_ns() - start;
+
+        if (best == 0 || elapsed < best)
+            best = elapsed;
+    }
+
+    return static_cast<uint32_t>(std::max<uint64_t>(1, kIterations * 1000ULL / std::max<uint64_t>(1, best)));
+}
+
+static uint32_t getSpinIterationsPerUsec() noexcept
+{
+    static const uint32_t iterations = calibrateSpinIterations();
+    return iterations;
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 BridgeAudioPool::BridgeAudioPool() noexcept
@@ -148,11 +212,358 @@ const char* BridgeAudioPool::getFilenameSuffix() const noexcept
 
 // -------------------------------------------------------------------------------------------------------------------
 
+BridgeChunkPool::BridgeChunkPool(const bool forClient) noexcept
+    : data(nullptr),
+      dataSize(0),
+      filename(),
+      isServer(false),
+      isForClient(forClient)
+{
+    carla_zeroChars(shm, 64);
+    jackbridge_shm_init(shm);
+}
+
+BridgeChunkPool::~BridgeChunkPool() noexcept
+{
+    clear();
+}
+
+bool BridgeChunkPool::initializeServer(const char* const basename) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(basename != nullptr && basename[0] != '\0', false);
+
+    // must be invalid right now
+    CARLA_SAFE_ASSERT_RETURN(! jackbridge_shm_is_valid(shm), false);
+
+    filename  = isForClient ? PLUGIN_BRIDGE_NAMEPREFIX_CLIENT_CHUNK : PLUGIN_BRIDGE_NAMEPREFIX_SERVER_CHUNK;
+    filename += basename;
+
+    const carla_shm_t shm2 = carla_shm_create(filename);
+
+    if (! carla_is_shm_valid(shm2))
+    {
+        filename.clear();
+        return false;
+    }
+
+    void* const shmptr = shm;
+    carla_shm_t& shm1  = *(carla_shm_t*)shmptr;
+    carla_copyStruct(shm1, shm2);
+
+    isServer = true;
+    return true;
+}
+
+bool BridgeChunkPool::attachClient(const char* const basename) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(basename != nullptr && basename[0] != '\0', false);
+
+    // must be invalid right now
+    CARLA_SAFE_ASSERT_RETURN(! jackbridge_shm_is_valid(shm), false);
+
+    filename  = isForClient ? PLUGIN_BRIDGE_NAMEPREFIX_CLIENT_CHUNK : PLUGIN_BRIDGE_NAMEPREFIX_SERVER_CHUNK;
+    filename += basename;
+
+    jackbridge_shm_attach(shm, filename);
+
+    return jackbridge_shm_is_valid(shm);
+}
+
+void BridgeChunkPool::clear() noexcept
+{
+    filename.clear();
+
+    if (! jackbridge_shm_is_valid(shm))
+    {
+        CARLA_SAFE_ASSERT(data == nullptr);
+        return;
+    }
+
+    if (data != nullptr)
+    {
+        jackbridge_shm_unmap(shm, data);
+        data = nullptr;
+    }
+
+    dataSize = 0;
+    jackbridge_shm_close(shm);
+    jackbridge_shm_init(shm);
+}
+
+bool BridgeChunkPool::resize(const std::size_t size) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(jackbridge_shm_is_valid(shm), false);
+    CARLA_SAFE_ASSERT_RETURN(isServer, false);
+    CARLA_SAFE_ASSERT_RETURN(size > 0, false);
+
+    if (data != nullptr && size <= dataSize)
+        return true;
+
+    if (data != nullptr)
+    {
+        jackbridge_shm_unmap(shm, data);
+        data = nullptr;
+    }
+
+    // leave some room for chunks that grow a little on every save, and keep it page aligned
+    dataSize = size + size / 8;
+    dataSize = (dataSize + 0xffff) & ~static_cast<std::size_t>(0xffff);
+
+    data = (uint8_t*)jackbridge_shm_map(shm, dataSize);
+
+    if (data == nullptr)
+    {
+        dataSize = 0;
+        return false;
+    }
+
+    return true;
+}
+
+bool BridgeChunkPool::map(const std::size_t size) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(jackbridge_shm_is_valid(shm), false);
+    CARLA_SAFE_ASSERT_RETURN(! isServer, false);
+    CARLA_SAFE_ASSERT_RETURN(data == nullptr, false);
+    CARLA_SAFE_ASSERT_RETURN(size > 0, false);
+
+    data = (uint8_t*)jackbridge_shm_map(shm, size);
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+    dataSize = size;
+    return true;
+}
+
+void BridgeChunkPool::unmap() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(! isServer,);
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+
+    jackbridge_shm_unmap(shm, data);
+    data = nullptr;
+    dataSize = 0;
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+
+BridgeParameterPool::BridgeParameterPool() noexcept
+    : data(nullptr),
+      dataSize(0),
+      count(0),
+      filename(),
+      isServer(false),
+      ownValues(nullptr),
+      ownSerials(nullptr),
+      otherValues(nullptr),
+      otherSerials(nullptr),
+      readSerials(nullptr),
+      readSerial(0),
+      readIndex(0)
+{
+    carla_zeroChars(shm, 64);
+    jackbridge_shm_init(shm);
+}
+
+BridgeParameterPool::~BridgeParameterPool() noexcept
+{
+    clear();
+}
+
+bool BridgeParameterPool::initializeServer(const char* const basename) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(basename != nullptr && basename[0] != '\0', false);
+
+    // must be invalid right now
+    CARLA_SAFE_ASSERT_RETURN(! jackbridge_shm_is_valid(shm), false);
+
+    filename  = PLUGIN_BRIDGE_NAMEPREFIX_PARAMETERS;
+    filename += basename;
+
+    const carla_shm_t shm2 = carla_shm_create(filename);
+
+    if (! carla_is_shm_valid(shm2))
+    {
+        filename.clear();
+        return false;
+    }
+
+    void* const shmptr = shm;
+    carla_shm_t& shm1  = *(carla_shm_t*)shmptr;
+    carla_copyStruct(shm1, shm2);
+
+    isServer = true;
+    return true;
+}
+
+bool BridgeParameterPool::attachClient(const char* const basename) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(basename != nullptr && basename[0] != '\0', false);
+
+    // must be invalid right now
+    CARLA_SAFE_ASSERT_RETURN(! jackbridge_shm_is_valid(shm), false);
+
+    filename  = PLUGIN_BRIDGE_NAMEPREFIX_PARAMETERS;
+    filename += basename;
+
+    jackbridge_shm_attach(shm, filename);
+
+    return jackbridge_shm_is_valid(shm);
+}
+
+void BridgeParameterPool::clear() noexcept
+{
+    filename.clear();
+
+    if (! jackbridge_shm_is_valid(shm))
+    {
+        CARLA_SAFE_ASSERT(data == nullptr);
+        return;
+    }
+
+    if (isServer)
+        resize(0);
+    else
+        map(0);
+
+    jackbridge_shm_close(shm);
+    jackbridge_shm_init(shm);
+}
+
+bool BridgeParameterPool::resize(const uint32_t newCount) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(isServer, false);
+
+    return map(newCount);
+}
+
+bool BridgeParameterPool::map(const uint32_t newCount) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(jackbridge_shm_is_valid(shm), false);
+
+    if (data != nullptr)
+    {
+        jackbridge_shm_unmap(shm, data);
+        data = nullptr;
+    }
+
+    delete[] readSerials;
+    readSerials = nullptr;
+    ownValues = nullptr;
+    ownSerials = nullptr;
+    otherValues = nullptr;
+    otherSerials = nullptr;
+    dataSize = 0;
+    count = 0;
+
+    if (newCount == 0)
+        return true;
+
+    const std::size_t newDataSize = sizeof(BridgeParameterPoolHeader)
+                                  + newCount * 2 * (sizeof(float) + sizeof(uint32_t));
+
+    try {
+        readSerials = new uint32_t[newCount];
+    } CARLA_SAFE_EXCEPTION_RETURN("BridgeParameterPool::map", false);
+
+    data = (BridgeParameterPoolHeader*)jackbridge_shm_map(shm, newDataSize);
+
+    if (data == nullptr)
+    {
+        delete[] readSerials;
+        readSerials = nullptr;
+        return false;
+    }
+
+    // the server starts from a clean pool, the client starts from whatever the server has written so far
+    if (isServer)
+        std::memset(data, 0, newDataSize);
+
+    uint8_t* ptr = (uint8_t*)(data + 1);
+    float* const serverValues = (float*)ptr;
+    ptr += newCount * sizeof(float);
+    uint32_t* const serverSerials = (uint32_t*)ptr;
+    ptr += newCount * sizeof(uint32_t);
+    float* const clientValues = (float*)ptr;
+    ptr += newCount * sizeof(float);
+    uint32_t* const clientSerials = (uint32_t*)ptr;
+
+    ownValues    = isServer ? serverValues  : clientValues;
+    ownSerials   = isServer ? serverSerials : clientSerials;
+    otherValues  = isServer ? clientValues  : serverValues;
+    otherSerials = isServer ? clientSerials : serverSerials;
+
+    carla_zeroStructs(readSerials, newCount);
+    readSerial = 0;
+    readIndex = 0;
+
+    if (! isServer)
+        data->clientCount = newCount;
+
+    dataSize = newDataSize;
+    count = newCount;
+    return true;
+}
+
+void BridgeParameterPool::writeValue(const uint32_t index, const float value, const bool onlyIfChanged) noexcept
+{
+    CARLA_SAFE_ASSERT_UINT2_RETURN(index < count, index, count,);
+
+    if (onlyIfChanged && carla_isEqual(ownValues[index], value))
+        return;
+
+    // value first, then the serials, so the other side never sees a new serial with an old value
+    ownValues[index] = value;
+    __sync_add_and_fetch(&ownSerials[index], 1);
+    __sync_add_and_fetch(&data->serial[isServer ? 0 : 1], 1);
+}
+
+bool BridgeParameterPool::hasChanges() noexcept
+{
+    if (count == 0)
+        return false;
+
+    const uint32_t serial = ((volatile const uint32_t*)data->serial)[isServer ? 1 : 0];
+
+    if (serial == readSerial)
+        return false;
+
+    __sync_synchronize();
+
+    readSerial = serial;
+    readIndex = 0;
+    return true;
+}
+
+bool BridgeParameterPool::readNextValue(uint32_t& index, float& value) noexcept
+{
+    for (; readIndex < count; ++readIndex)
+    {
+        const uint32_t serial = ((volatile const uint32_t*)otherSerials)[readIndex];
+
+        if (serial == readSerials[readIndex])
+            continue;
+
+        __sync_synchronize();
+
+        readSerials[readIndex] = serial;
+        index = readIndex++;
+        value = ((volatile const float*)otherValues)[index];
+        return true;
+    }
+
+    return false;
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+
 BridgeRtClientControl::BridgeRtClientControl() noexcept
     : data(nullptr),
       filename(),
       needsSemDestroy(false),
-      isServer(false)
+      isServer(false),
+      spinCount(0),
+      spinMisses(0),
+      spinBackoff(0)
 {
     carla_zeroChars(shm, 64);
     jackbridge_shm_init(shm);
@@ -283,6 +694,44 @@ void BridgeRtClientControl::unmapData() noexcept
     setRingBuffer(nullptr, false);
 }
 
+void BridgeRtClientControl::setSpinWaitTime(const uint usecs) noexcept
+{
+    spinCount   = static_cast<uint32_t>(std::min(usecs, kBridgeSpinWaitMaxTime) * getSpinIterationsPerUsec());
+    spinMisses  = 0;
+    spinBackoff = 0;
+}
+
+bool BridgeRtClientControl::spinWait(void* const sem, const bool server) noexcept
+{
+    if (spinCount == 0)
+        return false;
+
+    if (spinBackoff != 0)
+    {
+        --spinBackoff;
+        return false;
+    }
+
+    for (uint32_t i=0; i < spinCount; ++i)
+    {
+        if (jackbridge_sem_trywait(sem, server))
+        {
+            spinMisses = 0;
+            return true;
+        }
+
+        carla_cpu_pause();
+    }
+
+    if (++spinMisses == kBridgeSpinMaxMisses)
+    {
+        spinMisses  = 0;
+        spinBackoff = kBridgeSpinBackoffWaits;
+    }
+
+    return false;
+}
+
 bool BridgeRtClientControl::waitForClient(const uint msecs) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(msecs > 0, false);
@@ -291,6 +740,9 @@ bool BridgeRtClientControl::waitForClient(const uint msecs) noexcept
 
     jackbridge_sem_post(&data->sem.server, true);
 
+    if (spinWait(&data->sem.client, true))
+        return true;
+
     return jackbridge_sem_timedwait(&data->sem.client, msecs, true);
 }
 
@@ -308,7 +760,7 @@ PluginBridgeRtClientOpcode BridgeRtClientControl::readOpcode() noexcept
 
 BridgeRtClientControl::WaitHelper::WaitHelper(BridgeRtClientControl& c) noexcept
     : data(c.data),
-      ok(jackbridge_sem_timedwait(&data->sem.server, 5000, false)) {}
+      ok(c.spinWait(&data->sem.server, false) || jackbridge_sem_timedwait(&data->sem.server, 5000, false)) {}
 
 BridgeRtClientControl::WaitHelper::~WaitHelper() noexcept
 {
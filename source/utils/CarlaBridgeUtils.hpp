@@ -56,6 +56,8 @@ const char* PluginBridgeRtClientOpcode2str(const PluginBridgeRtClientOpcode opco
         return "kPluginBridgeRtClientProcess";
     case kPluginBridgeRtClientQuit:
         return "kPluginBridgeRtClientQuit";
+    case kPluginBridgeRtClientSetParameterPool:
+        return "kPluginBridgeRtClientSetParameterPool";
     }
 
     carla_stderr("CarlaBackend::PluginBridgeRtClientOpcode2str(%i) - invalid opcode", opcode);
@@ -131,6 +133,10 @@ const char* PluginBridgeNonRtClientOpcode2str(const PluginBridgeNonRtClientOpcod
         return "kPluginBridgeNonRtClientEmbedUI";
     case kPluginBridgeNonRtClientReload:
         return "kPluginBridgeNonRtClientReload";
+    case kPluginBridgeNonRtClientSetChunkDataShm:
+        return "kPluginBridgeNonRtClientSetChunkDataShm";
+    case kPluginBridgeNonRtClientSetServerChunkPoolSize:
+        return "kPluginBridgeNonRtClientSetServerChunkPoolSize";
     }
 
     carla_stderr("CarlaBackend::PluginBridgeNonRtClientOpcode2str(%i) - invalid opcode", opcode);
@@ -208,6 +214,12 @@ const char* PluginBridgeNonRtServerOpcode2str(const PluginBridgeNonRtServerOpcod
         return "kPluginBridgeNonRtServerRespEmbedUI";
     case kPluginBridgeNonRtServerResizeEmbedUI:
         return "kPluginBridgeNonRtServerResizeEmbedUI";
+    case kPluginBridgeNonRtServerSetChunkDataShm:
+        return "kPluginBridgeNonRtServerSetChunkDataShm";
+    case kPluginBridgeNonRtServerResizeChunkPool:
+        return "kPluginBridgeNonRtServerResizeChunkPool";
+    case kPluginBridgeNonRtServerChunkDataReceived:
+        return "kPluginBridgeNonRtServerChunkDataReceived";
     }
 
     carla_stderr("CarlaBackend::PluginBridgeNonRtServerOpcode2str%i) - invalid opcode", opcode);
@@ -263,6 +275,90 @@ struct CARLA_API BridgeAudioPool {
 
 // -------------------------------------------------------------------------------------------------------------------
 
+// Raw chunk data, Server => Client or Client => Server Non-RT
+// The server creates and sizes the pool, named after the audio pool, the client maps it only while transferring.
+struct CARLA_API BridgeChunkPool {
+    uint8_t* data;
+    std::size_t dataSize;
+    CarlaString filename;
+    char shm[64];
+    bool isServer;
+    const bool isForClient;
+
+    explicit BridgeChunkPool(const bool forClient) noexcept;
+    ~BridgeChunkPool() noexcept;
+
+    bool initializeServer(const char* const basename) noexcept;
+    bool attachClient(const char* const basename) noexcept;
+    void clear() noexcept;
+
+    // server, grows the pool to hold at least size bytes
+    bool resize(const std::size_t size) noexcept;
+
+    // client
+    bool map(const std::size_t size) noexcept;
+    void unmap() noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE(BridgeChunkPool)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+// Parameter values, Server => Client and Client => Server RT
+// Each side writes values into its own half of the pool, bumping a per-parameter and a global serial after each change.
+// The other side compares serials against the last ones it has seen, so the latest values are read in a single pass.
+struct BridgeParameterPoolHeader {
+    uint32_t serial[2];  // server, client
+    uint32_t clientCount; // set by the client after mapping, so the server knows the pool is in use
+    uint32_t reserved;
+};
+
+struct CARLA_API BridgeParameterPool {
+    BridgeParameterPoolHeader* data;
+    std::size_t dataSize;
+    uint32_t count;
+    CarlaString filename;
+    char shm[64];
+    bool isServer;
+
+    BridgeParameterPool() noexcept;
+    ~BridgeParameterPool() noexcept;
+
+    bool initializeServer(const char* const basename) noexcept;
+    bool attachClient(const char* const basename) noexcept;
+    void clear() noexcept;
+
+    // server, (re)creates the pool for count parameters
+    bool resize(const uint32_t count) noexcept;
+
+    // client, maps the pool created by the server for count parameters, 0 to unmap
+    bool map(const uint32_t count) noexcept;
+
+    // write a value for the other side
+    void writeValue(const uint32_t index, const float value, const bool onlyIfChanged) noexcept;
+
+    // check if the other side has changed any value, call readNextValue() in a loop after this
+    bool hasChanges() noexcept;
+
+    // get the next value changed by the other side, returns false when there are no more
+    bool readNextValue(uint32_t& index, float& value) noexcept;
+
+private:
+    float* ownValues;
+    uint32_t* ownSerials;
+    const float* otherValues;
+    const uint32_t* otherSerials;
+
+    // last seen serials of the other side, local memory
+    uint32_t* readSerials;
+    uint32_t readSerial;
+    uint32_t readIndex;
+
+    CARLA_DECLARE_NON_COPYABLE(BridgeParameterPool)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
 struct CARLA_API BridgeRtClientControl : public CarlaRingBufferControl<SmallStackBuffer> {
     BridgeRtClientData* data;
     CarlaString filename;
@@ -270,6 +366,11 @@ struct CARLA_API BridgeRtClientControl : public CarlaRingBufferControl<SmallStac
     char shm[64];
     bool isServer;
 
+    // busy-wait state, see setSpinWaitTime()
+    uint32_t spinCount;
+    uint32_t spinMisses;
+    uint32_t spinBackoff;
+
     BridgeRtClientControl() noexcept;
     ~BridgeRtClientControl() noexcept override;
 
@@ -280,6 +381,11 @@ struct CARLA_API BridgeRtClientControl : public CarlaRingBufferControl<SmallStac
     bool mapData() noexcept;
     void unmapData() noexcept;
 
+    // poll the semaphore for up to usecs before sleeping on it, 0 to always sleep
+    // spinning is skipped for a while when the other side keeps taking longer than that
+    void setSpinWaitTime(const uint usecs) noexcept;
+    bool spinWait(void* const sem, const bool server) noexcept;
+
     // non-bridge, server
     bool waitForClient(const uint msecs) noexcept;
     bool writeOpcode(const PluginBridgeRtClientOpcode opcode) noexcept;
@@ -0,0 +1,87 @@
+/*
+ * Carla cache utils
+ * Copyright (C) 2023 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_CACHE_UTILS_HPP_INCLUDED
+#define CARLA_CACHE_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include "water/files/File.h"
+
+#include <algorithm>
+#include <vector>
+
+// --------------------------------------------------------------------------------------------------------------------
+// Directory for files that Carla can recreate at any time, like plugin indexes and waveform peaks.
+
+static inline
+water::File carla_get_cache_directory()
+{
+#if defined(CARLA_OS_WIN)
+    return water::File::getSpecialLocation(water::File::winAppData).getChildFile("Carla");
+#elif defined(CARLA_OS_MAC)
+    return water::File::getSpecialLocation(water::File::userHomeDirectory).getChildFile("Library/Caches/Carla");
+#else
+    if (const char* const xdgCacheHome = std::getenv("XDG_CACHE_HOME"))
+    {
+        if (water::File::isAbsolutePath(xdgCacheHome))
+            return water::File(water::CharPointer_UTF8(xdgCacheHome)).getChildFile("carla");
+    }
+
+    return water::File::getSpecialLocation(water::File::userHomeDirectory).getChildFile(".cache/carla");
+#endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Delete the oldest files in 'dir' matching 'wildcard' until all of them take no more than 'maxSize' bytes.
+
+static inline
+void carla_trim_cache_directory(const water::File& dir, const char* const wildcard, const water::int64 maxSize)
+{
+    std::vector<water::File> files;
+
+    if (dir.findChildFiles(files, water::File::findFiles, false, wildcard) == 0)
+        return;
+
+    std::vector<std::pair<water::int64, water::File> > sortedFiles;
+    sortedFiles.reserve(files.size());
+    water::int64 totalSize = 0;
+
+    for (std::vector<water::File>::const_iterator it = files.begin(); it != files.end(); ++it)
+    {
+        sortedFiles.push_back(std::make_pair(it->getLastModificationTime(), *it));
+        totalSize += it->getSize();
+    }
+
+    if (totalSize <= maxSize)
+        return;
+
+    std::sort(sortedFiles.begin(), sortedFiles.end());
+
+    for (std::size_t i=0; i < sortedFiles.size() && totalSize > maxSize; ++i)
+    {
+        const water::File& file(sortedFiles[i].second);
+        const water::int64 size = file.getSize();
+
+        if (file.deleteFile())
+            totalSize -= size;
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_CACHE_UTILS_HPP_INCLUDED
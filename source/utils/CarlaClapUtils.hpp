@@ -31,6 +31,9 @@
 #include "clap/ext/params.h"
 #include "clap/ext/posix-fd-support.h"
 #include "clap/ext/state.h"
+#include "clap/ext/tail.h"
+#include "clap/ext/thread-check.h"
+#include "clap/ext/thread-pool.h"
 #include "clap/ext/timer-support.h"
 
 #if defined(CARLA_OS_WIN)
@@ -121,6 +121,27 @@ const char* EngineControlEventType2Str(const EngineControlEventType type) noexce
 
 // -----------------------------------------------------------------------
 
+/*
+ * Clear the used part of an engine event buffer.
+ * Events are always added at the first null slot, so everything after it is already zero.
+ */
+static inline
+void clearUsedEngineEvents(EngineEvent engineEvents[kMaxEngineEventInternalCount]) noexcept
+{
+    ushort numEvents = 0;
+
+    for (; numEvents < kMaxEngineEventInternalCount; ++numEvents)
+    {
+        if (engineEvents[numEvents].type == kEngineEventTypeNull)
+            break;
+    }
+
+    if (numEvents != 0)
+        carla_zeroStructs(engineEvents, numEvents);
+}
+
+// -----------------------------------------------------------------------
+
 static inline
 void fillEngineEventsFromWaterMidiBuffer(EngineEvent engineEvents[kMaxEngineEventInternalCount], const water::MidiBuffer& midiBuffer)
 {
@@ -162,6 +183,9 @@ void fillWaterMidiBufferFromEngineEvents(water::MidiBuffer& midiBuffer, const En
     uint8_t mdataTmp[EngineMidiEvent::kDataSize];
     const uint8_t* mdataPtr;
 
+    // engine events are usually sorted, append them directly while that holds
+    int lastTime = midiBuffer.getLastEventTime();
+
     for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
     {
         const EngineEvent& engineEvent(engineEvents[i]);
@@ -209,8 +233,20 @@ void fillWaterMidiBufferFromEngineEvents(water::MidiBuffer& midiBuffer, const En
             continue;
         }
 
-        if (size > 0)
-            midiBuffer.addEvent(mdataPtr, static_cast<int>(size), static_cast<int>(engineEvent.time));
+        if (size == 0)
+            continue;
+
+        const int time = static_cast<int>(engineEvent.time);
+
+        if (time >= lastTime)
+        {
+            midiBuffer.addEventAtEnd(mdataPtr, static_cast<int>(size), time);
+            lastTime = time;
+        }
+        else
+        {
+            midiBuffer.addEvent(mdataPtr, static_cast<int>(size), time);
+        }
     }
 }
 
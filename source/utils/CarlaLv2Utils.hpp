@@ -86,6 +86,7 @@
 #if defined(CARLA_UTILS_USE_QT)
 # include <QtCore/QStringList>
 #else
+# include "water/files/File.h"
 # include "water/text/StringArray.h"
 #endif
 
@@ -297,6 +298,8 @@ public:
     const LilvPlugin** cachedPlugins;
     uint pluginCount;
 
+    CarlaStringList partialBundles;
+
     // ----------------------------------------------------------------------------------------------------------------
 
     Lv2WorldClass()
@@ -431,7 +434,8 @@ public:
           needsInit(true),
           allPlugins(nullptr),
           cachedPlugins(nullptr),
-          pluginCount(0) {}
+          pluginCount(0),
+          partialBundles() {}
 
     ~Lv2WorldClass() override
     {
@@ -465,7 +469,10 @@ public:
 
         needsInit = false;
 
-        Lilv::World::load_all(LV2_PATH);
+        if (partialBundles.isEmpty())
+            Lilv::World::load_all(LV2_PATH);
+        else
+            load_all_except_partial_bundles(LV2_PATH);
 
         allPlugins = lilv_world_get_all_plugins(this->me);
         CARLA_SAFE_ASSERT_RETURN(allPlugins != nullptr,);
@@ -503,6 +510,68 @@ public:
         }
     }
 
+    // load some bundles only, for when a single plugin is needed and reading every manifest would be slow
+    // the world still needs init afterwards, initIfNeeded() can load everything else later
+    void load_bundles_partially(const char* const* const bundleURIs)
+    {
+        CARLA_SAFE_ASSERT_RETURN(bundleURIs != nullptr,);
+
+        if (! needsInit)
+            return;
+
+        for (int i=0; bundleURIs[i] != nullptr; ++i)
+        {
+            if (partialBundles.contains(bundleURIs[i]))
+                continue;
+
+            partialBundles.append(bundleURIs[i]);
+            Lilv::World::load_bundle(Lilv::Node(new_uri(bundleURIs[i])));
+        }
+
+        allPlugins = lilv_world_get_all_plugins(this->me);
+    }
+
+    // same as load_all, but skipping bundles already loaded by load_bundles_partially,
+    // as loading them again makes lilv reset the plugins that might already be in use.
+    // lilv's dc:replaces handling is skipped too, Carla does not use lilv_plugin_is_replaced.
+    void load_all_except_partial_bundles(const char* const LV2_PATH)
+    {
+#if defined(CARLA_UTILS_USE_QT)
+        Lilv::World::load_all(LV2_PATH);
+#else
+        const water::StringArray splitPaths(water::StringArray::fromTokens(LV2_PATH, CARLA_OS_SPLIT_STR, ""));
+
+        for (water::String *it = splitPaths.begin(), *end = splitPaths.end(); it != end; ++it)
+        {
+            if (! water::File::isAbsolutePath(*it))
+                continue;
+
+            const water::File dir(*it);
+
+            if (! dir.isDirectory())
+                continue;
+
+            std::vector<water::File> results;
+            dir.findChildFiles(results, water::File::findDirectories, false);
+
+            for (std::vector<water::File>::const_iterator it2 = results.begin(); it2 != results.end(); ++it2)
+            {
+                LilvNode* const bundleNode(lilv_new_file_uri(this->me, nullptr,
+                                                             (it2->getFullPathName() + "/").toRawUTF8()));
+                CARLA_SAFE_ASSERT_CONTINUE(bundleNode != nullptr);
+
+                if (! partialBundles.contains(lilv_node_as_uri(bundleNode)))
+                    lilv_world_load_bundle(this->me, bundleNode);
+
+                lilv_node_free(bundleNode);
+            }
+        }
+
+        lilv_world_load_specifications(this->me);
+        lilv_world_load_plugin_classes(this->me);
+#endif
+    }
+
     uint getPluginCount() const
     {
         CARLA_SAFE_ASSERT_RETURN(! needsInit, 0);
@@ -522,7 +591,6 @@ public:
     const LilvPlugin* getPluginFromURI(const LV2_URI uri) const
     {
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', nullptr);
-        CARLA_SAFE_ASSERT_RETURN(! needsInit, nullptr);
         CARLA_SAFE_ASSERT_RETURN(allPlugins != nullptr, nullptr);
 
         LilvNode* const uriNode(lilv_new_uri(this->me, uri));
@@ -538,7 +606,7 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', nullptr);
         CARLA_SAFE_ASSERT_RETURN(uridMap != nullptr, nullptr);
-        CARLA_SAFE_ASSERT_RETURN(! needsInit, nullptr);
+        CARLA_SAFE_ASSERT_RETURN(allPlugins != nullptr, nullptr);
 
         LilvNode* const uriNode(lilv_new_uri(this->me, uri));
         CARLA_SAFE_ASSERT_RETURN(uriNode != nullptr, nullptr);
@@ -179,7 +179,7 @@ void carla_addFloats(float dest[], const float src[], const std::size_t count) n
         if (!std::isfinite(src[i]))
             __builtin_unreachable();
        #endif
-        *dest++ += *src++;
+        dest[i] += src[i];
     }
 }
 
@@ -234,6 +234,68 @@ void carla_zeroFloats(float floats[], const std::size_t count) noexcept
     std::memset(floats, 0, count*sizeof(float));
 }
 
+/*
+ * Clear a double array.
+ */
+static inline
+void carla_zeroDoubles(double doubles[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(doubles != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    std::memset(doubles, 0, count*sizeof(double));
+}
+
+/*
+ * Convert a float array into a double array.
+ */
+static inline
+void carla_convertFloatsToDoubles(double dest[], const float src[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    for (std::size_t i=0; i<count; ++i)
+        dest[i] = static_cast<double>(src[i]);
+}
+
+/*
+ * Convert a double array into a float array.
+ */
+static inline
+void carla_convertDoublesToFloats(float dest[], const double src[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    for (std::size_t i=0; i<count; ++i)
+        dest[i] = static_cast<float>(src[i]);
+}
+
+/*
+ * Add double array values to another double array.
+ */
+static inline
+void carla_addDoubles(double dest[], const double src[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    for (std::size_t i=0; i<count; ++i)
+    {
+       #ifdef __GNUC__
+        if (!std::isfinite(dest[i]))
+            __builtin_unreachable();
+        if (!std::isfinite(src[i]))
+            __builtin_unreachable();
+       #endif
+        dest[i] += src[i];
+    }
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 /*
@@ -281,6 +343,94 @@ float carla_findMaxNormalizedFloat(const float floats[], const std::size_t count
     return maxf2;
 }
 
+/*
+ * Find the highest absolute and normalized value within a double array.
+ */
+static inline
+float carla_findMaxNormalizedDouble(const double doubles[], const std::size_t count)
+{
+    CARLA_SAFE_ASSERT_RETURN(doubles != nullptr, 0.f);
+    CARLA_SAFE_ASSERT_RETURN(count > 0, 0.f);
+
+    double tmp, maxd2 = std::abs(doubles[0]);
+
+    for (std::size_t i=1; i<count; ++i)
+    {
+       #ifdef __GNUC__
+        if (!std::isfinite(doubles[i]))
+            __builtin_unreachable();
+       #endif
+
+        tmp = std::abs(doubles[i]);
+
+        if (tmp > maxd2)
+            maxd2 = tmp;
+    }
+
+    return maxd2 > 1.0 ? 1.f : static_cast<float>(maxd2);
+}
+
+/*
+ * Check if all values within a float array are below a silence threshold (-120dB by default).
+ * Values are checked in small blocks without branches, so that each block can be vectorized.
+ */
+static inline
+bool carla_isSilentFloats(const float floats[], const std::size_t count, const float threshold = 1e-6f) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(floats != nullptr, true);
+
+    std::size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        int loud = 0;
+
+        for (std::size_t j=0; j<16; ++j)
+            loud |= std::abs(floats[i+j]) > threshold;
+
+        if (loud != 0)
+            return false;
+    }
+
+    for (; i < count; ++i)
+    {
+        if (std::abs(floats[i]) > threshold)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Check if all values within a double array are below a silence threshold (-120dB by default).
+ */
+static inline
+bool carla_isSilentDoubles(const double doubles[], const std::size_t count, const double threshold = 1e-6) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(doubles != nullptr, true);
+
+    std::size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        int loud = 0;
+
+        for (std::size_t j=0; j<16; ++j)
+            loud |= std::abs(doubles[i+j]) > threshold;
+
+        if (loud != 0)
+            return false;
+    }
+
+    for (; i < count; ++i)
+    {
+        if (std::abs(doubles[i]) > threshold)
+            return false;
+    }
+
+    return true;
+}
+
 /*
  * Multiply an array with a fixed value, float-specific version.
  */
@@ -152,9 +152,8 @@ public:
        #else
         CARLA_SAFE_ASSERT_RETURN(handle != 0, false);
        #endif
-        _copyFrom(handle);
 
-        // wait for thread to start
+        // wait for thread to start, it sets its own handle
         fSignal.wait();
         return true;
     }
@@ -312,6 +311,9 @@ private:
         if (fName.isNotEmpty())
             setCurrentThreadName(fName);
 
+        // set here and not after pthread_create, as a short run() could be done before that
+        _copyFrom(pthread_self());
+
         // report ready
         fSignal.signal();
 
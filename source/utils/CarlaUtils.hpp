@@ -328,6 +328,25 @@ void carla_unsetenv(const char* const key) noexcept
 #endif
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// carla_get_cpu_count
+
+/*
+ * Get the number of CPUs currently online, never less than 1.
+ */
+static inline
+uint carla_get_cpu_count() noexcept
+{
+#ifdef CARLA_OS_WIN
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? static_cast<uint>(info.dwNumberOfProcessors) : 1;
+#else
+    const long count = ::sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<uint>(count) : 1;
+#endif
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // carla_strdup
 